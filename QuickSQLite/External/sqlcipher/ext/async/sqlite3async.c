@@ -1031,7 +1031,14 @@ static int asyncOpen(
     asyncCheckReservedLock,          /* xCheckReservedLock */
     asyncFileControl,                /* xFileControl */
     asyncSectorSize,                 /* xSectorSize */
-    asyncDeviceCharacteristics       /* xDeviceCharacteristics */
+    asyncDeviceCharacteristics,      /* xDeviceCharacteristics */
+    0,                               /* xShmMap */
+    0,                               /* xShmLock */
+    0,                               /* xShmBarrier */
+    0,                               /* xShmUnmap */
+    0,                               /* xFetch */
+    0,                               /* xUnfetch */
+    0                                /* xWriteV */
   };
 
   sqlite3_vfs *pVfs = (sqlite3_vfs *)pAsyncVfs->pAppData;
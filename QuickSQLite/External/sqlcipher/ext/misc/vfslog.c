@@ -167,7 +167,10 @@ static sqlite3_io_methods vlog_io_methods = {
   0,                              /* xShmMap */
   0,                              /* xShmLock */
   0,                              /* xShmBarrier */
-  0                               /* xShmUnmap */
+  0,                              /* xShmUnmap */
+  0,                              /* xFetch */
+  0,                              /* xUnfetch */
+  0                               /* xWriteV */
 };
 
 #if SQLITE_OS_UNIX && !defined(NO_GETTOD)
@@ -502,6 +502,8 @@ mptester$(EXE):	sqlite3.c $(TOP)/mptest/mptest.c
 
 MPTEST1=./mptester$(EXE) mptest1.db $(TOP)/mptest/crash01.test --repeat 20
 MPTEST2=./mptester$(EXE) mptest2.db $(TOP)/mptest/multiwrite01.test --repeat 20
+# The mptest/ directory would otherwise satisfy this target in-tree.
+.PHONY: mptest
 mptest:	mptester$(EXE)
 	$(MPTEST1) --journalmode DELETE
 	$(MPTEST2) --journalmode WAL
@@ -511,6 +513,9 @@ mptest:	mptester$(EXE)
 	$(MPTEST2) --journalmode TRUNCATE
 	$(MPTEST1) --journalmode TRUNCATE
 	$(MPTEST2) --journalmode DELETE
+	./mptester$(EXE) mptest3.db $(TOP)/mptest/btreeappend01.test
+	./mptester$(EXE) mptest3.db $(TOP)/mptest/vacuumprefix01.test
+	./mptester$(EXE) mptest3.db $(TOP)/mptest/walpagemap01.test
 
 sqlite3.o:	sqlite3.c
 	$(TCCX) -I. -c sqlite3.c
@@ -848,6 +853,9 @@ wordcount$(EXE):	$(TOP)/test/wordcount.c sqlite3.c
 speedtest1$(EXE):	$(TOP)/test/speedtest1.c sqlite3.o
 	$(TCC) -I. $(OTAFLAGS) -o speedtest1$(EXE) $(TOP)/test/speedtest1.c sqlite3.o $(THREADLIB) 
 
+pcachebench$(EXE):	$(TOP)/tool/pcachebench.c sqlite3.o
+	$(TCC) -I. -o pcachebench$(EXE) $(TOP)/tool/pcachebench.c sqlite3.o $(THREADLIB)
+
 rbu$(EXE): $(TOP)/ext/rbu/rbu.c $(TOP)/ext/rbu/sqlite3rbu.c sqlite3.o 
 	$(TCC) -I. -o rbu$(EXE) $(TOP)/ext/rbu/rbu.c sqlite3.o \
 	  $(THREADLIB)
@@ -901,6 +909,7 @@ clean:
 	rm -f showstat4 showstat4.exe
 	rm -f showwal showwal.exe
 	rm -f speedtest1 speedtest1.exe
+	rm -f pcachebench pcachebench.exe
 	rm -f wordcount wordcount.exe
 	rm -f rbu rbu.exe
 	rm -f srcck1 srcck1.exe
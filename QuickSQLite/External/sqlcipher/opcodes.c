@@ -57,35 +57,35 @@ const char *sqlite3OpcodeName(int i){
     /*  44 */ "Once"             OpHelp(""),
     /*  45 */ "If"               OpHelp(""),
     /*  46 */ "IfNot"            OpHelp(""),
-    /*  47 */ "Column"           OpHelp("r[P3]=PX"),
-    /*  48 */ "Affinity"         OpHelp("affinity(r[P1@P2])"),
-    /*  49 */ "MakeRecord"       OpHelp("r[P3]=mkrec(r[P1@P2])"),
-    /*  50 */ "Count"            OpHelp("r[P2]=count()"),
-    /*  51 */ "ReadCookie"       OpHelp(""),
-    /*  52 */ "SetCookie"        OpHelp(""),
-    /*  53 */ "ReopenIdx"        OpHelp("root=P2 iDb=P3"),
-    /*  54 */ "OpenRead"         OpHelp("root=P2 iDb=P3"),
-    /*  55 */ "OpenWrite"        OpHelp("root=P2 iDb=P3"),
-    /*  56 */ "OpenAutoindex"    OpHelp("nColumn=P2"),
-    /*  57 */ "OpenEphemeral"    OpHelp("nColumn=P2"),
-    /*  58 */ "SorterOpen"       OpHelp(""),
-    /*  59 */ "SequenceTest"     OpHelp("if( cursor[P1].ctr++ ) pc = P2"),
-    /*  60 */ "OpenPseudo"       OpHelp("P3 columns in r[P2]"),
-    /*  61 */ "Close"            OpHelp(""),
-    /*  62 */ "ColumnsUsed"      OpHelp(""),
-    /*  63 */ "SeekLT"           OpHelp("key=r[P3@P4]"),
-    /*  64 */ "SeekLE"           OpHelp("key=r[P3@P4]"),
-    /*  65 */ "SeekGE"           OpHelp("key=r[P3@P4]"),
-    /*  66 */ "SeekGT"           OpHelp("key=r[P3@P4]"),
-    /*  67 */ "NoConflict"       OpHelp("key=r[P3@P4]"),
-    /*  68 */ "NotFound"         OpHelp("key=r[P3@P4]"),
-    /*  69 */ "Found"            OpHelp("key=r[P3@P4]"),
-    /*  70 */ "NotExists"        OpHelp("intkey=r[P3]"),
+    /*  47 */ "Columns"          OpHelp("r[P3..]=columns P2.. of cursor P1"),
+    /*  48 */ "ColumnCmp"        OpHelp("r[P3]=PX"),
+    /*  49 */ "ColumnRow"        OpHelp("r[P3]=PX"),
+    /*  50 */ "Column"           OpHelp("r[P3]=PX"),
+    /*  51 */ "Affinity"         OpHelp("affinity(r[P1@P2])"),
+    /*  52 */ "MakeRecord"       OpHelp("r[P3]=mkrec(r[P1@P2])"),
+    /*  53 */ "Count"            OpHelp("r[P2]=count()"),
+    /*  54 */ "AggScan"          OpHelp(""),
+    /*  55 */ "ReadCookie"       OpHelp(""),
+    /*  56 */ "SetCookie"        OpHelp(""),
+    /*  57 */ "ReopenIdx"        OpHelp("root=P2 iDb=P3"),
+    /*  58 */ "OpenRead"         OpHelp("root=P2 iDb=P3"),
+    /*  59 */ "OpenWrite"        OpHelp("root=P2 iDb=P3"),
+    /*  60 */ "OpenAutoindex"    OpHelp("nColumn=P2"),
+    /*  61 */ "OpenEphemeral"    OpHelp("nColumn=P2"),
+    /*  62 */ "SorterOpen"       OpHelp(""),
+    /*  63 */ "SequenceTest"     OpHelp("if( cursor[P1].ctr++ ) pc = P2"),
+    /*  64 */ "OpenPseudo"       OpHelp("P3 columns in r[P2]"),
+    /*  65 */ "Close"            OpHelp(""),
+    /*  66 */ "ColumnsUsed"      OpHelp(""),
+    /*  67 */ "SeekLT"           OpHelp("key=r[P3@P4]"),
+    /*  68 */ "SeekLE"           OpHelp("key=r[P3@P4]"),
+    /*  69 */ "SeekGE"           OpHelp("key=r[P3@P4]"),
+    /*  70 */ "SeekGT"           OpHelp("key=r[P3@P4]"),
     /*  71 */ "Or"               OpHelp("r[P3]=(r[P1] || r[P2])"),
     /*  72 */ "And"              OpHelp("r[P3]=(r[P1] && r[P2])"),
-    /*  73 */ "Sequence"         OpHelp("r[P2]=cursor[P1].ctr++"),
-    /*  74 */ "NewRowid"         OpHelp("r[P2]=rowid"),
-    /*  75 */ "Insert"           OpHelp("intkey=r[P3] data=r[P2]"),
+    /*  73 */ "NoConflict"       OpHelp("key=r[P3@P4]"),
+    /*  74 */ "NotFound"         OpHelp("key=r[P3@P4]"),
+    /*  75 */ "Found"            OpHelp("key=r[P3@P4]"),
     /*  76 */ "IsNull"           OpHelp("if r[P1]==NULL goto P2"),
     /*  77 */ "NotNull"          OpHelp("if r[P1]!=NULL goto P2"),
     /*  78 */ "Ne"               OpHelp("if r[P1]!=r[P3] goto P2"),
@@ -94,7 +94,7 @@ const char *sqlite3OpcodeName(int i){
     /*  81 */ "Le"               OpHelp("if r[P1]<=r[P3] goto P2"),
     /*  82 */ "Lt"               OpHelp("if r[P1]<r[P3] goto P2"),
     /*  83 */ "Ge"               OpHelp("if r[P1]>=r[P3] goto P2"),
-    /*  84 */ "InsertInt"        OpHelp("intkey=P3 data=r[P2]"),
+    /*  84 */ "NotExists"        OpHelp("intkey=r[P3]"),
     /*  85 */ "BitAnd"           OpHelp("r[P3]=r[P1]&r[P2]"),
     /*  86 */ "BitOr"            OpHelp("r[P3]=r[P1]|r[P2]"),
     /*  87 */ "ShiftLeft"        OpHelp("r[P3]=r[P2]<<r[P1]"),
@@ -105,73 +105,77 @@ const char *sqlite3OpcodeName(int i){
     /*  92 */ "Divide"           OpHelp("r[P3]=r[P2]/r[P1]"),
     /*  93 */ "Remainder"        OpHelp("r[P3]=r[P2]%r[P1]"),
     /*  94 */ "Concat"           OpHelp("r[P3]=r[P2]+r[P1]"),
-    /*  95 */ "Delete"           OpHelp(""),
+    /*  95 */ "Sequence"         OpHelp("r[P2]=cursor[P1].ctr++"),
     /*  96 */ "BitNot"           OpHelp("r[P1]= ~r[P1]"),
     /*  97 */ "String8"          OpHelp("r[P2]='P4'"),
-    /*  98 */ "ResetCount"       OpHelp(""),
-    /*  99 */ "SorterCompare"    OpHelp("if key(P1)!=trim(r[P3],P4) goto P2"),
-    /* 100 */ "SorterData"       OpHelp("r[P2]=data"),
-    /* 101 */ "RowKey"           OpHelp("r[P2]=key"),
-    /* 102 */ "RowData"          OpHelp("r[P2]=data"),
-    /* 103 */ "Rowid"            OpHelp("r[P2]=rowid"),
-    /* 104 */ "NullRow"          OpHelp(""),
-    /* 105 */ "Last"             OpHelp(""),
-    /* 106 */ "SorterSort"       OpHelp(""),
-    /* 107 */ "Sort"             OpHelp(""),
-    /* 108 */ "Rewind"           OpHelp(""),
-    /* 109 */ "SorterInsert"     OpHelp(""),
-    /* 110 */ "IdxInsert"        OpHelp("key=r[P2]"),
-    /* 111 */ "IdxDelete"        OpHelp("key=r[P2@P3]"),
-    /* 112 */ "Seek"             OpHelp("Move P3 to P1.rowid"),
-    /* 113 */ "IdxRowid"         OpHelp("r[P2]=rowid"),
-    /* 114 */ "IdxLE"            OpHelp("key=r[P3@P4]"),
-    /* 115 */ "IdxGT"            OpHelp("key=r[P3@P4]"),
-    /* 116 */ "IdxLT"            OpHelp("key=r[P3@P4]"),
-    /* 117 */ "IdxGE"            OpHelp("key=r[P3@P4]"),
-    /* 118 */ "Destroy"          OpHelp(""),
-    /* 119 */ "Clear"            OpHelp(""),
-    /* 120 */ "ResetSorter"      OpHelp(""),
-    /* 121 */ "CreateIndex"      OpHelp("r[P2]=root iDb=P1"),
-    /* 122 */ "CreateTable"      OpHelp("r[P2]=root iDb=P1"),
-    /* 123 */ "ParseSchema"      OpHelp(""),
-    /* 124 */ "LoadAnalysis"     OpHelp(""),
-    /* 125 */ "DropTable"        OpHelp(""),
-    /* 126 */ "DropIndex"        OpHelp(""),
-    /* 127 */ "DropTrigger"      OpHelp(""),
-    /* 128 */ "IntegrityCk"      OpHelp(""),
-    /* 129 */ "RowSetAdd"        OpHelp("rowset(P1)=r[P2]"),
-    /* 130 */ "RowSetRead"       OpHelp("r[P3]=rowset(P1)"),
-    /* 131 */ "RowSetTest"       OpHelp("if r[P3] in rowset(P1) goto P2"),
-    /* 132 */ "Program"          OpHelp(""),
+    /*  98 */ "NewRowid"         OpHelp("r[P2]=rowid"),
+    /*  99 */ "Insert"           OpHelp("intkey=r[P3] data=r[P2]"),
+    /* 100 */ "InsertInt"        OpHelp("intkey=P3 data=r[P2]"),
+    /* 101 */ "Delete"           OpHelp(""),
+    /* 102 */ "ResetCount"       OpHelp(""),
+    /* 103 */ "SorterCompare"    OpHelp("if key(P1)!=trim(r[P3],P4) goto P2"),
+    /* 104 */ "SorterData"       OpHelp("r[P2]=data"),
+    /* 105 */ "RowKey"           OpHelp("r[P2]=key"),
+    /* 106 */ "RowData"          OpHelp("r[P2]=data"),
+    /* 107 */ "Rowid"            OpHelp("r[P2]=rowid"),
+    /* 108 */ "NullRow"          OpHelp(""),
+    /* 109 */ "Last"             OpHelp(""),
+    /* 110 */ "SorterSort"       OpHelp(""),
+    /* 111 */ "Sort"             OpHelp(""),
+    /* 112 */ "Rewind"           OpHelp(""),
+    /* 113 */ "SorterInsert"     OpHelp(""),
+    /* 114 */ "IdxInsert"        OpHelp("key=r[P2]"),
+    /* 115 */ "IdxDelete"        OpHelp("key=r[P2@P3]"),
+    /* 116 */ "Seek"             OpHelp("Move P3 to P1.rowid"),
+    /* 117 */ "IdxRowid"         OpHelp("r[P2]=rowid"),
+    /* 118 */ "IdxLE"            OpHelp("key=r[P3@P4]"),
+    /* 119 */ "IdxGT"            OpHelp("key=r[P3@P4]"),
+    /* 120 */ "IdxLT"            OpHelp("key=r[P3@P4]"),
+    /* 121 */ "IdxGE"            OpHelp("key=r[P3@P4]"),
+    /* 122 */ "Destroy"          OpHelp(""),
+    /* 123 */ "Clear"            OpHelp(""),
+    /* 124 */ "ResetSorter"      OpHelp(""),
+    /* 125 */ "CreateIndex"      OpHelp("r[P2]=root iDb=P1"),
+    /* 126 */ "CreateTable"      OpHelp("r[P2]=root iDb=P1"),
+    /* 127 */ "ParseSchema"      OpHelp(""),
+    /* 128 */ "LoadAnalysis"     OpHelp(""),
+    /* 129 */ "DropTable"        OpHelp(""),
+    /* 130 */ "DropIndex"        OpHelp(""),
+    /* 131 */ "DropTrigger"      OpHelp(""),
+    /* 132 */ "IntegrityCk"      OpHelp(""),
     /* 133 */ "Real"             OpHelp("r[P2]=P4"),
-    /* 134 */ "Param"            OpHelp(""),
-    /* 135 */ "FkCounter"        OpHelp("fkctr[P1]+=P2"),
-    /* 136 */ "FkIfZero"         OpHelp("if fkctr[P1]==0 goto P2"),
-    /* 137 */ "MemMax"           OpHelp("r[P1]=max(r[P1],r[P2])"),
-    /* 138 */ "IfPos"            OpHelp("if r[P1]>0 then r[P1]-=P3, goto P2"),
-    /* 139 */ "OffsetLimit"      OpHelp("if r[P1]>0 then r[P2]=r[P1]+max(0,r[P3]) else r[P2]=(-1)"),
-    /* 140 */ "IfNotZero"        OpHelp("if r[P1]!=0 then r[P1]-=P3, goto P2"),
-    /* 141 */ "DecrJumpZero"     OpHelp("if (--r[P1])==0 goto P2"),
-    /* 142 */ "JumpZeroIncr"     OpHelp("if (r[P1]++)==0 ) goto P2"),
-    /* 143 */ "AggStep0"         OpHelp("accum=r[P3] step(r[P2@P5])"),
-    /* 144 */ "AggStep"          OpHelp("accum=r[P3] step(r[P2@P5])"),
-    /* 145 */ "AggFinal"         OpHelp("accum=r[P1] N=P2"),
-    /* 146 */ "IncrVacuum"       OpHelp(""),
-    /* 147 */ "Expire"           OpHelp(""),
-    /* 148 */ "TableLock"        OpHelp("iDb=P1 root=P2 write=P3"),
-    /* 149 */ "VBegin"           OpHelp(""),
-    /* 150 */ "VCreate"          OpHelp(""),
-    /* 151 */ "VDestroy"         OpHelp(""),
-    /* 152 */ "VOpen"            OpHelp(""),
-    /* 153 */ "VColumn"          OpHelp("r[P3]=vcolumn(P2)"),
-    /* 154 */ "VNext"            OpHelp(""),
-    /* 155 */ "VRename"          OpHelp(""),
-    /* 156 */ "Pagecount"        OpHelp(""),
-    /* 157 */ "MaxPgcnt"         OpHelp(""),
-    /* 158 */ "Init"             OpHelp("Start at P2"),
-    /* 159 */ "CursorHint"       OpHelp(""),
-    /* 160 */ "Noop"             OpHelp(""),
-    /* 161 */ "Explain"          OpHelp(""),
+    /* 134 */ "RowSetAdd"        OpHelp("rowset(P1)=r[P2]"),
+    /* 135 */ "RowSetRead"       OpHelp("r[P3]=rowset(P1)"),
+    /* 136 */ "RowSetTest"       OpHelp("if r[P3] in rowset(P1) goto P2"),
+    /* 137 */ "Program"          OpHelp(""),
+    /* 138 */ "Param"            OpHelp(""),
+    /* 139 */ "FkCounter"        OpHelp("fkctr[P1]+=P2"),
+    /* 140 */ "FkIfZero"         OpHelp("if fkctr[P1]==0 goto P2"),
+    /* 141 */ "MemMax"           OpHelp("r[P1]=max(r[P1],r[P2])"),
+    /* 142 */ "IfPos"            OpHelp("if r[P1]>0 then r[P1]-=P3, goto P2"),
+    /* 143 */ "OffsetLimit"      OpHelp("if r[P1]>0 then r[P2]=r[P1]+max(0,r[P3]) else r[P2]=(-1)"),
+    /* 144 */ "IfNotZero"        OpHelp("if r[P1]!=0 then r[P1]-=P3, goto P2"),
+    /* 145 */ "DecrJumpZero"     OpHelp("if (--r[P1])==0 goto P2"),
+    /* 146 */ "JumpZeroIncr"     OpHelp("if (r[P1]++)==0 ) goto P2"),
+    /* 147 */ "AggStep0"         OpHelp("accum=r[P3] step(r[P2@P5])"),
+    /* 148 */ "AggStep"          OpHelp("accum=r[P3] step(r[P2@P5])"),
+    /* 149 */ "AggFinal"         OpHelp("accum=r[P1] N=P2"),
+    /* 150 */ "IncrVacuum"       OpHelp(""),
+    /* 151 */ "Expire"           OpHelp(""),
+    /* 152 */ "TableLock"        OpHelp("iDb=P1 root=P2 write=P3"),
+    /* 153 */ "VBegin"           OpHelp(""),
+    /* 154 */ "VCreate"          OpHelp(""),
+    /* 155 */ "VDestroy"         OpHelp(""),
+    /* 156 */ "VOpen"            OpHelp(""),
+    /* 157 */ "VColumn"          OpHelp("r[P3]=vcolumn(P2)"),
+    /* 158 */ "VNext"            OpHelp(""),
+    /* 159 */ "VRename"          OpHelp(""),
+    /* 160 */ "Pagecount"        OpHelp(""),
+    /* 161 */ "MaxPgcnt"         OpHelp(""),
+    /* 162 */ "Init"             OpHelp("Start at P2"),
+    /* 163 */ "CursorHint"       OpHelp(""),
+    /* 164 */ "Noop"             OpHelp(""),
+    /* 165 */ "Explain"          OpHelp(""),
   };
   return azName[i];
 }
@@ -47,35 +47,35 @@
 #define OP_Once           44
 #define OP_If             45
 #define OP_IfNot          46
-#define OP_Column         47 /* synopsis: r[P3]=PX                         */
-#define OP_Affinity       48 /* synopsis: affinity(r[P1@P2])               */
-#define OP_MakeRecord     49 /* synopsis: r[P3]=mkrec(r[P1@P2])            */
-#define OP_Count          50 /* synopsis: r[P2]=count()                    */
-#define OP_ReadCookie     51
-#define OP_SetCookie      52
-#define OP_ReopenIdx      53 /* synopsis: root=P2 iDb=P3                   */
-#define OP_OpenRead       54 /* synopsis: root=P2 iDb=P3                   */
-#define OP_OpenWrite      55 /* synopsis: root=P2 iDb=P3                   */
-#define OP_OpenAutoindex  56 /* synopsis: nColumn=P2                       */
-#define OP_OpenEphemeral  57 /* synopsis: nColumn=P2                       */
-#define OP_SorterOpen     58
-#define OP_SequenceTest   59 /* synopsis: if( cursor[P1].ctr++ ) pc = P2   */
-#define OP_OpenPseudo     60 /* synopsis: P3 columns in r[P2]              */
-#define OP_Close          61
-#define OP_ColumnsUsed    62
-#define OP_SeekLT         63 /* synopsis: key=r[P3@P4]                     */
-#define OP_SeekLE         64 /* synopsis: key=r[P3@P4]                     */
-#define OP_SeekGE         65 /* synopsis: key=r[P3@P4]                     */
-#define OP_SeekGT         66 /* synopsis: key=r[P3@P4]                     */
-#define OP_NoConflict     67 /* synopsis: key=r[P3@P4]                     */
-#define OP_NotFound       68 /* synopsis: key=r[P3@P4]                     */
-#define OP_Found          69 /* synopsis: key=r[P3@P4]                     */
-#define OP_NotExists      70 /* synopsis: intkey=r[P3]                     */
+#define OP_Columns        47 /* synopsis: r[P3..]=columns P2.. of cursor P1 */
+#define OP_ColumnCmp      48 /* synopsis: r[P3]=PX                         */
+#define OP_ColumnRow      49 /* synopsis: r[P3]=PX                         */
+#define OP_Column         50 /* synopsis: r[P3]=PX                         */
+#define OP_Affinity       51 /* synopsis: affinity(r[P1@P2])               */
+#define OP_MakeRecord     52 /* synopsis: r[P3]=mkrec(r[P1@P2])            */
+#define OP_Count          53 /* synopsis: r[P2]=count()                    */
+#define OP_AggScan        54
+#define OP_ReadCookie     55
+#define OP_SetCookie      56
+#define OP_ReopenIdx      57 /* synopsis: root=P2 iDb=P3                   */
+#define OP_OpenRead       58 /* synopsis: root=P2 iDb=P3                   */
+#define OP_OpenWrite      59 /* synopsis: root=P2 iDb=P3                   */
+#define OP_OpenAutoindex  60 /* synopsis: nColumn=P2                       */
+#define OP_OpenEphemeral  61 /* synopsis: nColumn=P2                       */
+#define OP_SorterOpen     62
+#define OP_SequenceTest   63 /* synopsis: if( cursor[P1].ctr++ ) pc = P2   */
+#define OP_OpenPseudo     64 /* synopsis: P3 columns in r[P2]              */
+#define OP_Close          65
+#define OP_ColumnsUsed    66
+#define OP_SeekLT         67 /* synopsis: key=r[P3@P4]                     */
+#define OP_SeekLE         68 /* synopsis: key=r[P3@P4]                     */
+#define OP_SeekGE         69 /* synopsis: key=r[P3@P4]                     */
+#define OP_SeekGT         70 /* synopsis: key=r[P3@P4]                     */
 #define OP_Or             71 /* same as TK_OR, synopsis: r[P3]=(r[P1] || r[P2]) */
 #define OP_And            72 /* same as TK_AND, synopsis: r[P3]=(r[P1] && r[P2]) */
-#define OP_Sequence       73 /* synopsis: r[P2]=cursor[P1].ctr++           */
-#define OP_NewRowid       74 /* synopsis: r[P2]=rowid                      */
-#define OP_Insert         75 /* synopsis: intkey=r[P3] data=r[P2]          */
+#define OP_NoConflict     73 /* synopsis: key=r[P3@P4]                     */
+#define OP_NotFound       74 /* synopsis: key=r[P3@P4]                     */
+#define OP_Found          75 /* synopsis: key=r[P3@P4]                     */
 #define OP_IsNull         76 /* same as TK_ISNULL, synopsis: if r[P1]==NULL goto P2 */
 #define OP_NotNull        77 /* same as TK_NOTNULL, synopsis: if r[P1]!=NULL goto P2 */
 #define OP_Ne             78 /* same as TK_NE, synopsis: if r[P1]!=r[P3] goto P2 */
@@ -84,7 +84,7 @@
 #define OP_Le             81 /* same as TK_LE, synopsis: if r[P1]<=r[P3] goto P2 */
 #define OP_Lt             82 /* same as TK_LT, synopsis: if r[P1]<r[P3] goto P2 */
 #define OP_Ge             83 /* same as TK_GE, synopsis: if r[P1]>=r[P3] goto P2 */
-#define OP_InsertInt      84 /* synopsis: intkey=P3 data=r[P2]             */
+#define OP_NotExists      84 /* synopsis: intkey=r[P3]                     */
 #define OP_BitAnd         85 /* same as TK_BITAND, synopsis: r[P3]=r[P1]&r[P2] */
 #define OP_BitOr          86 /* same as TK_BITOR, synopsis: r[P3]=r[P1]|r[P2] */
 #define OP_ShiftLeft      87 /* same as TK_LSHIFT, synopsis: r[P3]=r[P2]<<r[P1] */
@@ -95,73 +95,77 @@
 #define OP_Divide         92 /* same as TK_SLASH, synopsis: r[P3]=r[P2]/r[P1] */
 #define OP_Remainder      93 /* same as TK_REM, synopsis: r[P3]=r[P2]%r[P1] */
 #define OP_Concat         94 /* same as TK_CONCAT, synopsis: r[P3]=r[P2]+r[P1] */
-#define OP_Delete         95
+#define OP_Sequence       95 /* synopsis: r[P2]=cursor[P1].ctr++           */
 #define OP_BitNot         96 /* same as TK_BITNOT, synopsis: r[P1]= ~r[P1] */
 #define OP_String8        97 /* same as TK_STRING, synopsis: r[P2]='P4'    */
-#define OP_ResetCount     98
-#define OP_SorterCompare  99 /* synopsis: if key(P1)!=trim(r[P3],P4) goto P2 */
-#define OP_SorterData    100 /* synopsis: r[P2]=data                       */
-#define OP_RowKey        101 /* synopsis: r[P2]=key                        */
-#define OP_RowData       102 /* synopsis: r[P2]=data                       */
-#define OP_Rowid         103 /* synopsis: r[P2]=rowid                      */
-#define OP_NullRow       104
-#define OP_Last          105
-#define OP_SorterSort    106
-#define OP_Sort          107
-#define OP_Rewind        108
-#define OP_SorterInsert  109
-#define OP_IdxInsert     110 /* synopsis: key=r[P2]                        */
-#define OP_IdxDelete     111 /* synopsis: key=r[P2@P3]                     */
-#define OP_Seek          112 /* synopsis: Move P3 to P1.rowid              */
-#define OP_IdxRowid      113 /* synopsis: r[P2]=rowid                      */
-#define OP_IdxLE         114 /* synopsis: key=r[P3@P4]                     */
-#define OP_IdxGT         115 /* synopsis: key=r[P3@P4]                     */
-#define OP_IdxLT         116 /* synopsis: key=r[P3@P4]                     */
-#define OP_IdxGE         117 /* synopsis: key=r[P3@P4]                     */
-#define OP_Destroy       118
-#define OP_Clear         119
-#define OP_ResetSorter   120
-#define OP_CreateIndex   121 /* synopsis: r[P2]=root iDb=P1                */
-#define OP_CreateTable   122 /* synopsis: r[P2]=root iDb=P1                */
-#define OP_ParseSchema   123
-#define OP_LoadAnalysis  124
-#define OP_DropTable     125
-#define OP_DropIndex     126
-#define OP_DropTrigger   127
-#define OP_IntegrityCk   128
-#define OP_RowSetAdd     129 /* synopsis: rowset(P1)=r[P2]                 */
-#define OP_RowSetRead    130 /* synopsis: r[P3]=rowset(P1)                 */
-#define OP_RowSetTest    131 /* synopsis: if r[P3] in rowset(P1) goto P2   */
-#define OP_Program       132
+#define OP_NewRowid       98 /* synopsis: r[P2]=rowid                      */
+#define OP_Insert         99 /* synopsis: intkey=r[P3] data=r[P2]          */
+#define OP_InsertInt     100 /* synopsis: intkey=P3 data=r[P2]             */
+#define OP_Delete        101
+#define OP_ResetCount    102
+#define OP_SorterCompare 103 /* synopsis: if key(P1)!=trim(r[P3],P4) goto P2 */
+#define OP_SorterData    104 /* synopsis: r[P2]=data                       */
+#define OP_RowKey        105 /* synopsis: r[P2]=key                        */
+#define OP_RowData       106 /* synopsis: r[P2]=data                       */
+#define OP_Rowid         107 /* synopsis: r[P2]=rowid                      */
+#define OP_NullRow       108
+#define OP_Last          109
+#define OP_SorterSort    110
+#define OP_Sort          111
+#define OP_Rewind        112
+#define OP_SorterInsert  113
+#define OP_IdxInsert     114 /* synopsis: key=r[P2]                        */
+#define OP_IdxDelete     115 /* synopsis: key=r[P2@P3]                     */
+#define OP_Seek          116 /* synopsis: Move P3 to P1.rowid              */
+#define OP_IdxRowid      117 /* synopsis: r[P2]=rowid                      */
+#define OP_IdxLE         118 /* synopsis: key=r[P3@P4]                     */
+#define OP_IdxGT         119 /* synopsis: key=r[P3@P4]                     */
+#define OP_IdxLT         120 /* synopsis: key=r[P3@P4]                     */
+#define OP_IdxGE         121 /* synopsis: key=r[P3@P4]                     */
+#define OP_Destroy       122
+#define OP_Clear         123
+#define OP_ResetSorter   124
+#define OP_CreateIndex   125 /* synopsis: r[P2]=root iDb=P1                */
+#define OP_CreateTable   126 /* synopsis: r[P2]=root iDb=P1                */
+#define OP_ParseSchema   127
+#define OP_LoadAnalysis  128
+#define OP_DropTable     129
+#define OP_DropIndex     130
+#define OP_DropTrigger   131
+#define OP_IntegrityCk   132
 #define OP_Real          133 /* same as TK_FLOAT, synopsis: r[P2]=P4       */
-#define OP_Param         134
-#define OP_FkCounter     135 /* synopsis: fkctr[P1]+=P2                    */
-#define OP_FkIfZero      136 /* synopsis: if fkctr[P1]==0 goto P2          */
-#define OP_MemMax        137 /* synopsis: r[P1]=max(r[P1],r[P2])           */
-#define OP_IfPos         138 /* synopsis: if r[P1]>0 then r[P1]-=P3, goto P2 */
-#define OP_OffsetLimit   139 /* synopsis: if r[P1]>0 then r[P2]=r[P1]+max(0,r[P3]) else r[P2]=(-1) */
-#define OP_IfNotZero     140 /* synopsis: if r[P1]!=0 then r[P1]-=P3, goto P2 */
-#define OP_DecrJumpZero  141 /* synopsis: if (--r[P1])==0 goto P2          */
-#define OP_JumpZeroIncr  142 /* synopsis: if (r[P1]++)==0 ) goto P2        */
-#define OP_AggStep0      143 /* synopsis: accum=r[P3] step(r[P2@P5])       */
-#define OP_AggStep       144 /* synopsis: accum=r[P3] step(r[P2@P5])       */
-#define OP_AggFinal      145 /* synopsis: accum=r[P1] N=P2                 */
-#define OP_IncrVacuum    146
-#define OP_Expire        147
-#define OP_TableLock     148 /* synopsis: iDb=P1 root=P2 write=P3          */
-#define OP_VBegin        149
-#define OP_VCreate       150
-#define OP_VDestroy      151
-#define OP_VOpen         152
-#define OP_VColumn       153 /* synopsis: r[P3]=vcolumn(P2)                */
-#define OP_VNext         154
-#define OP_VRename       155
-#define OP_Pagecount     156
-#define OP_MaxPgcnt      157
-#define OP_Init          158 /* synopsis: Start at P2                      */
-#define OP_CursorHint    159
-#define OP_Noop          160
-#define OP_Explain       161
+#define OP_RowSetAdd     134 /* synopsis: rowset(P1)=r[P2]                 */
+#define OP_RowSetRead    135 /* synopsis: r[P3]=rowset(P1)                 */
+#define OP_RowSetTest    136 /* synopsis: if r[P3] in rowset(P1) goto P2   */
+#define OP_Program       137
+#define OP_Param         138
+#define OP_FkCounter     139 /* synopsis: fkctr[P1]+=P2                    */
+#define OP_FkIfZero      140 /* synopsis: if fkctr[P1]==0 goto P2          */
+#define OP_MemMax        141 /* synopsis: r[P1]=max(r[P1],r[P2])           */
+#define OP_IfPos         142 /* synopsis: if r[P1]>0 then r[P1]-=P3, goto P2 */
+#define OP_OffsetLimit   143 /* synopsis: if r[P1]>0 then r[P2]=r[P1]+max(0,r[P3]) else r[P2]=(-1) */
+#define OP_IfNotZero     144 /* synopsis: if r[P1]!=0 then r[P1]-=P3, goto P2 */
+#define OP_DecrJumpZero  145 /* synopsis: if (--r[P1])==0 goto P2          */
+#define OP_JumpZeroIncr  146 /* synopsis: if (r[P1]++)==0 ) goto P2        */
+#define OP_AggStep0      147 /* synopsis: accum=r[P3] step(r[P2@P5])       */
+#define OP_AggStep       148 /* synopsis: accum=r[P3] step(r[P2@P5])       */
+#define OP_AggFinal      149 /* synopsis: accum=r[P1] N=P2                 */
+#define OP_IncrVacuum    150
+#define OP_Expire        151
+#define OP_TableLock     152 /* synopsis: iDb=P1 root=P2 write=P3          */
+#define OP_VBegin        153
+#define OP_VCreate       154
+#define OP_VDestroy      155
+#define OP_VOpen         156
+#define OP_VColumn       157 /* synopsis: r[P3]=vcolumn(P2)                */
+#define OP_VNext         158
+#define OP_VRename       159
+#define OP_Pagecount     160
+#define OP_MaxPgcnt      161
+#define OP_Init          162 /* synopsis: Start at P2                      */
+#define OP_CursorHint    163
+#define OP_Noop          164
+#define OP_Explain       165
 
 /* Properties such as "out2" or "jump" that are specified in
 ** comments following the "case" for each opcode in the vdbe.c
@@ -180,18 +184,170 @@
 /*  24 */ 0x10, 0x10, 0x00, 0x10, 0x10, 0x00, 0x00, 0x10,\
 /*  32 */ 0x10, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x02,\
 /*  40 */ 0x02, 0x00, 0x00, 0x01, 0x01, 0x03, 0x03, 0x00,\
-/*  48 */ 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00,\
-/*  56 */ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09,\
-/*  64 */ 0x09, 0x09, 0x09, 0x09, 0x09, 0x09, 0x09, 0x26,\
-/*  72 */ 0x26, 0x10, 0x10, 0x00, 0x03, 0x03, 0x0b, 0x0b,\
-/*  80 */ 0x0b, 0x0b, 0x0b, 0x0b, 0x00, 0x26, 0x26, 0x26,\
-/*  88 */ 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x00,\
-/*  96 */ 0x12, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10,\
-/* 104 */ 0x00, 0x01, 0x01, 0x01, 0x01, 0x04, 0x04, 0x00,\
-/* 112 */ 0x00, 0x10, 0x01, 0x01, 0x01, 0x01, 0x10, 0x00,\
-/* 120 */ 0x00, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00,\
-/* 128 */ 0x00, 0x06, 0x23, 0x0b, 0x01, 0x10, 0x10, 0x00,\
-/* 136 */ 0x01, 0x04, 0x03, 0x1a, 0x03, 0x03, 0x03, 0x00,\
-/* 144 */ 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,\
-/* 152 */ 0x00, 0x00, 0x01, 0x00, 0x10, 0x10, 0x01, 0x00,\
-/* 160 */ 0x00, 0x00,}
+/*  48 */ 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x01, 0x10,\
+/*  56 */ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,\
+/*  64 */ 0x00, 0x00, 0x00, 0x09, 0x09, 0x09, 0x09, 0x26,\
+/*  72 */ 0x26, 0x09, 0x09, 0x09, 0x03, 0x03, 0x0b, 0x0b,\
+/*  80 */ 0x0b, 0x0b, 0x0b, 0x0b, 0x09, 0x26, 0x26, 0x26,\
+/*  88 */ 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x10,\
+/*  96 */ 0x12, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00,\
+/* 104 */ 0x00, 0x00, 0x00, 0x10, 0x00, 0x01, 0x01, 0x01,\
+/* 112 */ 0x01, 0x04, 0x04, 0x00, 0x00, 0x10, 0x01, 0x01,\
+/* 120 */ 0x01, 0x01, 0x10, 0x00, 0x00, 0x10, 0x10, 0x00,\
+/* 128 */ 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x06, 0x23,\
+/* 136 */ 0x0b, 0x01, 0x10, 0x00, 0x01, 0x04, 0x03, 0x1a,\
+/* 144 */ 0x03, 0x03, 0x03, 0x00, 0x00, 0x00, 0x01, 0x00,\
+/* 152 */ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00,\
+/* 160 */ 0x10, 0x10, 0x01, 0x00, 0x00, 0x00,}
+
+/* Opcodes that are omitted from the build dispatch to the OP_Noop
+** label.  See the VDBE_LABEL() macro in vdbe.c.
+*/
+#if defined(SQLITE_OMIT_WAL)
+# define L_OP_Checkpoint L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_PRAGMA)
+# define L_OP_JournalMode L_OP_Noop
+#endif
+#if !(!defined(SQLITE_OMIT_VACUUM) && !defined(SQLITE_OMIT_ATTACH))
+# define L_OP_Vacuum L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_VIRTUALTABLE)
+# define L_OP_VFilter L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_VIRTUALTABLE)
+# define L_OP_VUpdate L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_FLOATING_POINT)
+# define L_OP_RealAffinity L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_CAST)
+# define L_OP_Cast L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_BTREECOUNT)
+# define L_OP_Count L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_AGGSCAN)
+# define L_OP_AggScan L_OP_Noop
+#endif
+#if !defined(SQLITE_ENABLE_COLUMN_USED_MASK)
+# define L_OP_ColumnsUsed L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_ANALYZE)
+# define L_OP_LoadAnalysis L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_INTEGRITY_CHECK)
+# define L_OP_IntegrityCk L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_FLOATING_POINT)
+# define L_OP_Real L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_TRIGGER)
+# define L_OP_Program L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_TRIGGER)
+# define L_OP_Param L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_FOREIGN_KEY)
+# define L_OP_FkCounter L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_FOREIGN_KEY)
+# define L_OP_FkIfZero L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_AUTOINCREMENT)
+# define L_OP_MemMax L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_AUTOVACUUM)
+# define L_OP_IncrVacuum L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_SHARED_CACHE)
+# define L_OP_TableLock L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_VIRTUALTABLE)
+# define L_OP_VBegin L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_VIRTUALTABLE)
+# define L_OP_VCreate L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_VIRTUALTABLE)
+# define L_OP_VDestroy L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_VIRTUALTABLE)
+# define L_OP_VOpen L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_VIRTUALTABLE)
+# define L_OP_VColumn L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_VIRTUALTABLE)
+# define L_OP_VNext L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_VIRTUALTABLE)
+# define L_OP_VRename L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_PAGER_PRAGMAS)
+# define L_OP_Pagecount L_OP_Noop
+#endif
+#if defined(SQLITE_OMIT_PAGER_PRAGMAS)
+# define L_OP_MaxPgcnt L_OP_Noop
+#endif
+#if !defined(SQLITE_ENABLE_CURSOR_HINTS)
+# define L_OP_CursorHint L_OP_Noop
+#endif
+#define OPLABEL_INITIALIZER {\
+/*   0 */ &&L_OP_Savepoint,     &&L_OP_AutoCommit,    &&L_OP_Transaction,  \
+/*   3 */ &&L_OP_SorterNext,    &&L_OP_PrevIfOpen,    &&L_OP_NextIfOpen,   \
+/*   6 */ &&L_OP_Prev,          &&L_OP_Next,          &&L_OP_Checkpoint,   \
+/*   9 */ &&L_OP_JournalMode,   &&L_OP_Vacuum,        &&L_OP_VFilter,      \
+/*  12 */ &&L_OP_VUpdate,       &&L_OP_Goto,          &&L_OP_Gosub,        \
+/*  15 */ &&L_OP_Return,        &&L_OP_InitCoroutine, &&L_OP_EndCoroutine, \
+/*  18 */ &&L_OP_Yield,         &&L_OP_Not,           &&L_OP_HaltIfNull,   \
+/*  21 */ &&L_OP_Halt,          &&L_OP_Integer,       &&L_OP_Int64,        \
+/*  24 */ &&L_OP_String,        &&L_OP_Null,          &&L_OP_SoftNull,     \
+/*  27 */ &&L_OP_Blob,          &&L_OP_Variable,      &&L_OP_Move,         \
+/*  30 */ &&L_OP_Copy,          &&L_OP_SCopy,         &&L_OP_IntCopy,      \
+/*  33 */ &&L_OP_ResultRow,     &&L_OP_CollSeq,       &&L_OP_Function0,    \
+/*  36 */ &&L_OP_Function,      &&L_OP_AddImm,        &&L_OP_MustBeInt,    \
+/*  39 */ &&L_OP_RealAffinity,  &&L_OP_Cast,          &&L_OP_Permutation,  \
+/*  42 */ &&L_OP_Compare,       &&L_OP_Jump,          &&L_OP_Once,         \
+/*  45 */ &&L_OP_If,            &&L_OP_IfNot,         &&L_OP_Columns,      \
+/*  48 */ &&L_OP_ColumnCmp,     &&L_OP_ColumnRow,     &&L_OP_Column,       \
+/*  51 */ &&L_OP_Affinity,      &&L_OP_MakeRecord,    &&L_OP_Count,        \
+/*  54 */ &&L_OP_AggScan,       &&L_OP_ReadCookie,    &&L_OP_SetCookie,    \
+/*  57 */ &&L_OP_ReopenIdx,     &&L_OP_OpenRead,      &&L_OP_OpenWrite,    \
+/*  60 */ &&L_OP_OpenAutoindex, &&L_OP_OpenEphemeral, &&L_OP_SorterOpen,   \
+/*  63 */ &&L_OP_SequenceTest,  &&L_OP_OpenPseudo,    &&L_OP_Close,        \
+/*  66 */ &&L_OP_ColumnsUsed,   &&L_OP_SeekLT,        &&L_OP_SeekLE,       \
+/*  69 */ &&L_OP_SeekGE,        &&L_OP_SeekGT,        &&L_OP_Or,           \
+/*  72 */ &&L_OP_And,           &&L_OP_NoConflict,    &&L_OP_NotFound,     \
+/*  75 */ &&L_OP_Found,         &&L_OP_IsNull,        &&L_OP_NotNull,      \
+/*  78 */ &&L_OP_Ne,            &&L_OP_Eq,            &&L_OP_Gt,           \
+/*  81 */ &&L_OP_Le,            &&L_OP_Lt,            &&L_OP_Ge,           \
+/*  84 */ &&L_OP_NotExists,     &&L_OP_BitAnd,        &&L_OP_BitOr,        \
+/*  87 */ &&L_OP_ShiftLeft,     &&L_OP_ShiftRight,    &&L_OP_Add,          \
+/*  90 */ &&L_OP_Subtract,      &&L_OP_Multiply,      &&L_OP_Divide,       \
+/*  93 */ &&L_OP_Remainder,     &&L_OP_Concat,        &&L_OP_Sequence,     \
+/*  96 */ &&L_OP_BitNot,        &&L_OP_String8,       &&L_OP_NewRowid,     \
+/*  99 */ &&L_OP_Insert,        &&L_OP_InsertInt,     &&L_OP_Delete,       \
+/* 102 */ &&L_OP_ResetCount,    &&L_OP_SorterCompare, &&L_OP_SorterData,   \
+/* 105 */ &&L_OP_RowKey,        &&L_OP_RowData,       &&L_OP_Rowid,        \
+/* 108 */ &&L_OP_NullRow,       &&L_OP_Last,          &&L_OP_SorterSort,   \
+/* 111 */ &&L_OP_Sort,          &&L_OP_Rewind,        &&L_OP_SorterInsert, \
+/* 114 */ &&L_OP_IdxInsert,     &&L_OP_IdxDelete,     &&L_OP_Seek,         \
+/* 117 */ &&L_OP_IdxRowid,      &&L_OP_IdxLE,         &&L_OP_IdxGT,        \
+/* 120 */ &&L_OP_IdxLT,         &&L_OP_IdxGE,         &&L_OP_Destroy,      \
+/* 123 */ &&L_OP_Clear,         &&L_OP_ResetSorter,   &&L_OP_CreateIndex,  \
+/* 126 */ &&L_OP_CreateTable,   &&L_OP_ParseSchema,   &&L_OP_LoadAnalysis, \
+/* 129 */ &&L_OP_DropTable,     &&L_OP_DropIndex,     &&L_OP_DropTrigger,  \
+/* 132 */ &&L_OP_IntegrityCk,   &&L_OP_Real,          &&L_OP_RowSetAdd,    \
+/* 135 */ &&L_OP_RowSetRead,    &&L_OP_RowSetTest,    &&L_OP_Program,      \
+/* 138 */ &&L_OP_Param,         &&L_OP_FkCounter,     &&L_OP_FkIfZero,     \
+/* 141 */ &&L_OP_MemMax,        &&L_OP_IfPos,         &&L_OP_OffsetLimit,  \
+/* 144 */ &&L_OP_IfNotZero,     &&L_OP_DecrJumpZero,  &&L_OP_JumpZeroIncr, \
+/* 147 */ &&L_OP_AggStep0,      &&L_OP_AggStep,       &&L_OP_AggFinal,     \
+/* 150 */ &&L_OP_IncrVacuum,    &&L_OP_Expire,        &&L_OP_TableLock,    \
+/* 153 */ &&L_OP_VBegin,        &&L_OP_VCreate,       &&L_OP_VDestroy,     \
+/* 156 */ &&L_OP_VOpen,         &&L_OP_VColumn,       &&L_OP_VNext,        \
+/* 159 */ &&L_OP_VRename,       &&L_OP_Pagecount,     &&L_OP_MaxPgcnt,     \
+/* 162 */ &&L_OP_Init,          &&L_OP_CursorHint,    &&L_OP_Noop,         \
+/* 165 */ &&L_OP_Noop,         \
+}
@@ -1385,6 +1385,63 @@ static int display_stats(
     sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_WRITE, &iCur, &iHiwtr, 1);
     raw_printf(pArg->out, "Page cache writes:                   %d\n", iCur); 
     iHiwtr = iCur = -1;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_READAHEAD_HIT, &iCur, &iHiwtr, 1);
+    raw_printf(pArg->out, "Read-ahead hits:                     %d\n", iCur); 
+    iHiwtr = iCur = -1;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_READAHEAD_MISS, &iCur, &iHiwtr, 1);
+    raw_printf(pArg->out, "Read-ahead misses:                   %d\n", iCur); 
+    iHiwtr = iCur = -1;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_CKPT_FRAMES, &iCur, &iHiwtr, bReset);
+    raw_printf(pArg->out, "Checkpointed frames:                 %d (max %d)\n",
+            iCur, iHiwtr);
+    iHiwtr = iCur = -1;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_CKPT_WRITES, &iCur, &iHiwtr, bReset);
+    raw_printf(pArg->out, "Checkpoint writes:                   %d (max %d)\n",
+            iCur, iHiwtr);
+    iHiwtr = iCur = -1;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_CKPT_TIME, &iCur, &iHiwtr, bReset);
+    raw_printf(pArg->out, "Checkpoint time (ms):                %d (max %d)\n",
+            iCur, iHiwtr);
+    iHiwtr = iCur = -1;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_WAL_SIZE, &iCur, &iHiwtr, bReset);
+    raw_printf(pArg->out, "WAL size (frames):                   %d (max %d)\n",
+            iCur, iHiwtr);
+    iHiwtr = iCur = -1;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_WAL_READ_RETRY, &iCur, &iHiwtr,
+                      bReset);
+    raw_printf(pArg->out, "WAL read retries:                    %d (max %d)\n",
+            iCur, iHiwtr);
+    iHiwtr = iCur = -1;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_WAL_READMARK_BUSY, &iCur, &iHiwtr,
+                      bReset);
+    raw_printf(pArg->out, "WAL reader slots busy:               %d\n", iCur);
+    iHiwtr = iCur = -1;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_MMAP_USED, &iCur, &iHiwtr, bReset);
+    raw_printf(pArg->out, "Memory mapped:                       %d bytes"
+            " (max %d)\n", iCur, iHiwtr);
+    iHiwtr = iCur = -1;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_MMAP_REMAP, &iCur, &iHiwtr, bReset);
+    raw_printf(pArg->out, "Memory map remaps:                   %d\n", iCur);
+    iHiwtr = iCur = -1;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_MMAP_MISS, &iCur, &iHiwtr, bReset);
+    raw_printf(pArg->out, "Memory map misses:                   %d\n", iCur);
+    iHiwtr = iCur = -1;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_SYNC, &iCur, &iHiwtr, bReset);
+    raw_printf(pArg->out, "Syncs:                               %d"
+            " (max %d per commit)\n", iCur, iHiwtr);
+    iHiwtr = iCur = -1;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_DEFRAG, &iCur, &iHiwtr, bReset);
+    raw_printf(pArg->out, "Page defragmentations:               %d\n", iCur);
+    iHiwtr = iCur = -1;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_DEFRAG_BYTES, &iCur, &iHiwtr, bReset);
+    raw_printf(pArg->out, "Bytes moved by defragmentation:      %d\n", iCur);
+    iHiwtr = iCur = -1;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_SEEK_ROOT, &iCur, &iHiwtr, bReset);
+    raw_printf(pArg->out, "Seeks from the root page:            %d\n", iCur);
+    iHiwtr = iCur = -1;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_SEEK_NEARBY, &iCur, &iHiwtr, bReset);
+    raw_printf(pArg->out, "Seeks from the current leaf:         %d\n", iCur);
+    iHiwtr = iCur = -1;
     sqlite3_db_status(db, SQLITE_DBSTATUS_SCHEMA_USED, &iCur, &iHiwtr, bReset);
     raw_printf(pArg->out, "Schema Heap Usage:                   %d bytes\n",
             iCur); 
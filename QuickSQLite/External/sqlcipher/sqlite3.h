@@ -723,6 +723,14 @@ struct sqlite3_file {
 ** information is written to disk in the same order as calls
 ** to xWrite().
 **
+** The xWriteV() method is available in version 4 and later.  It writes
+** nBuf buffers to adjacent regions of the file starting at offset iOfst,
+** with the same effect as calling xWrite() once for each buffer in turn.
+** Buffer apBuf[i] holds anBuf[i] bytes.  SQLite uses it to write a run of
+** contiguous database pages or WAL frames using a single gather-write
+** system call.  A VFS may set xWriteV to NULL, in which case SQLite
+** invokes xWrite() separately for each buffer.
+**
 ** If xRead() returns SQLITE_IOERR_SHORT_READ it must also fill
 ** in the unread portions of the buffer with zeros.  A VFS that
 ** fails to zero-fill short reads might seem to work.  However,
@@ -753,6 +761,9 @@ struct sqlite3_io_methods {
   int (*xFetch)(sqlite3_file*, sqlite3_int64 iOfst, int iAmt, void **pp);
   int (*xUnfetch)(sqlite3_file*, sqlite3_int64 iOfst, void *p);
   /* Methods above are valid for version 3 */
+  int (*xWriteV)(sqlite3_file*, int nBuf, const void **apBuf,
+                 const int *anBuf, sqlite3_int64 iOfst);
+  /* Methods above are valid for version 4 */
   /* Additional methods may be added in future releases */
 };
 
@@ -764,6 +775,9 @@ struct sqlite3_io_methods {
 ** of the [sqlite3_io_methods] object and for the [sqlite3_file_control()]
 ** interface.
 **
+** Opcodes specific to this library are numbered from 1000 up so that they
+** never collide with opcodes added to SQLite itself.
+**
 ** <ul>
 ** <li>[[SQLITE_FCNTL_LOCKSTATE]]
 ** The [SQLITE_FCNTL_LOCKSTATE] opcode is used for debugging.  This
@@ -987,6 +1001,55 @@ struct sqlite3_io_methods {
 ** The [SQLITE_FCNTL_RBU] opcode is implemented by the special VFS used by
 ** the RBU extension only.  All other VFS should return SQLITE_NOTFOUND for
 ** this opcode.  
+**
+** <li>[[SQLITE_FCNTL_WRITE_BATCH]]
+** The [SQLITE_FCNTL_WRITE_BATCH] opcode is generated internally by SQLite
+** around groups of writes to a database or [write-ahead log] file that
+** need not reach the file until the group is complete, such as the pages
+** of a commit or of a checkpoint.  The argument is a pointer to an integer
+** that is 1 at the start of a group and 0 at its end.  A VFS may hold the
+** writes issued between the two and submit them together, either when
+** the group ends or together with the next xSync call on the same file.
+** Held writes must be written, and any error reported, before the call
+** that ends the group returns, and before any other method that reads,
+** truncates, measures or locks the file.  VFS implementations that do not
+** batch writes should return [SQLITE_NOTFOUND] for this opcode.
+**
+** <li>[[SQLITE_FCNTL_MMAP_STATS]]
+** The [SQLITE_FCNTL_MMAP_STATS] opcode is used to obtain statistics on
+** the memory mapping of a database file, for the
+** [SQLITE_DBSTATUS_MMAP_USED] and related [sqlite3_db_status()] verbs.
+** The argument is a pointer to an array of five sqlite3_int64 values.
+** The VFS sets the first four to the number of bytes currently mapped,
+** the largest number of bytes mapped at once, the number of mappings
+** created and the number of [xFetch] requests that could not be
+** satisfied from the mapping. The fifth value is a bitmask supplied by
+** the caller: bits 0x01, 0x02 and 0x04 reset the second, third and
+** fourth statistics respectively after they have been read.
+**
+** <li>[[SQLITE_FCNTL_IO_ALIGN]]
+** The [SQLITE_FCNTL_IO_ALIGN] opcode is used by the pager to learn whether
+** page buffers should be aligned in memory. The argument is a pointer to
+** an integer. If the file was opened for direct I/O (for example, using
+** the "directio" URI parameter with the built-in unix VFS), the VFS
+** sets the integer to the alignment, in bytes, that buffers passed to
+** xRead and xWrite should have for transfers to bypass the operating
+** system cache without being staged. Otherwise it sets it to zero.
+**
+** <li>[[SQLITE_FCNTL_DURABILITY]]
+** The [SQLITE_FCNTL_DURABILITY] opcode is used by the pager to tell the
+** VFS how much work an [xSync] call on the file must do. The argument
+** is a pointer to an integer. A value of 0 (strict) requires a full
+** flush to stable storage. A value of 1 (batched) allows the VFS to skip
+** directory syncs for files that already existed when opened and to
+** start write-back of dirty data before the sync is requested. A value
+** of 2 (relaxed) allows [xSync] to only wait for the dirty data of the
+** file to be handed to the device, without syncing file metadata or the
+** directory or flushing the device cache. Such a sync guarantees
+** neither durability nor the order in which writes reach storage. If
+** the integer is negative, the VFS overwrites it with the current value.
+** VFS implementations that do not recognize this opcode treat every
+** sync as strict.
 ** </ul>
 */
 #define SQLITE_FCNTL_LOCKSTATE               1
@@ -1016,6 +1079,10 @@ struct sqlite3_io_methods {
 #define SQLITE_FCNTL_RBU                    26
 #define SQLITE_FCNTL_VFS_POINTER            27
 #define SQLITE_FCNTL_JOURNAL_POINTER        28
+#define SQLITE_FCNTL_WRITE_BATCH          1001
+#define SQLITE_FCNTL_MMAP_STATS           1002
+#define SQLITE_FCNTL_IO_ALIGN             1003
+#define SQLITE_FCNTL_DURABILITY           1004
 
 /* deprecated names */
 #define SQLITE_GET_LOCKPROXYFILE      SQLITE_FCNTL_GET_LOCKPROXYFILE
@@ -1291,8 +1358,20 @@ struct sqlite3_vfs {
 ** between 0 and this upper bound as its "offset" argument.
 ** The SQLite core will never attempt to acquire or release a
 ** lock outside of this range
-*/
-#define SQLITE_SHM_NLOCK        8
+**
+** The [WAL] uses all but three of these locks as reader slots, one for
+** each distinct snapshot that concurrent readers may hold. Read-heavy
+** applications may compile with a larger value, between 8 and 31, to
+** avoid busy retries when many readers start transactions at once.
+** The built-in VFSes support this. They keep the first eight locks at
+** their usual offsets, so processes built with different values still
+** exclude each other, but only those built with the same value can share
+** the wal-index. The others fail to open the database with
+** [SQLITE_CANTOPEN] while it is in use.
+*/
+#ifndef SQLITE_SHM_NLOCK
+# define SQLITE_SHM_NLOCK       8
+#endif
 
 
 /*
@@ -1516,6 +1595,9 @@ struct sqlite3_mem_methods {
 ** non-zero [error code] if a discontinued or unsupported configuration option
 ** is invoked.
 **
+** Options specific to this library are numbered from 1000 up so that they
+** never collide with options added to SQLite itself.
+**
 ** <dl>
 ** [[SQLITE_CONFIG_SINGLETHREAD]] <dt>SQLITE_CONFIG_SINGLETHREAD</dt>
 ** <dd>There are no arguments to this option.  ^This option sets the
@@ -1820,6 +1902,19 @@ struct sqlite3_mem_methods {
 ** is enabled (using the [PRAGMA threads] command) and the amount of content
 ** to be sorted exceeds the page size times the minimum of the
 ** [PRAGMA cache_size] setting and this value.
+**
+** [[SQLITE_CONFIG_PCACHE_POLICY]]
+** <dt>SQLITE_CONFIG_PCACHE_POLICY
+** <dd>^The SQLITE_CONFIG_PCACHE_POLICY option takes a single integer
+** parameter that selects the page replacement policy used by the default
+** page cache implementation.  ^The value must be one of
+** [SQLITE_PCACHE_POLICY_LRU] (the default) or [SQLITE_PCACHE_POLICY_2Q].
+** ^The 2Q policy admits newly loaded pages into a small probationary
+** queue and only promotes them to the main LRU list once they are
+** referenced again, so that a single large table scan or VACUUM does not
+** flush the frequently used pages out of the cache.  This option has no
+** effect if an application-defined page cache is installed using
+** [SQLITE_CONFIG_PCACHE2].
 ** </dl>
 */
 #define SQLITE_CONFIG_SINGLETHREAD  1  /* nil */
@@ -1847,6 +1942,16 @@ struct sqlite3_mem_methods {
 #define SQLITE_CONFIG_WIN32_HEAPSIZE      23  /* int nByte */
 #define SQLITE_CONFIG_PCACHE_HDRSZ        24  /* int *psz */
 #define SQLITE_CONFIG_PMASZ               25  /* unsigned int szPma */
+#define SQLITE_CONFIG_PCACHE_POLICY     1001  /* int ePolicy */
+
+/*
+** CAPI3REF: Page Cache Replacement Policies
+**
+** These constants are the valid arguments to the
+** [SQLITE_CONFIG_PCACHE_POLICY] option of [sqlite3_config()].
+*/
+#define SQLITE_PCACHE_POLICY_LRU          0
+#define SQLITE_PCACHE_POLICY_2Q           1
 
 /*
 ** CAPI3REF: Database Connection Configuration Options
@@ -6666,6 +6771,10 @@ SQLITE_API int SQLITE_STDCALL sqlite3_db_status(sqlite3*, int op, int *pCur, int
 ** The [sqlite3_db_status()] interface will return a non-zero error code
 ** if a discontinued or unsupported verb is invoked.
 **
+** Verbs specific to this library are numbered from 1000 up so that they
+** never collide with verbs added to SQLite itself.  [SQLITE_DBSTATUS_MAX]
+** is the largest verb below that range.
+**
 ** <dl>
 ** [[SQLITE_DBSTATUS_LOOKASIDE_USED]] ^(<dt>SQLITE_DBSTATUS_LOOKASIDE_USED</dt>
 ** <dd>This parameter returns the number of lookaside memory slots currently
@@ -6741,6 +6850,122 @@ SQLITE_API int SQLITE_STDCALL sqlite3_db_status(sqlite3*, int op, int *pCur, int
 ** all foreign key constraints (deferred or immediate) have been
 ** resolved.)^  ^The highwater mark is always 0.
 ** </dd>
+**
+** [[SQLITE_DBSTATUS_READAHEAD_HIT]] ^(<dt>SQLITE_DBSTATUS_READAHEAD_HIT</dt>
+** <dd>This parameter returns the number of database pages that were
+** loaded from the read-ahead buffer filled by an earlier read (see
+** [PRAGMA readahead]).)^ ^The highwater mark associated with
+** SQLITE_DBSTATUS_READAHEAD_HIT is always 0.
+** </dd>
+**
+** [[SQLITE_DBSTATUS_READAHEAD_MISS]] ^(<dt>SQLITE_DBSTATUS_READAHEAD_MISS</dt>
+** <dd>This parameter returns the number of database pages that were read
+** ahead but discarded before they were used.)^ ^The highwater mark
+** associated with SQLITE_DBSTATUS_READAHEAD_MISS is always 0.
+** </dd>
+**
+** [[SQLITE_DBSTATUS_CKPT_FRAMES]] ^(<dt>SQLITE_DBSTATUS_CKPT_FRAMES</dt>
+** <dd>This parameter returns the number of WAL frames copied into the
+** database file by [checkpoints] run using the database connection.)^
+** ^The highwater mark is the largest number of frames copied by a single
+** checkpoint.
+** </dd>
+**
+** [[SQLITE_DBSTATUS_CKPT_WRITES]] ^(<dt>SQLITE_DBSTATUS_CKPT_WRITES</dt>
+** <dd>This parameter returns the number of write calls made on the
+** database file by checkpoints run using the database connection.)^
+** ^Adjacent database pages are written by a single call, so this value is
+** usually smaller than that returned for SQLITE_DBSTATUS_CKPT_FRAMES.
+** ^The highwater mark is the largest number of calls made by a single
+** checkpoint.
+** </dd>
+**
+** [[SQLITE_DBSTATUS_CKPT_TIME]] ^(<dt>SQLITE_DBSTATUS_CKPT_TIME</dt>
+** <dd>This parameter returns the total number of milliseconds spent by
+** checkpoints run using the database connection copying frames into the
+** database file, including the time taken to sync the WAL and database
+** files.)^ ^The highwater mark is the duration of the slowest single
+** checkpoint.
+** </dd>
+**
+** [[SQLITE_DBSTATUS_WAL_SIZE]] ^(<dt>SQLITE_DBSTATUS_WAL_SIZE</dt>
+** <dd>This parameter returns the number of frames in the [write-ahead log]
+** files of all databases in WAL mode, as of the most recent transaction
+** or checkpoint on the database connection.)^ ^The highwater mark is the
+** largest number of frames seen in the WAL file of any single database.
+** </dd>
+**
+** [[SQLITE_DBSTATUS_WAL_READ_RETRY]] ^(<dt>SQLITE_DBSTATUS_WAL_READ_RETRY</dt>
+** <dd>This parameter returns the number of times the database connection
+** had to retry starting a read transaction on a database in WAL mode,
+** usually because another connection was changing the reader slot or
+** the wal-index header at the same time.)^ ^The highwater mark is the
+** largest number of retries needed to start a single read transaction.
+** </dd>
+**
+** [[SQLITE_DBSTATUS_WAL_READMARK_BUSY]]
+** ^(<dt>SQLITE_DBSTATUS_WAL_READMARK_BUSY</dt>
+** <dd>This parameter returns the number of times the database connection
+** found every WAL reader slot locked by other connections when it needed
+** one for a new snapshot. It then has to share a slot recording an older
+** snapshot, which holds back checkpoints, or retry.)^ A large value
+** suggests compiling with a larger [SQLITE_SHM_NLOCK].
+** ^The highwater mark is always zero.
+** </dd>
+**
+** [[SQLITE_DBSTATUS_MMAP_USED]] ^(<dt>SQLITE_DBSTATUS_MMAP_USED</dt>
+** <dd>This parameter returns the number of bytes of database files
+** currently memory mapped by the database connection (see
+** [mmap_size]).)^ ^The highwater mark is the largest number of bytes
+** mapped at once for any single database file. A database file larger
+** than the mmap_size limit is mapped through a window of that size,
+** which is moved to follow the pages being read.
+** </dd>
+**
+** [[SQLITE_DBSTATUS_MMAP_REMAP]] ^(<dt>SQLITE_DBSTATUS_MMAP_REMAP</dt>
+** <dd>This parameter returns the number of times the database connection
+** has created or moved a memory mapping of a database file.)^
+** ^The highwater mark is always zero.
+** </dd>
+**
+** [[SQLITE_DBSTATUS_MMAP_MISS]] ^(<dt>SQLITE_DBSTATUS_MMAP_MISS</dt>
+** <dd>This parameter returns the number of times a page the database
+** connection read while memory mapping was enabled lay outside of the
+** mapping, and so had to be read using a system call.)^
+** ^The highwater mark is always zero.
+** </dd>
+**
+** [[SQLITE_DBSTATUS_SYNC]] ^(<dt>SQLITE_DBSTATUS_SYNC</dt>
+** <dd>This parameter returns the number of times the database connection
+** has synced a database, journal or WAL file.)^ ^The highwater mark is
+** the largest number of syncs issued while committing a single write
+** transaction. See also [PRAGMA durability].
+** </dd>
+**
+** [[SQLITE_DBSTATUS_DEFRAG]] ^(<dt>SQLITE_DBSTATUS_DEFRAG</dt>
+** <dd>This parameter returns the number of times a b-tree page was
+** defragmented, gathering all of its free space into a single block.)^
+** ^The highwater mark is always zero.
+** </dd>
+**
+** [[SQLITE_DBSTATUS_DEFRAG_BYTES]] ^(<dt>SQLITE_DBSTATUS_DEFRAG_BYTES</dt>
+** <dd>This parameter returns the number of bytes of cell content moved
+** within pages by those defragmentations.)^ ^The highwater mark is always
+** zero.
+** </dd>
+**
+** [[SQLITE_DBSTATUS_SEEK_ROOT]] ^(<dt>SQLITE_DBSTATUS_SEEK_ROOT</dt>
+** <dd>This parameter returns the number of times a b-tree cursor was
+** positioned on a key by descending from the root page of its b-tree.)^
+** ^The highwater mark is always zero.
+** </dd>
+**
+** [[SQLITE_DBSTATUS_SEEK_NEARBY]] ^(<dt>SQLITE_DBSTATUS_SEEK_NEARBY</dt>
+** <dd>This parameter returns the number of times a table b-tree cursor was
+** positioned on a rowid without a descent from the root page, because the
+** rowid was on the leaf page the cursor already pointed to or on the leaf
+** page after it.)^ ^The highwater mark is always zero.
+** </dd>
 ** </dl>
 */
 #define SQLITE_DBSTATUS_LOOKASIDE_USED       0
@@ -6754,7 +6979,23 @@ SQLITE_API int SQLITE_STDCALL sqlite3_db_status(sqlite3*, int op, int *pCur, int
 #define SQLITE_DBSTATUS_CACHE_MISS           8
 #define SQLITE_DBSTATUS_CACHE_WRITE          9
 #define SQLITE_DBSTATUS_DEFERRED_FKS        10
-#define SQLITE_DBSTATUS_MAX                 10   /* Largest defined DBSTATUS */
+#define SQLITE_DBSTATUS_MAX                 10   /* Largest stock DBSTATUS */
+#define SQLITE_DBSTATUS_READAHEAD_HIT     1001
+#define SQLITE_DBSTATUS_READAHEAD_MISS    1002
+#define SQLITE_DBSTATUS_CKPT_FRAMES       1003
+#define SQLITE_DBSTATUS_CKPT_WRITES       1004
+#define SQLITE_DBSTATUS_CKPT_TIME         1005
+#define SQLITE_DBSTATUS_WAL_SIZE          1006
+#define SQLITE_DBSTATUS_WAL_READ_RETRY    1007
+#define SQLITE_DBSTATUS_WAL_READMARK_BUSY 1008
+#define SQLITE_DBSTATUS_MMAP_USED         1009
+#define SQLITE_DBSTATUS_MMAP_REMAP        1010
+#define SQLITE_DBSTATUS_MMAP_MISS         1011
+#define SQLITE_DBSTATUS_SYNC              1012
+#define SQLITE_DBSTATUS_DEFRAG            1013
+#define SQLITE_DBSTATUS_DEFRAG_BYTES      1014
+#define SQLITE_DBSTATUS_SEEK_ROOT         1015
+#define SQLITE_DBSTATUS_SEEK_NEARBY       1016
 
 
 /*
@@ -7528,6 +7769,45 @@ SQLITE_API void *SQLITE_STDCALL sqlite3_wal_hook(
 */
 SQLITE_API int SQLITE_STDCALL sqlite3_wal_autocheckpoint(sqlite3 *db, int N);
 
+/*
+** CAPI3REF: Run auto-checkpoints on a background thread
+** METHOD: sqlite3
+**
+** ^If N is greater than zero, the [sqlite3_wal_checkpoint_thread(D,N)]
+** interface causes the checkpoints configured by
+** [sqlite3_wal_autocheckpoint()] on [database connection] D to be run by
+** a background thread, instead of by whichever commit crosses the
+** auto-checkpoint threshold. ^If N is zero or negative, the background
+** checkpointer is stopped and automatic checkpoints are once again run
+** as part of the commit. ^The [wal_checkpoint_thread pragma] can be used
+** to invoke this interface from SQL.
+**
+** ^Each checkpoint is run by a separate thread using a private
+** connection to the database file, so it never holds the mutex of
+** connection D. ^The commit that triggers it returns without waiting. ^A
+** checkpoint is [sqlite3_wal_checkpoint_v2|PASSIVE]. ^If it is held
+** back by readers, it is not retried until the WAL has grown by another
+** auto-checkpoint threshold. ^If a commit leaves N or more frames in the
+** WAL, the background checkpoints are not keeping up with the writers.
+** ^In that case the committing connection waits for the running
+** background checkpoint, if any, and then runs a
+** [SQLITE_CHECKPOINT_TRUNCATE] checkpoint itself, as if by
+** [sqlite3_wal_checkpoint_v2()], to restart the WAL and reclaim its space.
+**
+** ^Databases opened in [locking_mode|EXCLUSIVE locking mode], and
+** in-memory and temporary databases, are always checkpointed as part of
+** the commit.
+**
+** ^Background checkpoints are included in the values reported by the
+** [SQLITE_DBSTATUS_CKPT_FRAMES], [SQLITE_DBSTATUS_CKPT_WRITES] and
+** [SQLITE_DBSTATUS_CKPT_TIME] counters of connection D.
+**
+** ^This interface returns SQLITE_ERROR if SQLite was built without
+** support for worker threads, or has been configured for
+** [SQLITE_CONFIG_SINGLETHREAD|single-thread] use.
+*/
+SQLITE_API int SQLITE_STDCALL sqlite3_wal_checkpoint_thread(sqlite3 *db, int N);
+
 /*
 ** CAPI3REF: Checkpoint a database
 ** METHOD: sqlite3
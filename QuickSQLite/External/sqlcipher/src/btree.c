@@ -49,6 +49,17 @@ int sqlite3BtreeTrace=1;  /* True to enable tracing */
 #define BTALLOC_ANY   0           /* Allocate any page */
 #define BTALLOC_EXACT 1           /* Allocate exact page if possible */
 #define BTALLOC_LE    2           /* Allocate any page <= the parameter */
+#define BTALLOC_APPEND 3          /* Allocate a new page at the end of file */
+
+/*
+** Overflow chains of at least this many pages are allocated at the end
+** of the database file, so that their pages are consecutive, and reads
+** that span at least this many overflow pages bypass the page cache.
+** See fillInCell() and readOverflowRun().
+*/
+#ifndef BTREE_OVFL_RUN
+# define BTREE_OVFL_RUN 4
+#endif
 
 /*
 ** Macro IfNotOmitAV(x) returns (x) if SQLITE_OMIT_AUTOVACUUM is not 
@@ -639,12 +650,16 @@ static int saveCursorKey(BtCursor *pCur){
   return rc;
 }
 
+/* Forward reference */
+static void btreeBulkEnd(BtCursor*);
+
 /*
 ** Save the current cursor position in the variables BtCursor.nKey 
 ** and BtCursor.pKey. The cursor's state is set to CURSOR_REQUIRESEEK.
 **
 ** The caller must ensure that the cursor is valid (has eState==CURSOR_VALID)
-** prior to calling this routine.  
+** prior to calling this routine.  Any bulk build in progress on the cursor
+** is finished.
 */
 static int saveCursorPosition(BtCursor *pCur){
   int rc;
@@ -664,11 +679,26 @@ static int saveCursorPosition(BtCursor *pCur){
     btreeReleaseAllCursorPages(pCur);
     pCur->eState = CURSOR_REQUIRESEEK;
   }
+  if( pCur->pBulk ) btreeBulkEnd(pCur);
 
   pCur->curFlags &= ~(BTCF_ValidNKey|BTCF_ValidOvfl|BTCF_AtLast);
   return rc;
 }
 
+/*
+** Finish the bulk build in progress on cursor pCur, first saving the
+** cursor position if the cursor points at an entry.
+*/
+static int btreeBulkSave(BtCursor *pCur){
+  assert( pCur->pBulk!=0 );
+  if( pCur->eState==CURSOR_VALID || pCur->eState==CURSOR_SKIPNEXT ){
+    return saveCursorPosition(pCur);
+  }
+  btreeReleaseAllCursorPages(pCur);
+  btreeBulkEnd(pCur);
+  return SQLITE_OK;
+}
+
 /* Forward reference */
 static int SQLITE_NOINLINE saveCursorsOnList(BtCursor*,Pgno,BtCursor*);
 
@@ -1020,6 +1050,174 @@ static int ptrmapGet(BtShared *pBt, Pgno key, u8 *pEType, Pgno *pPgno){
 #define findCellPastPtr(P,I) \
   ((P)->aDataOfst + ((P)->maskPage & get2byteAligned(&(P)->aCellIdx[2*(I)])))
 
+#if SQLITE_BTREE_KEYCACHE>0
+/*
+** Compiler intrinsics used by btreeKeyCountLess() to compare several
+** 64-bit keys at once.
+*/
+#if !defined(SQLITE_DISABLE_INTRINSIC)
+# if defined(__AVX2__)
+#  include <immintrin.h>
+# elif defined(__SSE4_2__)
+#  include <nmmintrin.h>
+# elif defined(__aarch64__) && defined(__ARM_NEON)
+#  include <arm_neon.h>
+# endif
+#endif
+
+/*
+** sqlite3BtreeMovetoUnpacked() binary searches a cached key array until
+** no more than this many keys remain, then counts the remaining keys
+** that are smaller than the search key using btreeKeyCountLess().
+*/
+#define BTREE_KEYSCAN 16
+
+/*
+** Decoding the keys of a page costs about as much as a few dozen binary
+** search probes, so the key array of a page is only built once the page
+** has been searched BTREE_KEYCACHE_BUILD times while holding its slot.
+** This keeps leaves visited by scattered point lookups out of the cache.
+**
+** BTREE_KEYCACHE_MAXHIT is the upper bound of BtKeyCache.nHit.  An entry
+** that has not been used recently loses its slot after at most this many
+** searches of other pages that map to the same slot.
+*/
+#define BTREE_KEYCACHE_BUILD  4
+#define BTREE_KEYCACHE_MAXHIT 8
+
+/*
+** Discard the key cache entry for page pgno, if there is one.  This
+** is called whenever the cells of a page are modified or reloaded.
+*/
+static void btreeKeyCacheDrop(BtShared *pBt, Pgno pgno){
+  BtKeyCache *p = &pBt->aKeyCache[pgno % SQLITE_BTREE_KEYCACHE];
+  if( p->pgno==pgno ){
+    p->pgno = 0;
+    p->bValid = 0;
+    p->nHit = 0;
+  }
+}
+
+/*
+** Free all memory held by the key cache of pBt.
+*/
+static void btreeKeyCacheFree(BtShared *pBt){
+  int i;
+  for(i=0; i<SQLITE_BTREE_KEYCACHE; i++){
+    sqlite3_free(pBt->aKeyCache[i].aKey);
+  }
+  memset(pBt->aKeyCache, 0, sizeof(pBt->aKeyCache));
+}
+
+/*
+** Return the cached array of integer keys for table b-tree page pPage,
+** building it first if the page has been searched often enough.
+** Return NULL if the page does not (yet) have an array, if memory cannot
+** be allocated, or if a cell is found to be corrupt.  In that case the
+** caller searches the page cells directly.
+*/
+static i64 *btreeKeyCacheFetch(MemPage *pPage){
+  BtKeyCache *p;
+  int i;
+  assert( pPage->intKey && pPage->nOverflow==0 );
+  assert( sqlite3_mutex_held(pPage->pBt->mutex) );
+  p = &pPage->pBt->aKeyCache[pPage->pgno % SQLITE_BTREE_KEYCACHE];
+  if( p->pgno!=pPage->pgno ){
+    if( p->nHit>0 ){
+      p->nHit--;
+    }else{
+      p->pgno = pPage->pgno;
+      p->bValid = 0;
+      p->nHit = 1;
+    }
+    return 0;
+  }
+  if( p->nHit<BTREE_KEYCACHE_MAXHIT ) p->nHit++;
+  if( p->bValid && p->nKey==pPage->nCell ) return p->aKey;
+
+  p->bValid = 0;
+  if( p->nHit<BTREE_KEYCACHE_BUILD ) return 0;
+  if( pPage->nCell>p->nAlloc ){
+    i64 *aNew = (i64*)sqlite3Realloc(p->aKey, sizeof(i64)*pPage->nCell);
+    if( aNew==0 ) return 0;
+    p->aKey = aNew;
+    p->nAlloc = pPage->nCell;
+  }
+  for(i=0; i<pPage->nCell; i++){
+    u8 *pCell = findCellPastPtr(pPage, i);
+    if( pPage->intKeyLeaf ){
+      while( 0x80 <= *(pCell++) ){
+        if( pCell>=pPage->aDataEnd ) return 0;
+      }
+    }
+    getVarint(pCell, (u64*)&p->aKey[i]);
+  }
+  p->nKey = pPage->nCell;
+  p->bValid = 1;
+  return p->aKey;
+}
+
+/*
+** Return the number of entries in aKey[0..nKey-1] that are less than
+** iKey, comparing several keys per instruction where the target
+** supports it.
+*/
+static int btreeKeyCountLess(const i64 *aKey, int nKey, i64 iKey){
+  int i = 0;
+  int n = 0;
+#if !defined(SQLITE_DISABLE_INTRINSIC) && defined(__AVX2__)
+  __m256i k = _mm256_set1_epi64x(iKey);
+  for(; i+4<=nKey; i+=4){
+    __m256i v = _mm256_loadu_si256((const __m256i*)&aKey[i]);
+    int m = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(k, v)));
+    n += (int)((0x4332322132212110ULL >> (m*4)) & 0xf);
+  }
+#elif !defined(SQLITE_DISABLE_INTRINSIC) && defined(__SSE4_2__)
+  __m128i k = _mm_set1_epi64x(iKey);
+  for(; i+2<=nKey; i+=2){
+    __m128i v = _mm_loadu_si128((const __m128i*)&aKey[i]);
+    int m = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(k, v)));
+    n += (m & 1) + (m >> 1);
+  }
+#elif !defined(SQLITE_DISABLE_INTRINSIC) \
+    && defined(__aarch64__) && defined(__ARM_NEON)
+  int64x2_t k = vdupq_n_s64(iKey);
+  int64x2_t acc = vdupq_n_s64(0);
+  for(; i+2<=nKey; i+=2){
+    uint64x2_t m = vcltq_s64(vld1q_s64(&aKey[i]), k);
+    acc = vsubq_s64(acc, vreinterpretq_s64_u64(m));
+  }
+  n = (int)vaddvq_s64(acc);
+#endif
+  for(; i<nKey; i++){
+    n += aKey[i]<iKey;
+  }
+  return n;
+}
+
+/*
+** Return the index of the first entry of the sorted array aKey[0..nKey-1]
+** that is greater than or equal to iKey, or nKey if there is no such
+** entry.
+*/
+static int btreeKeyLowerBound(const i64 *aKey, int nKey, i64 iKey){
+  int iLo = 0;
+  while( nKey>BTREE_KEYSCAN ){
+    int nHalf = nKey>>1;
+    if( aKey[iLo+nHalf]<iKey ){
+      iLo += nHalf+1;
+      nKey -= nHalf+1;
+    }else{
+      nKey = nHalf;
+    }
+  }
+  return iLo + btreeKeyCountLess(&aKey[iLo], nKey, iKey);
+}
+#else
+# define btreeKeyCacheDrop(pBt,pgno)
+# define btreeKeyCacheFree(pBt)
+#endif /* SQLITE_BTREE_KEYCACHE>0 */
+
 
 /*
 ** This is common tail processing for btreeParseCellPtr() and
@@ -1194,6 +1392,36 @@ static void btreeParseCellPtrIndex(
     btreeParseCellAdjustSizeForOverflow(pPage, pCell, pInfo);
   }
 }
+static void btreeParseCellPtrPrefix(
+  MemPage *pPage,         /* Page containing the cell */
+  u8 *pCell,              /* Pointer to the cell text. */
+  CellInfo *pInfo         /* Fill in this structure */
+){
+  u8 *pIter = pCell;      /* For scanning through pCell */
+  u32 nPayload;           /* Number of bytes of cell payload */
+  u32 nHdrShared;         /* Header bytes shared with the previous key */
+  u32 nHdr;               /* Size of the record header */
+  u32 nBodyShared;        /* Body bytes shared with the previous key */
+  u32 nSize;              /* Size of the cell */
+
+  assert( sqlite3_mutex_held(pPage->pBt->mutex) );
+  assert( pPage->prefixLeaf );
+  UNUSED_PARAMETER(pPage);
+  pIter += getVarint32(pIter, nPayload);
+  pIter += getVarint32(pIter, nHdrShared);
+  pIter += getVarint32(pIter, nHdr);
+  pIter += getVarint32(pIter, nBodyShared);
+  pInfo->nKey = nPayload;
+  pInfo->nPayload = nPayload;
+  pInfo->pPayload = pIter;
+  pInfo->nLocal = (u16)nPayload;
+  nSize = (u32)(pIter - pCell);
+  if( nHdrShared+nBodyShared<nPayload ){
+    nSize += nPayload - nHdrShared - nBodyShared;
+  }
+  if( nSize<4 ) nSize = 4;
+  pInfo->nSize = (u16)nSize;
+}
 static void btreeParseCell(
   MemPage *pPage,         /* Page containing the cell */
   int iCell,              /* The cell index.  First cell is 0 */
@@ -1212,7 +1440,8 @@ static void btreeParseCell(
 ** the space used by the cell pointer.
 **
 ** cellSizePtrNoPayload()    =>   table internal nodes
-** cellSizePtr()             =>   all index nodes & table leaf nodes
+** cellSizePtrPrefix()       =>   prefix-compressed index leaf nodes
+** cellSizePtr()             =>   all other index nodes & table leaf nodes
 */
 static u16 cellSizePtr(MemPage *pPage, u8 *pCell){
   u8 *pIter = pCell + pPage->childPtrSize; /* For looping over bytes of pCell */
@@ -1283,6 +1512,11 @@ static u16 cellSizePtrNoPayload(MemPage *pPage, u8 *pCell){
   assert( debuginfo.nSize==(u16)(pIter - pCell) || CORRUPT_DB );
   return (u16)(pIter - pCell);
 }
+static u16 cellSizePtrPrefix(MemPage *pPage, u8 *pCell){
+  CellInfo info;
+  btreeParseCellPtrPrefix(pPage, pCell, &info);
+  return info.nSize;
+}
 
 
 #ifdef SQLITE_DEBUG
@@ -1332,11 +1566,13 @@ static int defragmentPage(MemPage *pPage){
   int cellOffset;            /* Offset to the cell pointer array */
   int cbrk;                  /* Offset to the cell content area */
   int nCell;                 /* Number of cells on the page */
+  int nMove = 0;             /* Bytes of cell content moved */
   unsigned char *data;       /* The page data */
   unsigned char *temp;       /* Temp area for cell content */
   unsigned char *src;        /* Source of content */
   int iCellFirst;            /* First allowable cell index */
   int iCellLast;             /* Last possible cell index */
+  BtShared *pBt = pPage->pBt;
 
 
   assert( sqlite3PagerIswriteable(pPage->pDbPage) );
@@ -1344,13 +1580,14 @@ static int defragmentPage(MemPage *pPage){
   assert( pPage->pBt->usableSize <= SQLITE_MAX_PAGE_SIZE );
   assert( pPage->nOverflow==0 );
   assert( sqlite3_mutex_held(pPage->pBt->mutex) );
+  pBt->nDefrag++;
   temp = 0;
   src = data = pPage->aData;
   hdr = pPage->hdrOffset;
   cellOffset = pPage->cellOffset;
   nCell = pPage->nCell;
   assert( nCell==get2byte(&data[hdr+3]) );
-  usableSize = pPage->pBt->usableSize;
+  usableSize = pBt->usableSize;
   cbrk = usableSize;
   iCellFirst = cellOffset + 2*nCell;
   iCellLast = usableSize - 4;
@@ -1385,6 +1622,7 @@ static int defragmentPage(MemPage *pPage){
       src = temp;
     }
     memcpy(&data[cbrk], &src[pc], size);
+    nMove += size;
   }
   assert( cbrk>=iCellFirst );
   put2byte(&data[hdr+5], cbrk);
@@ -1392,6 +1630,7 @@ static int defragmentPage(MemPage *pPage){
   data[hdr+2] = 0;
   data[hdr+7] = 0;
   memset(&data[iCellFirst], 0, cbrk-iCellFirst);
+  pBt->nDefragByte += nMove;
   assert( sqlite3PagerIswriteable(pPage->pDbPage) );
   if( cbrk-iCellFirst!=pPage->nFree ){
     return SQLITE_CORRUPT_BKPT;
@@ -1670,8 +1909,9 @@ static int decodeFlags(MemPage *pPage, int flagByte){
 
   assert( pPage->hdrOffset==(pPage->pgno==1 ? 100 : 0) );
   assert( sqlite3_mutex_held(pPage->pBt->mutex) );
-  pPage->leaf = (u8)(flagByte>>3);  assert( PTF_LEAF == 1<<3 );
+  pPage->leaf = (u8)((flagByte>>3)&1);  assert( PTF_LEAF == 1<<3 );
   flagByte &= ~PTF_LEAF;
+  pPage->prefixLeaf = 0;
   pPage->childPtrSize = 4-4*pPage->leaf;
   pPage->xCellSize = cellSizePtr;
   pBt = pPage->pBt;
@@ -1705,6 +1945,19 @@ static int decodeFlags(MemPage *pPage, int flagByte){
     pPage->xParseCell = btreeParseCellPtrIndex;
     pPage->maxLocal = pBt->maxLocal;
     pPage->minLocal = pBt->minLocal;
+  }else if( flagByte==(PTF_PREFIX | PTF_ZERODATA) && pPage->leaf
+         && (pBt->btsFlags & BTS_PREFIX_KEYS)!=0
+  ){
+    /* A value of 26 means the page is a prefix-compressed leaf index
+    ** b-tree page.  Only databases of SQLITE_PREFIX_FILE_FORMAT have them. */
+    assert( (PTF_PREFIX|PTF_ZERODATA|PTF_LEAF)==26 );
+    pPage->intKey = 0;
+    pPage->intKeyLeaf = 0;
+    pPage->prefixLeaf = 1;
+    pPage->xCellSize = cellSizePtrPrefix;
+    pPage->xParseCell = btreeParseCellPtrPrefix;
+    pPage->maxLocal = pBt->maxLocal;
+    pPage->minLocal = pBt->minLocal;
   }else{
     /* EVIDENCE-OF: R-47608-56469 Any other value for the b-tree page type is
     ** an error. */
@@ -1745,6 +1998,7 @@ static int btreeInitPage(MemPage *pPage){
     int iCellLast;     /* Last possible cell or freeblock offset */
 
     pBt = pPage->pBt;
+    btreeKeyCacheDrop(pBt, pPage->pgno);
 
     hdr = pPage->hdrOffset;
     data = pPage->aData;
@@ -1865,6 +2119,7 @@ static void zeroPage(MemPage *pPage, int flags){
   assert( sqlite3PagerGetData(pPage->pDbPage) == data );
   assert( sqlite3PagerIswriteable(pPage->pDbPage) );
   assert( sqlite3_mutex_held(pBt->mutex) );
+  btreeKeyCacheDrop(pBt, pPage->pgno);
   if( pBt->btsFlags & BTS_SECURE_DELETE ){
     memset(&data[hdr], 0, pBt->usableSize - hdr);
   }
@@ -2281,6 +2536,7 @@ int sqlite3BtreeOpen(
       goto btree_open_out;
     }
     pBt->openFlags = (u8)flags;
+    pBt->bulkFill = SQLITE_DEFAULT_BULK_FILL;
     pBt->db = db;
     sqlite3PagerSetBusyhandler(pBt->pPager, btreeInvokeBusyHandler, pBt);
     p->pBt = pBt;
@@ -2532,6 +2788,7 @@ int sqlite3BtreeClose(Btree *p){
     }
     sqlite3DbFree(0, pBt->pSchema);
     freeTempSpace(pBt);
+    btreeKeyCacheFree(pBt);
     sqlite3_free(pBt);
   }
 
@@ -2582,6 +2839,56 @@ int sqlite3BtreeSetSpillSize(Btree *p, int mxPage){
   return res;
 }
 
+/*
+** Change the maximum number of pages the pager reads ahead when it
+** detects a sequential scan of the database file. A negative argument
+** leaves the setting unchanged. The value returned is the current
+** read-ahead size.
+*/
+int sqlite3BtreeSetReadahead(Btree *p, int nPage){
+  BtShared *pBt = p->pBt;
+  int res;
+  assert( sqlite3_mutex_held(p->db->mutex) );
+  sqlite3BtreeEnter(p);
+  res = sqlite3PagerSetReadahead(pBt->pPager, nPage);
+  sqlite3BtreeLeave(p);
+  return res;
+}
+
+/*
+** Change the percentage of each page that a bulk build fills before
+** moving on to the next page.  Zero disables bulk builds.  A negative
+** argument leaves the setting unchanged. The value returned is the
+** current setting.
+*/
+int sqlite3BtreeSetBulkFill(Btree *p, int nFill){
+  BtShared *pBt = p->pBt;
+  int res;
+  assert( sqlite3_mutex_held(p->db->mutex) );
+  sqlite3BtreeEnter(p);
+  if( nFill>=0 ){
+    pBt->bulkFill = (u8)(nFill>100 ? 100 : nFill);
+  }
+  res = pBt->bulkFill;
+  sqlite3BtreeLeave(p);
+  return res;
+}
+
+/*
+** Change the durability policy of the pager to one of the
+** PAGER_DURABILITY_* values. PAGER_DURABILITY_QUERY leaves the policy
+** unchanged. The value returned is the current policy.
+*/
+int sqlite3BtreeSetDurability(Btree *p, int eDurability){
+  BtShared *pBt = p->pBt;
+  int res;
+  assert( sqlite3_mutex_held(p->db->mutex) );
+  sqlite3BtreeEnter(p);
+  res = sqlite3PagerSetDurability(pBt->pPager, eDurability);
+  sqlite3BtreeLeave(p);
+  return res;
+}
+
 #if SQLITE_MAX_MMAP_SIZE>0
 /*
 ** Change the limit on the amount of the database file that may be
@@ -2808,6 +3115,20 @@ int sqlite3BtreeGetAutoVacuum(Btree *p){
 }
 
 
+/*
+** Set or clear BTS_PREFIX_KEYS according to the schema format number
+** in the database header at page1.  Prefix-compressed index leaves are
+** only recognized, and only written, in databases of format
+** SQLITE_PREFIX_FILE_FORMAT or later.
+*/
+static void btreePrefixFormat(BtShared *pBt, const u8 *page1){
+  if( get4byte(&page1[36 + BTREE_FILE_FORMAT*4])>=SQLITE_PREFIX_FILE_FORMAT ){
+    pBt->btsFlags |= BTS_PREFIX_KEYS;
+  }else{
+    pBt->btsFlags &= ~BTS_PREFIX_KEYS;
+  }
+}
+
 /*
 ** Get a reference to pPage1 of the database file.  This will
 ** also acquire a readlock on that file.
@@ -2949,6 +3270,7 @@ static int lockBtree(BtShared *pBt){
     pBt->incrVacuum = (get4byte(&page1[36 + 7*4])?1:0);
 #endif
   }
+  btreePrefixFormat(pBt, pPage1->aData);
 
   /* maxLocal is the maximum amount of payload to store locally for
   ** a cell.  Make sure it is small enough so that at least minFanout
@@ -3400,6 +3722,8 @@ static int relocatePage(
   /* Move page iDbPage from its current location to page number iFreePage */
   TRACE(("AUTOVACUUM: Moving %d to free page %d (ptr page %d type %d)\n", 
       iDbPage, iFreePage, iPtrPage, eType));
+  btreeKeyCacheDrop(pBt, iDbPage);
+  btreeKeyCacheDrop(pBt, iFreePage);
   rc = sqlite3PagerMovepage(pPager, pDbPage->pDbPage, iFreePage, isCommit);
   if( rc!=SQLITE_OK ){
     return rc;
@@ -3892,6 +4216,7 @@ int sqlite3BtreeTripAllCursors(Btree *pBtree, int errCode, int writeOnly){
         }
       }else{
         sqlite3BtreeClearCursor(p);
+        if( p->pBulk ) btreeBulkEnd(p);
         p->eState = CURSOR_FAULT;
         p->skipNext = errCode;
       }
@@ -3955,6 +4280,7 @@ int sqlite3BtreeRollback(Btree *p, int tripCode, int writeOnly){
       if( nPage==0 ) sqlite3PagerPagecount(pBt->pPager, &nPage);
       testcase( pBt->nPage!=nPage );
       pBt->nPage = nPage;
+      btreePrefixFormat(pBt, pPage1->aData);
       releasePage(pPage1);
     }
     assert( countValidCursors(pBt, 1)==0 );
@@ -4030,6 +4356,7 @@ int sqlite3BtreeSavepoint(Btree *p, int op, int iSavepoint){
       }
       rc = newDatabase(pBt);
       pBt->nPage = get4byte(28 + pBt->pPage1->aData);
+      btreePrefixFormat(pBt, pBt->pPage1->aData);
 
       /* The database size was written into the offset 28 of the header
       ** when the transaction started, so we know that the value at offset
@@ -4121,6 +4448,15 @@ static int btreeCursor(
     iTable = 0;
   }
 
+  /* A bulk build on the same b-tree must be finished before another
+  ** cursor can be allowed to see it. */
+  for(pX=pBt->pCursor; pX; pX=pX->pNext){
+    if( pX->pBulk && pX->pgnoRoot==(Pgno)iTable ){
+      int rc = btreeBulkSave(pX);
+      if( rc ) return rc;
+    }
+  }
+
   /* Now that no other errors can occur, finish filling in the BtCursor
   ** variables and link the cursor into the BtShared list.  */
   pCur->pgnoRoot = (Pgno)iTable;
@@ -4196,6 +4532,7 @@ int sqlite3BtreeCloseCursor(BtCursor *pCur){
     BtShared *pBt = pCur->pBt;
     sqlite3BtreeEnter(pBtree);
     sqlite3BtreeClearCursor(pCur);
+    if( pCur->pBulk ) btreeBulkEnd(pCur);
     assert( pBt->pCursor!=0 );
     if( pBt->pCursor==pCur ){
       pBt->pCursor = pCur->pNext;
@@ -4214,12 +4551,175 @@ int sqlite3BtreeCloseCursor(BtCursor *pCur){
     }
     unlockBtreeIfUnused(pBt);
     sqlite3_free(pCur->aOverflow);
+    sqlite3_free(pCur->aPrefixKey);
     /* sqlite3_free(pCur); */
     sqlite3BtreeLeave(pBtree);
   }
   return SQLITE_OK;
 }
 
+/*
+** Prepare cursor pCur to read the prefix-compressed leaf page it has
+** just moved to: allocate the buffer keys are expanded into, if this
+** is the first such page the cursor has visited, and forget whatever
+** key the buffer held.  The buffer has 18 bytes of padding for the
+** same reason as the one allocated by sqlite3BtreeMovetoUnpacked().
+*/
+static int btreePrefixEnter(BtCursor *pCur){
+  if( pCur->aPrefixKey==0 ){
+    pCur->aPrefixKey = (u8*)sqlite3Malloc(pCur->pBt->usableSize + 18);
+    if( pCur->aPrefixKey==0 ) return SQLITE_NOMEM;
+  }
+  pCur->iPrefixKey = 0;
+  return SQLITE_OK;
+}
+
+/*
+** Apply cell iCell of the prefix-compressed leaf pPage to aPrev[], the
+** nPrev byte key of the cell before it, and write the key of cell iCell
+** to aOut[].  aOut may be the same buffer as aPrev.  A restart cell is
+** applied to an empty previous key.  Return the size of the key written
+** to aOut[], or -1 if the page is corrupt.
+*/
+static int btreePrefixApply(
+  MemPage *pPage,                 /* Prefix-compressed leaf page */
+  int iCell,                      /* Cell to expand */
+  const u8 *aPrev,                /* Key of cell iCell-1 */
+  u32 nPrev,                      /* Size of aPrev[], or 0 */
+  u8 *aOut                        /* OUT: Key of cell iCell */
+){
+  u8 *aEnd = &pPage->aData[pPage->pBt->usableSize];
+  u8 *pCell = findCell(pPage, iCell);
+  u32 nHdrPrev = 0;
+  u32 nPayload, nHdrShared, nHdr, nBodyShared, nHdrSuffix, nBodySuffix;
+
+  assert( pPage->prefixLeaf );
+  if( iCell % BTREE_PREFIX_RESTART ){
+    getVarint32(aPrev, nHdrPrev);
+    if( nHdrPrev>nPrev ) return -1;
+  }else{
+    nPrev = 0;
+  }
+  if( pCell<pPage->aData || pCell>=aEnd-4 ) return -1;
+  pCell += getVarint32(pCell, nPayload);
+  pCell += getVarint32(pCell, nHdrShared);
+  pCell += getVarint32(pCell, nHdr);
+  pCell += getVarint32(pCell, nBodyShared);
+  if( nPayload>pPage->maxLocal
+   || nHdrShared>nHdr || nHdrShared>nHdrPrev
+   || nBodyShared>nPrev-nHdrPrev || nHdr+nBodyShared>nPayload
+  ){
+    return -1;
+  }
+  nHdrSuffix = nHdr - nHdrShared;
+  nBodySuffix = nPayload - nHdr - nBodyShared;
+  if( pCell+nHdrSuffix+nBodySuffix>aEnd ) return -1;
+  memmove(&aOut[nHdr], &aPrev[nHdrPrev], nBodyShared);
+  if( aOut!=aPrev ) memcpy(aOut, aPrev, nHdrShared);
+  memcpy(&aOut[nHdrShared], pCell, nHdrSuffix);
+  memcpy(&aOut[nHdr+nBodyShared], &pCell[nHdrSuffix], nBodySuffix);
+  return (int)nPayload;
+}
+
+/*
+** Expand the key of cell iCell of the prefix-compressed leaf pPage into
+** pCur->aPrefixKey[].  If the buffer already holds an earlier key of the
+** same restart run, only the cells that follow it are applied.  Return
+** the size of the key in bytes, or -1 if the page is corrupt.
+*/
+static int btreePrefixExpand(BtCursor *pCur, MemPage *pPage, int iCell){
+  int i = iCell - (iCell % BTREE_PREFIX_RESTART);
+  int nKey = 0;
+
+  assert( pPage->prefixLeaf );
+  assert( pCur->aPrefixKey!=0 );
+  assert( iCell>=0 && iCell<pPage->nCell );
+  if( pCur->iPrefixKey>i && pCur->iPrefixKey<=iCell+1 ){
+    i = pCur->iPrefixKey;
+    nKey = pCur->nPrefixKey;
+  }
+  for(; i<=iCell; i++){
+    nKey = btreePrefixApply(pPage, i, pCur->aPrefixKey, nKey,
+                            pCur->aPrefixKey);
+    if( nKey<0 ){
+      pCur->iPrefixKey = 0;
+      return -1;
+    }
+  }
+  pCur->iPrefixKey = iCell+1;
+  pCur->nPrefixKey = nKey;
+  return nKey;
+}
+
+/*
+** Search the prefix-compressed leaf page pPage for the key pIdxKey.
+** Restart cells hold whole records, so a binary search over them picks
+** the run the key belongs to, and only that run is expanded and compared
+** cell by cell.  On return *pIdx is the cell the cursor should point to
+** and *pC the result of comparing it with pIdxKey, with the same meaning
+** as the values left by the binary search of sqlite3BtreeMovetoUnpacked().
+*/
+static int btreePrefixSearch(
+  BtCursor *pCur,                 /* The cursor, on leaf pPage */
+  MemPage *pPage,                 /* Prefix-compressed leaf to search */
+  UnpackedRecord *pIdxKey,        /* The key to search for */
+  RecordCompare xRecordCompare,   /* Comparison function for pIdxKey */
+  int *pIdx,                      /* OUT: Cell the search ended on */
+  int *pC                         /* OUT: Comparison of that cell and key */
+){
+  u8 *aEnd = &pPage->aData[pPage->pBt->usableSize];
+  int lwr = 0;
+  int upr = (pPage->nCell-1) / BTREE_PREFIX_RESTART;
+  int iRun = -1;                  /* Last run with a restart key < pIdxKey */
+  int c;
+  int i, iLast;
+
+  assert( pPage->prefixLeaf && pPage->nCell>0 );
+  *pIdx = 0;
+  *pC = 0;
+  while( lwr<=upr ){
+    int r = (lwr+upr)>>1;
+    CellInfo info;
+    u8 *pCell = findCell(pPage, r*BTREE_PREFIX_RESTART);
+    if( pCell<pPage->aData || pCell>=aEnd-4 ) return SQLITE_CORRUPT_BKPT;
+    btreeParseCellPtrPrefix(pPage, pCell, &info);
+    if( info.nPayload<2 || &info.pPayload[info.nPayload]>aEnd ){
+      return SQLITE_CORRUPT_BKPT;
+    }
+    c = xRecordCompare(info.nPayload, info.pPayload, pIdxKey);
+    if( c<0 ){
+      iRun = r;
+      lwr = r+1;
+    }else if( c>0 ){
+      upr = r-1;
+    }else{
+      *pIdx = r*BTREE_PREFIX_RESTART;
+      *pC = 0;
+      return SQLITE_OK;
+    }
+  }
+  if( iRun<0 ){
+    *pIdx = 0;
+    *pC = 1;
+    return SQLITE_OK;
+  }
+  i = iRun*BTREE_PREFIX_RESTART;
+  iLast = i + BTREE_PREFIX_RESTART - 1;
+  if( iLast>=pPage->nCell ) iLast = pPage->nCell-1;
+  c = -1;
+  while( i<iLast ){
+    int nKey;
+    i++;
+    nKey = btreePrefixExpand(pCur, pPage, i);
+    if( nKey<2 ) return SQLITE_CORRUPT_BKPT;
+    c = xRecordCompare(nKey, pCur->aPrefixKey, pIdxKey);
+    if( c>=0 ) break;
+  }
+  *pIdx = i;
+  *pC = c;
+  return SQLITE_OK;
+}
+
 /*
 ** Make sure the BtCursor* given in the argument has a valid
 ** BtCursor.info structure.  If it is not already valid, call
@@ -4233,6 +4733,7 @@ int sqlite3BtreeCloseCursor(BtCursor *pCur){
     CellInfo info;
     int iPage = pCur->iPage;
     memset(&info, 0, sizeof(info));
+    if( pCur->apPage[iPage]->prefixLeaf ) return;
     btreeParseCell(pCur->apPage[iPage], pCur->aiIdx[iPage], &info);
     assert( CORRUPT_DB || memcmp(&info, &pCur->info, sizeof(info))==0 );
   }
@@ -4242,8 +4743,19 @@ int sqlite3BtreeCloseCursor(BtCursor *pCur){
 static SQLITE_NOINLINE void getCellInfo(BtCursor *pCur){
   if( pCur->info.nSize==0 ){
     int iPage = pCur->iPage;
+    MemPage *pPage = pCur->apPage[iPage];
     pCur->curFlags |= BTCF_ValidNKey;
-    btreeParseCell(pCur->apPage[iPage],pCur->aiIdx[iPage],&pCur->info);
+    btreeParseCell(pPage,pCur->aiIdx[iPage],&pCur->info);
+    if( pPage->prefixLeaf ){
+      /* The cell holds only the suffix of its key.  Present the expanded
+      ** key instead, or an empty one if the page is corrupt. */
+      int nKey = btreePrefixExpand(pCur, pPage, pCur->aiIdx[iPage]);
+      if( nKey<0 ) nKey = 0;
+      pCur->info.nKey = nKey;
+      pCur->info.nPayload = (u32)nKey;
+      pCur->info.nLocal = (u16)nKey;
+      pCur->info.pPayload = pCur->aPrefixKey;
+    }
   }else{
     assertCellInfo(pCur);
   }
@@ -4411,6 +4923,72 @@ static int copyPayload(
   return SQLITE_OK;
 }
 
+/*
+** Read amt bytes of the payload of the entry that pCur points to into
+** pBuf[], beginning at byte offset of overflow page pgno, the iIdx'th
+** page of the overflow chain.  The pages are fetched with a single call
+** to sqlite3PagerReadDirect(), so that large values are copied straight
+** from the database file without passing through the page cache.
+**
+** The chain is assumed to continue with pages pgno+1, pgno+2 and so on,
+** as it does when it was written by fillInCell(), until the overflow
+** page-list cache or the next-page pointer of a page read shows
+** otherwise.  On success, *pnByte is set to the number of bytes copied
+** (which may be less than amt), *pnPage to the number of chain pages
+** consumed and *pNext to the page that follows them in the chain.
+** SQLITE_NOTFOUND is returned if the pages cannot be read this way.
+*/
+static int readOverflowRun(
+  BtCursor *pCur,           /* Cursor pointing to entry to read from */
+  int iIdx,                 /* Index of page pgno in the overflow chain */
+  Pgno pgno,                /* First overflow page to read */
+  u32 offset,               /* Offset of first byte required on page pgno */
+  u32 amt,                  /* Number of bytes required */
+  unsigned char *pBuf,      /* Write the bytes into this buffer */
+  u32 *pnByte,              /* OUT: Number of bytes copied into pBuf[] */
+  int *pnPage,              /* OUT: Number of chain pages consumed */
+  Pgno *pNext               /* OUT: Next page of the overflow chain */
+){
+  BtShared *pBt = pCur->pBt;
+  const u32 ovflSize = pBt->usableSize - 4;
+  int bCache = (pCur->curFlags & BTCF_ValidOvfl)!=0;
+  int nRun;                 /* Number of pages to read */
+  u8 *aData;                /* Image of page pgno, followed by the others */
+  u32 nByte = 0;            /* Bytes copied so far */
+  Pgno next = 0;            /* Next-page pointer of the last page used */
+  int i;
+  int rc;
+
+  assert( offset<ovflSize && amt>ovflSize-offset );
+  nRun = 1 + (amt - (ovflSize-offset) + ovflSize - 1)/ovflSize;
+  if( bCache ){
+    for(i=1; i<nRun; i++){
+      Pgno iKnown = pCur->aOverflow[iIdx+i];
+      if( iKnown && iKnown!=pgno+i ) break;
+    }
+    nRun = i;
+  }
+  if( nRun<2 ) return SQLITE_NOTFOUND;
+  rc = sqlite3PagerReadDirect(pBt->pPager, pgno, &nRun, &aData);
+  if( rc!=SQLITE_OK ) return rc;
+
+  for(i=0; i<nRun; ){
+    u8 *aPage = &aData[i*pBt->pageSize];
+    u32 a = MIN(amt-nByte, ovflSize-offset);
+    memcpy(&pBuf[nByte], &aPage[4+offset], a);
+    nByte += a;
+    offset = 0;
+    if( bCache ) pCur->aOverflow[iIdx+i] = pgno+i;
+    next = get4byte(aPage);
+    i++;
+    if( nByte==amt || next!=pgno+i ) break;
+  }
+  *pnByte = nByte;
+  *pnPage = i;
+  *pNext = next;
+  return SQLITE_OK;
+}
+
 /*
 ** This function is used to read or overwrite payload information
 ** for the entry that the pCur cursor is pointing to. The eOp
@@ -4432,6 +5010,10 @@ static int copyPayload(
 ** Subsequent calls use this cache to make seeking to the supplied offset 
 ** more efficient.
 **
+** A read that spans BTREE_OVFL_RUN or more overflow pages is satisfied,
+** where possible, by readOverflowRun(), which reads runs of consecutive
+** overflow pages directly from the database file.
+**
 ** Once an overflow page-list cache has been allocated, it may be
 ** invalidated if some other cursor writes to the same table, or if
 ** the cursor is moved to a different row. Additionally, in auto-vacuum
@@ -4451,6 +5033,7 @@ static int accessPayload(
   unsigned char *aPayload;
   int rc = SQLITE_OK;
   int iIdx = 0;
+  int bRun;            /* True to try readOverflowRun() */
   MemPage *pPage = pCur->apPage[pCur->iPage]; /* Btree page of current entry */
   BtShared *pBt = pCur->pBt;                  /* Btree this cursor belongs to */
 #ifdef SQLITE_DIRECT_OVERFLOW_READ
@@ -4471,7 +5054,9 @@ static int accessPayload(
 #endif
   assert( offset+amt <= pCur->info.nPayload );
 
-  if( &aPayload[pCur->info.nLocal] > &pPage->aData[pBt->usableSize] ){
+  if( &aPayload[pCur->info.nLocal] > &pPage->aData[pBt->usableSize]
+   && !pPage->prefixLeaf
+  ){
     /* Trying to read or write past the end of the data is an error */
     return SQLITE_CORRUPT_BKPT;
   }
@@ -4496,6 +5081,7 @@ static int accessPayload(
     Pgno nextPage;
 
     nextPage = get4byte(&aPayload[pCur->info.nLocal]);
+    bRun = (eOp&0x01)==0 && amt>=BTREE_OVFL_RUN*ovflSize;
 
     /* If the BtCursor.aOverflow[] has not been allocated, allocate it now.
     ** Except, do not allocate aOverflow[] for eOp==2.
@@ -4577,6 +5163,26 @@ static int accessPayload(
           a = ovflSize - offset;
         }
 
+        if( bRun && (u32)a<amt ){
+          u32 nByte = 0;
+          int nPage = 0;
+          rc = readOverflowRun(pCur, iIdx, nextPage, offset, amt, pBuf,
+                               &nByte, &nPage, &nextPage);
+          if( rc!=SQLITE_NOTFOUND ){
+            if( rc==SQLITE_OK ){
+              /* Stop trying once the chain turns out not to be contiguous */
+              if( nPage==1 ) bRun = 0;
+              iIdx += nPage-1;
+              offset = 0;
+              amt -= nByte;
+              pBuf += nByte;
+            }
+            continue;
+          }
+          bRun = 0;
+          rc = SQLITE_OK;
+        }
+
 #ifdef SQLITE_DIRECT_OVERFLOW_READ
         /* If all the following are true:
         **
@@ -4714,6 +5320,10 @@ static const void *fetchPayload(
   assert( cursorOwnsBtShared(pCur) );
   assert( pCur->aiIdx[pCur->iPage]<pCur->apPage[pCur->iPage]->nCell );
   assert( pCur->info.nSize>0 );
+  if( pCur->apPage[pCur->iPage]->prefixLeaf ){
+    *pAmt = pCur->info.nLocal;
+    return (void*)pCur->info.pPayload;
+  }
   assert( pCur->info.pPayload>pCur->apPage[pCur->iPage]->aData || CORRUPT_DB );
   assert( pCur->info.pPayload<pCur->apPage[pCur->iPage]->aDataEnd ||CORRUPT_DB);
   amt = (int)(pCur->apPage[pCur->iPage]->aDataEnd - pCur->info.pPayload);
@@ -4756,6 +5366,7 @@ const void *sqlite3BtreeDataFetch(BtCursor *pCur, u32 *pAmt){
 */
 static int moveToChild(BtCursor *pCur, u32 newPgno){
   BtShared *pBt = pCur->pBt;
+  int rc;
 
   assert( cursorOwnsBtShared(pCur) );
   assert( pCur->eState==CURSOR_VALID );
@@ -4768,8 +5379,13 @@ static int moveToChild(BtCursor *pCur, u32 newPgno){
   pCur->curFlags &= ~(BTCF_ValidNKey|BTCF_ValidOvfl);
   pCur->iPage++;
   pCur->aiIdx[pCur->iPage] = 0;
-  return getAndInitPage(pBt, newPgno, &pCur->apPage[pCur->iPage],
-                        pCur, pCur->curPagerFlags);
+  rc = getAndInitPage(pBt, newPgno, &pCur->apPage[pCur->iPage],
+                      pCur, pCur->curPagerFlags);
+  if( rc==SQLITE_OK && pCur->apPage[pCur->iPage]->prefixLeaf ){
+    rc = btreePrefixEnter(pCur);
+    if( rc ) releasePageNotNull(pCur->apPage[pCur->iPage--]);
+  }
+  return rc;
 }
 
 #if SQLITE_DEBUG
@@ -4854,6 +5470,10 @@ static int moveToRoot(BtCursor *pCur){
     }
     sqlite3BtreeClearCursor(pCur);
   }
+  if( pCur->pBulk ){
+    btreeReleaseAllCursorPages(pCur);
+    btreeBulkEnd(pCur);
+  }
 
   if( pCur->iPage>=0 ){
     while( pCur->iPage ){
@@ -4895,6 +5515,13 @@ static int moveToRoot(BtCursor *pCur){
   pCur->aiIdx[0] = 0;
   pCur->info.nSize = 0;
   pCur->curFlags &= ~(BTCF_AtLast|BTCF_ValidNKey|BTCF_ValidOvfl);
+  if( pRoot->prefixLeaf ){
+    rc = btreePrefixEnter(pCur);
+    if( rc ){
+      pCur->eState = CURSOR_INVALID;
+      return rc;
+    }
+  }
 
   if( pRoot->nCell>0 ){
     pCur->eState = CURSOR_VALID;
@@ -5029,6 +5656,141 @@ int sqlite3BtreeLast(BtCursor *pCur, int *pRes){
   return rc;
 }
 
+/*
+** Set *piKey to the integer key of cell idx of table b-tree page pPage.
+*/
+static int btreeCellIntKey(MemPage *pPage, int idx, i64 *piKey){
+  u8 *pCell = findCellPastPtr(pPage, idx);
+  assert( pPage->intKey );
+  if( pPage->intKeyLeaf ){
+    while( 0x80 <= *(pCell++) ){
+      if( pCell>=pPage->aDataEnd ) return SQLITE_CORRUPT_BKPT;
+    }
+  }
+  getVarint(pCell, (u64*)piKey);
+  return SQLITE_OK;
+}
+
+/*
+** Try to move table cursor pCur, which is valid and so on a leaf page,
+** to intKey without descending from the root.  This succeeds if intKey
+** belongs on the current leaf, or on the sibling leaf that follows it,
+** which is the usual case when a loop seeks a table in ascending rowid
+** order, as the inner loop of a join on a sorted outer table does.  The
+** range of keys that belong on a leaf is bounded by the divider keys on
+** either side of it on the parent page.  The cursor and *pRes are set as
+** by sqlite3BtreeMovetoUnpacked(), and the cursor is left where a descent
+** from the root would leave it, so that an insert may use it.
+**
+** Return SQLITE_DONE if intKey may belong elsewhere in the table, or if
+** it is not in the table and would sort before or after every key on the
+** leaf.
+*/
+static int btreeMovetoNearby(BtCursor *pCur, i64 intKey, int *pRes){
+  MemPage *pPage = pCur->apPage[pCur->iPage];
+  MemPage *pParent;         /* Parent of pPage */
+  int iParent;              /* Index of pPage on pParent */
+  i64 iKey;
+  int lwr, upr, idx, c;
+  int rc;
+
+  assert( pCur->eState==CURSOR_VALID && pCur->curIntKey );
+  assert( pCur->pBulk==0 );
+  if( !pPage->leaf || pPage->nCell==0 ) return SQLITE_DONE;
+  if( pCur->iPage>0 ){
+    pParent = pCur->apPage[pCur->iPage-1];
+    iParent = pCur->aiIdx[pCur->iPage-1];
+    rc = btreeCellIntKey(pPage, pPage->nCell-1, &iKey);
+    if( rc ) return rc;
+    if( intKey>iKey ){
+      /* The keys of pPage are no greater than the divider at iParent, and
+      ** a key between the last cell and that divider is not in the table.
+      ** Past the divider, step to the next leaf only if the divider after
+      ** it shows that intKey belongs there, so that a key on some other
+      ** part of the table does not cost a page load on top of the descent
+      ** from the root. */
+      int bEof = 0;
+      if( iParent+1>=pParent->nCell ) return SQLITE_DONE;
+      rc = btreeCellIntKey(pParent, iParent, &iKey);
+      if( rc ) return rc;
+      if( intKey<=iKey ) return SQLITE_DONE;
+      rc = btreeCellIntKey(pParent, iParent+1, &iKey);
+      if( rc ) return rc;
+      if( intKey>iKey ) return SQLITE_DONE;
+      /* A seek from CURSOR_SKIPNEXT state leaves skipNext set, although
+      ** it has no meaning for a valid cursor. */
+      pCur->skipNext = 0;
+      pCur->aiIdx[pCur->iPage] = pPage->nCell-1;
+      rc = sqlite3BtreeNext(pCur, &bEof);
+      if( rc ) return rc;
+      pPage = pCur->apPage[pCur->iPage];
+      if( bEof || !pPage->leaf || pPage->nCell==0 ){
+        return SQLITE_CORRUPT_BKPT;
+      }
+    }else{
+      /* A key less than the first cell is not on pPage. */
+      rc = btreeCellIntKey(pPage, 0, &iKey);
+      if( rc ) return rc;
+      if( intKey<iKey ) return SQLITE_DONE;
+    }
+  }
+
+  /* intKey belongs on pPage.  Find the first cell with a key that is not
+  ** less than intKey, or the last cell if there is none. */
+#if SQLITE_BTREE_KEYCACHE>0
+  {
+    i64 *aKey = btreeKeyCacheFetch(pPage);
+    if( aKey ){
+      lwr = btreeKeyLowerBound(aKey, pPage->nCell, intKey);
+      if( lwr<pPage->nCell ){
+        idx = lwr;
+        c = aKey[idx]==intKey ? 0 : +1;
+      }else{
+        idx = lwr-1;
+        c = -1;
+      }
+      iKey = aKey[idx];
+      goto nearby_found;
+    }
+  }
+#endif
+  lwr = 0;
+  upr = pPage->nCell-1;
+  while( lwr<upr ){
+    int iMid = (lwr+upr)>>1;
+    rc = btreeCellIntKey(pPage, iMid, &iKey);
+    if( rc ) return rc;
+    if( iKey<intKey ){
+      lwr = iMid+1;
+    }else{
+      upr = iMid;
+    }
+  }
+  idx = lwr;
+  rc = btreeCellIntKey(pPage, idx, &iKey);
+  if( rc ) return rc;
+  c = iKey==intKey ? 0 : (iKey<intKey ? -1 : +1);
+
+#if SQLITE_BTREE_KEYCACHE>0
+nearby_found:
+#endif
+  /* A key that is missing and would sort before the first or after the
+  ** last cell of pPage falls between two leaves.  Leave that case to the
+  ** descent from the root, so that the leaf the cursor ends on and the
+  ** sign of *pRes are whatever the descent makes them. */
+  if( c<0 ? idx==pPage->nCell-1 : (c>0 && idx==0) ) return SQLITE_DONE;
+  pCur->aiIdx[pCur->iPage] = (u16)idx;
+  pCur->info.nSize = 0;
+  pCur->curFlags &= ~(BTCF_ValidNKey|BTCF_ValidOvfl|BTCF_AtLast);
+  if( c==0 ){
+    pCur->info.nKey = iKey;
+    pCur->curFlags |= BTCF_ValidNKey;
+  }
+  *pRes = c;
+  pCur->pBt->nSeekNearby++;
+  return SQLITE_OK;
+}
+
 /* Move the cursor so that it points to an entry near the key 
 ** specified by pIdxKey or intKey.   Return a success code.
 **
@@ -5098,8 +5860,13 @@ int sqlite3BtreeMovetoUnpacked(
     );
   }else{
     xRecordCompare = 0; /* All keys are integers */
+    if( pCur->eState==CURSOR_VALID && pCur->pBulk==0 ){
+      rc = btreeMovetoNearby(pCur, intKey, pRes);
+      if( rc!=SQLITE_DONE ) return rc;
+    }
   }
 
+  pCur->pBt->nSeekRoot++;
   rc = moveToRoot(pCur);
   if( rc ){
     return rc;
@@ -5116,6 +5883,7 @@ int sqlite3BtreeMovetoUnpacked(
   assert( pCur->curIntKey || pIdxKey );
   for(;;){
     int lwr, upr, idx, c;
+    i64 nCellKey = 0;                   /* Last integer key compared */
     Pgno chldPg;
     MemPage *pPage = pCur->apPage[pCur->iPage];
     u8 *pCell;                          /* Pointer to current cell in pPage */
@@ -5134,8 +5902,37 @@ int sqlite3BtreeMovetoUnpacked(
     idx = upr>>(1-biasRight); /* idx = biasRight ? upr : (lwr+upr)/2; */
     pCur->aiIdx[pCur->iPage] = (u16)idx;
     if( xRecordCompare==0 ){
+#if SQLITE_BTREE_KEYCACHE>0
+      i64 *aKey = btreeKeyCacheFetch(pPage);
+      if( aKey ){
+        /* The keys of this page are cached.  Find the first key that is
+        ** not less than intKey and leave lwr, upr, idx and c as the
+        ** binary search below would. */
+        lwr = btreeKeyLowerBound(aKey, pPage->nCell, intKey);
+        upr = lwr-1;
+        if( lwr<pPage->nCell ){
+          idx = lwr;
+          c = aKey[idx]==intKey ? 0 : +1;
+        }else{
+          idx = upr;
+          c = -1;
+        }
+        nCellKey = aKey[idx];
+        if( c==0 ){
+          pCur->curFlags |= BTCF_ValidNKey;
+          pCur->info.nKey = nCellKey;
+          pCur->aiIdx[pCur->iPage] = (u16)idx;
+          if( !pPage->leaf ){
+            goto moveto_next_layer;
+          }else{
+            *pRes = 0;
+            rc = SQLITE_OK;
+            goto moveto_finish;
+          }
+        }
+      }else
+#endif
       for(;;){
-        i64 nCellKey;
         pCell = findCellPastPtr(pPage, idx);
         if( pPage->intKeyLeaf ){
           while( 0x80 <= *(pCell++) ){
@@ -5166,6 +5963,17 @@ int sqlite3BtreeMovetoUnpacked(
         assert( lwr+upr>=0 );
         idx = (lwr+upr)>>1;  /* idx = (lwr+upr)/2; */
       }
+    }else if( pPage->prefixLeaf ){
+      rc = btreePrefixSearch(pCur, pPage, pIdxKey, xRecordCompare, &idx, &c);
+      if( rc ) goto moveto_finish;
+      pCur->aiIdx[pCur->iPage] = (u16)idx;
+      if( c==0 ){
+        *pRes = 0;
+        if( pIdxKey->errCode ) rc = SQLITE_CORRUPT;
+        goto moveto_finish;
+      }
+      lwr = idx+1;
+      upr = idx;
     }else{
       for(;;){
         int nCell;  /* Size of the pCell cell in bytes */
@@ -5257,6 +6065,25 @@ int sqlite3BtreeMovetoUnpacked(
       pCur->aiIdx[pCur->iPage] = (u16)idx;
       *pRes = c;
       rc = SQLITE_OK;
+      if( c<0 && idx==pPage->nCell-1 ){
+        /* If the key sorts after every entry in the b-tree, the cursor is
+        ** now on the last entry.  Say so, so that an insert of the key,
+        ** and of any larger keys that follow it, need not seek again. */
+        int i;
+        for(i=0; i<pCur->iPage; i++){
+          if( pCur->aiIdx[i]!=pCur->apPage[i]->nCell ) break;
+        }
+        if( i==pCur->iPage ){
+          pCur->curFlags |= BTCF_AtLast;
+          if( xRecordCompare==0 ){
+            pCur->info.nSize = 0;
+            pCur->info.nKey = nCellKey;
+            pCur->curFlags &= ~BTCF_ValidOvfl;
+            pCur->curFlags |= BTCF_ValidNKey;
+            return SQLITE_OK;
+          }
+        }
+      }
       goto moveto_finish;
     }
 moveto_next_layer:
@@ -5320,6 +6147,10 @@ static SQLITE_NOINLINE int btreeNext(BtCursor *pCur, int *pRes){
   assert( cursorOwnsBtShared(pCur) );
   assert( pCur->skipNext==0 || pCur->eState!=CURSOR_VALID );
   assert( *pRes==0 );
+  if( pCur->pBulk ){
+    rc = btreeBulkSave(pCur);
+    if( rc ) return rc;
+  }
   if( pCur->eState!=CURSOR_VALID ){
     assert( (pCur->curFlags & BTCF_ValidOvfl)==0 );
     rc = restoreCursorPosition(pCur);
@@ -5432,6 +6263,10 @@ static SQLITE_NOINLINE int btreePrevious(BtCursor *pCur, int *pRes){
   assert( pCur->skipNext==0 || pCur->eState!=CURSOR_VALID );
   assert( (pCur->curFlags & (BTCF_AtLast|BTCF_ValidOvfl|BTCF_ValidNKey))==0 );
   assert( pCur->info.nSize==0 );
+  if( pCur->pBulk ){
+    rc = btreeBulkSave(pCur);
+    if( rc ) return rc;
+  }
   if( pCur->eState!=CURSOR_VALID ){
     rc = restoreCursorPosition(pCur);
     if( rc!=SQLITE_OK ){
@@ -5519,14 +6354,16 @@ int sqlite3BtreePrevious(BtCursor *pCur, int *pRes){
 ** anywhere on the free-list, then it is guaranteed to be returned.  If
 ** eMode is BTALLOC_LT then the page returned will be less than or equal
 ** to nearby if any such page exists.  If eMode is BTALLOC_ANY then there
-** are no restrictions on which page is returned.
+** are no restrictions on which page is returned.  If eMode is
+** BTALLOC_APPEND, the free-list is ignored and a new page is always
+** appended to the database image.
 */
 static int allocateBtreePage(
   BtShared *pBt,         /* The btree */
   MemPage **ppPage,      /* Store pointer to the allocated page here */
   Pgno *pPgno,           /* Store the page number here */
   Pgno nearby,           /* Search for a page near this one */
-  u8 eMode               /* BTALLOC_EXACT, BTALLOC_LT, or BTALLOC_ANY */
+  u8 eMode               /* BTALLOC_EXACT, BTALLOC_LT, _ANY or _APPEND */
 ){
   MemPage *pPage1;
   int rc;
@@ -5537,7 +6374,8 @@ static int allocateBtreePage(
   Pgno mxPage;     /* Total size of the database file */
 
   assert( sqlite3_mutex_held(pBt->mutex) );
-  assert( eMode==BTALLOC_ANY || (nearby>0 && IfNotOmitAV(pBt->autoVacuum)) );
+  assert( eMode==BTALLOC_ANY || eMode==BTALLOC_APPEND
+       || (nearby>0 && IfNotOmitAV(pBt->autoVacuum)) );
   pPage1 = pBt->pPage1;
   mxPage = btreePagecount(pBt);
   /* EVIDENCE-OF: R-05119-02637 The 4-byte big-endian integer at offset 36
@@ -5547,7 +6385,7 @@ static int allocateBtreePage(
   if( n>=mxPage ){
     return SQLITE_CORRUPT_BKPT;
   }
-  if( n>0 ){
+  if( n>0 && eMode!=BTALLOC_APPEND ){
     /* There are pages on the freelist.  Reuse one of those pages. */
     Pgno iTrunk;
     u8 searchList = 0; /* If the free-list must be searched for 'nearby' */
@@ -5763,8 +6601,8 @@ static int allocateBtreePage(
       pPrevTrunk = 0;
     }while( searchList );
   }else{
-    /* There are no pages on the freelist, so append a new page to the
-    ** database image.
+    /* There are no pages on the freelist, or the caller asked for a new
+    ** page, so append a new page to the database image.
     **
     ** Normally, new pages allocated by this block can be requested from the
     ** pager layer with the 'no-content' flag set. This prevents the pager
@@ -5856,6 +6694,7 @@ static int freePage2(BtShared *pBt, MemPage *pMemPage, Pgno iPage){
   assert( !pMemPage || pMemPage->pgno==iPage );
 
   if( iPage<2 ) return SQLITE_CORRUPT_BKPT;
+  btreeKeyCacheDrop(pBt, iPage);
   if( pMemPage ){
     pPage = pMemPage;
     sqlite3PagerRef(pPage->pDbPage);
@@ -6081,6 +6920,7 @@ static int fillInCell(
   unsigned char *pPayload;
   BtShared *pBt = pPage->pBt;
   Pgno pgnoOvfl = 0;
+  u8 eAlloc = BTALLOC_ANY;
   int nHeader;
 
   assert( sqlite3_mutex_held(pPage->pBt->mutex) );
@@ -6132,6 +6972,17 @@ static int fillInCell(
   }
   pPayload = &pCell[nHeader];
 
+  /* Pages taken from the free-list are scattered through the file.  So
+  ** that a long overflow chain can be read back with a few large reads,
+  ** allocate it at the end of the file instead.  This is not done for
+  ** auto-vacuum databases, which would move the pages again at commit.
+  */
+  if( nPayload-spaceLeft>=BTREE_OVFL_RUN*(int)(pBt->usableSize-4)
+   && !IfNotOmitAV(pBt->autoVacuum)
+  ){
+    eAlloc = BTALLOC_APPEND;
+  }
+
   /* At this point variables should be set as follows:
   **
   **   nPayload           Total payload size in bytes
@@ -6147,7 +6998,12 @@ static int fillInCell(
 #if SQLITE_DEBUG
   {
     CellInfo info;
-    pPage->xParseCell(pPage, pCell, &info);
+    if( pPage->prefixLeaf ){
+      /* The bulk build encodes the cell afterwards */
+      btreeParseCellPtrIndex(pPage, pCell, &info);
+    }else{
+      pPage->xParseCell(pPage, pCell, &info);
+    }
     assert( nHeader==(int)(info.pPayload - pCell) );
     assert( info.nKey==nKey );
     assert( *pnSize == info.nSize );
@@ -6168,7 +7024,7 @@ static int fillInCell(
         );
       }
 #endif
-      rc = allocateBtreePage(pBt, &pOvfl, &pgnoOvfl, pgnoOvfl, 0);
+      rc = allocateBtreePage(pBt, &pOvfl, &pgnoOvfl, pgnoOvfl, eAlloc);
 #ifndef SQLITE_OMIT_AUTOVACUUM
       /* If the database supports auto-vacuum, and the second or subsequent
       ** overflow page is being allocated, add an entry to the pointer-map
@@ -6264,6 +7120,7 @@ static void dropCell(MemPage *pPage, int idx, int sz, int *pRC){
   assert( CORRUPT_DB || sz==cellSize(pPage, idx) );
   assert( sqlite3PagerIswriteable(pPage->pDbPage) );
   assert( sqlite3_mutex_held(pPage->pBt->mutex) );
+  btreeKeyCacheDrop(pPage->pBt, pPage->pgno);
   data = pPage->aData;
   ptr = &pPage->aCellIdx[2*idx];
   pc = get2byte(ptr);
@@ -6333,6 +7190,7 @@ static void insertCell(
   ** might be less than 8 (leaf-size + pointer) on the interior node.  Hence
   ** the term after the || in the following assert(). */
   assert( sz==pPage->xCellSize(pPage, pCell) || (sz==8 && iChild>0) );
+  btreeKeyCacheDrop(pPage->pBt, pPage->pgno);
   if( pPage->nOverflow || sz+2>pPage->nFree ){
     if( pTemp ){
       memcpy(pTemp, pCell, sz);
@@ -6392,6 +7250,50 @@ static void insertCell(
   }
 }
 
+/*
+** Replace cell idx of pPage with the szNew byte cell pCell.  If the new
+** cell is the same size as the old one it is copied over the old cell, so
+** that neither the free-list nor the cell pointer array needs to be
+** searched or shifted.  A smaller cell is not written in place, as the
+** bytes it leaves behind would become a small freeblock in the middle of
+** the cell content area that the next insert is unlikely to be able to use.
+**
+** Return SQLITE_DONE without modifying the page if the sizes differ.  The
+** caller must then drop the old cell and insert the new one.  The new cell
+** must have the same key as the old one, so the page's entry in the key
+** cache (if any) remains valid.
+*/
+static int overwriteCell(
+  MemPage *pPage,   /* Page containing the cell */
+  int idx,          /* Index of the cell to replace */
+  int szOld,        /* Size of the existing cell */
+  u8 *pCell,        /* Content of the new cell */
+  int szNew         /* Size of the new cell */
+){
+  u8 * const data = pPage->aData;
+  int pc = get2byte(&pPage->aCellIdx[2*idx]);
+  int rc = SQLITE_OK;
+
+  assert( idx>=0 && idx<pPage->nCell );
+  assert( pPage->nOverflow==0 );
+  assert( CORRUPT_DB || szOld==cellSize(pPage, idx) );
+  assert( sqlite3PagerIswriteable(pPage->pDbPage) );
+  assert( sqlite3_mutex_held(pPage->pBt->mutex) );
+  if( szNew!=szOld ) return SQLITE_DONE;
+  if( pc<get2byte(&data[pPage->hdrOffset+5])
+   || pc+szOld>(int)pPage->pBt->usableSize
+  ){
+    return SQLITE_CORRUPT_BKPT;
+  }
+  memcpy(&data[pc], pCell, szNew);
+#ifndef SQLITE_OMIT_AUTOVACUUM
+  if( pPage->pBt->autoVacuum ){
+    ptrmapPutOvflPtr(pPage, &data[pc], &rc);
+  }
+#endif
+  return rc;
+}
+
 /*
 ** A CellArray object contains a cache of pointers and sizes for a
 ** consecutive sequence of cells that might be held multiple pages.
@@ -6466,6 +7368,7 @@ static int rebuildPage(
   u8 *pTmp = sqlite3PagerTempSpace(pPg->pBt->pPager);
   u8 *pData;
 
+  btreeKeyCacheDrop(pPg->pBt, pPg->pgno);
   i = get2byte(&aData[hdr+5]);
   memcpy(&pTmp[i], &aData[i], usableSize - i);
 
@@ -6645,6 +7548,8 @@ static int editPage(
   memcpy(pTmp, aData, pPg->pBt->usableSize);
 #endif
 
+  btreeKeyCacheDrop(pPg->pBt, pPg->pgno);
+
   /* Remove cells from the start and end of the page */
   if( iOld<iNew ){
     int nShift = pageFreeArray(pPg, iOld, iNew-iOld, pCArray);
@@ -6940,6 +7845,59 @@ static void copyNodeContent(MemPage *pFrom, MemPage *pTo, int *pRC){
   }
 }
 
+/*
+** Expand the cells of the prefix-compressed leaf pPage into ordinary
+** index leaf cells, so that balance_nonroot() can redistribute them.
+** The cells are written to a buffer obtained from sqlite3Malloc() that
+** the caller must free, returned in *ppBuf.  apCell[] and szCell[] are
+** filled in for each cell and *pnTotal is set to the space the cells
+** need on an ordinary page, cell pointers included.
+*/
+static int btreePrefixCells(
+  MemPage *pPage,                 /* Prefix-compressed leaf page */
+  u8 **apCell,                    /* OUT: Pointer to each expanded cell */
+  u16 *szCell,                    /* OUT: Size of each expanded cell */
+  u8 **ppBuf,                     /* OUT: Buffer holding the cells */
+  int *pnTotal                    /* OUT: Space needed by the cells */
+){
+  u8 *aKey;                       /* Scratch space for sizing the keys */
+  u8 *aBuf;
+  u8 *pOut;
+  u8 *pPrev = 0;
+  int nPrev = 0;
+  int nTotal = 0;
+  int i, n;
+
+  assert( pPage->prefixLeaf );
+  aKey = (u8*)sqlite3Malloc(pPage->pBt->usableSize + 18);
+  if( aKey==0 ) return SQLITE_NOMEM;
+  for(i=0; i<pPage->nCell; i++){
+    nPrev = btreePrefixApply(pPage, i, aKey, nPrev, aKey);
+    if( nPrev<2 ) break;
+    n = sqlite3VarintLen(nPrev) + nPrev;
+    nTotal += (n<4 ? 4 : n) + 2;
+  }
+  sqlite3_free(aKey);
+  if( i<pPage->nCell ) return SQLITE_CORRUPT_BKPT;
+
+  *ppBuf = aBuf = (u8*)sqlite3MallocZero(nTotal + 1);
+  if( aBuf==0 ) return SQLITE_NOMEM;
+  nPrev = 0;
+  for(i=0, pOut=aBuf; i<pPage->nCell; i++){
+    u32 nPayload;
+    getVarint32(findCell(pPage, i), nPayload);
+    n = putVarint32(pOut, nPayload);
+    nPrev = btreePrefixApply(pPage, i, pPrev, nPrev, &pOut[n]);
+    if( nPrev!=(int)nPayload ) return SQLITE_CORRUPT_BKPT;
+    pPrev = &pOut[n];
+    apCell[i] = pOut;
+    szCell[i] = (u16)(n+nPrev<4 ? 4 : n+nPrev);
+    pOut += szCell[i];
+  }
+  *pnTotal = nTotal;
+  return SQLITE_OK;
+}
+
 /*
 ** This routine redistributes cells on the iParentIdx'th child of pParent
 ** (hereafter "the page") and up to 2 siblings so that all pages have about the
@@ -7014,9 +7972,14 @@ static int balance_nonroot(
   Pgno aPgno[NB+2];            /* Page numbers of new pages before shuffling */
   Pgno aPgOrder[NB+2];         /* Copy of aPgno[] used for sorting pages */
   u16 aPgFlags[NB+2];          /* flags field of new pages before shuffling */
+  u8 *apExpand[NB];            /* Expanded cells of prefix-compressed pages */
+  int szExpand[NB];            /* Space needed by the cells in apExpand[] */
+  int bTwo;                    /* True to balance only two siblings */
   CellArray b;                  /* Parsed information on cells being balanced */
 
   memset(abDone, 0, sizeof(abDone));
+  memset(apExpand, 0, sizeof(apExpand));
+  memset(szExpand, 0, sizeof(szExpand));
   b.nCell = 0;
   b.apCell = 0;
   pBt = pParent->pBt;
@@ -7049,20 +8012,30 @@ static int balance_nonroot(
   ** way, the remainder of the function does not have to deal with any
   ** overflow cells in the parent page, since if any existed they will
   ** have already been removed.
+  **
+  ** Only two siblings are taken for a bulk load, and for index b-trees
+  ** that may contain prefix-compressed leaves.  The cells of a compressed
+  ** leaf need up to two ordinary pages, so that three siblings could
+  ** need more than NB+2 pages once expanded.
   */
+  assert( bBulk==0 || bBulk==1 );
+  bTwo = bBulk || (!pParent->intKey && (pBt->btsFlags & BTS_PREFIX_KEYS)!=0);
   i = pParent->nOverflow + pParent->nCell;
   if( i<2 ){
     nxDiv = 0;
   }else{
-    assert( bBulk==0 || bBulk==1 );
     if( iParentIdx==0 ){                 
       nxDiv = 0;
     }else if( iParentIdx==i ){
-      nxDiv = i-2+bBulk;
+      nxDiv = i-2+bTwo;
+    }else if( bTwo && pParent->nOverflow ){
+      /* Take the right sibling, so that the overflow cell, which has
+      ** index iParentIdx, is one of the dividers */
+      nxDiv = iParentIdx;
     }else{
       nxDiv = iParentIdx-1;
     }
-    i = 2-bBulk;
+    i = 2-bTwo;
   }
   nOld = i+1;
   if( (i+nxDiv-pParent->nOverflow)==pParent->nCell ){
@@ -7173,11 +8146,25 @@ static int balance_nonroot(
     /* Verify that all sibling pages are of the same "type" (table-leaf,
     ** table-interior, index-leaf, or index-interior).
     */
-    if( pOld->aData[0]!=apOld[0]->aData[0] ){
+    if( (pOld->aData[0] & ~PTF_PREFIX)!=(apOld[0]->aData[0] & ~PTF_PREFIX) ){
       rc = SQLITE_CORRUPT_BKPT;
       goto balance_cleanup;
     }
 
+    /* The cells of a prefix-compressed leaf are expanded into a separate
+    ** buffer, after which the page is cleared and becomes an ordinary,
+    ** empty, leaf.  So the block below finds no cells on it.  */
+    if( pOld->prefixLeaf ){
+      assert( pOld->nOverflow==0 );
+      rc = btreePrefixCells(pOld, &b.apCell[b.nCell], &b.szCell[b.nCell],
+                            &apExpand[i], &szExpand[i]);
+      if( rc==SQLITE_OK ) rc = sqlite3PagerWrite(pOld->pDbPage);
+      if( rc ) goto balance_cleanup;
+      b.nCell += pOld->nCell;
+      zeroPage(pOld, pOld->aData[0] & ~PTF_PREFIX);
+      limit = 0;
+    }
+
     /* Load b.apCell[] with pointers to all cells in pOld.  If pOld
     ** constains overflow cells, include them in the b.apCell[] array
     ** in the correct spot.
@@ -7271,7 +8258,7 @@ static int balance_nonroot(
   usableSpace = pBt->usableSize - 12 + leafCorrection;
   for(i=0; i<nOld; i++){
     MemPage *p = apOld[i];
-    szNew[i] = usableSpace - p->nFree;
+    szNew[i] = usableSpace - p->nFree + szExpand[i];
     if( szNew[i]<0 ){ rc = SQLITE_CORRUPT_BKPT; goto balance_cleanup; }
     for(j=0; j<p->nOverflow; j++){
       szNew[i] += 2 + p->xCellSize(p, p->apOvfl[j]);
@@ -7714,6 +8701,9 @@ static int balance_nonroot(
   */
 balance_cleanup:
   sqlite3ScratchFree(b.apCell);
+  for(i=0; i<NB; i++){
+    sqlite3_free(apExpand[i]);
+  }
   for(i=0; i<nOld; i++){
     releasePage(apOld[i]);
   }
@@ -7806,10 +8796,24 @@ static int balance(BtCursor *pCur){
   const int nMin = pCur->pBt->usableSize * 2 / 3;
   u8 aBalanceQuickSpace[13];
   u8 *pFree = 0;
+  int bAppend;            /* True if the new cell is the last in the b-tree */
+  int i;
 
   VVA_ONLY( int balance_quick_called = 0 );
   VVA_ONLY( int balance_deeper_called = 0 );
 
+  /* Decide once, at the page where the new cell was inserted, whether it
+  ** was appended to the right edge of the whole b-tree. It is not enough
+  ** for that page to be the right-most child of its parent. Random
+  ** inserts often land at the end of such a page, or of the page above
+  ** one, and packing those pages full makes them split again at once. */
+  bAppend = pCur->apPage[pCur->iPage]->nOverflow==1
+         && pCur->apPage[pCur->iPage]->aiOvfl[0]
+                                     ==pCur->apPage[pCur->iPage]->nCell;
+  for(i=0; bAppend && i<pCur->iPage; i++){
+    bAppend = pCur->aiIdx[i]==pCur->apPage[i]->nCell;
+  }
+
   do {
     int iPage = pCur->iPage;
     MemPage *pPage = pCur->apPage[iPage];
@@ -7833,7 +8837,9 @@ static int balance(BtCursor *pCur){
       }else{
         break;
       }
-    }else if( pPage->nOverflow==0 && pPage->nFree<=nMin ){
+    }else if( pPage->nOverflow==0 && (pPage->nFree<=nMin || pPage->prefixLeaf) ){
+      /* An underfull prefix-compressed leaf is left alone too, rather than
+      ** expanding it and its siblings only to reclaim a little space. */
       break;
     }else{
       MemPage * const pParent = pCur->apPage[iPage-1];
@@ -7883,10 +8889,17 @@ static int balance(BtCursor *pCur){
           ** the previous call, as the overflow cell data will have been 
           ** copied either into the body of a database page or into the new
           ** pSpace buffer passed to the latter call to balance_nonroot().
+          **
+          ** If the overflow cell was appended to the right-most page of the
+          ** b-tree, the inserts are most likely arriving in key order. In
+          ** that case pack the left sibling full, as for a bulk load, rather
+          ** than splitting evenly and leaving half-empty pages behind.
           */
           u8 *pSpace = sqlite3PageMalloc(pCur->pBt->pageSize);
+          int bPack = bAppend && pPage->nOverflow==1
+                              && pPage->aiOvfl[0]==pPage->nCell;
           rc = balance_nonroot(pParent, iIdx, pSpace, iPage==1,
-                               pCur->hints&BTREE_BULKLOAD);
+                               (pCur->hints&BTREE_BULKLOAD) | bPack);
           if( pFree ){
             /* If pFree is not NULL, it points to the pSpace buffer used 
             ** by a previous call to balance_nonroot(). Its contents are
@@ -7918,6 +8931,532 @@ static int balance(BtCursor *pCur){
 }
 
 
+/*
+** A bulk build.
+**
+** When a cursor with the BTREE_BULKLOAD hint inserts into an empty b-tree,
+** the keys usually arrive in sorted order: CREATE INDEX feeds the b-tree
+** from the sorter, and the transfer optimization copies an ordered source.
+** Rather than descending from the root for every row and letting
+** balance_nonroot() split pages that are then left half full, the builder
+** appends each cell to the right-most leaf, fills that leaf up to
+** BtShared.bulkFill percent, then pushes a divider cell into the level above
+** and starts the next leaf.  Interior levels are filled the same way as
+** their dividers arrive, and the root page is pushed down a level each time
+** it fills.  Pages are allocated in the order they are filled.
+**
+** The right-most page on each level stays pinned and writable in aLevel[],
+** and the right-child pointer of each interior page always refers to the
+** right-most page on the level below, so the b-tree is well formed after
+** every append.  The build ends, and the cursor reverts to ordinary
+** inserts, as soon as a key arrives out of order or the cursor is used for
+** anything other than appending.
+*/
+struct BtBulk {
+  int nLevel;                 /* Number of entries used in aLevel[] */
+  int szTarget;               /* Bytes of a page to fill before moving on */
+  Pgno iNearby;               /* Most recently allocated page */
+  i64 iLastKey;               /* Last key appended to an intkey b-tree */
+  u8 *aLastKey;               /* Last key appended to an index b-tree */
+  int nLastAlloc;             /* Allocated size of aLastKey[] */
+  UnpackedRecord *pLast;      /* aLastKey[] unpacked */
+  u8 *aPrefix;                /* Space to encode prefix-compressed cells */
+  int nExpand;                /* Space leaf cells would take uncompressed */
+  struct BtBulkLevel {
+    MemPage *pPage;             /* Right-most page on this level */
+    Pgno iPrev;                 /* Page before pPage, if btreeBulkRotate() due */
+    u8 *aDivider;               /* Space to build divider cells */
+  } aLevel[BTCURSOR_MAX_DEPTH]; /* aLevel[0] is the leaf level */
+};
+
+/*
+** Finish the bulk build on cursor pCur, releasing the pages it holds.
+** The b-tree is already complete, so this cannot fail.
+*/
+static void btreeBulkEnd(BtCursor *pCur){
+  BtBulk *p = pCur->pBulk;
+  int i;
+  assert( p!=0 );
+  for(i=0; i<p->nLevel; i++){
+    releasePage(p->aLevel[i].pPage);
+    sqlite3_free(p->aLevel[i].aDivider);
+  }
+  sqlite3_free(p->aLastKey);
+  sqlite3_free(p->aPrefix);
+  if( p->pLast ) sqlite3DbFree(pCur->pKeyInfo->db, p->pLast);
+  sqlite3_free(p);
+  pCur->pBulk = 0;
+}
+
+/*
+** Start a bulk build on cursor pCur if the b-tree allows one.  Whether or
+** not a build is started, no further attempt is made on this cursor.
+*/
+static int btreeBulkBegin(BtCursor *pCur){
+  BtShared *pBt = pCur->pBt;
+  MemPage *pRoot;
+  BtBulk *p;
+  char *pFree;
+  int rc;
+
+  pCur->curFlags |= BTCF_NoBulk;
+  if( pBt->bulkFill==0 || pCur->pgnoRoot<=1
+   || (pCur->curFlags & BTCF_Multiple)!=0
+   || IfNotOmitAV(pBt->autoVacuum)
+  ){
+    return SQLITE_OK;
+  }
+  rc = getAndInitPage(pBt, pCur->pgnoRoot, &pRoot, 0, 0);
+  if( rc ) return rc;
+  if( pRoot->nCell>0 || !pRoot->leaf
+   || pRoot->intKey!=(pCur->pKeyInfo==0)
+  ){
+    releasePage(pRoot);
+    return SQLITE_OK;
+  }
+  rc = sqlite3PagerWrite(pRoot->pDbPage);
+  if( rc ){
+    releasePage(pRoot);
+    return rc;
+  }
+  p = (BtBulk*)sqlite3MallocZero(sizeof(BtBulk));
+  if( p && pCur->pKeyInfo ){
+    p->pLast = sqlite3VdbeAllocUnpackedRecord(pCur->pKeyInfo, 0, 0, &pFree);
+    if( p->pLast==0 ){
+      sqlite3_free(p);
+      p = 0;
+    }
+  }
+  if( p && pCur->pKeyInfo && (pBt->btsFlags & BTS_PREFIX_KEYS)!=0 ){
+    /* Leaves of an index b-tree are built prefix-compressed */
+    p->aPrefix = (u8*)sqlite3Malloc(pBt->usableSize + 40);
+    if( p->aPrefix==0 || btreePrefixEnter(pCur) ){
+      sqlite3_free(p->aPrefix);
+      sqlite3DbFree(pCur->pKeyInfo->db, p->pLast);
+      sqlite3_free(p);
+      p = 0;
+    }
+  }
+  if( p==0 ){
+    releasePage(pRoot);
+    return SQLITE_NOMEM;
+  }
+  if( p->aPrefix ){
+    zeroPage(pRoot, PTF_ZERODATA|PTF_LEAF|PTF_PREFIX);
+    assert( pRoot->prefixLeaf );
+  }
+  p->nLevel = 1;
+  p->szTarget = pBt->usableSize*pBt->bulkFill/100;
+  p->iNearby = pCur->pgnoRoot;
+  p->aLevel[0].pPage = pRoot;
+  sqlite3BtreeClearCursor(pCur);
+  btreeReleaseAllCursorPages(pCur);
+  pCur->pBulk = p;
+  return SQLITE_OK;
+}
+
+/*
+** Encode the nKey byte index key pKey as a cell of a prefix-compressed
+** leaf, sharing what it can of the record header and body of pPrev, the
+** nPrev byte key of the cell before it.  If nPrev is zero, a restart
+** cell is written.  Write the cell to pOut and return its size.
+*/
+static int btreePrefixEncode(
+  const u8 *pKey, u32 nKey,       /* Key to encode */
+  const u8 *pPrev, u32 nPrev,     /* Key of the cell before, if any */
+  u8 *pOut                        /* OUT: The cell */
+){
+  u8 *pIter = pOut;
+  u32 nHdr;                       /* Size of the record header of pKey */
+  u32 nHdrPrev;                   /* Size of the record header of pPrev */
+  u32 nHdrShared = 0;             /* Header bytes shared with pPrev */
+  u32 nBodyShared = 0;            /* Body bytes shared with pPrev */
+
+  getVarint32(pKey, nHdr);
+  assert( nHdr<=nKey );
+  if( nPrev ){
+    u32 n;
+    getVarint32(pPrev, nHdrPrev);
+    assert( nHdrPrev<=nPrev );
+    n = MIN(nHdr, nHdrPrev);
+    while( nHdrShared<n && pKey[nHdrShared]==pPrev[nHdrShared] ){
+      nHdrShared++;
+    }
+    n = MIN(nKey-nHdr, nPrev-nHdrPrev);
+    while( nBodyShared<n && pKey[nHdr+nBodyShared]==pPrev[nHdrPrev+nBodyShared] ){
+      nBodyShared++;
+    }
+  }
+  pIter += putVarint32(pIter, nKey);
+  pIter += putVarint32(pIter, nHdrShared);
+  pIter += putVarint32(pIter, nHdr);
+  pIter += putVarint32(pIter, nBodyShared);
+  memcpy(pIter, &pKey[nHdrShared], nHdr-nHdrShared);
+  pIter += nHdr-nHdrShared;
+  memcpy(pIter, &pKey[nHdr+nBodyShared], nKey-nHdr-nBodyShared);
+  pIter += nKey-nHdr-nBodyShared;
+  return (int)(pIter - pOut);
+}
+
+/*
+** Page pPage on level iLevel of the bulk build on pCur was started with
+** a single cell X, after the last cell E of the page before it was
+** promoted to the divider between the two pages.  Now that another cell
+** is about to follow X, move E back into the earlier page and promote X
+** in its place, so that the earlier page keeps every cell it was filled
+** with.  pPage is left empty.  If X does not fit in the parent page in
+** place of E, nothing is changed.
+*/
+static int btreeBulkRotate(BtCursor *pCur, int iLevel){
+  BtBulk *p = pCur->pBulk;
+  BtShared *pBt = pCur->pBt;
+  MemPage *pPage = p->aLevel[iLevel].pPage;
+  MemPage *pParent = p->aLevel[iLevel+1].pPage;
+  MemPage *pPrev = 0;
+  u8 *aRestore = p->aLevel[iLevel].aDivider;  /* E as a cell of pPrev */
+  u8 *aDiv = &aRestore[pBt->pageSize];        /* X as a divider */
+  u8 *pOld;                                   /* E in pParent */
+  u8 *pX;                                     /* X in pPage */
+  int iOld = pParent->nCell-1;
+  int szOld, szX, szDiv, szRestore;
+  int rc;
+
+  assert( pPage->nCell==1 && pParent->nCell>0 );
+  pOld = findCell(pParent, iOld);
+  szOld = pParent->xCellSize(pParent, pOld);
+  assert( get4byte(pOld)==p->aLevel[iLevel].iPrev );
+  pX = findCell(pPage, 0);
+  szX = pPage->xCellSize(pPage, pX);
+  put4byte(aDiv, p->aLevel[iLevel].iPrev);
+  if( pPage->prefixLeaf ){
+    /* X is a restart cell, so it holds its whole key */
+    CellInfo info;
+    btreeParseCellPtrPrefix(pPage, pX, &info);
+    szDiv = putVarint32(&aDiv[4], info.nPayload);
+    memcpy(&aDiv[4+szDiv], info.pPayload, info.nPayload);
+  }else{
+    memcpy(&aDiv[4], &pX[pPage->childPtrSize], szX-pPage->childPtrSize);
+  }
+  szDiv = pParent->xCellSize(pParent, aDiv);
+  if( szDiv>szOld+pParent->nFree ) return SQLITE_OK;
+
+  rc = getAndInitPage(pBt, p->aLevel[iLevel].iPrev, &pPrev, 0, 0);
+  if( rc ) return rc;
+  if( pPrev->prefixLeaf ){
+    /* E goes back as a restart cell, which may be larger than the cell it
+    ** was promoted from.  Give up if it no longer fits. */
+    u32 nKey;
+    int nHdr = getVarint32(&pOld[4], nKey);
+    szRestore = btreePrefixEncode(&pOld[4+nHdr], nKey, 0, 0, aRestore);
+    if( szRestore+2>pPrev->nFree ){
+      releasePage(pPrev);
+      return SQLITE_OK;
+    }
+  }
+  rc = sqlite3PagerWrite(pPrev->pDbPage);
+  if( rc==SQLITE_OK ){
+    if( pPrev->prefixLeaf ){
+      /* aRestore[] already holds E */
+    }else if( pPrev->leaf ){
+      memcpy(&aRestore[4], &pOld[4], szOld-4);
+      aRestore += 4;
+    }else{
+      /* E regains the page's right-child, and X's left-child takes over */
+      memcpy(&aRestore[4], &pOld[4], szOld-4);
+      put4byte(aRestore, get4byte(&pPrev->aData[pPrev->hdrOffset+8]));
+      put4byte(&pPrev->aData[pPrev->hdrOffset+8], get4byte(pX));
+    }
+    szRestore = pPrev->xCellSize(pPrev, aRestore);
+    dropCell(pPage, 0, szX, &rc);
+    dropCell(pParent, iOld, szOld, &rc);
+    insertCell(pParent, iOld, aDiv, szDiv, 0, 0, &rc);
+    insertCell(pPrev, pPrev->nCell, aRestore, szRestore, 0, 0, &rc);
+  }
+  releasePage(pPrev);
+  return rc;
+}
+
+/*
+** Append the sz-byte cell pCell to the right-most page on level iLevel of
+** the bulk build on pCur.  On the leaf level pCell is a cell formatted by
+** fillInCell().  On interior levels it is a divider cell whose first four
+** bytes hold the left-child page number.
+**
+** If the page is already filled to the target, its last cell (or, on a
+** table leaf, its largest key) becomes a divider that is appended to the
+** level above, and pCell starts a new page.
+**
+** A prefix-compressed leaf is given the cell encoded against the key
+** before it.  Such a leaf is also full once its cells would need two
+** ordinary pages, the most balance_nonroot() can take from one sibling.
+*/
+static int btreeBulkAppend(BtCursor *pCur, int iLevel, u8 *pCell, int sz){
+  BtBulk *p = pCur->pBulk;
+  BtShared *pBt = pCur->pBt;
+  MemPage *pPage = p->aLevel[iLevel].pPage;
+  MemPage *pNew = 0;
+  MemPage *pParent;
+  Pgno pgnoNew;
+  u8 *pDiv;
+  int szDiv;
+  u8 *pKey = 0;                   /* Key of pCell on a prefix-compressed leaf */
+  u32 nKey = 0;                   /* Size of pKey[] */
+  u8 *pEnc = pCell;               /* Cell as it is stored on pPage */
+  int szEnc = sz;                 /* Size of pEnc[] */
+  int rc = SQLITE_OK;
+
+  if( p->aLevel[iLevel].iPrev ){
+    rc = btreeBulkRotate(pCur, iLevel);
+    p->aLevel[iLevel].iPrev = 0;
+    if( rc ) return rc;
+    if( pPage->nCell==0 ) p->nExpand = 0;
+  }
+  if( pPage->prefixLeaf ){
+    pKey = &pCell[getVarint32(pCell, nKey)];
+    szEnc = btreePrefixEncode(pKey, nKey, p->aLastKey,
+        (pPage->nCell % BTREE_PREFIX_RESTART) ? (u32)p->iLastKey : 0,
+        p->aPrefix
+    );
+    pEnc = p->aPrefix;
+  }
+  if( szEnc+2<=pPage->nFree
+   && (pPage->nCell<2 || (int)(pBt->usableSize-pPage->nFree)+szEnc+2<=p->szTarget)
+   && (pKey==0 || p->nExpand+sz+2<=2*(int)(pBt->usableSize-8))
+  ){
+    insertCell(pPage, pPage->nCell, pEnc, szEnc, 0, 0, &rc);
+    if( pKey ) p->nExpand += sz+2;
+    return rc;
+  }
+
+  /* Build the divider between pPage and the page that follows it. */
+  pDiv = p->aLevel[iLevel].aDivider;
+  if( pDiv==0 ){
+    pDiv = p->aLevel[iLevel].aDivider = sqlite3Malloc(2*pBt->pageSize);
+    if( pDiv==0 ) return SQLITE_NOMEM;
+  }
+  if( pPage->intKey && pPage->leaf ){
+    assert( pPage->nCell>0 );
+    putVarint(&pDiv[4], p->iLastKey);
+  }else{
+    int iLast = pPage->nCell-1;
+    u8 *pLast;
+    u16 szLast;
+    if( iLast<1 ) return SQLITE_CORRUPT_BKPT;
+    pLast = findCell(pPage, iLast);
+    szLast = pPage->xCellSize(pPage, pLast);
+    if( pPage->prefixLeaf ){
+      /* The last cell holds only part of its key, the last key appended */
+      int nHdr = putVarint32(&pDiv[4], (u32)p->iLastKey);
+      memcpy(&pDiv[4+nHdr], p->aLastKey, (size_t)p->iLastKey);
+    }else if( pPage->leaf ){
+      memcpy(&pDiv[4], pLast, szLast);
+    }else{
+      memcpy(pDiv, pLast, szLast);
+      put4byte(&pPage->aData[pPage->hdrOffset+8], get4byte(pLast));
+    }
+    dropCell(pPage, iLast, szLast, &rc);
+    if( rc ) return rc;
+  }
+
+  /* If pPage is the root, move its content to a new page and turn the
+  ** root into an interior page with the new page as its only child. */
+  if( iLevel==p->nLevel-1 ){
+    if( p->nLevel>=BTCURSOR_MAX_DEPTH ) return SQLITE_CORRUPT_BKPT;
+    rc = allocateBtreePage(pBt, &pNew, &pgnoNew, p->iNearby, BTALLOC_ANY);
+    if( rc ) return rc;
+    p->iNearby = pgnoNew;
+    copyNodeContent(pPage, pNew, &rc);
+    if( rc ){
+      releasePage(pNew);
+      return rc;
+    }
+    zeroPage(pPage, pPage->aData[pPage->hdrOffset] & ~(PTF_LEAF|PTF_PREFIX));
+    put4byte(&pPage->aData[pPage->hdrOffset+8], pgnoNew);
+    p->aLevel[iLevel+1].pPage = pPage;
+    p->aLevel[iLevel].pPage = pPage = pNew;
+    p->nLevel++;
+  }
+
+  pParent = p->aLevel[iLevel+1].pPage;
+  put4byte(pDiv, pPage->pgno);
+  szDiv = pParent->xCellSize(pParent, pDiv);
+  rc = btreeBulkAppend(pCur, iLevel+1, pDiv, szDiv);
+  if( rc ) return rc;
+
+  rc = allocateBtreePage(pBt, &pNew, &pgnoNew, p->iNearby, BTALLOC_ANY);
+  if( rc ) return rc;
+  p->iNearby = pgnoNew;
+  zeroPage(pNew, pPage->aData[pPage->hdrOffset]);
+  if( !pPage->intKey || !pPage->leaf ){
+    p->aLevel[iLevel].iPrev = pPage->pgno;
+  }
+  releasePage(pPage);
+  p->aLevel[iLevel].pPage = pNew;
+  pParent = p->aLevel[iLevel+1].pPage;
+  put4byte(&pParent->aData[pParent->hdrOffset+8], pgnoNew);
+  if( pKey ){
+    /* The first cell of a page is a restart cell */
+    szEnc = btreePrefixEncode(pKey, nKey, 0, 0, p->aPrefix);
+    p->nExpand = sz+2;
+  }
+  insertCell(pNew, 0, pEnc, szEnc, 0, 0, &rc);
+  return rc;
+}
+
+/*
+** Append an entry to the bulk build on pCur.  Return SQLITE_DONE, having
+** finished the build, if the key does not sort after every key appended
+** so far.  The caller then inserts the entry the ordinary way.
+**
+** Otherwise the cursor is left pointing at the new entry, which is the
+** last in the b-tree, so that sqlite3BtreeLast() and the rowid fast paths
+** in sqlite3BtreeInsert() and sqlite3BtreeMovetoUnpacked() need not seek.
+*/
+static int btreeBulkInsert(
+  BtCursor *pCur,                /* Cursor with a bulk build in progress */
+  const void *pKey, i64 nKey,    /* The key of the new record */
+  const void *pData, int nData,  /* The data of the new record */
+  int nZero                      /* Number of extra 0 bytes to append */
+){
+  BtBulk *p = pCur->pBulk;
+  BtShared *pBt = pCur->pBt;
+  MemPage *pLeaf = p->aLevel[0].pPage;
+  u8 *pCell = pBt->pTmpSpace;
+  int szCell = 0;
+  int rc;
+
+  if( pLeaf->prefixLeaf ){
+    /* Keys that overflow, or are not well-formed records, cannot be
+    ** stored on a prefix-compressed leaf.  Build the rest of the b-tree
+    ** the ordinary way. */
+    u32 nHdr = 0;
+    if( nKey>=2 ) getVarint32((const u8*)pKey, nHdr);
+    if( nKey>pLeaf->maxLocal || nHdr<1 || nHdr>nKey ){
+      rc = btreeBulkSave(pCur);
+      return rc ? rc : SQLITE_DONE;
+    }
+  }
+  if( pLeaf->nCell>0 ){
+    if( pLeaf->intKey ? nKey<=p->iLastKey
+        : sqlite3VdbeRecordCompare((int)nKey, pKey, p->pLast)<=0
+    ){
+      rc = btreeBulkSave(pCur);
+      return rc ? rc : SQLITE_DONE;
+    }
+  }
+
+  rc = fillInCell(pLeaf, pCell, pKey, nKey, pData, nData, nZero, &szCell);
+  if( rc==SQLITE_OK ){
+    assert( pLeaf->prefixLeaf || szCell==pLeaf->xCellSize(pLeaf, pCell) );
+    rc = btreeBulkAppend(pCur, 0, pCell, szCell);
+  }
+  if( rc==SQLITE_OK && pCur->pKeyInfo ){
+    if( nKey>p->nLastAlloc ){
+      u8 *aNew = sqlite3Realloc(p->aLastKey, nKey);
+      if( aNew==0 ){
+        rc = SQLITE_NOMEM;
+      }else{
+        p->aLastKey = aNew;
+        p->nLastAlloc = (int)nKey;
+      }
+    }
+    if( rc==SQLITE_OK ){
+      memcpy(p->aLastKey, pKey, (size_t)nKey);
+      sqlite3VdbeRecordUnpack(pCur->pKeyInfo, (int)nKey, p->aLastKey,
+                              p->pLast);
+    }
+  }
+  if( rc ){
+    btreeReleaseAllCursorPages(pCur);
+    pCur->eState = CURSOR_INVALID;
+    btreeBulkEnd(pCur);
+    return rc;
+  }
+  p->iLastKey = nKey;
+
+  pLeaf = p->aLevel[0].pPage;
+  if( pCur->iPage!=0 || pCur->apPage[0]!=pLeaf ){
+    btreeReleaseAllCursorPages(pCur);
+    sqlite3PagerRef(pLeaf->pDbPage);
+    pCur->apPage[0] = pLeaf;
+    pCur->iPage = 0;
+  }
+  pCur->aiIdx[0] = pLeaf->nCell-1;
+  pCur->eState = CURSOR_VALID;
+  pCur->info.nSize = 0;
+  pCur->iPrefixKey = 0;
+  pCur->curFlags &= ~BTCF_ValidOvfl;
+  pCur->curFlags |= BTCF_AtLast;
+  if( pLeaf->intKey ){
+    pCur->info.nKey = nKey;
+    pCur->curFlags |= BTCF_ValidNKey;
+  }else{
+    pCur->curFlags &= ~BTCF_ValidNKey;
+  }
+  return SQLITE_OK;
+}
+
+/*
+** The cursor points into a prefix-compressed leaf page.  Rewrite that
+** page in the ordinary index leaf format so that it may be modified.
+** The expanded cells that still fit are written back to the page and
+** the rest are inserted into the b-tree again, which splits the page.
+** The cursor is left pointing at no particular entry.
+*/
+static int btreePrefixDecompress(BtCursor *pCur){
+  BtShared *pBt = pCur->pBt;
+  MemPage *pPage = pCur->apPage[pCur->iPage];
+  int nCell = pPage->nCell;
+  int *aSize = 0;                 /* Size of each expanded key */
+  u8 *aKeys;                      /* The expanded keys, end to end */
+  i64 nTotal = 0;                 /* Total size of the expanded keys */
+  u8 *pKey;
+  int i;
+  int rc;
+
+  assert( pPage->prefixLeaf );
+  assert( pCur->aPrefixKey!=0 );
+  if( pCur->curFlags & BTCF_Multiple ){
+    rc = saveAllCursors(pBt, pCur->pgnoRoot, pCur);
+    if( rc ) return rc;
+  }
+  rc = sqlite3PagerWrite(pPage->pDbPage);
+  if( rc ) return rc;
+  for(i=0; i<nCell; i++){
+    int nKey = btreePrefixExpand(pCur, pPage, i);
+    if( nKey<2 ) return SQLITE_CORRUPT_BKPT;
+    nTotal += nKey;
+  }
+  if( nCell>0 ){
+    aSize = (int*)sqlite3Malloc(nCell*sizeof(int) + nTotal);
+    if( aSize==0 ) return SQLITE_NOMEM;
+  }
+  aKeys = (u8*)&aSize[nCell];
+  for(i=0, pKey=aKeys; i<nCell; i++){
+    aSize[i] = btreePrefixExpand(pCur, pPage, i);
+    memcpy(pKey, pCur->aPrefixKey, aSize[i]);
+    pKey += aSize[i];
+  }
+
+  zeroPage(pPage, PTF_ZERODATA|PTF_LEAF);
+  pCur->info.nSize = 0;
+  pCur->curFlags &= ~(BTCF_ValidNKey|BTCF_ValidOvfl|BTCF_AtLast);
+  for(i=0, pKey=aKeys; i<nCell && rc==SQLITE_OK; i++){
+    int sz;
+    rc = fillInCell(pPage, pBt->pTmpSpace, pKey, aSize[i], 0, 0, 0, &sz);
+    if( rc || sz+2>pPage->nFree ) break;
+    insertCell(pPage, i, pBt->pTmpSpace, sz, 0, 0, &rc);
+    pKey += aSize[i];
+  }
+  pCur->eState = CURSOR_INVALID;
+  for(; i<nCell && rc==SQLITE_OK; i++){
+    rc = sqlite3BtreeInsert(pCur, pKey, aSize[i], 0, 0, 0, 0, 0);
+    pKey += aSize[i];
+  }
+  sqlite3_free(aSize);
+  return rc;
+}
+
 /*
 ** Insert a new record into the BTree.  The key is given by (pKey,nKey)
 ** and the data is given by (pData,nData).  The cursor is used only to
@@ -7992,6 +9531,20 @@ int sqlite3BtreeInsert(
     if( rc ) return rc;
   }
 
+  /* A cursor hinted for a bulk load appends to an empty b-tree through
+  ** the bulk builder for as long as the keys arrive in order. */
+  if( pCur->hints & BTREE_BULKLOAD ){
+    if( pCur->pBulk==0 && (pCur->curFlags & BTCF_NoBulk)==0 ){
+      rc = btreeBulkBegin(pCur);
+      if( rc ) return rc;
+    }
+    if( pCur->pBulk ){
+      rc = btreeBulkInsert(pCur, pKey, nKey, pData, nData, nZero);
+      if( rc!=SQLITE_DONE ) return rc;
+      loc = 0;
+    }
+  }
+
   if( pCur->pKeyInfo==0 ){
     assert( pKey==0 );
     /* If this is an insert into a table b-tree, invalidate any incrblob 
@@ -7999,10 +9552,11 @@ int sqlite3BtreeInsert(
     invalidateIncrblobCursors(p, nKey, 0);
 
     /* If the cursor is currently on the last row and we are appending a
-    ** new row onto the end, set the "loc" to avoid an unnecessary
-    ** btreeMoveto() call */
-    if( (pCur->curFlags&BTCF_ValidNKey)!=0 && nKey>0
-      && pCur->info.nKey==nKey-1 ){
+    ** new row onto the end, or on the row just before the new one, set
+    ** the "loc" to avoid an unnecessary btreeMoveto() call */
+    if( (pCur->curFlags&BTCF_ValidNKey)!=0 && nKey>pCur->info.nKey
+     && ((pCur->curFlags&BTCF_AtLast)!=0 || pCur->info.nKey==nKey-1)
+    ){
        loc = -1;
     }else if( loc==0 ){
       rc = sqlite3BtreeMovetoUnpacked(pCur, 0, nKey, appendBias, &loc);
@@ -8012,6 +9566,11 @@ int sqlite3BtreeInsert(
     rc = btreeMoveto(pCur, pKey, nKey, appendBias, &loc);
     if( rc ) return rc;
   }
+  if( pCur->iPage>=0 && pCur->apPage[pCur->iPage]->prefixLeaf ){
+    rc = btreePrefixDecompress(pCur);
+    if( rc==SQLITE_OK ) rc = btreeMoveto(pCur, pKey, nKey, appendBias, &loc);
+    if( rc ) return rc;
+  }
   assert( pCur->eState==CURSOR_VALID || (pCur->eState==CURSOR_INVALID && loc) );
 
   pPage = pCur->apPage[pCur->iPage];
@@ -8041,15 +9600,22 @@ int sqlite3BtreeInsert(
       memcpy(newCell, oldCell, 4);
     }
     rc = clearCell(pPage, oldCell, &szOld);
-    dropCell(pPage, idx, szOld, &rc);
     if( rc ) goto end_insert;
-  }else if( loc<0 && pPage->nCell>0 ){
-    assert( pPage->leaf );
-    idx = ++pCur->aiIdx[pCur->iPage];
+    rc = overwriteCell(pPage, idx, szOld, newCell, szNew);
+    if( rc==SQLITE_DONE ){
+      rc = SQLITE_OK;
+      dropCell(pPage, idx, szOld, &rc);
+      insertCell(pPage, idx, newCell, szNew, 0, 0, &rc);
+    }
   }else{
-    assert( pPage->leaf );
+    if( loc<0 && pPage->nCell>0 ){
+      assert( pPage->leaf );
+      idx = ++pCur->aiIdx[pCur->iPage];
+    }else{
+      assert( pPage->leaf );
+    }
+    insertCell(pPage, idx, newCell, szNew, 0, 0, &rc);
   }
-  insertCell(pPage, idx, newCell, szNew, 0, 0, &rc);
   assert( rc!=SQLITE_OK || pPage->nCell>0 || pPage->nOverflow>0 );
 
   /* If no error has occurred and pPage has an overflow cell, call balance() 
@@ -8073,6 +9639,13 @@ int sqlite3BtreeInsert(
   ** row without seeking the cursor. This can be a big performance boost.
   */
   pCur->info.nSize = 0;
+  if( loc>0 ) pCur->curFlags &= ~BTCF_AtLast;
+  if( pCur->curIntKey && pCur->eState==CURSOR_VALID ){
+    /* The cursor is on the new row.  Keep its key so that the next
+    ** append can use the test above instead of a seek. */
+    pCur->info.nKey = nKey;
+    pCur->curFlags |= BTCF_ValidNKey;
+  }
   if( rc==SQLITE_OK && pPage->nOverflow ){
     pCur->curFlags &= ~(BTCF_ValidNKey);
     rc = balance(pCur);
@@ -8129,6 +9702,33 @@ int sqlite3BtreeDelete(BtCursor *pCur, u8 flags){
   assert( pCur->eState==CURSOR_VALID );
   assert( (flags & ~(BTREE_SAVEPOSITION | BTREE_AUXDELETE))==0 );
 
+  /* Finish any bulk build so that the entry is removed from a b-tree the
+  ** cursor has descended normally. */
+  if( pCur->pBulk ){
+    rc = btreeBulkSave(pCur);
+    if( rc==SQLITE_OK ) rc = btreeRestoreCursorPosition(pCur);
+    if( rc ) return rc;
+    if( pCur->eState!=CURSOR_VALID ) return SQLITE_CORRUPT_BKPT;
+  }
+
+  /* A prefix-compressed leaf is rewritten in the ordinary format before
+  ** an entry is removed from it.  Then the entry is found again.  */
+  if( pCur->apPage[pCur->iPage]->prefixLeaf ){
+    u8 *pKey;
+    int res = 0;
+    i64 nKey;
+    getCellInfo(pCur);
+    nKey = pCur->info.nKey;
+    pKey = (u8*)sqlite3Malloc(nKey);
+    if( pKey==0 ) return SQLITE_NOMEM;
+    memcpy(pKey, pCur->info.pPayload, (size_t)nKey);
+    rc = btreePrefixDecompress(pCur);
+    if( rc==SQLITE_OK ) rc = btreeMoveto(pCur, pKey, nKey, 0, &res);
+    sqlite3_free(pKey);
+    if( rc ) return rc;
+    if( res!=0 || pCur->eState!=CURSOR_VALID ) return SQLITE_CORRUPT_BKPT;
+  }
+
   iCellDepth = pCur->iPage;
   iCellIdx = pCur->aiIdx[iCellDepth];
   pPage = pCur->apPage[iCellDepth];
@@ -8209,8 +9809,27 @@ int sqlite3BtreeDelete(BtCursor *pCur, u8 flags){
     pTmp = pBt->pTmpSpace;
     assert( pTmp!=0 );
     rc = sqlite3PagerWrite(pLeaf->pDbPage);
-    insertCell(pPage, iCellIdx, pCell-4, nCell+4, pTmp, n, &rc);
-    dropCell(pLeaf, pLeaf->nCell-1, nCell, &rc);
+    if( pLeaf->prefixLeaf ){
+      /* Build an ordinary cell from the expanded key.  Removing the last
+      ** cell of a prefix-compressed leaf leaves the others intact. */
+      u8 *pNew;
+      int nKey, nHdr;
+      getCellInfo(pCur);
+      nKey = (int)pCur->info.nKey;
+      pNew = (u8*)sqlite3Malloc(nKey+13);
+      if( pNew==0 ) return SQLITE_NOMEM;
+      nHdr = 4 + putVarint32(&pNew[4], nKey);
+      memcpy(&pNew[nHdr], pCur->info.pPayload, nKey);
+      insertCell(pPage, iCellIdx, pNew, nHdr+nKey, pTmp, n, &rc);
+      sqlite3_free(pNew);
+      dropCell(pLeaf, pLeaf->nCell-1, nCell, &rc);
+      if( rc==SQLITE_OK && pLeaf->nCell==0 ){
+        zeroPage(pLeaf, PTF_ZERODATA|PTF_LEAF);
+      }
+    }else{
+      insertCell(pPage, iCellIdx, pCell-4, nCell+4, pTmp, n, &rc);
+      dropCell(pLeaf, pLeaf->nCell-1, nCell, &rc);
+    }
     if( rc ) return rc;
   }
 
@@ -8470,7 +10089,7 @@ static int clearDatabasePage(
   if( freePageFlag ){
     freePage(pPage, &rc);
   }else if( (rc = sqlite3PagerWrite(pPage->pDbPage))==0 ){
-    zeroPage(pPage, pPage->aData[hdr] | PTF_LEAF);
+    zeroPage(pPage, (pPage->aData[hdr] | PTF_LEAF) & ~PTF_PREFIX);
   }
 
 cleardatabasepage_out:
@@ -8710,9 +10329,17 @@ int sqlite3BtreeUpdateMeta(Btree *p, int idx, u32 iMeta){
   assert( p->inTrans==TRANS_WRITE );
   assert( pBt->pPage1!=0 );
   pP1 = pBt->pPage1->aData;
+  if( idx==BTREE_FILE_FORMAT && (pBt->btsFlags & BTS_PREFIX_KEYS)!=0
+   && iMeta<SQLITE_PREFIX_FILE_FORMAT
+  ){
+    /* The file may already hold prefix-compressed pages, so the format
+    ** number must not be lowered by, for example, ALTER TABLE. */
+    iMeta = get4byte(&pP1[36 + idx*4]);
+  }
   rc = sqlite3PagerWrite(pBt->pPage1->pDbPage);
   if( rc==SQLITE_OK ){
     put4byte(&pP1[36 + idx*4], iMeta);
+    if( idx==BTREE_FILE_FORMAT ) btreePrefixFormat(pBt, pP1);
 #ifndef SQLITE_OMIT_AUTOVACUUM
     if( idx==BTREE_INCR_VACUUM ){
       assert( pBt->autoVacuum || iMeta==0 );
@@ -8800,6 +10427,54 @@ int sqlite3BtreeCount(BtCursor *pCur, i64 *pnEntry){
 }
 #endif
 
+#ifndef SQLITE_OMIT_AGGSCAN
+/*
+** Cursor pCur points to an entry of an intkey table b-tree.  Describe
+** that entry and up to nMax-1 entries that follow it on the same leaf
+** page in aCell[], leave the cursor pointing at the last entry described
+** so that the next sqlite3BtreeNext() moves past them all, and return
+** the number of entries described.
+**
+** An entry whose record spills onto overflow pages is always the last
+** one described, so that the parts of it that are not at aCell[].pData
+** can be read through the cursor with sqlite3BtreeData().  The pData
+** pointers look directly into the cached page and are only valid until
+** the cursor moves.
+*/
+int sqlite3BtreeLeafCells(BtCursor *pCur, BtreeCell *aCell, int nMax){
+  MemPage *pPage;                      /* The leaf page */
+  CellInfo info;                       /* Parse of the current cell */
+  int iCell;                           /* Cell the cursor points at */
+  int n;                               /* Number of cells to describe */
+  int i;
+
+  assert( cursorOwnsBtShared(pCur) );
+  assert( pCur->eState==CURSOR_VALID );
+  assert( nMax>0 );
+  pPage = pCur->apPage[pCur->iPage];
+  assert( pPage->leaf && pPage->intKeyLeaf && !pPage->prefixLeaf );
+  iCell = pCur->aiIdx[pCur->iPage];
+  n = pPage->nCell - iCell;
+  if( n>nMax ) n = nMax;
+  for(i=0; i<n; ){
+    BtreeCell *p = &aCell[i++];
+    u32 amt;
+    pPage->xParseCell(pPage, findCell(pPage, iCell+i-1), &info);
+    p->nKey = info.nKey;
+    p->pData = info.pPayload;
+    p->nData = info.nPayload;
+    amt = info.pPayload<pPage->aDataEnd ?
+             (u32)(pPage->aDataEnd - info.pPayload) : 0;
+    p->nLocal = info.nLocal<amt ? info.nLocal : amt;
+    if( info.nLocal<info.nPayload ) break;
+  }
+  pCur->aiIdx[pCur->iPage] = (u16)(iCell+i-1);
+  pCur->info.nSize = 0;
+  pCur->curFlags &= ~(BTCF_ValidNKey|BTCF_ValidOvfl|BTCF_AtLast);
+  return i;
+}
+#endif
+
 /*
 ** Return the pager associated with a BTree.  This routine is used for
 ** testing and debugging only.
@@ -8808,6 +10483,31 @@ Pager *sqlite3BtreePager(Btree *p){
   return p->pBt->pPager;
 }
 
+/*
+** Parameter op must be one of SQLITE_DBSTATUS_DEFRAG, _DEFRAG_BYTES,
+** _SEEK_ROOT or _SEEK_NEARBY.  Add the value of the corresponding
+** statistic of the shared b-tree to *pnVal.  If reset is true, zero the
+** statistic afterwards.  The value added is capped so that the sum over
+** every database of a connection cannot overflow.
+*/
+void sqlite3BtreeDbStatus(Btree *p, int op, int reset, i64 *pnVal){
+  BtShared *pBt = p->pBt;
+  u64 *pStat;
+  sqlite3BtreeEnter(p);
+  switch( op ){
+    case SQLITE_DBSTATUS_DEFRAG:       pStat = &pBt->nDefrag;      break;
+    case SQLITE_DBSTATUS_DEFRAG_BYTES: pStat = &pBt->nDefragByte;  break;
+    case SQLITE_DBSTATUS_SEEK_ROOT:    pStat = &pBt->nSeekRoot;    break;
+    default:
+      assert( op==SQLITE_DBSTATUS_SEEK_NEARBY );
+      pStat = &pBt->nSeekNearby;
+      break;
+  }
+  *pnVal += (i64)MIN(*pStat, LARGEST_INT64/(SQLITE_MAX_ATTACHED+2));
+  if( reset ) *pStat = 0;
+  sqlite3BtreeLeave(p);
+}
+
 #ifndef SQLITE_OMIT_INTEGRITY_CHECK
 /*
 ** Append a message to the error message string.
@@ -9475,7 +11175,7 @@ int sqlite3BtreeCheckpoint(Btree *p, int eMode, int *pnLog, int *pnCkpt){
     if( pBt->inTransaction!=TRANS_NONE ){
       rc = SQLITE_LOCKED;
     }else{
-      rc = sqlite3PagerCheckpoint(pBt->pPager, eMode, pnLog, pnCkpt);
+      rc = sqlite3PagerCheckpoint(pBt->pPager, p->db, eMode, pnLog, pnCkpt);
     }
     sqlite3BtreeLeave(p);
   }
@@ -64,6 +64,9 @@ int sqlite3BtreeOpen(
 int sqlite3BtreeClose(Btree*);
 int sqlite3BtreeSetCacheSize(Btree*,int);
 int sqlite3BtreeSetSpillSize(Btree*,int);
+int sqlite3BtreeSetReadahead(Btree*,int);
+int sqlite3BtreeSetBulkFill(Btree*,int);
+int sqlite3BtreeSetDurability(Btree*,int);
 #if SQLITE_MAX_MMAP_SIZE>0
   int sqlite3BtreeSetMmapLimit(Btree*,sqlite3_int64);
 #endif
@@ -183,8 +186,10 @@ int sqlite3BtreeNewDb(Btree *p);
 ** Values that may be OR'd together to form the argument to the
 ** BTREE_HINT_FLAGS hint for sqlite3BtreeCursorHint():
 **
-** The BTREE_BULKLOAD flag is set on index cursors when the index is going
-** to be filled with content that is already in sorted order.
+** The BTREE_BULKLOAD flag is set on cursors when the b-tree is going
+** to be filled with content that is likely already in sorted order.  If
+** the b-tree is empty, the btree layer then builds it bottom-up with full
+** pages for as long as the keys do arrive in order.
 **
 ** The BTREE_SEEK_EQ flag is set on cursors that will get OP_SeekGE or
 ** OP_SeekLE opcodes for a range search, but where the range of entries
@@ -192,7 +197,7 @@ int sqlite3BtreeNewDb(Btree *p);
 ** be used only for equality key searches.
 **
 */
-#define BTREE_BULKLOAD 0x00000001  /* Used to full index in sorted order */
+#define BTREE_BULKLOAD 0x00000001  /* Used to fill a b-tree in sorted order */
 #define BTREE_SEEK_EQ  0x00000002  /* EQ seeks only - no range seeks */
 
 /* 
@@ -268,6 +273,7 @@ int sqlite3BtreeData(BtCursor*, u32 offset, u32 amt, void*);
 
 char *sqlite3BtreeIntegrityCheck(Btree*, int *aRoot, int nRoot, int, int*);
 struct Pager *sqlite3BtreePager(Btree*);
+void sqlite3BtreeDbStatus(Btree*, int, int, i64*);
 
 int sqlite3BtreePutData(BtCursor*, u32 offset, u32 amt, void*);
 void sqlite3BtreeIncrblobCursor(BtCursor *);
@@ -285,6 +291,21 @@ int sqlite3BtreeCursorIsValid(BtCursor*);
 int sqlite3BtreeCount(BtCursor *, i64 *);
 #endif
 
+#ifndef SQLITE_OMIT_AGGSCAN
+/*
+** An entry of a table b-tree leaf page as described by
+** sqlite3BtreeLeafCells().
+*/
+typedef struct BtreeCell BtreeCell;
+struct BtreeCell {
+  i64 nKey;             /* The integer key (rowid) of the entry */
+  const u8 *pData;      /* The record, as stored on the leaf page */
+  u32 nLocal;           /* Bytes of the record readable at pData */
+  u32 nData;            /* Total size of the record */
+};
+int sqlite3BtreeLeafCells(BtCursor*, BtreeCell *aCell, int nMax);
+#endif
+
 #ifdef SQLITE_TEST
 int sqlite3BtreeCursorInfo(BtCursor*, int*, int);
 void sqlite3BtreeCursorList(Btree*);
@@ -232,6 +232,8 @@
 typedef struct MemPage MemPage;
 typedef struct BtLock BtLock;
 typedef struct CellInfo CellInfo;
+typedef struct BtBulk BtBulk;
+typedef struct BtKeyCache BtKeyCache;
 
 /*
 ** This is a magic string that appears at the beginning of every
@@ -257,6 +259,35 @@ typedef struct CellInfo CellInfo;
 #define PTF_ZERODATA  0x02
 #define PTF_LEAFDATA  0x04
 #define PTF_LEAF      0x08
+#define PTF_PREFIX    0x10
+
+/*
+** Prefix-compressed index leaves.
+**
+** In a database whose schema format number is SQLITE_PREFIX_FILE_FORMAT or
+** more, an index leaf page may carry the PTF_PREFIX flag (page type 0x1a).
+** Each cell on such a page shares a prefix of the record header and a
+** prefix of the record body with the key before it, and stores only the
+** rest:
+**
+**    varint   Size of the whole record in bytes
+**    varint   Bytes of the header shared with the previous key
+**    varint   Size of the record header in bytes
+**    varint   Bytes of the body shared with the previous key
+**    bytes    Rest of the header, then rest of the body
+**
+** Every BTREE_PREFIX_RESTART-th cell, starting with the first, is a restart
+** cell that shares nothing, so its record is stored whole.  A search does a
+** binary search over the restart cells and then expands the cells of a
+** single run.  Cells never spill onto overflow pages.
+**
+** Prefix-compressed leaves are written only by a bulk build.  They are not
+** modified in place: before a cell is inserted into or deleted from one,
+** the page is rewritten in the ordinary format.  So that a page can always
+** be balanced with a neighbour, the ordinary-format cells of one page never
+** need more than two pages.
+*/
+#define BTREE_PREFIX_RESTART 16
 
 /*
 ** As each page of the file is loaded into memory, an instance of the following
@@ -281,6 +312,7 @@ struct MemPage {
   u8 childPtrSize;     /* 0 if leaf==1.  4 if leaf==0 */
   u8 max1bytePayload;  /* min(maxLocal,127) */
   u8 bBusy;            /* Prevent endless loops on corrupt database files */
+  u8 prefixLeaf;       /* True if cells are prefix-compressed (PTF_PREFIX) */
   u16 maxLocal;        /* Copy of BtShared.maxLocal or BtShared.maxLeaf */
   u16 minLocal;        /* Copy of BtShared.minLocal or BtShared.minLeaf */
   u16 cellOffset;      /* Index in aData of first cell pointer */
@@ -375,6 +407,35 @@ struct Btree {
 #define TRANS_READ  1
 #define TRANS_WRITE 2
 
+/*
+** The integer keys of a table b-tree page, decoded into an array so that
+** sqlite3BtreeMovetoUnpacked() can search them without parsing a varint
+** per probe.  BtShared.aKeyCache[] is a small direct-mapped cache of these
+** arrays indexed by page number.  A slot is claimed the first time a page
+** is searched and its array is built once the same page has been searched
+** a few more times, so pages that are rarely visited pay almost nothing.
+**
+** An entry is discarded whenever the content of its page is modified or
+** reloaded (see btreeKeyCacheDrop()).  nHit is a small saturating count
+** of searches that used the entry.  Searches of other pages that map to
+** the same slot decrement it, and the slot is taken over once it is zero.
+*/
+struct BtKeyCache {
+  Pgno pgno;            /* Page the keys belong to, or 0 if slot unused */
+  u16 nKey;             /* Number of keys in aKey[] (== MemPage.nCell) */
+  u8 bValid;            /* True once aKey[] holds the keys of page pgno */
+  u8 nHit;              /* Recent searches of this page */
+  int nAlloc;           /* Number of slots allocated in aKey[] */
+  i64 *aKey;            /* Integer key of each cell, in cell order */
+};
+
+/*
+** Number of slots in BtShared.aKeyCache[].  Zero disables the key cache.
+*/
+#ifndef SQLITE_BTREE_KEYCACHE
+# define SQLITE_BTREE_KEYCACHE 64
+#endif
+
 /*
 ** An instance of this object represents a single database file.
 ** 
@@ -423,6 +484,7 @@ struct BtShared {
 #endif
   u8 inTransaction;     /* Transaction state */
   u8 max1bytePayload;   /* Maximum first byte of cell for a 1-byte payload */
+  u8 bulkFill;          /* Percent of each page filled by a bulk build */
 #ifdef SQLITE_HAS_CODEC
   u8 optimalReserve;    /* Desired amount of reserved space per page */
 #endif
@@ -446,6 +508,13 @@ struct BtShared {
   Btree *pWriter;       /* Btree with currently open write transaction */
 #endif
   u8 *pTmpSpace;        /* Temp space sufficient to hold a single cell */
+  u64 nDefrag;          /* Number of page defragmentations */
+  u64 nDefragByte;      /* Bytes of cell content moved by defragmentation */
+  u64 nSeekRoot;        /* Seeks that descended from the root page */
+  u64 nSeekNearby;      /* Table seeks satisfied from the current leaf */
+#if SQLITE_BTREE_KEYCACHE>0
+  BtKeyCache aKeyCache[SQLITE_BTREE_KEYCACHE];  /* Decoded intkey pages */
+#endif
 };
 
 /*
@@ -458,6 +527,7 @@ struct BtShared {
 #define BTS_NO_WAL           0x0010   /* Do not open write-ahead-log files */
 #define BTS_EXCLUSIVE        0x0020   /* pWriter has an exclusive lock */
 #define BTS_PENDING          0x0040   /* Waiting for read-locks to clear */
+#define BTS_PREFIX_KEYS      0x0080   /* Index leaves may be prefix-compressed */
 
 /*
 ** An instance of the following structure is used to hold information
@@ -483,6 +553,15 @@ struct CellInfo {
 */
 #define BTCURSOR_MAX_DEPTH 20
 
+/*
+** The percentage of each page that a bulk build (see BtBulk in btree.c)
+** fills before starting the next page.  This is the default for the
+** "PRAGMA bulk_fill" setting.  Zero disables bulk builds.
+*/
+#ifndef SQLITE_DEFAULT_BULK_FILL
+# define SQLITE_DEFAULT_BULK_FILL 100
+#endif
+
 /*
 ** A cursor is a pointer to a particular entry within a particular
 ** b-tree within a database file.
@@ -507,11 +586,15 @@ struct BtCursor {
   BtShared *pBt;            /* The BtShared this cursor points to */
   BtCursor *pNext;          /* Forms a linked list of all cursors */
   Pgno *aOverflow;          /* Cache of overflow page locations */
+  BtBulk *pBulk;            /* Bulk build in progress, or NULL */
+  u8 *aPrefixKey;           /* Key expanded from a prefix-compressed cell */
   CellInfo info;            /* A parse of the cell we are pointing at */
   i64 nKey;                 /* Size of pKey, or last integer key */
   void *pKey;               /* Saved key that was cursor last known position */
   Pgno pgnoRoot;            /* The root page of this tree */
   int nOvflAlloc;           /* Allocated size of aOverflow[] array */
+  int nPrefixKey;           /* Size of the key in aPrefixKey[] */
+  int iPrefixKey;           /* One more than the cell in aPrefixKey[], or 0 */
   int skipNext;    /* Prev() is noop if negative. Next() is noop if positive.
                    ** Error code if eState==CURSOR_FAULT */
   u8 curFlags;              /* zero or more BTCF_* flags defined below */
@@ -524,7 +607,6 @@ struct BtCursor {
   i8 iPage;                 /* Index of current page in apPage */
   u8 curIntKey;             /* Value of apPage[0]->intKey */
   struct KeyInfo *pKeyInfo; /* Argument passed to comparison function */
-  void *padding1;           /* Make object size a multiple of 16 */
   u16 aiIdx[BTCURSOR_MAX_DEPTH];        /* Current index in apPage[i] */
   MemPage *apPage[BTCURSOR_MAX_DEPTH];  /* Pages from root to current page */
 };
@@ -538,6 +620,7 @@ struct BtCursor {
 #define BTCF_AtLast       0x08   /* Cursor is pointing ot the last entry */
 #define BTCF_Incrblob     0x10   /* True if an incremental I/O handle */
 #define BTCF_Multiple     0x20   /* Maybe another cursor on the same btree */
+#define BTCF_NoBulk       0x40   /* Do not start a bulk build */
 
 /*
 ** Potential values for BtCursor.eState.
@@ -224,6 +224,15 @@ int sqlcipher_codec_pragma(sqlite3* db, int iDb, Parse *pParse, const char *zLef
       sqlite3_free(default_use_hmac);
     }
   }else
+  if( sqlite3StrICmp(zLeft,"cipher_temp_encryption")==0 ){
+    if( zRight ) {
+      sqlcipher_set_temp_encryption(sqlite3GetBoolean(zRight,0));
+    } else {
+      char *temp_encryption = sqlite3_mprintf("%d", sqlcipher_get_temp_encryption());
+      codec_vdbe_return_static_string(pParse, "cipher_temp_encryption", temp_encryption);
+      sqlite3_free(temp_encryption);
+    }
+  }else
   if( sqlite3StrICmp(zLeft,"cipher_use_hmac")==0 ){
     if(ctx) {
       if( zRight ) {
@@ -100,6 +100,18 @@
 #define CIPHER_MAX_KEY_SZ 64
 #endif
 
+/* temporary file encryption is off by default, and can be turned on at 
+   runtime with PRAGMA cipher_temp_encryption */
+#ifndef SQLCIPHER_TEMP_ENCRYPTION
+#define SQLCIPHER_TEMP_ENCRYPTION 0
+#endif
+
+/* size of the keystream unit used for temporary file encryption. Each
+   read or write generates keystream for every chunk it touches */
+#ifndef SQLCIPHER_TEMP_CHUNK_SZ
+#define SQLCIPHER_TEMP_CHUNK_SZ 1024
+#endif
+
 
 #ifdef CODEC_DEBUG
 #define CODEC_TRACE(X)  {printf X;fflush(stdout);}
@@ -241,6 +253,12 @@ static void sqlcipher_codec_get_pass(codec_ctx *ctx, void **zKey, int *nKey);
 static void sqlcipher_codec_set_store_pass(codec_ctx *ctx, int value);
 int sqlcipher_codec_fips_status(codec_ctx *ctx);
 const char* sqlcipher_codec_get_provider_version(codec_ctx *ctx);
+
+/* temporary file encryption */
+void sqlcipher_set_temp_encryption(int enable);
+int sqlcipher_get_temp_encryption();
+int sqlcipher_temp_file_wanted(sqlite3_vfs *pVfs, int flags);
+int sqlcipher_temp_file_open(sqlite3_vfs *pVfs, const char *zName, sqlite3_file *pFile, int flags, int *pOutFlags);
 #endif
 #endif
 /* END SQLCIPHER */
@@ -71,6 +71,7 @@ static unsigned int default_flags = DEFAULT_CIPHER_FLAGS;
 static unsigned char hmac_salt_mask = HMAC_SALT_MASK;
 static int default_kdf_iter = PBKDF2_ITER;
 static int default_page_size = SQLITE_DEFAULT_PAGE_SIZE;
+static int default_temp_encryption = SQLCIPHER_TEMP_ENCRYPTION;
 static unsigned int sqlcipher_activate_count = 0;
 static sqlite3_mutex* sqlcipher_provider_mutex = NULL;
 static sqlcipher_provider *default_provider = NULL;
@@ -1225,6 +1226,240 @@ static void sqlcipher_profile_callback(void *file, const char *sql, sqlite3_uint
   if( f ) fprintf(f, "Elapsed time:%.3f ms - %s\n", elapsed, sql);
 }
 
+/* 
+  * Temporary file encryption. 
+  *
+  * When enabled, every temporary file that is deleted on close (sorter spill
+  * files, statement journals, temporary and transient databases and their
+  * journals) is wrapped in a sqlcipher_temp_file. Data is XORed with an 
+  * AES-OFB keystream under a random key that is generated when the file is
+  * opened and never leaves memory. The keystream is produced in chunks of
+  * SQLCIPHER_TEMP_CHUNK_SZ bytes by CBC encrypting a block of zeros, using
+  * the chunk number and a per-file nonce as IV, so any byte range of the
+  * file can be read or written independently. There is no HMAC and no
+  * per-page reserve, since temporary files never outlive the process.
+  */
+typedef struct {
+  sqlcipher_provider *provider;
+  void *provider_ctx;
+  int key_sz;
+  int iv_sz;
+  unsigned char key[CIPHER_MAX_KEY_SZ];
+  unsigned char nonce[8];
+  unsigned char zero[SQLCIPHER_TEMP_CHUNK_SZ];
+  unsigned char stream[SQLCIPHER_TEMP_CHUNK_SZ];
+  unsigned char *buffer;       /* scratch space for encrypting writes */
+  int buffer_sz;
+  sqlite3_file *pReal;         /* the underlying temporary file */
+} sqlcipher_temp_ctx;
+
+typedef struct {
+  sqlite3_file base;           /* base class, must be first */
+  sqlcipher_temp_ctx *ctx;
+} sqlcipher_temp_file;
+
+void sqlcipher_set_temp_encryption(int enable) {
+  default_temp_encryption = enable;
+}
+
+int sqlcipher_get_temp_encryption() {
+  return default_temp_encryption;
+}
+
+/* XOR n bytes at a with the keystream for file offset iOff */
+static int sqlcipher_temp_xor(sqlcipher_temp_ctx *ctx, sqlite3_int64 iOff, unsigned char *a, int n) {
+  unsigned char iv[CIPHER_MAX_IV_SZ];
+  while(n > 0) {
+    sqlite3_int64 chunk = iOff / SQLCIPHER_TEMP_CHUNK_SZ;
+    int start = (int)(iOff % SQLCIPHER_TEMP_CHUNK_SZ);
+    int amt = SQLCIPHER_TEMP_CHUNK_SZ - start;
+    int i;
+    if(amt > n) amt = n;
+
+    memset(iv, 0, sizeof(iv));
+    memcpy(iv, ctx->nonce, sizeof(ctx->nonce));
+    sqlite3Put4byte(&iv[8], (u32)(chunk>>32));
+    sqlite3Put4byte(&iv[12], (u32)chunk);
+    if(ctx->provider->cipher(ctx->provider_ctx, CIPHER_ENCRYPT, ctx->key, ctx->key_sz, iv,
+                             ctx->zero, SQLCIPHER_TEMP_CHUNK_SZ, ctx->stream) != SQLITE_OK) {
+      return SQLITE_IOERR;
+    }
+    for(i = 0; i < amt; i++) a[i] ^= ctx->stream[start + i];
+
+    a += amt;
+    n -= amt;
+    iOff += amt;
+  }
+  return SQLITE_OK;
+}
+
+static int sqlcipher_temp_close(sqlite3_file *pFile) {
+  sqlcipher_temp_ctx *ctx = ((sqlcipher_temp_file*)pFile)->ctx;
+  int rc = sqlite3OsClose(ctx->pReal);
+  ctx->provider->ctx_free(&ctx->provider_ctx);
+  sqlcipher_free(ctx->buffer, ctx->buffer_sz);
+  sqlcipher_free(ctx, sizeof(sqlcipher_temp_ctx));
+  pFile->pMethods = 0;
+  sqlcipher_deactivate();
+  return rc;
+}
+
+static int sqlcipher_temp_read(sqlite3_file *pFile, void *zBuf, int iAmt, sqlite3_int64 iOff) {
+  sqlcipher_temp_ctx *ctx = ((sqlcipher_temp_file*)pFile)->ctx;
+  int n = iAmt;
+  int rc = sqlite3OsRead(ctx->pReal, zBuf, iAmt, iOff);
+  if(rc == SQLITE_IOERR_SHORT_READ) {
+    /* only decrypt the bytes that were actually read, the rest of the 
+       buffer has been zero filled and must stay that way */
+    sqlite3_int64 sz = 0;
+    if(sqlite3OsFileSize(ctx->pReal, &sz) != SQLITE_OK) return SQLITE_IOERR_READ;
+    n = (sz > iOff) ? (int)MIN(sz - iOff, iAmt) : 0;
+  } else if(rc != SQLITE_OK) {
+    return rc;
+  }
+  if(n > 0 && sqlcipher_temp_xor(ctx, iOff, (unsigned char*)zBuf, n) != SQLITE_OK) {
+    return SQLITE_IOERR_READ;
+  }
+  return rc;
+}
+
+static int sqlcipher_temp_write(sqlite3_file *pFile, const void *zBuf, int iAmt, sqlite3_int64 iOff) {
+  sqlcipher_temp_ctx *ctx = ((sqlcipher_temp_file*)pFile)->ctx;
+  if(iAmt > ctx->buffer_sz) {
+    unsigned char *buffer = sqlcipher_malloc(iAmt);
+    if(buffer == NULL) return SQLITE_IOERR_NOMEM;
+    sqlcipher_free(ctx->buffer, ctx->buffer_sz);
+    ctx->buffer = buffer;
+    ctx->buffer_sz = iAmt;
+  }
+  memcpy(ctx->buffer, zBuf, iAmt);
+  if(sqlcipher_temp_xor(ctx, iOff, ctx->buffer, iAmt) != SQLITE_OK) return SQLITE_IOERR_WRITE;
+  return sqlite3OsWrite(ctx->pReal, ctx->buffer, iAmt, iOff);
+}
+
+static int sqlcipher_temp_truncate(sqlite3_file *pFile, sqlite3_int64 size) {
+  return sqlite3OsTruncate(((sqlcipher_temp_file*)pFile)->ctx->pReal, size);
+}
+
+static int sqlcipher_temp_sync(sqlite3_file *pFile, int flags) {
+  return sqlite3OsSync(((sqlcipher_temp_file*)pFile)->ctx->pReal, flags);
+}
+
+static int sqlcipher_temp_file_size(sqlite3_file *pFile, sqlite3_int64 *pSize) {
+  return sqlite3OsFileSize(((sqlcipher_temp_file*)pFile)->ctx->pReal, pSize);
+}
+
+static int sqlcipher_temp_lock(sqlite3_file *pFile, int lock) {
+  return sqlite3OsLock(((sqlcipher_temp_file*)pFile)->ctx->pReal, lock);
+}
+
+static int sqlcipher_temp_unlock(sqlite3_file *pFile, int lock) {
+  return sqlite3OsUnlock(((sqlcipher_temp_file*)pFile)->ctx->pReal, lock);
+}
+
+static int sqlcipher_temp_check_reserved_lock(sqlite3_file *pFile, int *pResOut) {
+  return sqlite3OsCheckReservedLock(((sqlcipher_temp_file*)pFile)->ctx->pReal, pResOut);
+}
+
+static int sqlcipher_temp_file_control(sqlite3_file *pFile, int op, void *pArg) {
+  return sqlite3OsFileControl(((sqlcipher_temp_file*)pFile)->ctx->pReal, op, pArg);
+}
+
+static int sqlcipher_temp_sector_size(sqlite3_file *pFile) {
+  return sqlite3OsSectorSize(((sqlcipher_temp_file*)pFile)->ctx->pReal);
+}
+
+static int sqlcipher_temp_device_characteristics(sqlite3_file *pFile) {
+  return sqlite3OsDeviceCharacteristics(((sqlcipher_temp_file*)pFile)->ctx->pReal);
+}
+
+/* version 1 methods: no shared memory and no memory mapping, so every read
+   of a temporary file goes through sqlcipher_temp_read */
+static const sqlite3_io_methods sqlcipher_temp_io_methods = {
+  1,                                     /* iVersion */
+  sqlcipher_temp_close,                  /* xClose */
+  sqlcipher_temp_read,                   /* xRead */
+  sqlcipher_temp_write,                  /* xWrite */
+  sqlcipher_temp_truncate,               /* xTruncate */
+  sqlcipher_temp_sync,                   /* xSync */
+  sqlcipher_temp_file_size,              /* xFileSize */
+  sqlcipher_temp_lock,                   /* xLock */
+  sqlcipher_temp_unlock,                 /* xUnlock */
+  sqlcipher_temp_check_reserved_lock,    /* xCheckReservedLock */
+  sqlcipher_temp_file_control,           /* xFileControl */
+  sqlcipher_temp_sector_size,            /* xSectorSize */
+  sqlcipher_temp_device_characteristics, /* xDeviceCharacteristics */
+  0,                                     /* xShmMap */
+  0,                                     /* xShmLock */
+  0,                                     /* xShmBarrier */
+  0,                                     /* xShmUnmap */
+  0,                                     /* xFetch */
+  0,                                     /* xUnfetch */
+  0                                      /* xWriteV */
+};
+
+/*
+  * Return true if a file opened with flags should be encrypted with an
+  * ephemeral key. Only files that are deleted on close qualify.
+  */
+int sqlcipher_temp_file_wanted(sqlite3_vfs *pVfs, int flags) {
+  const int temp_types = SQLITE_OPEN_TEMP_DB | SQLITE_OPEN_TEMP_JOURNAL
+                       | SQLITE_OPEN_SUBJOURNAL | SQLITE_OPEN_TRANSIENT_DB;
+  return default_temp_encryption
+      && (flags & SQLITE_OPEN_DELETEONCLOSE) != 0
+      && (flags & temp_types) != 0
+      && pVfs->szOsFile >= (int)sizeof(sqlcipher_temp_file);
+}
+
+/*
+  * Open a temporary file through pVfs and wrap it in a sqlcipher_temp_file
+  * stored in pFile, which must be at least pVfs->szOsFile bytes.
+  */
+int sqlcipher_temp_file_open(sqlite3_vfs *pVfs, const char *zName, sqlite3_file *pFile, int flags, int *pOutFlags) {
+  sqlcipher_temp_file *p = (sqlcipher_temp_file*)pFile;
+  sqlcipher_temp_ctx *ctx;
+  int rc;
+
+  assert(sqlcipher_temp_file_wanted(pVfs, flags));
+  pFile->pMethods = 0;
+
+  ctx = sqlcipher_malloc(sizeof(sqlcipher_temp_ctx));
+  if(ctx == NULL) return SQLITE_NOMEM;
+  ctx->pReal = (sqlite3_file*)sqlite3MallocZero(pVfs->szOsFile);
+  if(ctx->pReal == NULL) {
+    sqlcipher_free(ctx, sizeof(sqlcipher_temp_ctx));
+    return SQLITE_NOMEM;
+  }
+
+  sqlcipher_activate();
+  ctx->provider = sqlcipher_get_provider();
+  if((rc = ctx->provider->ctx_init(&ctx->provider_ctx)) != SQLITE_OK) goto open_failed;
+  if((rc = ctx->provider->set_cipher(ctx->provider_ctx, CIPHER)) != SQLITE_OK) goto open_failed;
+  ctx->key_sz = ctx->provider->get_key_sz(ctx->provider_ctx);
+  ctx->iv_sz = ctx->provider->get_iv_sz(ctx->provider_ctx);
+  if(ctx->key_sz > CIPHER_MAX_KEY_SZ || ctx->iv_sz != CIPHER_MAX_IV_SZ) {
+    rc = SQLITE_ERROR;
+    goto open_failed;
+  }
+  if((rc = ctx->provider->random(ctx->provider_ctx, ctx->key, ctx->key_sz)) != SQLITE_OK) goto open_failed;
+  if((rc = ctx->provider->random(ctx->provider_ctx, ctx->nonce, sizeof(ctx->nonce))) != SQLITE_OK) goto open_failed;
+
+  rc = pVfs->xOpen(pVfs, zName, ctx->pReal, flags, pOutFlags);
+  if(rc != SQLITE_OK) goto open_failed;
+
+  CODEC_TRACE(("sqlcipher_temp_file_open: wrapped temp file %p flags=%x\n", pFile, flags));
+  p->ctx = ctx;
+  pFile->pMethods = &sqlcipher_temp_io_methods;
+  return SQLITE_OK;
+
+open_failed:
+  if(ctx->provider_ctx) ctx->provider->ctx_free(&ctx->provider_ctx);
+  sqlite3_free(ctx->pReal);
+  sqlcipher_free(ctx, sizeof(sqlcipher_temp_ctx));
+  sqlcipher_deactivate();
+  return rc;
+}
+
 int sqlcipher_codec_fips_status(codec_ctx *ctx) {
   return ctx->read_ctx->provider->fips_status(ctx->read_ctx);
 }
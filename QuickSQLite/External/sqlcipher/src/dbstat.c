@@ -68,7 +68,9 @@
   "  mx_payload INTEGER,          /* Largest payload size of all cells */"  \
   "  pgoffset   INTEGER,          /* Offset of page in file */"             \
   "  pgsize     INTEGER,          /* Size of the page */"                   \
-  "  schema     TEXT HIDDEN       /* Database schema being analyzed */"     \
+  "  schema     TEXT HIDDEN,      /* Database schema being analyzed */"     \
+  "  freeblocks INTEGER,          /* Freeblocks on this page */"            \
+  "  frag       INTEGER           /* Fragmented free bytes on this page */" \
   ");"
 
 
@@ -97,6 +99,8 @@ struct StatPage {
   u8 flags;                       /* Copy of flags byte */
   int nCell;                      /* Number of cells on page */
   int nUnused;                    /* Number of unused bytes on page */
+  int nFreeblock;                 /* Number of freeblocks on page */
+  int nFrag;                      /* Number of fragmented bytes on page */
   StatCell *aCell;                /* Array of parsed cells */
   u32 iRightChildPg;              /* Right-child page number (or 0) */
   int nMxPayload;                 /* Largest payload of any cell on this page */
@@ -122,6 +126,8 @@ struct StatCursor {
   int nMxPayload;                 /* Value of 'mx_payload' column */
   i64 iOffset;                    /* Value of 'pgOffset' column */
   int szPage;                     /* Value of 'pgSize' column */
+  int nFreeblock;                 /* Value of 'freeblocks' column */
+  int nFrag;                      /* Value of 'frag' column */
 };
 
 struct StatTable {
@@ -327,15 +333,18 @@ static int statDecodePage(Btree *pBt, StatPage *p){
   p->nCell = get2byte(&aHdr[3]);
   p->nMxPayload = 0;
 
-  isLeaf = (p->flags==0x0A || p->flags==0x0D);
+  isLeaf = (p->flags==0x0A || p->flags==0x0D || p->flags==0x1A);
   nHdr = 12 - isLeaf*4 + (p->iPgno==1)*100;
 
   nUnused = get2byte(&aHdr[5]) - nHdr - 2*p->nCell;
   nUnused += (int)aHdr[7];
+  p->nFreeblock = 0;
+  p->nFrag = (int)aHdr[7];
   iOff = get2byte(&aHdr[1]);
   while( iOff ){
     nUnused += get2byte(&aData[iOff+2]);
     iOff = get2byte(&aData[iOff]);
+    p->nFreeblock++;
   }
   p->nUnused = nUnused;
   p->iRightChildPg = isLeaf ? 0 : sqlite3Get4byte(&aHdr[8]);
@@ -362,6 +371,18 @@ static int statDecodePage(Btree *pBt, StatPage *p){
       }
       if( p->flags==0x05 ){
         /* A table interior node. nPayload==0. */
+      }else if( p->flags==0x1A ){
+        /* A prefix-compressed index leaf. Only the part of the key not
+        ** shared with the previous cell is stored, never overflowing. */
+        u32 nPayload, nHdrShared, nHdr, nBodyShared;
+        iOff += getVarint32(&aData[iOff], nPayload);
+        iOff += getVarint32(&aData[iOff], nHdrShared);
+        iOff += getVarint32(&aData[iOff], nHdr);
+        iOff += getVarint32(&aData[iOff], nBodyShared);
+        if( nPayload>(u32)p->nMxPayload ) p->nMxPayload = nPayload;
+        if( nHdrShared+nBodyShared<nPayload ){
+          pCell->nLocal = nPayload - nHdrShared - nBodyShared;
+        }
       }else{
         u32 nPayload;             /* Bytes of payload total (local+overflow) */
         int nLocal;               /* Bytes of payload stored locally */
@@ -484,6 +505,8 @@ statNextRestart:
         pCsr->zPagetype = "overflow";
         pCsr->nCell = 0;
         pCsr->nMxPayload = 0;
+        pCsr->nFreeblock = 0;
+        pCsr->nFrag = 0;
         pCsr->zPath = z = sqlite3_mprintf(
             "%s%.3x+%.6x", p->zPath, p->iCell, pCell->iOvfl
         );
@@ -544,6 +567,7 @@ statNextRestart:
           break;
         case 0x0D:             /* table leaf */
         case 0x0A:             /* index leaf */
+        case 0x1A:             /* prefix-compressed index leaf */
           pCsr->zPagetype = "leaf";
           break;
         default:
@@ -553,6 +577,8 @@ statNextRestart:
       pCsr->nCell = p->nCell;
       pCsr->nUnused = p->nUnused;
       pCsr->nMxPayload = p->nMxPayload;
+      pCsr->nFreeblock = p->nFreeblock;
+      pCsr->nFrag = p->nFrag;
       pCsr->zPath = z = sqlite3_mprintf("%s", p->zPath);
       if( z==0 ) rc = SQLITE_NOMEM;
       nPayload = 0;
@@ -653,6 +679,12 @@ static int statColumn(
     case 9:            /* pgsize */
       sqlite3_result_int(ctx, pCsr->szPage);
       break;
+    case 11:           /* freeblocks */
+      sqlite3_result_int(ctx, pCsr->nFreeblock);
+      break;
+    case 12:           /* frag */
+      sqlite3_result_int(ctx, pCsr->nFrag);
+      break;
     default: {          /* schema */
       sqlite3 *db = sqlite3_context_db_handle(ctx);
       int iDb = pCsr->iDb;
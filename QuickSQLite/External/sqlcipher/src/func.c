@@ -1706,6 +1706,27 @@ int sqlite3IsLikeFunction(sqlite3 *db, Expr *pExpr, int *pIsNocase, char *aWc){
   return 1;
 }
 
+#ifndef SQLITE_OMIT_AGGSCAN
+/*
+** If pDef is one of the built-in count(), sum(), total(), avg(), min()
+** or max() aggregates, return the AGGSCAN_* code that OP_AggScan uses
+** to compute it.  Return 0 for any other function, including an
+** application-defined function that overrides one of the built-ins.
+*/
+int sqlite3AggScanFunc(FuncDef *pDef){
+  if( pDef->xSFunc==countStep ) return AGGSCAN_COUNT;
+  if( pDef->xSFunc==minmaxStep ){
+    return pDef->pUserData ? AGGSCAN_MAX : AGGSCAN_MIN;
+  }
+  if( pDef->xSFunc==sumStep ){
+    if( pDef->xFinalize==sumFinalize ) return AGGSCAN_SUM;
+    if( pDef->xFinalize==totalFinalize ) return AGGSCAN_TOTAL;
+    if( pDef->xFinalize==avgFinalize ) return AGGSCAN_AVG;
+  }
+  return 0;
+}
+#endif
+
 /*
 ** All of the FuncDef structures in the aBuiltinFunc[] array above
 ** to the global function hash table.  This occurs at start-time (as
@@ -190,6 +190,7 @@ SQLITE_WSD struct Sqlite3Config sqlite3Config = {
    0,                         /* mxParserStack */
    0,                         /* sharedCacheEnabled */
    SQLITE_SORTER_PMASZ,       /* szPma */
+   SQLITE_DEFAULT_PCACHE_POLICY, /* ePcachePolicy */
    /* All the rest should always be initialized to zero */
    0,                         /* isInit */
    0,                         /* inProgress */
@@ -785,8 +785,18 @@ void sqlite3Insert(
   /* If this is not a view, open the table and and all indices */
   if( !isView ){
     int nIdx;
+    int addrOpen = sqlite3VdbeCurrentAddr(v);
     nIdx = sqlite3OpenTableAndIndices(pParse, pTab, OP_OpenWrite, 0, -1, 0,
                                       &iDataCur, &iIdxCur);
+    if( pSelect && HasRowid(pTab) && !IsVirtual(pTab) ){
+      /* Rows from a SELECT usually arrive in rowid order, either because
+      ** new rowids are generated or because they come from a rowid scan.
+      ** If the table is empty the btree layer can then build it bottom-up. */
+      VdbeOp *pOp = sqlite3VdbeGetOp(v, addrOpen);
+      assert( db->mallocFailed
+           || (pOp->opcode==OP_OpenWrite && pOp->p1==iDataCur) );
+      pOp->p5 |= OPFLAG_BULKCSR;
+    }
     aRegIdx = sqlite3DbMallocRawNN(db, sizeof(int)*(nIdx+1));
     if( aRegIdx==0 ){
       goto insert_cleanup;
@@ -2054,6 +2064,7 @@ static int xferOptimization(
   regData = sqlite3GetTempReg(pParse);
   regRowid = sqlite3GetTempReg(pParse);
   sqlite3OpenTable(pParse, iDest, iDbDest, pDest, OP_OpenWrite);
+  sqlite3VdbeChangeP5(v, OPFLAG_BULKCSR);
   assert( HasRowid(pDest) || destHasUniqueIdx );
   if( (db->flags & SQLITE_Vacuum)==0 && (
       (pDest->iPKey<0 && pDest->pIndex!=0)          /* (1) */
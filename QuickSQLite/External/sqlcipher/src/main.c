@@ -634,6 +634,18 @@ int sqlite3_config(int op, ...){
       break;
     }
 
+    case SQLITE_CONFIG_PCACHE_POLICY: {
+      int ePolicy = va_arg(ap, int);
+      if( ePolicy!=SQLITE_PCACHE_POLICY_LRU
+       && ePolicy!=SQLITE_PCACHE_POLICY_2Q
+      ){
+        rc = SQLITE_ERROR;
+      }else{
+        sqlite3GlobalConfig.ePcachePolicy = ePolicy;
+      }
+      break;
+    }
+
     default: {
       rc = SQLITE_ERROR;
       break;
@@ -1057,6 +1069,9 @@ static int sqlite3Close(sqlite3 *db, int forceZombie){
   }
 #endif
 
+  /* Stop the background checkpointer, if any */
+  sqlite3CkptThreadFree(db);
+
   /* Convert the connection into a zombie and then close it.
   */
   db->magic = SQLITE_MAGIC_ZOMBIE;
@@ -1919,12 +1934,242 @@ void *sqlite3_rollback_hook(
   return pRet;
 }
 
+#if !defined(SQLITE_OMIT_WAL) && SQLITE_MAX_WORKER_THREADS>0
+/*
+** The background checkpointer configured by sqlite3_wal_checkpoint_thread()
+** is represented by a CkptThread object, with a CkptWorker for each
+** database that it has checkpointed.
+**
+** Each checkpoint is run by a new thread, started by the commit that
+** crosses the auto-checkpoint threshold. The thread opens a private
+** connection to the database file, checkpoints it and closes it again.
+** The private connection has no codec and never reads a database page,
+** see sqlite3PagerOpenWalForCheckpoint(). If the previous checkpoint of a
+** database is still running when the threshold is next crossed, nothing
+** is started. Finished threads are joined by the next commit, or when
+** the checkpointer is stopped.
+*/
+typedef struct CkptWorker CkptWorker;
+struct CkptWorker {
+  CkptThread *pCkpt;              /* Checkpointer this worker belongs to */
+  char *zDb;                      /* Schema name of database */
+  char *zFile;                    /* Name of database file */
+  const char *zVfs;               /* Name of VFS used to open zFile */
+  int szPage;                     /* Page size of database */
+  SQLiteThread *pThread;          /* Running or finished thread, or NULL */
+  int bRunning;                   /* True until pThread has finished */
+  int bBlocked;                   /* True if readers held back checkpoint */
+  int nLog;                       /* WAL frames after the last checkpoint */
+  CkptWorker *pNext;              /* Next worker for same CkptThread */
+};
+struct CkptThread {
+  sqlite3_mutex *mutex;           /* Mutex protecting fields below */
+  int nCap;                       /* WAL size that triggers TRUNCATE */
+  CkptWorker *pWorker;            /* List of workers */
+  u32 aStat[3];                   /* Totals of SQLITE_DBSTATUS_CKPT_* values */
+  u32 aMax[3];                    /* Largest values for a single checkpoint */
+};
+
+/*
+** Body of the thread that runs a single background checkpoint for
+** worker p.
+*/
+static void *ckptWorkerMain(void *pCtx){
+  CkptWorker *p = (CkptWorker*)pCtx;
+  CkptThread *pCkpt = p->pCkpt;
+  sqlite3 *db = 0;
+  int nLog = 0;
+  int nCkpt = 0;
+  int aCur[3] = {0, 0, 0};
+  int aMax[3] = {0, 0, 0};
+  int rc;
+  int i;
+
+  rc = sqlite3_open_v2(p->zFile, &db, SQLITE_OPEN_READWRITE, p->zVfs);
+  if( rc==SQLITE_OK ){
+    Btree *pBt = db->aDb[0].pBt;
+    sqlite3_mutex_enter(db->mutex);
+    sqlite3BtreeEnter(pBt);
+    rc = sqlite3PagerOpenWalForCheckpoint(sqlite3BtreePager(pBt), p->szPage);
+    sqlite3BtreeLeave(pBt);
+    sqlite3_mutex_leave(db->mutex);
+  }
+  if( rc==SQLITE_OK ){
+    rc = sqlite3_wal_checkpoint_v2(db, "main", SQLITE_CHECKPOINT_PASSIVE,
+                                   &nLog, &nCkpt);
+  }
+  if( rc!=SQLITE_OK && rc!=SQLITE_EMPTY ){
+    sqlite3_log(rc, "background checkpoint failed: %s", p->zFile);
+  }
+  for(i=0; db && i<ArraySize(aCur); i++){
+    sqlite3_db_status(db, SQLITE_DBSTATUS_CKPT_FRAMES+i, &aCur[i], &aMax[i], 0);
+  }
+  sqlite3_close(db);
+
+  sqlite3_mutex_enter(pCkpt->mutex);
+  for(i=0; i<ArraySize(aCur); i++){
+    pCkpt->aStat[i] += aCur[i];
+    if( (u32)aMax[i]>pCkpt->aMax[i] ) pCkpt->aMax[i] = aMax[i];
+  }
+  p->nLog = nLog;
+  p->bBlocked = (rc==SQLITE_OK && nCkpt<nLog);
+  p->bRunning = 0;
+  sqlite3_mutex_leave(pCkpt->mutex);
+  return 0;
+}
+
+/*
+** Wait for the thread started for worker p, if any, to finish.
+*/
+static void ckptWorkerJoin(CkptWorker *p){
+  if( p->pThread ){
+    void *pOut;
+    sqlite3ThreadJoin(p->pThread, &pOut);
+    p->pThread = 0;
+  }
+}
+
+/*
+** Hand the checkpoint of database zDb, the WAL of which holds nFrame
+** frames, to the background checkpointer of connection db. Parameter
+** nThreshold is the auto-checkpoint threshold. If the WAL has reached the
+** size cap, the checkpoint is run in the foreground instead.
+**
+** Return SQLITE_OK if the checkpoint was started, or if none is required
+** just now. Otherwise, return an error code to indicate that the caller
+** should run the checkpoint itself.
+*/
+static int ckptThreadStart(
+  sqlite3 *db,                    /* Connection that committed */
+  const char *zDb,                /* Database to checkpoint */
+  int nFrame,                     /* Size of WAL in frames */
+  int nThreshold                  /* Auto-checkpoint threshold */
+){
+  CkptThread *pCkpt = db->pCkptThread;
+  CkptWorker *p;
+  int bRunning;
+  int iDb;
+  Btree *pBt;
+  Pager *pPager;
+
+  assert( sqlite3_mutex_held(db->mutex) );
+  iDb = sqlite3FindDbName(db, zDb);
+  if( iDb<0 || (pBt = db->aDb[iDb].pBt)==0 ) return SQLITE_ERROR;
+  pPager = sqlite3BtreePager(pBt);
+  if( sqlite3PagerLockingMode(pPager, PAGER_LOCKINGMODE_QUERY)
+   || sqlite3PagerFilename(pPager, 1)[0]==0
+  ){
+    return SQLITE_ERROR;
+  }
+
+  for(p=pCkpt->pWorker; p && sqlite3StrICmp(p->zDb, zDb); p=p->pNext);
+  if( p==0 ){
+    const char *zFile = sqlite3PagerFilename(pPager, 1);
+    int nDb = sqlite3Strlen30(zDb) + 1;
+    int nFile = sqlite3Strlen30(zFile) + 1;
+    p = (CkptWorker*)sqlite3MallocZero(sizeof(CkptWorker) + nDb + nFile);
+    if( p==0 ) return SQLITE_NOMEM;
+    p->pCkpt = pCkpt;
+    p->zDb = (char*)&p[1];
+    memcpy(p->zDb, zDb, nDb);
+    p->zFile = &p->zDb[nDb];
+    memcpy(p->zFile, zFile, nFile);
+    p->zVfs = sqlite3PagerVfs(pPager)->zName;
+    p->pNext = pCkpt->pWorker;
+    pCkpt->pWorker = p;
+  }
+
+  if( nFrame>=pCkpt->nCap ){
+    /* The background checkpoints are not keeping up with the writers.
+    ** Wait for the running one, if any, then checkpoint and truncate the
+    ** WAL in the foreground so that the next writer starts it afresh. */
+    ckptWorkerJoin(p);
+    sqlite3_wal_checkpoint_v2(db, zDb, SQLITE_CHECKPOINT_TRUNCATE, 0, 0);
+    return SQLITE_OK;
+  }
+
+  sqlite3_mutex_enter(pCkpt->mutex);
+  bRunning = p->bRunning;
+  sqlite3_mutex_leave(pCkpt->mutex);
+  if( bRunning ) return SQLITE_OK;
+  ckptWorkerJoin(p);
+
+  /* If readers held back the previous checkpoint, wait until the WAL has
+  ** grown by another nThreshold frames before trying again. */
+  if( p->bBlocked && nFrame<p->nLog+nThreshold ) return SQLITE_OK;
+
+  p->szPage = sqlite3BtreeGetPageSize(pBt);
+  p->bRunning = 1;
+  if( sqlite3ThreadCreate(&p->pThread, ckptWorkerMain, (void*)p) ){
+    p->bRunning = 0;
+    return SQLITE_NOMEM;
+  }
+  return SQLITE_OK;
+}
+
+/*
+** Stop the background checkpointer of connection db, if any, waiting for
+** running checkpoints to finish.
+*/
+void sqlite3CkptThreadFree(sqlite3 *db){
+  CkptThread *pCkpt = db->pCkptThread;
+  if( pCkpt ){
+    while( pCkpt->pWorker ){
+      CkptWorker *p = pCkpt->pWorker;
+      pCkpt->pWorker = p->pNext;
+      ckptWorkerJoin(p);
+      sqlite3_free(p);
+    }
+    sqlite3_mutex_free(pCkpt->mutex);
+    sqlite3_free(pCkpt);
+    db->pCkptThread = 0;
+  }
+}
+
+/*
+** Return the WAL size cap configured for the background checkpointer of
+** connection db, or zero if it has none.
+*/
+int sqlite3CkptThreadCap(sqlite3 *db){
+  return db->pCkptThread ? db->pCkptThread->nCap : 0;
+}
+
+/*
+** Add the value of statistic op (one of the SQLITE_DBSTATUS_CKPT_* values)
+** for checkpoints run by the background checkpointer of connection db to
+** *pnCur, and raise *pnMax to its largest value for a single checkpoint.
+** If reset is true, zero the statistic.
+*/
+void sqlite3CkptThreadStat(
+  sqlite3 *db,
+  int op,
+  int reset,
+  int *pnCur,
+  int *pnMax
+){
+  CkptThread *pCkpt = db->pCkptThread;
+  int iStat = op - SQLITE_DBSTATUS_CKPT_FRAMES;
+  if( pCkpt && iStat>=0 && iStat<ArraySize(pCkpt->aStat) ){
+    sqlite3_mutex_enter(pCkpt->mutex);
+    *pnCur += (int)pCkpt->aStat[iStat];
+    if( (int)pCkpt->aMax[iStat]>*pnMax ) *pnMax = (int)pCkpt->aMax[iStat];
+    if( reset ){
+      pCkpt->aStat[iStat] = 0;
+      pCkpt->aMax[iStat] = 0;
+    }
+    sqlite3_mutex_leave(pCkpt->mutex);
+  }
+}
+#endif /* !SQLITE_OMIT_WAL && SQLITE_MAX_WORKER_THREADS>0 */
+
 #ifndef SQLITE_OMIT_WAL
 /*
 ** The sqlite3_wal_hook() callback registered by sqlite3_wal_autocheckpoint().
 ** Invoke sqlite3_wal_checkpoint if the number of frames in the log file
 ** is greater than sqlite3.pWalArg cast to an integer (the value configured by
-** wal_autocheckpoint()).
+** wal_autocheckpoint()). If a background checkpointer has been configured
+** using sqlite3_wal_checkpoint_thread(), it is asked to run the checkpoint
+** instead.
 */ 
 int sqlite3WalDefaultHook(
   void *pClientData,     /* Argument */
@@ -1934,6 +2179,11 @@ int sqlite3WalDefaultHook(
 ){
   if( nFrame>=SQLITE_PTR_TO_INT(pClientData) ){
     sqlite3BeginBenignMalloc();
+#if SQLITE_MAX_WORKER_THREADS>0
+    if( db->pCkptThread==0
+     || ckptThreadStart(db, zDb, nFrame, SQLITE_PTR_TO_INT(pClientData))
+    )
+#endif
     sqlite3_wal_checkpoint(db, zDb);
     sqlite3EndBenignMalloc();
   }
@@ -1969,6 +2219,50 @@ int sqlite3_wal_autocheckpoint(sqlite3 *db, int nFrame){
   return SQLITE_OK;
 }
 
+/*
+** Configure the background checkpointer of connection db. If nCap is
+** greater than zero, auto-checkpoints are run by a background thread (see
+** ckptThreadStart()), and the WAL is truncated in the foreground once it
+** holds nCap or more frames. Otherwise, the background checkpointer is
+** stopped.
+*/
+int sqlite3_wal_checkpoint_thread(sqlite3 *db, int nCap){
+#if defined(SQLITE_OMIT_WAL) || SQLITE_MAX_WORKER_THREADS==0
+  UNUSED_PARAMETER(db);
+  UNUSED_PARAMETER(nCap);
+  return SQLITE_ERROR;
+#else
+  int rc = SQLITE_OK;
+#ifdef SQLITE_ENABLE_API_ARMOR
+  if( !sqlite3SafetyCheckOk(db) ) return SQLITE_MISUSE_BKPT;
+#endif
+  if( sqlite3GlobalConfig.bCoreMutex==0 ) return SQLITE_ERROR;
+  sqlite3_mutex_enter(db->mutex);
+  if( nCap<=0 ){
+    sqlite3CkptThreadFree(db);
+  }else{
+    if( db->pCkptThread==0 ){
+      CkptThread *pCkpt = (CkptThread*)sqlite3MallocZero(sizeof(CkptThread));
+      if( pCkpt ){
+        pCkpt->mutex = sqlite3MutexAlloc(SQLITE_MUTEX_FAST);
+        if( pCkpt->mutex==0 ){
+          sqlite3_free(pCkpt);
+          pCkpt = 0;
+        }
+      }
+      db->pCkptThread = pCkpt;
+    }
+    if( db->pCkptThread ){
+      db->pCkptThread->nCap = nCap;
+    }else{
+      rc = SQLITE_NOMEM;
+    }
+  }
+  sqlite3_mutex_leave(db->mutex);
+  return rc;
+#endif
+}
+
 /*
 ** Register a callback to be invoked each time a transaction is written
 ** into the write-ahead-log by this database connection.
@@ -2787,6 +3081,7 @@ static int openDatabase(
   db->aLimit[SQLITE_LIMIT_WORKER_THREADS] = SQLITE_DEFAULT_WORKER_THREADS;
   db->autoCommit = 1;
   db->nextAutovac = -1;
+  db->nextPrefix = -1;
   db->szMmap = sqlite3GlobalConfig.szMmap;
   db->nextPagesize = 0;
   db->nMaxSorterMmap = 0x7FFFFFFF;
@@ -226,7 +226,8 @@ static const struct sqlite3_io_methods MemJournalMethods = {
   0,                /* xShmBarrier */
   0,                /* xShmUnmap */
   0,                /* xFetch */
-  0                 /* xUnfetch */
+  0,                /* xUnfetch */
+  0                 /* xWriteV */
 };
 
 /* 
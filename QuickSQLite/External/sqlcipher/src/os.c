@@ -51,6 +51,7 @@ int sqlite3_open_file_count = 0;
 **
 **     sqlite3OsRead()
 **     sqlite3OsWrite()
+**     sqlite3OsWriteV()
 **     sqlite3OsSync()
 **     sqlite3OsFileSize()
 **     sqlite3OsLock()
@@ -97,6 +98,25 @@ int sqlite3OsWrite(sqlite3_file *id, const void *pBuf, int amt, i64 offset){
   DO_OS_MALLOC_TEST(id);
   return id->pMethods->xWrite(id, pBuf, amt, offset);
 }
+int sqlite3OsWriteV(
+  sqlite3_file *id,
+  int nBuf,
+  const void **apBuf,
+  const int *anBuf,
+  i64 offset
+){
+  int rc = SQLITE_OK;
+  int i;
+  DO_OS_MALLOC_TEST(id);
+  if( nBuf>1 && id->pMethods->iVersion>=4 && id->pMethods->xWriteV ){
+    return id->pMethods->xWriteV(id, nBuf, apBuf, anBuf, offset);
+  }
+  for(i=0; rc==SQLITE_OK && i<nBuf; i++){
+    rc = id->pMethods->xWrite(id, apBuf[i], anBuf[i], offset);
+    offset += anBuf[i];
+  }
+  return rc;
+}
 int sqlite3OsTruncate(sqlite3_file *id, i64 size){
   return id->pMethods->xTruncate(id, size);
 }
@@ -210,6 +230,23 @@ int sqlite3OsOpen(
 ){
   int rc;
   DO_OS_MALLOC_TEST(0);
+/* BEGIN SQLCIPHER */
+#ifdef SQLITE_HAS_CODEC
+  {
+    /* Temporary files may be wrapped so that their content is encrypted
+    ** with an ephemeral key. See sqlcipher_temp_file_open(). */
+    extern int sqlcipher_temp_file_wanted(sqlite3_vfs*, int);
+    extern int sqlcipher_temp_file_open(sqlite3_vfs*, const char*,
+                                        sqlite3_file*, int, int*);
+    if( sqlcipher_temp_file_wanted(pVfs, flags) ){
+      rc = sqlcipher_temp_file_open(pVfs, zPath, pFile, flags & 0x87f7f,
+                                    pFlagsOut);
+      assert( rc==SQLITE_OK || pFile->pMethods==0 );
+      return rc;
+    }
+  }
+#endif
+/* END SQLCIPHER */
   /* 0x87f7f is a mask of SQLITE_OPEN_ flags that are valid to be passed
   ** down into the VFS layer.  Some SQLITE_OPEN_ flags (for example,
   ** SQLITE_OPEN_FULLMUTEX or SQLITE_OPEN_SHAREDCACHE) are blocked before
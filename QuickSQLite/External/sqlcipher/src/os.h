@@ -152,6 +152,15 @@
 #define SHARED_FIRST      (PENDING_BYTE+2)
 #define SHARED_SIZE       510
 
+/*
+** The largest number of buffers that the pager or the WAL module will
+** pass to a single sqlite3OsWriteV() call.  Set this to 1 or less to
+** write every page with a separate call to sqlite3OsWrite().
+*/
+#ifndef SQLITE_MAX_WRITEV
+# define SQLITE_MAX_WRITEV 64
+#endif
+
 /*
 ** Wrapper around OS specific sqlite3_os_init() function.
 */
@@ -163,6 +172,7 @@ int sqlite3OsInit(void);
 int sqlite3OsClose(sqlite3_file*);
 int sqlite3OsRead(sqlite3_file*, void*, int amt, i64 offset);
 int sqlite3OsWrite(sqlite3_file*, const void*, int amt, i64 offset);
+int sqlite3OsWriteV(sqlite3_file*, int, const void**, const int*, i64 offset);
 int sqlite3OsTruncate(sqlite3_file*, i64 size);
 int sqlite3OsSync(sqlite3_file*, int);
 int sqlite3OsFileSize(sqlite3_file*, i64 *pSize);
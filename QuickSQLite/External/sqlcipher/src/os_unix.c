@@ -80,6 +80,7 @@
 #include <unistd.h>
 #include <time.h>
 #include <sys/time.h>
+#include <sys/uio.h>
 #include <errno.h>
 #if !defined(SQLITE_OMIT_WAL) || SQLITE_MAX_MMAP_SIZE>0
 # include <sys/mman.h>
@@ -112,6 +113,73 @@
 # include <sys/mount.h>
 #endif
 
+/*
+** The "unix-uring" VFS, which submits writes and syncs through io_uring,
+** is only available on Linux, and only if SQLITE_ENABLE_IO_URING is
+** defined.
+*/
+#if defined(SQLITE_ENABLE_IO_URING) && defined(__linux__)
+# define UNIX_USE_URING 1
+# include <sys/mman.h>
+# include <sys/syscall.h>
+# include <linux/io_uring.h>
+#else
+# define UNIX_USE_URING 0
+#endif
+
+/*
+** HAVE_DIRECT_IO is true if the O_DIRECT open flag is available. On Linux
+** this requires _GNU_SOURCE. Database files opened with the "directio"
+** URI parameter set (or all database files, if SQLITE_DEFAULT_DIRECT_IO
+** is true) bypass the operating system page cache, so that each page
+** is cached once, in the SQLite page cache, instead of twice.
+**
+** Transfers to and from a file opened for direct I/O must use buffers,
+** file offsets and lengths that are multiples of SQLITE_DIRECT_IO_ALIGN
+** bytes. Other transfers, such as reads of the 100-byte database header,
+** are staged through an aligned buffer or made with O_DIRECT cleared.
+** Journal, WAL and temporary files always use buffered I/O.
+*/
+#if !defined(HAVE_DIRECT_IO)
+# if defined(O_DIRECT)
+#  define HAVE_DIRECT_IO 1
+# else
+#  define HAVE_DIRECT_IO 0
+# endif
+#endif
+#ifndef SQLITE_DEFAULT_DIRECT_IO
+# define SQLITE_DEFAULT_DIRECT_IO 0
+#endif
+#ifndef SQLITE_DIRECT_IO_ALIGN
+# define SQLITE_DIRECT_IO_ALIGN 4096
+#endif
+#if (SQLITE_DIRECT_IO_ALIGN & (SQLITE_DIRECT_IO_ALIGN-1))!=0
+# error SQLITE_DIRECT_IO_ALIGN must be a power of two
+#endif
+
+/*
+** HAVE_SYNC_FILE_RANGE defaults to true on Linux and false everywhere
+** else. If it is false, PRAGMA durability=relaxed syncs files with a full
+** fsync(), and no write-back is started ahead of a sync.
+*/
+#if !defined(HAVE_SYNC_FILE_RANGE)
+# if defined(__linux__) && defined(_GNU_SOURCE)
+#  define HAVE_SYNC_FILE_RANGE 1
+# else
+#  define HAVE_SYNC_FILE_RANGE 0
+# endif
+#endif
+
+/*
+** Under PRAGMA durability=batched or relaxed, write-back of the data
+** written to a file is started each time SQLITE_WRITEBACK_CHUNK bytes
+** have been written to it since the last sync, so that less remains to
+** be written when the file is synced.
+*/
+#ifndef SQLITE_WRITEBACK_CHUNK
+# define SQLITE_WRITEBACK_CHUNK (1024*1024)
+#endif
+
 #ifdef HAVE_UTIME
 # include <utime.h>
 #endif
@@ -182,6 +250,26 @@ struct UnixUnusedFd {
   UnixUnusedFd *pNext;      /* Next unused file descriptor on same file */
 };
 
+#if UNIX_USE_URING
+typedef struct UringRing UringRing;
+#endif
+
+#if SQLITE_MAX_MMAP_SIZE>0
+/*
+** A memory mapping of a database file that has been replaced by a mapping
+** of a different part of the file while xFetch() references to it were
+** still outstanding. It is unmapped when the last of them is released.
+** Each unixFile has UNIX_MMAP_NOLD slots for such mappings.
+*/
+typedef struct UnixMapOld UnixMapOld;
+struct UnixMapOld {
+  void *pMap;                         /* Mapping, or NULL if slot is unused */
+  sqlite3_int64 nMap;                 /* Size of mapping in bytes */
+  int nRef;                           /* Outstanding xFetch() references */
+};
+#define UNIX_MMAP_NOLD 4
+#endif
+
 /*
 ** The unixFile structure is subclass of sqlite3_file specific to the unix
 ** VFS implementations.
@@ -206,6 +294,18 @@ struct unixFile {
   sqlite3_int64 mmapSizeActual;       /* Actual size of mapping at pMapRegion */
   sqlite3_int64 mmapSizeMax;          /* Configured FCNTL_MMAP_SIZE value */
   void *pMapRegion;                   /* Memory mapped region */
+  int nMapRef;                        /* xFetch refs into pMapRegion */
+  UnixMapOld aMapOld[UNIX_MMAP_NOLD]; /* Replaced mappings still in use */
+  sqlite3_int64 mmapOffset;           /* File offset of pMapRegion[0] */
+  sqlite3_int64 mmapSizePeak;         /* Largest value of mmapSize */
+  sqlite3_int64 iMapNext;             /* Offset following the last fetch */
+  sqlite3_int64 iMapWillNeed;         /* Prefetched up to this offset */
+  int nMapRemap;                      /* Number of mappings created */
+  int nMapMiss;                       /* Fetches outside of the mapping */
+  u8 nMapMissRun;                     /* Consecutive fetches that missed */
+  u8 nMapSeqRun;                      /* Consecutive sequential fetches */
+  u8 nMapRandRun;                     /* Consecutive random fetches */
+  u8 eMapAdvice;                      /* Last madvise() hint given */
 #endif
 #ifdef __QNXNTO__
   int sectorSize;                     /* Device sector size */
@@ -220,6 +320,18 @@ struct unixFile {
 #if OS_VXWORKS
   struct vxworksFileId *pId;          /* Unique file ID */
 #endif
+#if UNIX_USE_URING
+  UringRing *pRing;                   /* io_uring state for "unix-uring" */
+#endif
+  u8 eDurability;                     /* PAGER_DURABILITY_* setting */
+#if HAVE_SYNC_FILE_RANGE
+  sqlite3_int64 iWbFirst;             /* Start of range written since the */
+  sqlite3_int64 iWbLast;              /*   last sync or write-back, and end */
+#endif
+#if HAVE_DIRECT_IO
+  void *pDirect;                      /* Staging buffer for direct I/O */
+  int nDirect;                        /* Usable size of pDirect (aligned) */
+#endif
 #ifdef SQLITE_DEBUG
   /* The next group of variables are used to track whether or not the
   ** transaction counter in bytes 24-27 of database files are updated
@@ -263,6 +375,9 @@ static pid_t randomnessPid = 0;
 #define UNIXFILE_DELETE      0x20     /* Delete on close */
 #define UNIXFILE_URI         0x40     /* Filename might have query parameters */
 #define UNIXFILE_NOLOCK      0x80     /* Do no file locking */
+#define UNIXFILE_NOURING     0x100    /* io_uring setup failed. Do not retry */
+#define UNIXFILE_DIRECT      0x200    /* File descriptor opened O_DIRECT */
+#define UNIXFILE_EXISTED     0x400    /* Journal or WAL existed before open */
 
 /*
 ** Include code that is common to all os_*.c files
@@ -307,6 +422,31 @@ static pid_t randomnessPid = 0;
 # endif
 #endif
 
+/*
+** HAVE_PWRITEV defaults to true on Linux and false everywhere else.  If
+** it is false, unixWriteV() uses lseek() followed by writev().
+*/
+#if !defined(HAVE_PWRITEV)
+# if defined(__linux__) && defined(_GNU_SOURCE)
+#  define HAVE_PWRITEV 1
+# else
+#  define HAVE_PWRITEV 0
+# endif
+#endif
+
+/*
+** HAVE_MADVISE defaults to true on Linux and Apple platforms and false
+** everywhere else. If it is false, no access-pattern or huge page hints
+** are given for memory-mapped files.
+*/
+#if !defined(HAVE_MADVISE)
+# if defined(__linux__) || defined(__APPLE__)
+#  define HAVE_MADVISE 1
+# else
+#  define HAVE_MADVISE 0
+# endif
+#endif
+
 /*
 ** Explicitly call the 64-bit version of lseek() on Android. Otherwise, lseek()
 ** is the 32-bit version, even if _FILE_OFFSET_BITS=64 is defined.
@@ -487,6 +627,33 @@ static struct unix_syscall {
 #endif
 #define osLstat      ((int(*)(const char*,struct stat*))aSyscall[27].pCurrent)
 
+  { "writev",       (sqlite3_syscall_ptr)writev,          0 },
+#define osWritev     ((ssize_t(*)(int,const struct iovec*,int))\
+                    aSyscall[28].pCurrent)
+
+#if HAVE_PWRITEV
+  { "pwritev",      (sqlite3_syscall_ptr)pwritev,         0 },
+#else
+  { "pwritev",      (sqlite3_syscall_ptr)0,               0 },
+#endif
+#define osPwritev    ((ssize_t(*)(int,const struct iovec*,int,off_t))\
+                    aSyscall[29].pCurrent)
+
+#if HAVE_MADVISE && (!defined(SQLITE_OMIT_WAL) || SQLITE_MAX_MMAP_SIZE>0)
+  { "madvise",      (sqlite3_syscall_ptr)madvise,         0 },
+#else
+  { "madvise",      (sqlite3_syscall_ptr)0,               0 },
+#endif
+#define osMadvise    ((int(*)(void*,size_t,int))aSyscall[30].pCurrent)
+
+#if HAVE_SYNC_FILE_RANGE
+  { "sync_file_range", (sqlite3_syscall_ptr)sync_file_range, 0 },
+#else
+  { "sync_file_range", (sqlite3_syscall_ptr)0,               0 },
+#endif
+#define osSyncFileRange ((int(*)(int,off_t,off_t,unsigned int))\
+                    aSyscall[31].pCurrent)
+
 }; /* End of the overrideable system calls */
 
 
@@ -1919,6 +2086,9 @@ static int closeUnixFile(sqlite3_file *id){
     robust_close(pFile, pFile->h, __LINE__);
     pFile->h = -1;
   }
+#if HAVE_DIRECT_IO
+  sqlite3_free(pFile->pDirect);
+#endif
 #if OS_VXWORKS
   if( pFile->pId ){
     if( pFile->ctrlFlags & UNIXFILE_DELETE ){
@@ -3081,6 +3251,99 @@ static int nfsUnlock(sqlite3_file *id, int eFileLock){
 ** are gather together into this division.
 */
 
+#if HAVE_DIRECT_IO
+/*
+** Return true if nByte bytes may be transfered between buffer p and
+** offset iOff of a file opened for direct I/O without staging.
+*/
+static int unixDirectAligned(const void *p, int nByte, i64 iOff){
+  return ((SQLITE_PTR_TO_INT(p) | nByte | (int)iOff)
+            & (SQLITE_DIRECT_IO_ALIGN-1))==0;
+}
+
+/*
+** Return true if each of the nBuf buffers that unixWriteV() is to write
+** to adjacent regions of a direct I/O file beginning at iOff is aligned.
+*/
+static int unixDirectAlignedV(
+  int nBuf,
+  const void **apBuf,
+  const int *anBuf,
+  i64 iOff
+){
+  int i;
+  for(i=0; i<nBuf; i++){
+    if( !unixDirectAligned(apBuf[i], anBuf[i], iOff) ) return 0;
+    iOff += anBuf[i];
+  }
+  return 1;
+}
+
+/*
+** Set the O_DIRECT flag of file descriptor h if bOn is true, or clear it
+** otherwise. Return 0 on success or -1 if the flag cannot be changed.
+*/
+static int unixDirectMode(int h, int bOn){
+  int f = osFcntl(h, F_GETFL);
+  if( f<0 ) return -1;
+  if( ((f & O_DIRECT)!=0)==(bOn!=0) ) return 0;
+  return osFcntl(h, F_SETFL, bOn ? (f | O_DIRECT) : (f & ~O_DIRECT));
+}
+
+/*
+** Return a buffer of at least nByte bytes, aligned for direct I/O, that
+** may be used to stage unaligned transfers to or from pFile. Return NULL
+** if such a buffer cannot be allocated.
+*/
+static u8 *unixDirectBuffer(unixFile *pFile, int nByte){
+  if( nByte>pFile->nDirect ){
+    sqlite3_free(pFile->pDirect);
+    pFile->pDirect = sqlite3_malloc64((i64)nByte + SQLITE_DIRECT_IO_ALIGN);
+    pFile->nDirect = pFile->pDirect ? nByte : 0;
+    if( pFile->pDirect==0 ) return 0;
+  }
+  return &((u8*)pFile->pDirect)[(SQLITE_DIRECT_IO_ALIGN
+      - (SQLITE_PTR_TO_INT(pFile->pDirect) & (SQLITE_DIRECT_IO_ALIGN-1)))
+      & (SQLITE_DIRECT_IO_ALIGN-1)];
+}
+
+static int seekAndRead(unixFile*, sqlite3_int64, void*, int);
+
+/*
+** Read cnt bytes from offset iOff of direct I/O file pFile into pBuf, where
+** at least one of pBuf, iOff and cnt is not aligned. The smallest aligned
+** region that contains the requested bytes is read into the staging
+** buffer and the requested bytes copied from there. If no staging buffer
+** is available, O_DIRECT is cleared for the duration of the read instead.
+** The return value is as for seekAndRead().
+*/
+static int unixDirectRead(unixFile *pFile, i64 iOff, void *pBuf, int cnt){
+  i64 iStart = iOff & ~(i64)(SQLITE_DIRECT_IO_ALIGN-1);
+  i64 iEnd = (iOff + cnt + SQLITE_DIRECT_IO_ALIGN - 1)
+                  & ~(i64)(SQLITE_DIRECT_IO_ALIGN-1);
+  u8 *aBuf = unixDirectBuffer(pFile, (int)(iEnd - iStart));
+  int got;
+
+  if( aBuf ){
+    got = seekAndRead(pFile, iStart, aBuf, (int)(iEnd - iStart));
+    if( got<0 ) return got;
+    got -= (int)(iOff - iStart);
+    if( got<=0 ) return 0;
+    if( got>cnt ) got = cnt;
+    memcpy(pBuf, &aBuf[iOff - iStart], got);
+  }else if( unixDirectMode(pFile->h, 0) ){
+    storeLastErrno(pFile, errno);
+    got = -1;
+  }else{
+    pFile->ctrlFlags &= ~UNIXFILE_DIRECT;
+    got = seekAndRead(pFile, iOff, pBuf, cnt);
+    pFile->ctrlFlags |= UNIXFILE_DIRECT;
+    unixDirectMode(pFile->h, 1);
+  }
+  return got;
+}
+#endif /* HAVE_DIRECT_IO */
+
 /*
 ** Seek to the offset passed as the second argument, then read cnt 
 ** bytes into pBuf. Return the number of bytes actually read.
@@ -3099,9 +3362,16 @@ static int seekAndRead(unixFile *id, sqlite3_int64 offset, void *pBuf, int cnt){
   int prior = 0;
 #if (!defined(USE_PREAD) && !defined(USE_PREAD64))
   i64 newOffset;
+#endif
+#if HAVE_DIRECT_IO
+  if( (id->ctrlFlags & UNIXFILE_DIRECT)!=0
+   && !unixDirectAligned(pBuf, cnt, offset)
+  ){
+    return unixDirectRead(id, offset, pBuf, cnt);
+  }
 #endif
   TIMER_START;
-  assert( cnt==(cnt&0x1ffff) );
+  assert( cnt>=0 );
   assert( id->h>2 );
   do{
 #if defined(USE_PREAD)
@@ -3167,13 +3437,14 @@ static int unixRead(
 #if SQLITE_MAX_MMAP_SIZE>0
   /* Deal with as much of this read request as possible by transfering
   ** data from the memory mapping using memcpy().  */
-  if( offset<pFile->mmapSize ){
-    if( offset+amt <= pFile->mmapSize ){
-      memcpy(pBuf, &((u8 *)(pFile->pMapRegion))[offset], amt);
+  if( offset>=pFile->mmapOffset && offset<pFile->mmapOffset+pFile->mmapSize ){
+    i64 iRel = offset - pFile->mmapOffset;
+    if( iRel+amt <= pFile->mmapSize ){
+      memcpy(pBuf, &((u8 *)(pFile->pMapRegion))[iRel], amt);
       return SQLITE_OK;
     }else{
-      int nCopy = pFile->mmapSize - offset;
-      memcpy(pBuf, &((u8 *)(pFile->pMapRegion))[offset], nCopy);
+      int nCopy = pFile->mmapSize - iRel;
+      memcpy(pBuf, &((u8 *)(pFile->pMapRegion))[iRel], nCopy);
       pBuf = &((u8 *)pBuf)[nCopy];
       amt -= nCopy;
       offset += nCopy;
@@ -3211,10 +3482,9 @@ static int seekAndWriteFd(
 ){
   int rc = 0;                     /* Value returned by system call */
 
-  assert( nBuf==(nBuf&0x1ffff) );
+  assert( nBuf>=0 );
   assert( fd>2 );
   assert( piErrno!=0 );
-  nBuf &= 0x1ffff;
   TIMER_START;
 
 #if defined(USE_PREAD)
@@ -3248,11 +3518,78 @@ static int seekAndWriteFd(
 ** To avoid stomping the errno value on a failed write the lastErrno value
 ** is set before returning.
 */
+#if HAVE_DIRECT_IO
+/*
+** Write cnt bytes from pBuf to offset iOff of direct I/O file pFile, where
+** at least one of pBuf, iOff and cnt is not aligned. If only the buffer is
+** unaligned, the data is copied to the staging buffer and written from
+** there. Otherwise, or if no staging buffer is available, O_DIRECT is
+** cleared for the duration of the write. The return value is as for
+** seekAndWriteFd().
+*/
+static int unixDirectWrite(
+  unixFile *pFile,
+  i64 iOff,
+  const void *pBuf,
+  int cnt
+){
+  int rc;
+  if( unixDirectAligned(0, cnt, iOff) ){
+    u8 *aBuf = unixDirectBuffer(pFile, cnt);
+    if( aBuf ){
+      memcpy(aBuf, pBuf, cnt);
+      return seekAndWriteFd(pFile->h, iOff, aBuf, cnt, &pFile->lastErrno);
+    }
+  }
+  if( unixDirectMode(pFile->h, 0) ){
+    storeLastErrno(pFile, errno);
+    return -1;
+  }
+  rc = seekAndWriteFd(pFile->h, iOff, pBuf, cnt, &pFile->lastErrno);
+  unixDirectMode(pFile->h, 1);
+  return rc;
+}
+#endif /* HAVE_DIRECT_IO */
+
 static int seekAndWrite(unixFile *id, i64 offset, const void *pBuf, int cnt){
+#if HAVE_DIRECT_IO
+  if( (id->ctrlFlags & UNIXFILE_DIRECT)!=0
+   && !unixDirectAligned(pBuf, cnt, offset)
+  ){
+    return unixDirectWrite(id, offset, pBuf, cnt);
+  }
+#endif
   return seekAndWriteFd(id->h, offset, pBuf, cnt, &id->lastErrno);
 }
 
 
+#if HAVE_SYNC_FILE_RANGE
+/*
+** Record that nByte bytes were written at offset iOff of pFile. Under
+** PRAGMA durability=batched or relaxed, start write-back of the range
+** written since the last sync once it reaches SQLITE_WRITEBACK_CHUNK
+** bytes. Only write-back is started; durability is still provided by
+** the next xSync call alone.
+*/
+static void unixWriteback(unixFile *pFile, i64 iOff, i64 nByte){
+  if( pFile->eDurability==PAGER_DURABILITY_STRICT ) return;
+  if( pFile->iWbLast<=pFile->iWbFirst ){
+    pFile->iWbFirst = iOff;
+    pFile->iWbLast = iOff + nByte;
+  }else{
+    if( iOff<pFile->iWbFirst ) pFile->iWbFirst = iOff;
+    if( iOff+nByte>pFile->iWbLast ) pFile->iWbLast = iOff + nByte;
+  }
+  if( pFile->iWbLast-pFile->iWbFirst>=SQLITE_WRITEBACK_CHUNK ){
+    osSyncFileRange(pFile->h, pFile->iWbFirst,
+                    pFile->iWbLast-pFile->iWbFirst, SYNC_FILE_RANGE_WRITE);
+    pFile->iWbFirst = pFile->iWbLast = 0;
+  }
+}
+#else
+# define unixWriteback(A,B,C) UNUSED_PARAMETER2(B,C)
+#endif
+
 /*
 ** Write data from a buffer into a file.  Return SQLITE_OK on success
 ** or some other error code on failure.
@@ -3265,6 +3602,8 @@ static int unixWrite(
 ){
   unixFile *pFile = (unixFile*)id;
   int wrote = 0;
+  i64 iFirst;
+  int nTotal;
   assert( id );
   assert( amt>0 );
 
@@ -3302,13 +3641,14 @@ static int unixWrite(
 #if defined(SQLITE_MMAP_READWRITE) && SQLITE_MAX_MMAP_SIZE>0
   /* Deal with as much of this write request as possible by transfering
   ** data from the memory mapping using memcpy().  */
-  if( offset<pFile->mmapSize ){
-    if( offset+amt <= pFile->mmapSize ){
-      memcpy(&((u8 *)(pFile->pMapRegion))[offset], pBuf, amt);
+  if( offset>=pFile->mmapOffset && offset<pFile->mmapOffset+pFile->mmapSize ){
+    i64 iRel = offset - pFile->mmapOffset;
+    if( iRel+amt <= pFile->mmapSize ){
+      memcpy(&((u8 *)(pFile->pMapRegion))[iRel], pBuf, amt);
       return SQLITE_OK;
     }else{
-      int nCopy = pFile->mmapSize - offset;
-      memcpy(&((u8 *)(pFile->pMapRegion))[offset], pBuf, nCopy);
+      int nCopy = pFile->mmapSize - iRel;
+      memcpy(&((u8 *)(pFile->pMapRegion))[iRel], pBuf, nCopy);
       pBuf = &((u8 *)pBuf)[nCopy];
       amt -= nCopy;
       offset += nCopy;
@@ -3316,6 +3656,8 @@ static int unixWrite(
   }
 #endif
  
+  iFirst = offset;
+  nTotal = amt;
   while( (wrote = seekAndWrite(pFile, offset, pBuf, amt))<amt && wrote>0 ){
     amt -= wrote;
     offset += wrote;
@@ -3334,6 +3676,117 @@ static int unixWrite(
     }
   }
 
+  unixWriteback(pFile, iFirst, nTotal);
+  return SQLITE_OK;
+}
+
+/*
+** Write nBuf buffers to adjacent regions of the file beginning at offset
+** using as few writev() or pwritev() calls as possible.  This is the
+** xWriteV method of the version 4 sqlite3_io_methods objects.
+*/
+static int unixWriteV(
+  sqlite3_file *id,
+  int nBuf,
+  const void **apBuf,
+  const int *anBuf,
+  sqlite3_int64 offset
+){
+  unixFile *pFile = (unixFile*)id;
+  struct iovec aIov[SQLITE_MAX_WRITEV>1 ? SQLITE_MAX_WRITEV : 2];
+  int i = 0;
+  assert( id );
+  assert( nBuf>0 );
+
+  /* Writes that must be examined or redirected a buffer at a time are
+  ** passed through to unixWrite(): in debugging builds those that cover
+  ** the transaction counter of a database file, those that might
+  ** overlap a writable memory mapping and unaligned direct I/O writes. */
+  if( 0
+#ifdef SQLITE_DEBUG
+   || (pFile->inNormalWrite && offset<=24)
+#endif
+#if defined(SQLITE_MMAP_READWRITE) && SQLITE_MAX_MMAP_SIZE>0
+   || pFile->mmapSize>0
+#endif
+#if HAVE_DIRECT_IO
+   || ((pFile->ctrlFlags & UNIXFILE_DIRECT)!=0
+        && !unixDirectAlignedV(nBuf, apBuf, anBuf, offset))
+#endif
+  ){
+    int rc = SQLITE_OK;
+    for(i=0; rc==SQLITE_OK && i<nBuf; i++){
+      rc = unixWrite(id, apBuf[i], anBuf[i], offset);
+      offset += anBuf[i];
+    }
+    return rc;
+  }
+#ifdef SQLITE_DEBUG
+  if( pFile->inNormalWrite ) pFile->dbUpdate = 1;
+#endif
+
+  while( i<nBuf ){
+    int nIov = 0;
+    i64 nTotal = 0;
+    i64 wrote;
+    while( i+nIov<nBuf && nIov<(int)ArraySize(aIov) ){
+      assert( anBuf[i+nIov]>0 );
+      aIov[nIov].iov_base = (void*)apBuf[i+nIov];
+      aIov[nIov].iov_len = anBuf[i+nIov];
+      nTotal += anBuf[i+nIov];
+      nIov++;
+    }
+
+    TIMER_START;
+#if HAVE_PWRITEV
+    do{
+      wrote = (i64)osPwritev(pFile->h, aIov, nIov, offset);
+    }while( wrote<0 && errno==EINTR );
+#else
+    do{
+      i64 iSeek = lseek(pFile->h, offset, SEEK_SET);
+      if( iSeek<0 ){
+        wrote = -1;
+        break;
+      }
+      wrote = (i64)osWritev(pFile->h, aIov, nIov);
+    }while( wrote<0 && errno==EINTR );
+#endif
+    TIMER_END;
+    OSTRACE(("WRITEV  %-3d %5lld %7lld %llu\n",
+             pFile->h, wrote, offset, TIMER_ELAPSED));
+    if( wrote<0 ) storeLastErrno(pFile, errno);
+    SimulateIOError(( wrote=(-1) ));
+    SimulateDiskfullError(( wrote=0 ));
+
+    if( wrote<=0 ){
+      if( wrote<0 && pFile->lastErrno!=ENOSPC ){
+        return SQLITE_IOERR_WRITE;
+      }
+      storeLastErrno(pFile, 0); /* not a system error */
+      return SQLITE_FULL;
+    }
+    unixWriteback(pFile, offset, wrote);
+
+    if( wrote<nTotal ){
+      /* A short write.  Skip the buffers that were written in full, then
+      ** finish the one that was written in part using unixWrite(). */
+      int rc;
+      while( wrote>=anBuf[i] ){
+        wrote -= anBuf[i];
+        offset += anBuf[i];
+        i++;
+      }
+      rc = unixWrite(id, &((const char*)apBuf[i])[wrote],
+                     anBuf[i]-(int)wrote, offset+wrote);
+      if( rc ) return rc;
+      offset += anBuf[i];
+      i++;
+    }else{
+      offset += nTotal;
+      i += nIov;
+    }
+  }
   return SQLITE_OK;
 }
 
@@ -3510,6 +3963,40 @@ static int openDirectory(const char *zFilename, int *pFd){
   return unixLogError(SQLITE_CANTOPEN_BKPT, "openDirectory", zDirname);
 }
 
+/*
+** Fsync the directory containing file pFile if the DIRSYNC flag is set.
+** This is a one-time occurrence, done after the first successful sync of
+** the file.  Many systems (examples: AIX) are unable to fsync a directory,
+** so errors on the fsync are ignored.
+*/
+static void unixSyncDirectory(unixFile *pFile, int isFullsync){
+  UNUSED_PARAMETER(isFullsync);
+  /* Under PRAGMA durability=batched or relaxed, the directory is not
+  ** synced if the file existed before it was opened, as its directory
+  ** entry was synced by the connection that created it. The DIRSYNC
+  ** flag is left set, so that the first sync after a return to
+  ** durability=strict still syncs the directory. */
+  if( (pFile->ctrlFlags & UNIXFILE_EXISTED)!=0
+   && pFile->eDurability!=PAGER_DURABILITY_STRICT
+  ){
+    return;
+  }
+  if( pFile->ctrlFlags & UNIXFILE_DIRSYNC ){
+    int dirfd;
+    int rc;
+    OSTRACE(("DIRSYNC %s (have_fullfsync=%d fullsync=%d)\n", pFile->zPath,
+            HAVE_FULLFSYNC, isFullsync));
+    rc = osOpenDirectory(pFile->zPath, &dirfd);
+    if( rc==SQLITE_OK ){
+      full_fsync(dirfd, 0, 0);
+      robust_close(pFile, dirfd, __LINE__);
+    }else{
+      assert( rc==SQLITE_CANTOPEN );
+    }
+    pFile->ctrlFlags &= ~UNIXFILE_DIRSYNC;
+  }
+}
+
 /*
 ** Make sure all writes to a particular file are committed to disk.
 **
@@ -3544,6 +4031,24 @@ static int unixSync(sqlite3_file *id, int flags){
 
   assert( pFile );
   OSTRACE(("SYNC    %-3d\n", pFile->h));
+#if HAVE_SYNC_FILE_RANGE
+  pFile->iWbFirst = pFile->iWbLast = 0;
+  if( pFile->eDurability==PAGER_DURABILITY_RELAXED ){
+    /* Under PRAGMA durability=relaxed a sync only waits until the dirty
+    ** data of the file has been handed to the device. It does not sync
+    ** the metadata of the file or its directory, nor flush the device's
+    ** volatile cache, so none of the writes is known to be durable or
+    ** ordered against later writes. The DIRSYNC flag is left set, so
+    ** that the directory is synced once a full sync is done. */
+    rc = osSyncFileRange(pFile->h, 0, 0, SYNC_FILE_RANGE_WAIT_BEFORE
+                           | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+    if( rc ){
+      storeLastErrno(pFile, errno);
+      return unixLogError(SQLITE_IOERR_FSYNC, "sync_file_range", pFile->zPath);
+    }
+    return SQLITE_OK;
+  }
+#endif
   rc = full_fsync(pFile->h, isFullsync, isDataOnly);
   SimulateIOError( rc=1 );
   if( rc ){
@@ -3551,25 +4056,8 @@ static int unixSync(sqlite3_file *id, int flags){
     return unixLogError(SQLITE_IOERR_FSYNC, "full_fsync", pFile->zPath);
   }
 
-  /* Also fsync the directory containing the file if the DIRSYNC flag
-  ** is set.  This is a one-time occurrence.  Many systems (examples: AIX)
-  ** are unable to fsync a directory, so ignore errors on the fsync.
-  */
-  if( pFile->ctrlFlags & UNIXFILE_DIRSYNC ){
-    int dirfd;
-    OSTRACE(("DIRSYNC %s (have_fullfsync=%d fullsync=%d)\n", pFile->zPath,
-            HAVE_FULLFSYNC, isFullsync));
-    rc = osOpenDirectory(pFile->zPath, &dirfd);
-    if( rc==SQLITE_OK ){
-      full_fsync(dirfd, 0, 0);
-      robust_close(pFile, dirfd, __LINE__);
-    }else{
-      assert( rc==SQLITE_CANTOPEN );
-      rc = SQLITE_OK;
-    }
-    pFile->ctrlFlags &= ~UNIXFILE_DIRSYNC;
-  }
-  return rc;
+  unixSyncDirectory(pFile, isFullsync);
+  return SQLITE_OK;
 }
 
 /*
@@ -3613,8 +4101,8 @@ static int unixTruncate(sqlite3_file *id, i64 nByte){
     ** mapped region, reduce the effective mapping size as well. SQLite will
     ** use read() and write() to access data beyond this point from now on.  
     */
-    if( nByte<pFile->mmapSize ){
-      pFile->mmapSize = nByte;
+    if( nByte<pFile->mmapOffset+pFile->mmapSize ){
+      pFile->mmapSize = nByte>pFile->mmapOffset ? nByte-pFile->mmapOffset : 0;
     }
 #endif
 
@@ -3709,7 +4197,7 @@ static int fcntlSizeHint(unixFile *pFile, i64 nByte){
   }
 
 #if SQLITE_MAX_MMAP_SIZE>0
-  if( pFile->mmapSizeMax>0 && nByte>pFile->mmapSize ){
+  if( pFile->mmapSizeMax>0 && nByte>pFile->mmapOffset+pFile->mmapSize ){
     int rc;
     if( pFile->szChunk<=0 ){
       if( robust_ftruncate(pFile->h, nByte) ){
@@ -3794,6 +4282,23 @@ static int unixFileControl(sqlite3_file *id, int op, void *pArg){
       *(int*)pArg = fileHasMoved(pFile);
       return SQLITE_OK;
     }
+    case SQLITE_FCNTL_DURABILITY: {
+      int eNew = *(int*)pArg;
+      if( eNew>=PAGER_DURABILITY_STRICT && eNew<=PAGER_DURABILITY_RELAXED ){
+        pFile->eDurability = (u8)eNew;
+      }
+      *(int*)pArg = pFile->eDurability;
+      return SQLITE_OK;
+    }
+    case SQLITE_FCNTL_IO_ALIGN: {
+      *(int*)pArg = 0;
+#if HAVE_DIRECT_IO
+      if( pFile->ctrlFlags & UNIXFILE_DIRECT ){
+        *(int*)pArg = SQLITE_DIRECT_IO_ALIGN;
+      }
+#endif
+      return SQLITE_OK;
+    }
 #if SQLITE_MAX_MMAP_SIZE>0
     case SQLITE_FCNTL_MMAP_SIZE: {
       i64 newLimit = *(i64*)pArg;
@@ -3801,6 +4306,7 @@ static int unixFileControl(sqlite3_file *id, int op, void *pArg){
       if( newLimit>sqlite3GlobalConfig.mxMmap ){
         newLimit = sqlite3GlobalConfig.mxMmap;
       }
+      if( pFile->ctrlFlags & UNIXFILE_DIRECT ) newLimit = 0;
       *(i64*)pArg = pFile->mmapSizeMax;
       if( newLimit>=0 && newLimit!=pFile->mmapSizeMax && pFile->nFetchOut==0 ){
         pFile->mmapSizeMax = newLimit;
@@ -3811,6 +4317,18 @@ static int unixFileControl(sqlite3_file *id, int op, void *pArg){
       }
       return rc;
     }
+    case SQLITE_FCNTL_MMAP_STATS: {
+      i64 *aStat = (i64*)pArg;
+      int mReset = (int)aStat[4];
+      aStat[0] = pFile->mmapSize;
+      aStat[1] = pFile->mmapSizePeak;
+      aStat[2] = pFile->nMapRemap;
+      aStat[3] = pFile->nMapMiss;
+      if( mReset & 0x01 ) pFile->mmapSizePeak = pFile->mmapSize;
+      if( mReset & 0x02 ) pFile->nMapRemap = 0;
+      if( mReset & 0x04 ) pFile->nMapMiss = 0;
+      return SQLITE_OK;
+    }
 #endif
 #ifdef SQLITE_DEBUG
     /* The pager calls this method to signal that it has done
@@ -3978,6 +4496,26 @@ static int unixGetpagesize(void){
 
 #ifndef SQLITE_OMIT_WAL
 
+/*
+** If SQLITE_SHM_RESERVE is set to a non-zero number of bytes, a range of
+** address space that size is reserved for each wal-index when it is first
+** mapped. The -shm file is then mapped into that range, and preallocated
+** when it is extended, SQLITE_SHM_CHUNK bytes at a time. This means a
+** large wal-index needs few mmap() calls and page faults, and that the
+** mapping can be backed by transparent huge pages where the file system
+** supports them. Regions beyond the reserved range are mapped one at a
+** time, as they are when SQLITE_SHM_RESERVE is zero.
+*/
+#ifndef SQLITE_SHM_RESERVE
+# define SQLITE_SHM_RESERVE 0
+#endif
+#ifndef SQLITE_SHM_CHUNK
+# define SQLITE_SHM_CHUNK (2*1024*1024)
+#endif
+#ifndef MAP_NORESERVE
+# define MAP_NORESERVE 0
+#endif
+
 /*
 ** Object used to represent an shared memory buffer.  
 **
@@ -4016,11 +4554,15 @@ struct unixShmNode {
   u16 nRegion;               /* Size of array apRegion */
   u8 isReadonly;             /* True if read-only */
   char **apRegion;           /* Array of mapped shared-memory regions */
+#if SQLITE_SHM_RESERVE>0
+  char *pReserve;            /* Reserved address range, or NULL */
+  u16 nReserveMap;           /* Regions of the file mapped into pReserve */
+#endif
   int nRef;                  /* Number of unixShm objects pointing to this */
   unixShm *pFirst;           /* All unixShm objects pointing to this */
 #ifdef SQLITE_DEBUG
-  u8 exclMask;               /* Mask of exclusive locks held */
-  u8 sharedMask;             /* Mask of shared locks held */
+  u32 exclMask;              /* Mask of exclusive locks held */
+  u32 sharedMask;            /* Mask of shared locks held */
   u8 nextShmId;              /* Next available unixShm.id value */
 #endif
 };
@@ -4043,15 +4585,22 @@ struct unixShm {
   unixShm *pNext;            /* Next unixShm with the same unixShmNode */
   u8 hasMutex;               /* True if holding the unixShmNode mutex */
   u8 id;                     /* Id of this connection within its unixShmNode */
-  u16 sharedMask;            /* Mask of shared locks held */
-  u16 exclMask;              /* Mask of exclusive locks held */
+  u32 sharedMask;            /* Mask of shared locks held */
+  u32 exclMask;              /* Mask of exclusive locks held */
 };
 
 /*
-** Constants used for locking
+** Constants used for locking.  The first eight shm locks and the deadman
+** switch use the same bytes whatever the value of SQLITE_SHM_NLOCK, so
+** that processes built with different values still see each other's
+** locks.  Locks 8 and up, if any, use the bytes starting at UNIX_SHM_XBASE,
+** which wal.c reserves after the stock 136-byte wal-index header.
 */
-#define UNIX_SHM_BASE   ((22+SQLITE_SHM_NLOCK)*4)         /* first lock byte */
-#define UNIX_SHM_DMS    (UNIX_SHM_BASE+SQLITE_SHM_NLOCK)  /* deadman switch */
+#define UNIX_SHM_BASE   ((22+8)*4)                     /* first lock byte */
+#define UNIX_SHM_DMS    (UNIX_SHM_BASE+8)              /* deadman switch */
+#if SQLITE_SHM_NLOCK>8
+# define UNIX_SHM_XBASE (136+(SQLITE_SHM_NLOCK-8)*4)   /* lock 8 and up */
+#endif
 
 /*
 ** Apply posix advisory locks for all bytes from ofst through ofst+n-1.
@@ -4093,9 +4642,9 @@ static int unixShmSystemLock(
 
   /* Update the global lock state and do debug tracing */
 #ifdef SQLITE_DEBUG
-  { u16 mask;
+  { u32 mask;
   OSTRACE(("SHM-LOCK "));
-  mask = ofst>31 ? 0xffff : (1<<(ofst+n)) - (1<<ofst);
+  mask = ofst>31 ? 0xffffffff : (1U<<(ofst+n)) - (1U<<ofst);
   if( rc==SQLITE_OK ){
     if( lockType==F_UNLCK ){
       OSTRACE(("unlock %d ok", ofst));
@@ -4129,6 +4678,37 @@ static int unixShmSystemLock(
   return rc;        
 }
 
+/*
+** Apply posix advisory locks to shm locks ofst through ofst+n-1.  Locks
+** below 8 map to the bytes at UNIX_SHM_BASE and any others to the bytes
+** at UNIX_SHM_XBASE.  If a range that spans both cannot be locked in full,
+** no part of it is left locked.
+*/
+static int unixShmSlotLock(
+  unixFile *pFile,       /* Open connection to the WAL file */
+  int lockType,          /* F_UNLCK, F_RDLCK, or F_WRLCK */
+  int ofst,              /* First shm lock */
+  int n                  /* Number of shm locks */
+){
+#if SQLITE_SHM_NLOCK>8
+  if( ofst+n>8 ){
+    int nBase = ofst<8 ? 8-ofst : 0;
+    int rc = SQLITE_OK;
+    if( nBase>0 ){
+      rc = unixShmSystemLock(pFile, lockType, UNIX_SHM_BASE+ofst, nBase);
+      if( rc!=SQLITE_OK ) return rc;
+    }
+    rc = unixShmSystemLock(pFile, lockType,
+                           UNIX_SHM_XBASE+ofst+nBase-8, n-nBase);
+    if( rc!=SQLITE_OK && nBase>0 && lockType!=F_UNLCK ){
+      unixShmSystemLock(pFile, F_UNLCK, UNIX_SHM_BASE+ofst, nBase);
+    }
+    return rc;
+  }
+#endif
+  return unixShmSystemLock(pFile, lockType, UNIX_SHM_BASE+ofst, n);
+}
+
 /*
 ** Return the minimum number of 32KB shm regions that should be mapped at
 ** a time, assuming that each mapping must be an integer multiple of the
@@ -4162,11 +4742,17 @@ static void unixShmPurge(unixFile *pFd){
     sqlite3_mutex_free(p->mutex);
     for(i=0; i<p->nRegion; i+=nShmPerMap){
       if( p->h>=0 ){
+#if SQLITE_SHM_RESERVE>0
+        if( i<p->nReserveMap ) continue;
+#endif
         osMunmap(p->apRegion[i], p->szRegion);
       }else{
         sqlite3_free(p->apRegion[i]);
       }
     }
+#if SQLITE_SHM_RESERVE>0
+    if( p->pReserve ) osMunmap(p->pReserve, SQLITE_SHM_RESERVE);
+#endif
     sqlite3_free(p->apRegion);
     if( p->h>=0 ){
       robust_close(pFd, p->h, __LINE__);
@@ -4340,6 +4926,80 @@ shm_open_err:
   return rc;
 }
 
+#if SQLITE_SHM_RESERVE>0
+/*
+** Return the number of szRegion byte regions that are mapped, and
+** preallocated, at a time within the range reserved for a wal-index.
+*/
+static int unixShmChunkRegions(int szRegion){
+  int nShmPerMap = unixShmRegionPerMap();
+  int nChunk = SQLITE_SHM_CHUNK / szRegion;
+  return ((nChunk + nShmPerMap - 1) / nShmPerMap) * nShmPerMap;
+}
+
+/*
+** Return the number of szRegion byte regions that fit within the range
+** reserved for a wal-index.
+*/
+static int unixShmReserveRegions(int szRegion){
+  int nChunk = unixShmChunkRegions(szRegion);
+  i64 nMax = SQLITE_SHM_RESERVE / ((i64)nChunk*szRegion) * nChunk;
+  return (int)(nMax>0xffff ? 0xffff/nChunk*nChunk : nMax);
+}
+
+/*
+** Make the regions of the wal-index below nReqRegion, or as many of them
+** as fit within the reserved range, available in pShmNode->apRegion[].
+** The caller has already made sure that the file is large enough to hold
+** them.
+**
+** The first call reserves SQLITE_SHM_RESERVE bytes of address space. The
+** file is then mapped into it a chunk at a time, so regions that lie in
+** a chunk that is already mapped need no system call at all. If address
+** space cannot be reserved, SQLITE_OK is returned and the caller maps
+** the regions one at a time instead.
+*/
+static int unixShmMapReserved(unixShmNode *pShmNode, int nReqRegion){
+  int szRegion = pShmNode->szRegion;
+  int nChunk = unixShmChunkRegions(szRegion);
+  int nMax = unixShmReserveRegions(szRegion);
+
+  if( pShmNode->pReserve==0 ){
+    void *pMem;
+    if( pShmNode->nRegion>0 || nMax==0 ) return SQLITE_OK;
+    pMem = osMmap(0, SQLITE_SHM_RESERVE, PROT_NONE,
+                  MAP_PRIVATE|MAP_ANON|MAP_NORESERVE, -1, 0);
+    if( pMem==MAP_FAILED ) return SQLITE_OK;
+    pShmNode->pReserve = (char*)pMem;
+  }
+  if( nReqRegion>nMax ) nReqRegion = nMax;
+
+  if( pShmNode->nReserveMap<nReqRegion ){
+    int nNew = (nReqRegion + nChunk - 1) / nChunk * nChunk;
+    i64 iOff = (i64)pShmNode->nReserveMap * szRegion;
+    size_t nMap = (size_t)(nNew - pShmNode->nReserveMap) * szRegion;
+    void *pMem = osMmap(&pShmNode->pReserve[iOff], nMap,
+        pShmNode->isReadonly ? PROT_READ : PROT_READ|PROT_WRITE,
+        MAP_SHARED|MAP_FIXED, pShmNode->h, iOff
+    );
+    if( pMem==MAP_FAILED ){
+      return unixLogError(SQLITE_IOERR_SHMMAP, "mmap", pShmNode->zFilename);
+    }
+#if HAVE_MADVISE && defined(MADV_HUGEPAGE)
+    osMadvise(pMem, nMap, MADV_HUGEPAGE);
+#endif
+    pShmNode->nReserveMap = (u16)nNew;
+  }
+
+  while( pShmNode->nRegion<nReqRegion ){
+    pShmNode->apRegion[pShmNode->nRegion] =
+        &pShmNode->pReserve[(i64)pShmNode->nRegion * szRegion];
+    pShmNode->nRegion++;
+  }
+  return SQLITE_OK;
+}
+#endif /* SQLITE_SHM_RESERVE>0 */
+
 /*
 ** This function is called to obtain a pointer to region iRegion of the 
 ** shared-memory associated with the database file fd. Shared-memory regions 
@@ -4426,6 +5086,14 @@ static int unixShmMap(
           static const int pgsz = 4096;
           int iPg;
 
+#if SQLITE_SHM_RESERVE>0
+          /* Within the reserved range, preallocate a whole chunk */
+          if( nReqRegion<unixShmReserveRegions(szRegion) ){
+            int nChunk = unixShmChunkRegions(szRegion);
+            nByte = (nReqRegion + nChunk - 1) / nChunk * nChunk * szRegion;
+          }
+#endif
+
           /* Write to the last byte of each newly allocated or extended page */
           assert( (nByte % pgsz)==0 );
           for(iPg=(sStat.st_size/pgsz); iPg<(nByte/pgsz); iPg++){
@@ -4449,6 +5117,12 @@ static int unixShmMap(
       goto shmpage_out;
     }
     pShmNode->apRegion = apNew;
+#if SQLITE_SHM_RESERVE>0
+    if( pShmNode->h>=0 ){
+      rc = unixShmMapReserved(pShmNode, nReqRegion);
+      if( rc!=SQLITE_OK ) goto shmpage_out;
+    }
+#endif
     while( pShmNode->nRegion<nReqRegion ){
       int nMap = szRegion*nShmPerMap;
       int i;
@@ -4508,7 +5182,7 @@ static int unixShmLock(
   unixShm *pX;                          /* For looping over all siblings */
   unixShmNode *pShmNode = p->pShmNode;  /* The underlying file iNode */
   int rc = SQLITE_OK;                   /* Result code */
-  u16 mask;                             /* Mask of locks to take or release */
+  u32 mask;                             /* Mask of locks to take or release */
 
   assert( pShmNode==pDbFd->pInode->pShmNode );
   assert( pShmNode->pInode==pDbFd->pInode );
@@ -4522,11 +5196,11 @@ static int unixShmLock(
   assert( pShmNode->h>=0 || pDbFd->pInode->bProcessLock==1 );
   assert( pShmNode->h<0 || pDbFd->pInode->bProcessLock==0 );
 
-  mask = (1<<(ofst+n)) - (1<<ofst);
-  assert( n>1 || mask==(1<<ofst) );
+  mask = (1U<<(ofst+n)) - (1U<<ofst);
+  assert( n>1 || mask==(1U<<ofst) );
   sqlite3_mutex_enter(pShmNode->mutex);
   if( flags & SQLITE_SHM_UNLOCK ){
-    u16 allMask = 0; /* Mask of locks held by siblings */
+    u32 allMask = 0; /* Mask of locks held by siblings */
 
     /* See if any siblings hold this same lock */
     for(pX=pShmNode->pFirst; pX; pX=pX->pNext){
@@ -4537,7 +5211,7 @@ static int unixShmLock(
 
     /* Unlock the system-level locks */
     if( (mask & allMask)==0 ){
-      rc = unixShmSystemLock(pDbFd, F_UNLCK, ofst+UNIX_SHM_BASE, n);
+      rc = unixShmSlotLock(pDbFd, F_UNLCK, ofst, n);
     }else{
       rc = SQLITE_OK;
     }
@@ -4548,7 +5222,7 @@ static int unixShmLock(
       p->sharedMask &= ~mask;
     } 
   }else if( flags & SQLITE_SHM_SHARED ){
-    u16 allShared = 0;  /* Union of locks held by connections other than "p" */
+    u32 allShared = 0;  /* Union of locks held by connections other than "p" */
 
     /* Find out which shared locks are already held by sibling connections.
     ** If any sibling already holds an exclusive lock, go ahead and return
@@ -4565,7 +5239,7 @@ static int unixShmLock(
     /* Get shared locks at the system level, if necessary */
     if( rc==SQLITE_OK ){
       if( (allShared & mask)==0 ){
-        rc = unixShmSystemLock(pDbFd, F_RDLCK, ofst+UNIX_SHM_BASE, n);
+        rc = unixShmSlotLock(pDbFd, F_RDLCK, ofst, n);
       }else{
         rc = SQLITE_OK;
       }
@@ -4590,7 +5264,7 @@ static int unixShmLock(
     ** also mark the local connection as being locked.
     */
     if( rc==SQLITE_OK ){
-      rc = unixShmSystemLock(pDbFd, F_WRLCK, ofst+UNIX_SHM_BASE, n);
+      rc = unixShmSlotLock(pDbFd, F_WRLCK, ofst, n);
       if( rc==SQLITE_OK ){
         assert( (p->sharedMask & mask)==0 );
         p->exclMask |= mask;
@@ -4679,21 +5353,48 @@ static int unixShmUnmap(
 
 #if SQLITE_MAX_MMAP_SIZE>0
 /*
-** If it is currently memory mapped, unmap file pFd.
+** A file larger than its mmap_size limit is mapped through a window of
+** that size. Once SQLITE_MMAP_SLIDE consecutive xFetch() requests have
+** fallen outside of the window, it is moved so that it starts a quarter
+** of its size before the last of them.
+*/
+#ifndef SQLITE_MMAP_SLIDE
+# define SQLITE_MMAP_SLIDE 16
+#endif
+
+/*
+** Once SQLITE_MMAP_ADVISE_RUN consecutive xFetch() requests have been
+** sequential, or random, the mapping is given an madvise() hint to say
+** so. While access is sequential, the next SQLITE_MMAP_READAHEAD bytes
+** of the mapping are also marked MADV_WILLNEED ahead of the reader.
+*/
+#ifndef SQLITE_MMAP_ADVISE_RUN
+# define SQLITE_MMAP_ADVISE_RUN 16
+#endif
+#ifndef SQLITE_MMAP_READAHEAD
+# define SQLITE_MMAP_READAHEAD (1024*1024)
+#endif
+
+/*
+** If it is currently memory mapped, unmap file pFd.
 */
 static void unixUnmapfile(unixFile *pFd){
-  assert( pFd->nFetchOut==0 );
+  assert( pFd->nMapRef==0 );
   if( pFd->pMapRegion ){
     osMunmap(pFd->pMapRegion, pFd->mmapSizeActual);
     pFd->pMapRegion = 0;
     pFd->mmapSize = 0;
     pFd->mmapSizeActual = 0;
   }
+  pFd->mmapOffset = 0;
+  pFd->eMapAdvice = 0;
+  pFd->iMapWillNeed = 0;
 }
 
 /*
 ** Attempt to set the size of the memory mapping maintained by file 
-** descriptor pFd to nNew bytes. Any existing mapping is discarded.
+** descriptor pFd to nNew bytes, starting at file offset pFd->mmapOffset.
+** Any existing mapping is discarded.
 **
 ** If successful, this function sets the following variables:
 **
@@ -4717,7 +5418,7 @@ static void unixRemapfile(
   u8 *pNew = 0;                        /* Location of new mapping */
   int flags = PROT_READ;               /* Flags to pass to mmap() */
 
-  assert( pFd->nFetchOut==0 );
+  assert( pFd->nMapRef==0 );
   assert( nNew>pFd->mmapSize );
   assert( nNew<=pFd->mmapSizeMax );
   assert( nNew>0 );
@@ -4746,7 +5447,8 @@ static void unixRemapfile(
     pNew = osMremap(pOrig, nReuse, nNew, MREMAP_MAYMOVE);
     zErr = "mremap";
 #else
-    pNew = osMmap(pReq, nNew-nReuse, flags, MAP_SHARED, h, nReuse);
+    pNew = osMmap(pReq, nNew-nReuse, flags, MAP_SHARED, h,
+                  pFd->mmapOffset+nReuse);
     if( pNew!=MAP_FAILED ){
       if( pNew!=pReq ){
         osMunmap(pNew, nNew - nReuse);
@@ -4765,7 +5467,7 @@ static void unixRemapfile(
 
   /* If pNew is still NULL, try to create an entirely new mapping. */
   if( pNew==0 ){
-    pNew = osMmap(0, nNew, flags, MAP_SHARED, h, 0);
+    pNew = osMmap(0, nNew, flags, MAP_SHARED, h, pFd->mmapOffset);
   }
 
   if( pNew==MAP_FAILED ){
@@ -4777,9 +5479,13 @@ static void unixRemapfile(
     ** will probably fail too. Fall back to using xRead/xWrite exclusively
     ** in this case.  */
     pFd->mmapSizeMax = 0;
+    pFd->mmapOffset = 0;
   }
   pFd->pMapRegion = (void *)pNew;
   pFd->mmapSize = pFd->mmapSizeActual = nNew;
+  pFd->nMapRemap++;
+  pFd->eMapAdvice = 0;
+  if( nNew>pFd->mmapSizePeak ) pFd->mmapSizePeak = nNew;
 }
 
 /*
@@ -4788,11 +5494,12 @@ static void unixRemapfile(
 ** there already exists a mapping for this file, and there are still 
 ** outstanding xFetch() references to it, this function is a no-op.
 **
-** If parameter nByte is non-negative, then it is the requested size of 
-** the mapping to create. Otherwise, if nByte is less than zero, then the 
-** requested size is the size of the file on disk. The actual size of the
-** created mapping is either the requested size or the value configured 
-** using SQLITE_FCNTL_MMAP_LIMIT, whichever is smaller.
+** If parameter nByte is non-negative, then it is the size of the file
+** to map. Otherwise, if nByte is less than zero, the size of the file on
+** disk is used. The mapping covers the file from offset pFd->mmapOffset
+** up to the end of the file or the limit configured using
+** SQLITE_FCNTL_MMAP_SIZE, whichever is smaller. If the file has shrunk
+** to no more than pFd->mmapOffset bytes, it is mapped from the start.
 **
 ** SQLITE_OK is returned if no error occurs (even if the mapping is not
 ** recreated as a result of outstanding references) or an SQLite error
@@ -4801,7 +5508,7 @@ static void unixRemapfile(
 static int unixMapfile(unixFile *pFd, i64 nMap){
   assert( nMap>=0 || pFd->nFetchOut==0 );
   assert( nMap>0 || (pFd->mmapSize==0 && pFd->pMapRegion==0) );
-  if( pFd->nFetchOut>0 ) return SQLITE_OK;
+  if( pFd->nMapRef>0 ) return SQLITE_OK;
 
   if( nMap<0 ){
     struct stat statbuf;          /* Low-level file information */
@@ -4810,6 +5517,10 @@ static int unixMapfile(unixFile *pFd, i64 nMap){
     }
     nMap = statbuf.st_size;
   }
+  if( pFd->mmapOffset>0 ){
+    if( nMap<=pFd->mmapOffset ) unixUnmapfile(pFd);
+    nMap -= pFd->mmapOffset;
+  }
   if( nMap>pFd->mmapSizeMax ){
     nMap = pFd->mmapSizeMax;
   }
@@ -4821,6 +5532,115 @@ static int unixMapfile(unixFile *pFd, i64 nMap){
 
   return SQLITE_OK;
 }
+
+/*
+** Move the window through which file pFd is mapped so that it covers
+** offset iOff, which has just been requested using xFetch(). If the whole
+** file fits within the mmap_size limit, the mapping is extended to cover
+** all of it instead.
+**
+** If there are xFetch() references into the current mapping, it is kept
+** in one of the pFd->aMapOld[] slots until they have been released. If
+** there is no free slot, the mapping is left as it is.
+*/
+static int unixSlideMapfile(unixFile *pFd, i64 iOff){
+  struct stat statbuf;            /* Low-level file information */
+  i64 iNew = 0;                   /* New value for pFd->mmapOffset */
+  int i;
+
+  pFd->nMapMissRun = 0;
+  if( osFstat(pFd->h, &statbuf) ){
+    return SQLITE_IOERR_FSTAT;
+  }
+  if( statbuf.st_size>pFd->mmapSizeMax ){
+    i64 szSyspage = osGetpagesize();
+    iNew = iOff - pFd->mmapSizeMax/4;
+    if( iNew+pFd->mmapSizeMax>statbuf.st_size ){
+      iNew = statbuf.st_size - pFd->mmapSizeMax;
+    }
+    if( iNew<0 ) iNew = 0;
+    iNew &= ~(szSyspage-1);
+  }
+  if( iNew==pFd->mmapOffset && pFd->nMapRef>0 ){
+    return SQLITE_OK;
+  }
+  if( pFd->nMapRef>0 ){
+    for(i=0; i<UNIX_MMAP_NOLD && pFd->aMapOld[i].pMap; i++);
+    if( i==UNIX_MMAP_NOLD ) return SQLITE_OK;
+    pFd->aMapOld[i].pMap = pFd->pMapRegion;
+    pFd->aMapOld[i].nMap = pFd->mmapSizeActual;
+    pFd->aMapOld[i].nRef = pFd->nMapRef;
+    pFd->pMapRegion = 0;
+    pFd->mmapSize = 0;
+    pFd->mmapSizeActual = 0;
+    pFd->nMapRef = 0;
+  }
+  if( iNew!=pFd->mmapOffset ){
+    unixUnmapfile(pFd);
+    pFd->mmapOffset = iNew;
+  }
+  return unixMapfile(pFd, statbuf.st_size);
+}
+
+#if HAVE_MADVISE
+/*
+** Values for unixFile.eMapAdvice
+*/
+#define UNIX_MADV_NONE        0   /* No hint given since mapping was made */
+#define UNIX_MADV_RANDOM      1   /* MADV_RANDOM */
+#define UNIX_MADV_SEQUENTIAL  2   /* MADV_SEQUENTIAL */
+
+/*
+** This is called for each xFetch() request on file pFd that is satisfied
+** from the mapping. The request covers nAmt bytes at offset iOff. A request
+** is sequential if it starts at, or a few pages beyond, the end of the
+** one before it. Once a run of requests has been sequential, or random,
+** tell the kernel so that it can adjust its read-ahead. While access is
+** sequential, also ask for the data just ahead of the reader to be read
+** in the background.
+*/
+static void unixMapAdvise(unixFile *pFd, i64 iOff, int nAmt){
+  u8 *pMap = (u8*)pFd->pMapRegion;
+  int eAdvice = UNIX_MADV_NONE;
+
+  if( iOff>=pFd->iMapNext && iOff<=pFd->iMapNext+4*(i64)nAmt ){
+    pFd->nMapRandRun = 0;
+    if( pFd->nMapSeqRun<SQLITE_MMAP_ADVISE_RUN ){
+      pFd->nMapSeqRun++;
+    }else{
+      eAdvice = UNIX_MADV_SEQUENTIAL;
+    }
+  }else{
+    pFd->nMapSeqRun = 0;
+    if( pFd->nMapRandRun<SQLITE_MMAP_ADVISE_RUN ){
+      pFd->nMapRandRun++;
+    }else{
+      eAdvice = UNIX_MADV_RANDOM;
+    }
+  }
+  pFd->iMapNext = iOff + nAmt;
+
+  if( eAdvice!=UNIX_MADV_NONE && eAdvice!=pFd->eMapAdvice ){
+    osMadvise(pMap, (size_t)pFd->mmapSize,
+        eAdvice==UNIX_MADV_SEQUENTIAL ? MADV_SEQUENTIAL : MADV_RANDOM
+    );
+    pFd->eMapAdvice = (u8)eAdvice;
+    pFd->iMapWillNeed = 0;
+  }
+  if( pFd->eMapAdvice==UNIX_MADV_SEQUENTIAL
+   && iOff+SQLITE_MMAP_READAHEAD/2>pFd->iMapWillNeed
+  ){
+    i64 szSyspage = osGetpagesize();
+    i64 iStart = (iOff - pFd->mmapOffset) & ~(szSyspage-1);
+    i64 iEnd = iStart + SQLITE_MMAP_READAHEAD;
+    if( iEnd>pFd->mmapSize ) iEnd = pFd->mmapSize;
+    if( iEnd>iStart ){
+      osMadvise(&pMap[iStart], (size_t)(iEnd-iStart), MADV_WILLNEED);
+    }
+    pFd->iMapWillNeed = pFd->mmapOffset + iEnd;
+  }
+}
+#endif /* HAVE_MADVISE */
 #endif /* SQLITE_MAX_MMAP_SIZE>0 */
 
 /*
@@ -4843,13 +5663,28 @@ static int unixFetch(sqlite3_file *fd, i64 iOff, int nAmt, void **pp){
 
 #if SQLITE_MAX_MMAP_SIZE>0
   if( pFd->mmapSizeMax>0 ){
+    i64 iRel;
     if( pFd->pMapRegion==0 ){
       int rc = unixMapfile(pFd, -1);
       if( rc!=SQLITE_OK ) return rc;
     }
-    if( pFd->mmapSize >= iOff+nAmt ){
-      *pp = &((u8 *)pFd->pMapRegion)[iOff];
+    iRel = iOff - pFd->mmapOffset;
+    if( (iRel<0 || iRel+nAmt>pFd->mmapSize) && pFd->mmapSizeMax>=nAmt ){
+      pFd->nMapMiss++;
+      if( ++pFd->nMapMissRun>=SQLITE_MMAP_SLIDE ){
+        int rc = unixSlideMapfile(pFd, iOff);
+        if( rc!=SQLITE_OK ) return rc;
+        iRel = iOff - pFd->mmapOffset;
+      }
+    }
+    if( iRel>=0 && pFd->mmapSize>=iRel+nAmt ){
+      *pp = &((u8 *)pFd->pMapRegion)[iRel];
       pFd->nFetchOut++;
+      pFd->nMapRef++;
+      pFd->nMapMissRun = 0;
+#if HAVE_MADVISE
+      unixMapAdvise(pFd, iOff, nAmt);
+#endif
     }
   }
 #endif
@@ -4876,11 +5711,29 @@ static int unixUnfetch(sqlite3_file *fd, i64 iOff, void *p){
   ** then there must be at least one outstanding.  */
   assert( (p==0)==(pFd->nFetchOut==0) );
 
-  /* If p!=0, it must match the iOff value. */
-  assert( p==0 || p==&((u8 *)pFd->pMapRegion)[iOff] );
-
   if( p ){
+    u8 *pMap = (u8*)pFd->pMapRegion;
     pFd->nFetchOut--;
+    if( pMap && (u8*)p>=pMap && (u8*)p<&pMap[pFd->mmapSizeActual] ){
+      /* If p is in the current mapping, it must match the iOff value. */
+      assert( p==&pMap[iOff-pFd->mmapOffset] );
+      pFd->nMapRef--;
+    }else{
+      /* Otherwise it is in a mapping that has since been replaced */
+      int i;
+      for(i=0; i<UNIX_MMAP_NOLD; i++){
+        UnixMapOld *pOld = &pFd->aMapOld[i];
+        u8 *pOldMap = (u8*)pOld->pMap;
+        if( pOldMap && (u8*)p>=pOldMap && (u8*)p<&pOldMap[pOld->nMap] ){
+          if( (--pOld->nRef)==0 ){
+            osMunmap(pOld->pMap, pOld->nMap);
+            pOld->pMap = 0;
+          }
+          break;
+        }
+      }
+      assert( i<UNIX_MMAP_NOLD );
+    }
   }else{
     unixUnmapfile(pFd);
   }
@@ -4955,6 +5808,7 @@ static const sqlite3_io_methods METHOD = {                                   \
    unixShmUnmap,               /* xShmUnmap */                               \
    unixFetch,                  /* xFetch */                                  \
    unixUnfetch,                /* xUnfetch */                                \
+   unixWriteV,                 /* xWriteV */                                 \
 };                                                                           \
 static const sqlite3_io_methods *FINDER##Impl(const char *z, unixFile *p){   \
   UNUSED_PARAMETER(z); UNUSED_PARAMETER(p);                                  \
@@ -4971,7 +5825,7 @@ static const sqlite3_io_methods *(*const FINDER)(const char*,unixFile *p)    \
 IOMETHODS(
   posixIoFinder,            /* Finder function name */
   posixIoMethods,           /* sqlite3_io_methods object name */
-  3,                        /* shared memory and mmap are enabled */
+  4,                        /* shared memory, mmap and writev are enabled */
   unixClose,                /* xClose method */
   unixLock,                 /* xLock method */
   unixUnlock,               /* xUnlock method */
@@ -4981,7 +5835,7 @@ IOMETHODS(
 IOMETHODS(
   nolockIoFinder,           /* Finder function name */
   nolockIoMethods,          /* sqlite3_io_methods object name */
-  3,                        /* shared memory is disabled */
+  4,                        /* shared memory is disabled */
   nolockClose,              /* xClose method */
   nolockLock,               /* xLock method */
   nolockUnlock,             /* xUnlock method */
@@ -5180,6 +6034,680 @@ static const sqlite3_io_methods
 
 #endif /* OS_VXWORKS */
 
+#if UNIX_USE_URING
+/******************************************************************************
+************************** Begin io_uring I/O *********************************
+**
+** The "unix-uring" VFS locks files in the same way as "unix" but submits
+** writes, syncs and large reads through an io_uring instance owned by each
+** file, using the kernel interface in <linux/io_uring.h> directly.
+**
+** The pager and the WAL send SQLITE_FCNTL_WRITE_BATCH around the writes of
+** a commit and of a checkpoint. Writes issued within such a batch are
+** copied into a staging buffer registered with the ring and held. They are
+** submitted all together when the batch ends or, if the file is synced
+** first, together with an fsync that the kernel only starts once they have
+** all completed (IOSQE_IO_DRAIN). So a commit that writes N separate runs
+** of pages and then syncs makes one io_uring_enter() call rather than N+1
+** system calls. Held writes are also submitted before any other method
+** reads, truncates, measures or locks the file, and adjacent held writes
+** are merged.
+**
+** Reads of at least 2*URING_READ_CHUNK bytes, such as those made by the
+** pager read-ahead, are split into chunks that the kernel reads
+** concurrently.
+**
+** The ring is created the first time a file needs it. If that fails, for
+** example because the kernel does not support io_uring (Linux 5.2 or later
+** is required), the file quietly falls back to the plain unix methods.
+*/
+
+/*
+** Number of submission queue entries in each ring, and the size in bytes
+** of the staging buffer that holds the writes of a batch.
+*/
+#ifndef SQLITE_URING_ENTRIES
+# define SQLITE_URING_ENTRIES 64
+#endif
+#ifndef SQLITE_URING_STAGING
+# define SQLITE_URING_STAGING (1024*1024)
+#endif
+
+/*
+** Large reads are split into chunks of this many bytes.
+*/
+#define URING_READ_CHUNK (64*1024)
+
+/*
+** System call numbers, for C libraries that predate io_uring.
+*/
+#ifndef __NR_io_uring_setup
+# define __NR_io_uring_setup    425
+# define __NR_io_uring_enter    426
+# define __NR_io_uring_register 427
+#endif
+
+/*
+** Values for UringOp.eOp
+*/
+#define URING_OP_WRITE  1
+#define URING_OP_READ   2
+
+/*
+** One read or write to be submitted on a ring.
+*/
+typedef struct UringOp UringOp;
+struct UringOp {
+  u8 eOp;                         /* URING_OP_WRITE or URING_OP_READ */
+  i64 iOff;                       /* File offset */
+  struct iovec iov;               /* Buffer to read into or write from */
+  int res;                        /* Result from the completion queue */
+};
+
+/*
+** An io_uring instance and the writes held on it for one file.
+*/
+struct UringRing {
+  int fd;                         /* File descriptor of the ring */
+  u8 bFixed;                      /* True if aStage[] is registered */
+  u8 bBatch;                      /* True while a write batch is open */
+  unsigned *sqHead;               /* Submission queue head */
+  unsigned *sqTail;               /* Submission queue tail */
+  unsigned *sqMask;               /* Submission queue index mask */
+  unsigned *sqArray;              /* Submission queue indirection array */
+  struct io_uring_sqe *aSqe;      /* Submission queue entries */
+  unsigned *cqHead;               /* Completion queue head */
+  unsigned *cqTail;               /* Completion queue tail */
+  unsigned *cqMask;               /* Completion queue index mask */
+  struct io_uring_cqe *aCqe;      /* Completion queue entries */
+  void *pSqRing;                  /* Mapping of the submission queue ring */
+  void *pCqRing;                  /* Separate mapping of the CQ ring, if any */
+  size_t szSqRing;                /* Size of mapping pSqRing */
+  size_t szCqRing;                /* Size of mapping pCqRing */
+  size_t szSqe;                   /* Size of mapping aSqe */
+  u8 *aStage;                     /* Staging buffer for held writes */
+  int nStage;                     /* Bytes of aStage[] in use */
+  int nOp;                        /* Number of held writes in aOp[] */
+  UringOp aOp[SQLITE_URING_ENTRIES];
+};
+
+/*
+** Release all resources held by ring p.
+*/
+static void uringRingFree(UringRing *p){
+  if( p->aSqe ) munmap(p->aSqe, p->szSqe);
+  if( p->pCqRing ) munmap(p->pCqRing, p->szCqRing);
+  if( p->pSqRing ) munmap(p->pSqRing, p->szSqRing);
+  if( p->fd>=0 ) osClose(p->fd);
+  sqlite3_free(p->aStage);
+  sqlite3_free(p);
+}
+
+/*
+** Create a new ring and register its staging buffer with the kernel.
+** Return NULL if the kernel does not support io_uring or if any resource
+** cannot be allocated.
+*/
+static UringRing *uringRingNew(void){
+  struct io_uring_params prm;
+  struct iovec iov;
+  UringRing *p;
+  u8 *pSq;
+  u8 *pCq;
+  void *pMap;
+
+  p = (UringRing*)sqlite3_malloc64(sizeof(UringRing));
+  if( p==0 ) return 0;
+  memset(p, 0, sizeof(UringRing));
+  memset(&prm, 0, sizeof(prm));
+  p->aStage = (u8*)sqlite3_malloc64(SQLITE_URING_STAGING);
+  p->fd = (int)syscall(__NR_io_uring_setup, SQLITE_URING_ENTRIES, &prm);
+  if( p->aStage==0 || p->fd<0 ) goto ring_failed;
+
+  p->szSqRing = prm.sq_off.array + prm.sq_entries*sizeof(unsigned);
+  p->szCqRing = prm.cq_off.cqes + prm.cq_entries*sizeof(struct io_uring_cqe);
+  if( (prm.features & IORING_FEAT_SINGLE_MMAP) && p->szCqRing>p->szSqRing ){
+    p->szSqRing = p->szCqRing;
+  }
+  pMap = mmap(0, p->szSqRing, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE,
+              p->fd, IORING_OFF_SQ_RING);
+  if( pMap==MAP_FAILED ) goto ring_failed;
+  p->pSqRing = pMap;
+  pSq = pCq = (u8*)pMap;
+  if( (prm.features & IORING_FEAT_SINGLE_MMAP)==0 ){
+    pMap = mmap(0, p->szCqRing, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE,
+                p->fd, IORING_OFF_CQ_RING);
+    if( pMap==MAP_FAILED ) goto ring_failed;
+    p->pCqRing = pMap;
+    pCq = (u8*)pMap;
+  }
+  p->szSqe = prm.sq_entries*sizeof(struct io_uring_sqe);
+  pMap = mmap(0, p->szSqe, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE,
+              p->fd, IORING_OFF_SQES);
+  if( pMap==MAP_FAILED ) goto ring_failed;
+  p->aSqe = (struct io_uring_sqe*)pMap;
+
+  p->sqHead = (unsigned*)&pSq[prm.sq_off.head];
+  p->sqTail = (unsigned*)&pSq[prm.sq_off.tail];
+  p->sqMask = (unsigned*)&pSq[prm.sq_off.ring_mask];
+  p->sqArray = (unsigned*)&pSq[prm.sq_off.array];
+  p->cqHead = (unsigned*)&pCq[prm.cq_off.head];
+  p->cqTail = (unsigned*)&pCq[prm.cq_off.tail];
+  p->cqMask = (unsigned*)&pCq[prm.cq_off.ring_mask];
+  p->aCqe = (struct io_uring_cqe*)&pCq[prm.cq_off.cqes];
+
+  /* Writes are staged in a registered buffer if possible, which saves the
+  ** kernel from mapping the pages of the buffer for each submission. If
+  ** registration fails (RLIMIT_MEMLOCK is too low, for example), writes
+  ** use IORING_OP_WRITEV instead. */
+  iov.iov_base = p->aStage;
+  iov.iov_len = SQLITE_URING_STAGING;
+  p->bFixed = syscall(__NR_io_uring_register, p->fd,
+                      IORING_REGISTER_BUFFERS, &iov, 1)==0;
+  return p;
+
+ring_failed:
+  uringRingFree(p);
+  return 0;
+}
+
+/*
+** Return the ring for file pFile, creating it if this is the first time
+** it is needed. Return NULL if io_uring cannot be used for this file.
+*/
+static UringRing *uringRing(unixFile *pFile){
+  if( pFile->pRing==0 && (pFile->ctrlFlags & UNIXFILE_NOURING)==0 ){
+    pFile->pRing = uringRingNew();
+    if( pFile->pRing==0 ) pFile->ctrlFlags |= UNIXFILE_NOURING;
+  }
+  return pFile->pRing;
+}
+
+/*
+** Stop using the ring of pFile after a call to io_uring_enter() has
+** failed. The ring is not freed, as the kernel might still be using its
+** staging buffer.
+*/
+static void uringAbandon(unixFile *pFile){
+  pFile->pRing = 0;
+  pFile->ctrlFlags |= UNIXFILE_NOURING;
+}
+
+/*
+** Submit the first nOp operations in p->aOp[] against file descriptor fd
+** and wait for all of them to complete, storing the result of each in its
+** UringOp.res field. If syncFlags is not zero, an fsync of fd that starts
+** only after all of the operations have completed is submitted with them,
+** and its result stored in *pSyncRes.
+**
+** Return 0 if successful, or an errno value if io_uring_enter() fails.
+*/
+static int uringRun(
+  UringRing *p,                   /* The ring */
+  int fd,                         /* File to read or write */
+  int nOp,                        /* Number of operations in p->aOp[] */
+  int syncFlags,                  /* Sync flags, or 0 for no sync */
+  int *pSyncRes                   /* OUT: Result of the fsync */
+){
+  unsigned iTail = *p->sqTail;
+  unsigned nSqe = 0;
+  unsigned nDone = 0;
+  int i;
+
+  assert( nOp+(syncFlags!=0)<=SQLITE_URING_ENTRIES );
+  for(i=0; i<=nOp; i++){
+    unsigned idx = (iTail+nSqe) & *p->sqMask;
+    struct io_uring_sqe *pSqe = &p->aSqe[idx];
+    if( i==nOp && syncFlags==0 ) break;
+    memset(pSqe, 0, sizeof(*pSqe));
+    pSqe->fd = fd;
+    pSqe->user_data = i;
+    if( i==nOp ){
+      pSqe->opcode = IORING_OP_FSYNC;
+      pSqe->flags = IOSQE_IO_DRAIN;
+#if HAVE_FDATASYNC
+      if( syncFlags & SQLITE_SYNC_DATAONLY ){
+        pSqe->fsync_flags = IORING_FSYNC_DATASYNC;
+      }
+#endif
+    }else{
+      UringOp *pOp = &p->aOp[i];
+      pSqe->off = (u64)pOp->iOff;
+      if( pOp->eOp==URING_OP_READ ){
+        pSqe->opcode = IORING_OP_READV;
+        pSqe->addr = (u64)(uintptr_t)&pOp->iov;
+        pSqe->len = 1;
+      }else if( p->bFixed ){
+        pSqe->opcode = IORING_OP_WRITE_FIXED;
+        pSqe->addr = (u64)(uintptr_t)pOp->iov.iov_base;
+        pSqe->len = (u32)pOp->iov.iov_len;
+        pSqe->buf_index = 0;
+      }else{
+        pSqe->opcode = IORING_OP_WRITEV;
+        pSqe->addr = (u64)(uintptr_t)&pOp->iov;
+        pSqe->len = 1;
+      }
+    }
+    p->sqArray[idx] = idx;
+    nSqe++;
+  }
+  __atomic_store_n(p->sqTail, iTail+nSqe, __ATOMIC_RELEASE);
+
+  while( 1 ){
+    unsigned iHead = *p->cqHead;
+    unsigned iCqTail = __atomic_load_n(p->cqTail, __ATOMIC_ACQUIRE);
+    unsigned nSubmit;
+    while( iHead!=iCqTail ){
+      struct io_uring_cqe *pCqe = &p->aCqe[iHead & *p->cqMask];
+      if( pCqe->user_data<(u64)nOp ){
+        p->aOp[pCqe->user_data].res = pCqe->res;
+      }else{
+        *pSyncRes = pCqe->res;
+      }
+      iHead++;
+      nDone++;
+    }
+    __atomic_store_n(p->cqHead, iHead, __ATOMIC_RELEASE);
+    if( nDone>=nSqe ) break;
+    nSubmit = iTail + nSqe - __atomic_load_n(p->sqHead, __ATOMIC_ACQUIRE);
+    if( syscall(__NR_io_uring_enter, p->fd, nSubmit, nSqe-nDone,
+                IORING_ENTER_GETEVENTS, 0, 0)<0
+     && errno!=EINTR && errno!=EAGAIN && errno!=EBUSY
+    ){
+      return errno;
+    }
+  }
+  return 0;
+}
+
+/*
+** Submit the writes held for file pFile and wait for them to complete.
+** If syncFlags is not zero, the file is also synced, with an fsync that
+** the kernel starts once all of the writes have completed. This is a
+** no-op if no writes are held.
+*/
+static int uringFlush(unixFile *pFile, int syncFlags){
+  UringRing *p = pFile->pRing;
+  int rc = SQLITE_OK;
+  int bRewrite = 0;               /* True if a short write was completed */
+  int resSync = 0;                /* Result of the fsync */
+  int nOp;
+  int e;
+  int i;
+
+  if( p==0 || p->nOp==0 ) return SQLITE_OK;
+  nOp = p->nOp;
+  p->nOp = 0;
+  p->nStage = 0;
+
+  TIMER_START;
+  e = uringRun(p, pFile->h, nOp, syncFlags, &resSync);
+  TIMER_END;
+  OSTRACE(("URING   %-3d %d writes%s %llu\n",
+           pFile->h, nOp, syncFlags ? " + sync" : "", TIMER_ELAPSED));
+  if( e ){
+    uringAbandon(pFile);
+    storeLastErrno(pFile, e);
+    return unixLogError(SQLITE_IOERR_WRITE, "io_uring_enter", pFile->zPath);
+  }
+
+  for(i=0; i<nOp; i++){
+    UringOp *pOp = &p->aOp[i];
+    if( pOp->res<0 ){
+      if( rc==SQLITE_OK ){
+        storeLastErrno(pFile, -pOp->res);
+        rc = pOp->res==-ENOSPC ? SQLITE_FULL : SQLITE_IOERR_WRITE;
+      }
+    }else if( pOp->res<(int)pOp->iov.iov_len ){
+      /* A short write. Write the rest directly. The data is still in
+      ** aStage[] as nothing can be staged before this function returns. */
+      int rc2 = unixWrite((sqlite3_file*)pFile,
+          &((u8*)pOp->iov.iov_base)[pOp->res],
+          (int)pOp->iov.iov_len - pOp->res, pOp->iOff + pOp->res
+      );
+      if( rc==SQLITE_OK ) rc = rc2;
+      bRewrite = 1;
+    }
+  }
+
+  if( rc==SQLITE_OK && syncFlags ){
+    if( resSync<0 ){
+      storeLastErrno(pFile, -resSync);
+      rc = unixLogError(SQLITE_IOERR_FSYNC, "io_uring fsync", pFile->zPath);
+    }else if( bRewrite ){
+      /* The fsync may have run before the rest of a short write */
+      rc = unixSync((sqlite3_file*)pFile, syncFlags);
+    }else{
+      unixSyncDirectory(pFile, (syncFlags&0x0F)==SQLITE_SYNC_FULL);
+    }
+  }
+  return rc;
+}
+
+/*
+** Return true if any write held on ring p overlaps the nByte bytes of the
+** file starting at offset iOff.
+*/
+static int uringOverlap(UringRing *p, i64 iOff, i64 nByte){
+  int i;
+  for(i=0; i<p->nOp; i++){
+    UringOp *pOp = &p->aOp[i];
+    if( iOff<pOp->iOff+(i64)pOp->iov.iov_len && pOp->iOff<iOff+nByte ){
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/*
+** Return true if a write of nByte bytes at offset iOff of file pFile may
+** be held until the current batch is submitted.
+*/
+static int uringCanHold(unixFile *pFile, i64 iOff, i64 nByte){
+  UNUSED_PARAMETER(iOff);
+  return pFile->pRing!=0
+      && pFile->pRing->bBatch
+      && nByte<=SQLITE_URING_STAGING
+#ifdef SQLITE_DEBUG
+      /* unixWrite() checks updates of the transaction counter */
+      && !(pFile->inNormalWrite && iOff<=24)
+#endif
+#if defined(SQLITE_MMAP_READWRITE) && SQLITE_MAX_MMAP_SIZE>0
+      && iOff>=pFile->mmapSize
+#endif
+  ;
+}
+
+/*
+** Copy the nBuf buffers in apBuf[] into the staging buffer of pFile and
+** hold them as a write to the file starting at offset iOff.
+*/
+static int uringHold(
+  unixFile *pFile,
+  int nBuf,
+  const void **apBuf,
+  const int *anBuf,
+  i64 iOff
+){
+  UringRing *p = pFile->pRing;
+  UringOp *pLast;
+  u8 *pDest;
+  i64 nByte = 0;
+  int i;
+
+  for(i=0; i<nBuf; i++) nByte += anBuf[i];
+  assert( nByte<=SQLITE_URING_STAGING );
+  if( p->nStage+nByte>SQLITE_URING_STAGING
+   || p->nOp>=SQLITE_URING_ENTRIES-1
+   || uringOverlap(p, iOff, nByte)
+  ){
+    int rc = uringFlush(pFile, 0);
+    if( rc!=SQLITE_OK ) return rc;
+  }
+
+  pDest = &p->aStage[p->nStage];
+  for(i=0; i<nBuf; i++){
+    memcpy(pDest, apBuf[i], anBuf[i]);
+    pDest += anBuf[i];
+  }
+  pDest = &p->aStage[p->nStage];
+  p->nStage += (int)nByte;
+
+  /* Extend the previous write if this one follows on from it */
+  pLast = p->nOp>0 ? &p->aOp[p->nOp-1] : 0;
+  if( pLast && pLast->iOff+(i64)pLast->iov.iov_len==iOff
+   && &((u8*)pLast->iov.iov_base)[pLast->iov.iov_len]==pDest
+  ){
+    pLast->iov.iov_len += nByte;
+  }else{
+    UringOp *pOp = &p->aOp[p->nOp++];
+    pOp->eOp = URING_OP_WRITE;
+    pOp->iOff = iOff;
+    pOp->iov.iov_base = pDest;
+    pOp->iov.iov_len = nByte;
+  }
+#ifdef SQLITE_DEBUG
+  if( pFile->inNormalWrite ) pFile->dbUpdate = 1;
+#endif
+  return SQLITE_OK;
+}
+
+/*
+** Read amt bytes at offset iOff of pFile into pBuf as a set of chunks of
+** URING_READ_CHUNK bytes read concurrently.
+*/
+static int uringReadChunks(unixFile *pFile, u8 *pBuf, int amt, i64 iOff){
+  UringRing *p = pFile->pRing;
+  int got = 0;
+  int rc;
+
+  rc = uringFlush(pFile, 0);
+  while( rc==SQLITE_OK && got<amt ){
+    int nOp = 0;
+    int e;
+    int i;
+    while( got+nOp*URING_READ_CHUNK<amt && nOp<SQLITE_URING_ENTRIES ){
+      UringOp *pOp = &p->aOp[nOp];
+      int iStart = got + nOp*URING_READ_CHUNK;
+      pOp->eOp = URING_OP_READ;
+      pOp->iOff = iOff + iStart;
+      pOp->iov.iov_base = &pBuf[iStart];
+      pOp->iov.iov_len = MIN(URING_READ_CHUNK, amt-iStart);
+      nOp++;
+    }
+    e = uringRun(p, pFile->h, nOp, 0, 0);
+    if( e ){
+      uringAbandon(pFile);
+      storeLastErrno(pFile, e);
+      return SQLITE_IOERR_READ;
+    }
+    for(i=0; i<nOp; i++){
+      UringOp *pOp = &p->aOp[i];
+      if( pOp->res<0 ){
+        storeLastErrno(pFile, -pOp->res);
+        return SQLITE_IOERR_READ;
+      }
+      got += pOp->res;
+      if( pOp->res<(int)pOp->iov.iov_len ){
+        /* The end of the file. unixRead() reads anything that remains and
+        ** zero-fills the rest of the buffer. */
+        return unixRead((sqlite3_file*)pFile, &pBuf[got], amt-got, iOff+got);
+      }
+    }
+  }
+  return rc;
+}
+
+/*
+** The sqlite3_io_methods of the "unix-uring" VFS. Database files use
+** posix advisory locks, as with "unix", and other files no locks.
+*/
+static int uringCloseRing(unixFile *pFile){
+  int rc = uringFlush(pFile, 0);
+  if( pFile->pRing ){
+    uringRingFree(pFile->pRing);
+    pFile->pRing = 0;
+  }
+  return rc;
+}
+static int uringClose(sqlite3_file *id){
+  int rc = uringCloseRing((unixFile*)id);
+  unixClose(id);
+  return rc;
+}
+static int uringNolockClose(sqlite3_file *id){
+  int rc = uringCloseRing((unixFile*)id);
+  nolockClose(id);
+  return rc;
+}
+static int uringRead(sqlite3_file *id, void *pBuf, int amt, i64 offset){
+  unixFile *pFile = (unixFile*)id;
+  if( pFile->pRing && uringOverlap(pFile->pRing, offset, amt) ){
+    int rc = uringFlush(pFile, 0);
+    if( rc!=SQLITE_OK ) return rc;
+  }
+  if( amt>=2*URING_READ_CHUNK
+#if SQLITE_MAX_MMAP_SIZE>0
+   && offset>=pFile->mmapSize
+#endif
+   && uringRing(pFile)
+  ){
+    return uringReadChunks(pFile, (u8*)pBuf, amt, offset);
+  }
+  return unixRead(id, pBuf, amt, offset);
+}
+static int uringWrite(sqlite3_file *id, const void *pBuf, int amt, i64 offset){
+  unixFile *pFile = (unixFile*)id;
+  int rc;
+  if( uringCanHold(pFile, offset, amt) ){
+    return uringHold(pFile, 1, &pBuf, &amt, offset);
+  }
+  rc = uringFlush(pFile, 0);
+  if( rc==SQLITE_OK ) rc = unixWrite(id, pBuf, amt, offset);
+  return rc;
+}
+static int uringWriteV(
+  sqlite3_file *id,
+  int nBuf,
+  const void **apBuf,
+  const int *anBuf,
+  i64 offset
+){
+  unixFile *pFile = (unixFile*)id;
+  i64 nByte = 0;
+  int rc;
+  int i;
+  for(i=0; i<nBuf; i++) nByte += anBuf[i];
+  if( uringCanHold(pFile, offset, nByte) ){
+    return uringHold(pFile, nBuf, apBuf, anBuf, offset);
+  }
+  rc = uringFlush(pFile, 0);
+  if( rc==SQLITE_OK ) rc = unixWriteV(id, nBuf, apBuf, anBuf, offset);
+  return rc;
+}
+static int uringTruncate(sqlite3_file *id, i64 nByte){
+  int rc = uringFlush((unixFile*)id, 0);
+  if( rc==SQLITE_OK ) rc = unixTruncate(id, nByte);
+  return rc;
+}
+static int uringSync(sqlite3_file *id, int flags){
+  unixFile *pFile = (unixFile*)id;
+  assert( (flags&0x0F)==SQLITE_SYNC_NORMAL || (flags&0x0F)==SQLITE_SYNC_FULL );
+#ifndef SQLITE_NO_SYNC
+  if( pFile->pRing && pFile->pRing->nOp>0 ){
+    if( pFile->eDurability==PAGER_DURABILITY_RELAXED ){
+      /* unixSync() replaces the fsync with a wait for write-out */
+      int rc = uringFlush(pFile, 0);
+      if( rc!=SQLITE_OK ) return rc;
+    }else{
+      OSTRACE(("SYNC    %-3d\n", pFile->h));
+      return uringFlush(pFile, flags);
+    }
+  }
+#else
+  {
+    int rc = uringFlush(pFile, 0);
+    if( rc!=SQLITE_OK ) return rc;
+  }
+#endif
+  return unixSync(id, flags);
+}
+static int uringFileSize(sqlite3_file *id, i64 *pSize){
+  int rc = uringFlush((unixFile*)id, 0);
+  if( rc==SQLITE_OK ) rc = unixFileSize(id, pSize);
+  return rc;
+}
+static int uringLock(sqlite3_file *id, int eFileLock){
+  int rc = uringFlush((unixFile*)id, 0);
+  if( rc==SQLITE_OK ) rc = unixLock(id, eFileLock);
+  return rc;
+}
+static int uringUnlock(sqlite3_file *id, int eFileLock){
+  int rc = uringFlush((unixFile*)id, 0);
+  int rc2 = unixUnlock(id, eFileLock);
+  return rc==SQLITE_OK ? rc2 : rc;
+}
+static int uringFileControl(sqlite3_file *id, int op, void *pArg){
+  unixFile *pFile = (unixFile*)id;
+  int rc;
+  switch( op ){
+    case SQLITE_FCNTL_WRITE_BATCH: {
+      if( *(int*)pArg ){
+        if( uringRing(pFile)==0 ) return SQLITE_NOTFOUND;
+        pFile->pRing->bBatch = 1;
+        return SQLITE_OK;
+      }
+      if( pFile->pRing==0 ) return SQLITE_NOTFOUND;
+      pFile->pRing->bBatch = 0;
+      return uringFlush(pFile, 0);
+    }
+    case SQLITE_FCNTL_SYNC: {
+      /* Sent just before xSync. Keep any held writes for the sync. */
+      return unixFileControl(id, op, pArg);
+    }
+  }
+  rc = uringFlush(pFile, 0);
+  if( rc==SQLITE_OK ) rc = unixFileControl(id, op, pArg);
+  return rc;
+}
+static int uringFetch(sqlite3_file *id, i64 iOff, int nAmt, void **pp){
+  int rc = uringFlush((unixFile*)id, 0);
+  *pp = 0;
+  if( rc==SQLITE_OK ) rc = unixFetch(id, iOff, nAmt, pp);
+  return rc;
+}
+
+#define URING_IOMETHODS(METHOD,CLOSE,LOCK,UNLOCK,CKLOCK,SHMMAP)             \
+static const sqlite3_io_methods METHOD = {                                   \
+   4,                          /* iVersion */                                \
+   CLOSE,                      /* xClose */                                  \
+   uringRead,                  /* xRead */                                   \
+   uringWrite,                 /* xWrite */                                  \
+   uringTruncate,              /* xTruncate */                               \
+   uringSync,                  /* xSync */                                   \
+   uringFileSize,              /* xFileSize */                               \
+   LOCK,                       /* xLock */                                   \
+   UNLOCK,                     /* xUnlock */                                 \
+   CKLOCK,                     /* xCheckReservedLock */                      \
+   uringFileControl,           /* xFileControl */                            \
+   unixSectorSize,             /* xSectorSize */                             \
+   unixDeviceCharacteristics,  /* xDeviceCapabilities */                     \
+   SHMMAP,                     /* xShmMap */                                 \
+   unixShmLock,                /* xShmLock */                                \
+   unixShmBarrier,             /* xShmBarrier */                             \
+   unixShmUnmap,               /* xShmUnmap */                               \
+   uringFetch,                 /* xFetch */                                  \
+   unixUnfetch,                /* xUnfetch */                                \
+   uringWriteV,                /* xWriteV */                                 \
+};
+URING_IOMETHODS(
+  uringIoMethods,           /* sqlite3_io_methods object name */
+  uringClose,               /* xClose method */
+  uringLock,                /* xLock method */
+  uringUnlock,              /* xUnlock method */
+  unixCheckReservedLock,    /* xCheckReservedLock method */
+  unixShmMap                /* xShmMap method */
+)
+URING_IOMETHODS(
+  uringNolockIoMethods,     /* sqlite3_io_methods object name */
+  uringNolockClose,         /* xClose method */
+  nolockLock,               /* xLock method */
+  nolockUnlock,             /* xUnlock method */
+  nolockCheckReservedLock,  /* xCheckReservedLock method */
+  0                         /* xShmMap method */
+)
+
+static const sqlite3_io_methods *uringIoFinderImpl(const char *z, unixFile *p){
+  UNUSED_PARAMETER(z); UNUSED_PARAMETER(p);
+  return &uringIoMethods;
+}
+static const sqlite3_io_methods 
+  *(*const uringIoFinder)(const char*,unixFile*) = uringIoFinderImpl;
+
+/*************************** End of io_uring I/O *****************************
+******************************************************************************/
+#endif /* UNIX_USE_URING */
+
 /*
 ** An abstract type for a pointer to an IO method finder function:
 */
@@ -5227,10 +6755,18 @@ static int fillInUnixFile(
   pNew->h = h;
   pNew->pVfs = pVfs;
   pNew->zPath = zFilename;
-  pNew->ctrlFlags = (u8)ctrlFlags;
+  pNew->ctrlFlags = (unsigned short)ctrlFlags;
 #if SQLITE_MAX_MMAP_SIZE>0
   pNew->mmapSizeMax = sqlite3GlobalConfig.szMmap;
 #endif
+  if( ctrlFlags & UNIXFILE_DIRECT ){
+    /* Direct I/O files are never memory mapped, and io_uring is not used
+    ** for them as the staging buffer of the ring is not aligned. */
+#if SQLITE_MAX_MMAP_SIZE>0
+    pNew->mmapSizeMax = 0;
+#endif
+    pNew->ctrlFlags |= UNIXFILE_NOURING;
+  }
   if( sqlite3_uri_boolean(((ctrlFlags & UNIXFILE_URI) ? zFilename : 0),
                            "psow", SQLITE_POWERSAFE_OVERWRITE) ){
     pNew->ctrlFlags |= UNIXFILE_PSOW;
@@ -5249,6 +6785,11 @@ static int fillInUnixFile(
 
   if( ctrlFlags & UNIXFILE_NOLOCK ){
     pLockingStyle = &nolockIoMethods;
+#if UNIX_USE_URING
+    if( pVfs->pAppData==(void*)&uringIoFinder ){
+      pLockingStyle = &uringNolockIoMethods;
+    }
+#endif
   }else{
     pLockingStyle = (**(finder_type*)pVfs->pAppData)(zFilename, pNew);
 #if SQLITE_ENABLE_LOCKING_STYLE
@@ -5262,6 +6803,9 @@ static int fillInUnixFile(
   if( pLockingStyle == &posixIoMethods
 #if defined(__APPLE__) && SQLITE_ENABLE_LOCKING_STYLE
     || pLockingStyle == &nfsIoMethods
+#endif
+#if UNIX_USE_URING
+    || pLockingStyle == &uringIoMethods
 #endif
   ){
     unixEnterMutex();
@@ -5737,6 +7281,11 @@ static int unixOpen(
       assert( eType==SQLITE_OPEN_WAL || eType==SQLITE_OPEN_MAIN_JOURNAL );
       return rc;
     }
+    /* Note whether a journal or WAL file existed before this open(), in
+    ** which case a directory sync may be skipped. See unixSyncDirectory(). */
+    if( syncDir && osAccess(zName, F_OK)==0 ){
+      ctrlFlags |= UNIXFILE_EXISTED;
+    }
     fd = robust_open(zName, openFlags, openMode);
     OSTRACE(("OPENX   %-3d %s 0%o\n", fd, zName, openFlags));
     assert( !isExclusive || (openFlags & O_CREAT)!=0 );
@@ -5814,6 +7363,18 @@ static int unixOpen(
   if( noLock )                  ctrlFlags |= UNIXFILE_NOLOCK;
   if( syncDir )                 ctrlFlags |= UNIXFILE_DIRSYNC;
   if( flags & SQLITE_OPEN_URI ) ctrlFlags |= UNIXFILE_URI;
+#if HAVE_DIRECT_IO
+  /* A descriptor reused from an earlier connection may have been opened
+  ** either way, so O_DIRECT is set or cleared for every database file. If
+  ** the file-system does not support direct I/O, use buffered I/O. */
+  if( eType==SQLITE_OPEN_MAIN_DB ){
+    int bDirect = sqlite3_uri_boolean((flags & SQLITE_OPEN_URI) ? zName : 0,
+                                      "directio", SQLITE_DEFAULT_DIRECT_IO);
+    if( unixDirectMode(fd, bDirect)==0 && bDirect ){
+      ctrlFlags |= UNIXFILE_DIRECT;
+    }
+  }
+#endif
 
 #if SQLITE_ENABLE_LOCKING_STYLE
 #if SQLITE_PREFER_PROXY_LOCKING
@@ -7529,6 +9090,9 @@ int sqlite3_os_init(void){
     UNIXVFS("unix-none",     nolockIoFinder ),
     UNIXVFS("unix-dotfile",  dotlockIoFinder ),
     UNIXVFS("unix-excl",     posixIoFinder ),
+#if UNIX_USE_URING
+    UNIXVFS("unix-uring",    uringIoFinder ),
+#endif
 #if OS_VXWORKS
     UNIXVFS("unix-namedsem", semIoFinder ),
 #endif
@@ -7548,7 +9112,7 @@ int sqlite3_os_init(void){
 
   /* Double-check that the aSyscall[] array has been constructed
   ** correctly.  See ticket [bb3a86e890c8e96ab] */
-  assert( ArraySize(aSyscall)==28 );
+  assert( ArraySize(aSyscall)==32 );
 
   /* Register all VFSes defined in the aVfs[] array */
   for(i=0; i<(sizeof(aVfs)/sizeof(sqlite3_vfs)); i++){
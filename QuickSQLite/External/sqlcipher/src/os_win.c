@@ -3486,18 +3486,23 @@ struct winShm {
   winShmNode *pShmNode;      /* The underlying winShmNode object */
   winShm *pNext;             /* Next winShm with the same winShmNode */
   u8 hasMutex;               /* True if holding the winShmNode mutex */
-  u16 sharedMask;            /* Mask of shared locks held */
-  u16 exclMask;              /* Mask of exclusive locks held */
+  u32 sharedMask;            /* Mask of shared locks held */
+  u32 exclMask;              /* Mask of exclusive locks held */
 #if defined(SQLITE_DEBUG) || defined(SQLITE_HAVE_OS_TRACE)
   u8 id;                     /* Id of this connection with its winShmNode */
 #endif
 };
 
 /*
-** Constants used for locking
+** Constants used for locking.  As in os_unix.c, the first eight shm locks
+** and the deadman switch do not move when SQLITE_SHM_NLOCK is changed, and
+** locks 8 and up use the bytes starting at WIN_SHM_XBASE.
 */
-#define WIN_SHM_BASE   ((22+SQLITE_SHM_NLOCK)*4)        /* first lock byte */
-#define WIN_SHM_DMS    (WIN_SHM_BASE+SQLITE_SHM_NLOCK)  /* deadman switch */
+#define WIN_SHM_BASE   ((22+8)*4)                      /* first lock byte */
+#define WIN_SHM_DMS    (WIN_SHM_BASE+8)                /* deadman switch */
+#if SQLITE_SHM_NLOCK>8
+# define WIN_SHM_XBASE (136+(SQLITE_SHM_NLOCK-8)*4)    /* lock 8 and up */
+#endif
 
 /*
 ** Apply advisory locks for all n bytes beginning at ofst.
@@ -3543,6 +3548,37 @@ static int winShmSystemLock(
   return rc;
 }
 
+/*
+** Apply advisory locks to shm locks ofst through ofst+n-1.  Locks below 8
+** map to the bytes at WIN_SHM_BASE and any others to the bytes at
+** WIN_SHM_XBASE.  If a range that spans both cannot be locked in full, no
+** part of it is left locked.
+*/
+static int winShmSlotLock(
+  winShmNode *pFile,    /* Apply locks to this open shared-memory segment */
+  int lockType,         /* _SHM_UNLCK, _SHM_RDLCK, or _SHM_WRLCK */
+  int ofst,             /* First shm lock */
+  int n                 /* Number of shm locks */
+){
+#if SQLITE_SHM_NLOCK>8
+  if( ofst+n>8 ){
+    int nBase = ofst<8 ? 8-ofst : 0;
+    int rc = SQLITE_OK;
+    if( nBase>0 ){
+      rc = winShmSystemLock(pFile, lockType, WIN_SHM_BASE+ofst, nBase);
+      if( rc!=SQLITE_OK ) return rc;
+    }
+    rc = winShmSystemLock(pFile, lockType,
+                          WIN_SHM_XBASE+ofst+nBase-8, n-nBase);
+    if( rc!=SQLITE_OK && nBase>0 && lockType!=_SHM_UNLCK ){
+      winShmSystemLock(pFile, _SHM_UNLCK, WIN_SHM_BASE+ofst, nBase);
+    }
+    return rc;
+  }
+#endif
+  return winShmSystemLock(pFile, lockType, WIN_SHM_BASE+ofst, n);
+}
+
 /* Forward references to VFS methods */
 static int winOpen(sqlite3_vfs*,const char*,sqlite3_file*,int,int*);
 static int winDelete(sqlite3_vfs *,const char*,int);
@@ -3765,7 +3801,7 @@ static int winShmLock(
   winShm *pX;                           /* For looping over all siblings */
   winShmNode *pShmNode = p->pShmNode;
   int rc = SQLITE_OK;                   /* Result code */
-  u16 mask;                             /* Mask of locks to take or release */
+  u32 mask;                             /* Mask of locks to take or release */
 
   assert( ofst>=0 && ofst+n<=SQLITE_SHM_NLOCK );
   assert( n>=1 );
@@ -3775,11 +3811,11 @@ static int winShmLock(
        || flags==(SQLITE_SHM_UNLOCK | SQLITE_SHM_EXCLUSIVE) );
   assert( n==1 || (flags & SQLITE_SHM_EXCLUSIVE)!=0 );
 
-  mask = (u16)((1U<<(ofst+n)) - (1U<<ofst));
-  assert( n>1 || mask==(1<<ofst) );
+  mask = (1U<<(ofst+n)) - (1U<<ofst);
+  assert( n>1 || mask==(1U<<ofst) );
   sqlite3_mutex_enter(pShmNode->mutex);
   if( flags & SQLITE_SHM_UNLOCK ){
-    u16 allMask = 0; /* Mask of locks held by siblings */
+    u32 allMask = 0; /* Mask of locks held by siblings */
 
     /* See if any siblings hold this same lock */
     for(pX=pShmNode->pFirst; pX; pX=pX->pNext){
@@ -3790,7 +3826,7 @@ static int winShmLock(
 
     /* Unlock the system-level locks */
     if( (mask & allMask)==0 ){
-      rc = winShmSystemLock(pShmNode, _SHM_UNLCK, ofst+WIN_SHM_BASE, n);
+      rc = winShmSlotLock(pShmNode, _SHM_UNLCK, ofst, n);
     }else{
       rc = SQLITE_OK;
     }
@@ -3801,7 +3837,7 @@ static int winShmLock(
       p->sharedMask &= ~mask;
     }
   }else if( flags & SQLITE_SHM_SHARED ){
-    u16 allShared = 0;  /* Union of locks held by connections other than "p" */
+    u32 allShared = 0;  /* Union of locks held by connections other than "p" */
 
     /* Find out which shared locks are already held by sibling connections.
     ** If any sibling already holds an exclusive lock, go ahead and return
@@ -3818,7 +3854,7 @@ static int winShmLock(
     /* Get shared locks at the system level, if necessary */
     if( rc==SQLITE_OK ){
       if( (allShared & mask)==0 ){
-        rc = winShmSystemLock(pShmNode, _SHM_RDLCK, ofst+WIN_SHM_BASE, n);
+        rc = winShmSlotLock(pShmNode, _SHM_RDLCK, ofst, n);
       }else{
         rc = SQLITE_OK;
       }
@@ -3843,7 +3879,7 @@ static int winShmLock(
     ** also mark the local connection as being locked.
     */
     if( rc==SQLITE_OK ){
-      rc = winShmSystemLock(pShmNode, _SHM_WRLCK, ofst+WIN_SHM_BASE, n);
+      rc = winShmSlotLock(pShmNode, _SHM_WRLCK, ofst, n);
       if( rc==SQLITE_OK ){
         assert( (p->sharedMask & mask)==0 );
         p->exclMask |= mask;
@@ -4283,7 +4319,8 @@ static const sqlite3_io_methods winIoMethod = {
   winShmBarrier,                  /* xShmBarrier */
   winShmUnmap,                    /* xShmUnmap */
   winFetch,                       /* xFetch */
-  winUnfetch                      /* xUnfetch */
+  winUnfetch,                     /* xUnfetch */
+  0                               /* xWriteV */
 };
 
 /****************************************************************************
@@ -701,7 +701,7 @@ struct Pager {
   char *zJournal;             /* Name of the journal file */
   int (*xBusyHandler)(void*); /* Function to call when busy */
   void *pBusyHandlerArg;      /* Context argument for xBusyHandler */
-  int aStat[3];               /* Total cache hits, misses and writes */
+  int aStat[6];               /* Cache hits, misses, writes, read-ahead, syncs */
 #ifdef SQLITE_TEST
   int nRead;                  /* Database pages read */
 #endif
@@ -711,9 +711,24 @@ struct Pager {
   void (*xCodecSizeChng)(void*,int,int); /* Notify of page size changes */
   void (*xCodecFree)(void*);             /* Destructor for the codec */
   void *pCodec;               /* First argument to xCodec... methods */
+  u8 *aWriteV;                /* Encoded pages for sqlite3OsWriteV(), or NULL */
 #endif
   char *pTmpSpace;            /* Pager.pageSize bytes of space for tmp use */
   PCache *pPCache;            /* Pointer to page cache object */
+  int nReadahead;             /* Max pages per read-ahead. 0 to disable */
+  u8 *aReadahead;             /* Read-ahead staging buffer, or NULL */
+  u8 *aRaPage;                /* Page images in aReadahead[], aligned */
+  int szIoAlign;              /* Buffer alignment for direct I/O, or 0 */
+  Pgno raFirst;               /* Page number of first page in aReadahead[] */
+  int nRaPage;                /* Number of pages held in aReadahead[] */
+  int nRaUnused;              /* Pages in aReadahead[] not yet consumed */
+  Pgno raLastPgno;            /* Last page read from the database file */
+  int nRaSeq;                 /* Consecutive sequential database reads */
+  u8 *aDirect;                /* Staging buffer for direct reads, or NULL */
+  u8 *aDirectPage;            /* Page images in aDirect[], aligned */
+  u8 eDurability;             /* One of the PAGER_DURABILITY_* values */
+  int iSyncMark;              /* aStat[PAGER_STAT_SYNC] at start of write txn */
+  int mxCommitSync;           /* Most syncs issued by a single transaction */
 #ifndef SQLITE_OMIT_WAL
   Wal *pWal;                  /* Write-ahead log used by "journal_mode=wal" */
   char *zWal;                 /* File name for write-ahead log */
@@ -722,12 +737,61 @@ struct Pager {
 
 /*
 ** Indexes for use with Pager.aStat[]. The Pager.aStat[] array contains
-** the values accessed by passing SQLITE_DBSTATUS_CACHE_HIT, CACHE_MISS 
-** or CACHE_WRITE to sqlite3_db_status().
+** the values accessed by passing SQLITE_DBSTATUS_CACHE_HIT, CACHE_MISS,
+** CACHE_WRITE, READAHEAD_HIT, READAHEAD_MISS or SYNC to sqlite3_db_status().
+*/
+#define PAGER_STAT_HIT            0
+#define PAGER_STAT_MISS           1
+#define PAGER_STAT_WRITE          2
+#define PAGER_STAT_READAHEAD_HIT  3
+#define PAGER_STAT_READAHEAD_MISS 4
+#define PAGER_STAT_SYNC           5
+
+/*
+** Read-ahead.
+**
+** When Pager.nReadahead is greater than zero and PAGER_READAHEAD_TRIGGER
+** consecutive database pages have been read from the database file in
+** ascending order (as happens when a cursor walks the leaves of a table 
+** that is stored contiguously), the next read from the database file
+** fetches up to Pager.nReadahead pages with a single sqlite3OsRead() into
+** the Pager.aReadahead[] staging buffer. Subsequent reads of pages in
+** the staged range are satisfied by copying from the staging buffer. 
+**
+** This is read-ahead of file I/O only. It replaces many small reads with
+** one large one, but does nothing to the cost of decryption: staged pages
+** are stored exactly as they are on disk and are passed through the codec
+** (if any) one at a time, on the reading thread, as they are consumed.
+** The codec context and its buffers are not safe to use from a second
+** thread, so decryption cannot be moved off the read path here.
+**
+** The staging buffer is only valid while the database file is known not
+** to change underneath it. It is discarded whenever the pager writes to
+** or truncates the database file, and at the end of each transaction.
+*/
+#ifndef SQLITE_DEFAULT_READAHEAD
+# define SQLITE_DEFAULT_READAHEAD 0
+#endif
+#ifndef SQLITE_MAX_READAHEAD
+# define SQLITE_MAX_READAHEAD 256
+#endif
+#define PAGER_READAHEAD_TRIGGER 2
+
+/*
+** The largest number of bytes read from the database file by a single
+** call to sqlite3PagerReadDirect(). At least one page is always read.
 */
-#define PAGER_STAT_HIT   0
-#define PAGER_STAT_MISS  1
-#define PAGER_STAT_WRITE 2
+#ifndef SQLITE_MAX_DIRECT_READ
+# define SQLITE_MAX_DIRECT_READ 262144
+#endif
+
+/*
+** The durability policy in effect when a pager is opened. See the comments
+** above sqlite3PagerSetDurability() for the meaning of each value.
+*/
+#ifndef SQLITE_DEFAULT_DURABILITY
+# define SQLITE_DEFAULT_DURABILITY PAGER_DURABILITY_STRICT
+#endif
 
 /*
 ** The following global variables hold counters used for
@@ -1094,6 +1158,28 @@ static int write32bits(sqlite3_file *fd, i64 offset, u32 val){
   return sqlite3OsWrite(fd, ac, 4, offset);
 }
 
+/*
+** Sync file fd, which is either the database file or the journal file of
+** pager pPager, and count the sync for SQLITE_DBSTATUS_SYNC.
+*/
+static int pagerSync(Pager *pPager, sqlite3_file *fd, int flags){
+  pPager->aStat[PAGER_STAT_SYNC]++;
+  return sqlite3OsSync(fd, flags);
+}
+
+/*
+** Pass the durability policy of pager pPager down to file fd. This is
+** a hint only - VFS implementations that do not recognize the
+** SQLITE_FCNTL_DURABILITY file-control continue to fsync() every time
+** they are asked to sync.
+*/
+static void pagerApplyDurability(Pager *pPager, sqlite3_file *fd){
+  int eDurability = pPager->eDurability;
+  if( isOpen(fd) ){
+    sqlite3OsFileControlHint(fd, SQLITE_FCNTL_DURABILITY, &eDurability);
+  }
+}
+
 /*
 ** Unlock the database file to level eLock, which must be either NO_LOCK
 ** or SHARED_LOCK. Regardless of whether or not the call to xUnlock()
@@ -1354,7 +1440,7 @@ static int zeroJournalHdr(Pager *pPager, int doTruncate){
       rc = sqlite3OsWrite(pPager->jfd, zeroHdr, sizeof(zeroHdr), 0);
     }
     if( rc==SQLITE_OK && !pPager->noSync ){
-      rc = sqlite3OsSync(pPager->jfd, SQLITE_SYNC_DATAONLY|pPager->syncFlags);
+      rc = pagerSync(pPager, pPager->jfd, SQLITE_SYNC_DATAONLY|pPager->syncFlags);
     }
 
     /* At this point the transaction is committed but the write lock 
@@ -1697,11 +1783,37 @@ static int writeMasterJournal(Pager *pPager, const char *zMaster){
   return rc;
 }
 
+/*
+** Discard the content of the read-ahead staging buffer, if any. Pages that
+** were read ahead but never used are counted as read-ahead misses.
+*/
+static void pagerReadaheadDiscard(Pager *pPager){
+  pPager->aStat[PAGER_STAT_READAHEAD_MISS] += pPager->nRaUnused;
+  pPager->nRaPage = 0;
+  pPager->nRaUnused = 0;
+  pPager->nRaSeq = 0;
+  pPager->raLastPgno = 0;
+}
+
+/*
+** Free the read-ahead and direct-read staging buffers.
+*/
+static void pagerReadaheadFree(Pager *pPager){
+  pagerReadaheadDiscard(pPager);
+  sqlite3_free(pPager->aReadahead);
+  pPager->aReadahead = 0;
+  pPager->aRaPage = 0;
+  sqlite3_free(pPager->aDirect);
+  pPager->aDirect = 0;
+  pPager->aDirectPage = 0;
+}
+
 /*
 ** Discard the entire contents of the in-memory page-cache.
 */
 static void pager_reset(Pager *pPager){
   pPager->iDataVersion++;
+  pagerReadaheadDiscard(pPager);
   sqlite3BackupRestart(pPager->pBackup);
   sqlite3PcacheClear(pPager->pPCache);
 }
@@ -1780,6 +1892,7 @@ static void pager_unlock(Pager *pPager){
   sqlite3BitvecDestroy(pPager->pInJournal);
   pPager->pInJournal = 0;
   releaseAllSavepoints(pPager);
+  pagerReadaheadDiscard(pPager);
 
   if( pagerUseWal(pPager) ){
     assert( !isOpen(pPager->jfd) );
@@ -1937,6 +2050,8 @@ static int pager_end_transaction(Pager *pPager, int hasMaster, int bCommit){
   int rc = SQLITE_OK;      /* Error code from journal finalization operation */
   int rc2 = SQLITE_OK;     /* Error code from db file unlock operation */
 
+  pagerReadaheadDiscard(pPager);
+
   /* Do nothing if the pager does not have an open write transaction
   ** or at least a RESERVED lock. This function may be called when there
   ** is no write-transaction active but a RESERVED or greater lock is
@@ -1976,7 +2091,7 @@ static int pager_end_transaction(Pager *pPager, int hasMaster, int bCommit){
           ** cause the last transaction to roll back.  See
           ** https://bugzilla.mozilla.org/show_bug.cgi?id=1072773
           */
-          rc = sqlite3OsSync(pPager->jfd, pPager->syncFlags);
+          rc = pagerSync(pPager, pPager->jfd, pPager->syncFlags);
         }
       }
       pPager->journalOff = 0;
@@ -2319,6 +2434,7 @@ static int pager_playback_one_page(
     i64 ofst = (pgno-1)*(i64)pPager->pageSize;
     testcase( !isSavepnt && pPg!=0 && (pPg->flags&PGHDR_NEED_SYNC)!=0 );
     assert( !pagerUseWal(pPager) );
+    pagerReadaheadDiscard(pPager);
     rc = sqlite3OsWrite(pPager->fd, (u8 *)aData, pPager->pageSize, ofst);
     if( pgno>pPager->dbFileSize ){
       pPager->dbFileSize = pgno;
@@ -2561,6 +2677,7 @@ static int pager_truncate(Pager *pPager, Pgno nPage){
   int rc = SQLITE_OK;
   assert( pPager->eState!=PAGER_ERROR );
   assert( pPager->eState!=PAGER_READER );
+  pagerReadaheadDiscard(pPager);
   
   if( isOpen(pPager->fd) 
    && (pPager->eState>=PAGER_WRITER_DBMOD || pPager->eState==PAGER_OPEN) 
@@ -2897,6 +3014,77 @@ end_playback:
 }
 
 
+/*
+** Attempt to load the raw content of database page pgno into pData[]
+** from the read-ahead staging buffer, filling the staging buffer first
+** if the recent pattern of reads is sequential.
+**
+** Return SQLITE_OK if pData[] was populated, SQLITE_NOTFOUND if the
+** caller should read the page from the database file itself, or an
+** error code if an I/O error occurs.
+*/
+static int pagerReadaheadFetch(Pager *pPager, Pgno pgno, void *pData){
+  int pgsz = pPager->pageSize;
+  int bFill = 0;                  /* True if this call fills aReadahead[] */
+  u8 *aUsed;                      /* One flag per staged page */
+  int iSlot;                      /* Index of pgno within aReadahead[] */
+
+  assert( pPager->nReadahead>0 );
+  if( pgno==pPager->raLastPgno+1 ){
+    if( pPager->nRaSeq<PAGER_READAHEAD_TRIGGER ) pPager->nRaSeq++;
+  }else{
+    pPager->nRaSeq = 0;
+  }
+  pPager->raLastPgno = pgno;
+
+  if( pPager->nRaPage==0
+   || pgno<pPager->raFirst 
+   || pgno>=pPager->raFirst+pPager->nRaPage
+  ){
+    int nPage;
+    int rc;
+    if( pPager->nRaSeq<PAGER_READAHEAD_TRIGGER || pgno>pPager->dbSize ){
+      return SQLITE_NOTFOUND;
+    }
+    if( pPager->aReadahead==0 ){
+      int mAlign = pPager->szIoAlign ? pPager->szIoAlign-1 : 0;
+      pPager->aReadahead = (u8*)sqlite3Malloc(
+          (i64)pPager->nReadahead*(pgsz+1) + mAlign
+      );
+      if( pPager->aReadahead==0 ) return SQLITE_NOTFOUND;
+      pPager->aRaPage = &pPager->aReadahead[
+          (mAlign+1 - (SQLITE_PTR_TO_INT(pPager->aReadahead) & mAlign)) & mAlign
+      ];
+    }
+    pPager->aStat[PAGER_STAT_READAHEAD_MISS] += pPager->nRaUnused;
+    pPager->nRaPage = 0;
+    pPager->nRaUnused = 0;
+    nPage = MIN(pPager->nReadahead, (int)(pPager->dbSize - pgno + 1));
+    rc = sqlite3OsRead(pPager->fd, pPager->aRaPage, nPage*pgsz,
+                       (pgno-1)*(i64)pgsz);
+    if( rc==SQLITE_IOERR_SHORT_READ ) rc = SQLITE_OK;
+    if( rc!=SQLITE_OK ) return rc;
+    pPager->raFirst = pgno;
+    pPager->nRaPage = nPage;
+    pPager->nRaUnused = nPage;
+    memset(&pPager->aRaPage[pPager->nReadahead*pgsz], 0, nPage);
+    IOTRACE(("READAHEAD %p %d %d\n", pPager, pgno, nPage));
+    bFill = 1;
+  }
+
+  /* The page that caused the staging buffer to be filled would have been
+  ** read anyway, so it is consumed without being counted as a hit. */
+  iSlot = pgno - pPager->raFirst;
+  aUsed = &pPager->aRaPage[pPager->nReadahead*pgsz];
+  if( aUsed[iSlot]==0 ){
+    aUsed[iSlot] = 1;
+    pPager->nRaUnused--;
+    if( !bFill ) pPager->aStat[PAGER_STAT_READAHEAD_HIT]++;
+  }
+  memcpy(pData, &pPager->aRaPage[iSlot*pgsz], pgsz);
+  return SQLITE_OK;
+}
+
 /*
 ** Read the content for page pPg out of the database file and into 
 ** pPg->pData. A shared lock or greater must be held on the database
@@ -2923,7 +3111,9 @@ static int readDbPage(PgHdr *pPg, u32 iFrame){
     rc = sqlite3WalReadFrame(pPager->pWal, iFrame, pgsz, pPg->pData);
   }else
 #endif
-  {
+  if( pPager->nReadahead==0
+   || (rc = pagerReadaheadFetch(pPager, pgno, pPg->pData))==SQLITE_NOTFOUND
+  ){
     i64 iOffset = (pgno-1)*(i64)pPager->pageSize;
     rc = sqlite3OsRead(pPager->fd, pPg->pData, pgsz, iOffset);
     if( rc==SQLITE_IOERR_SHORT_READ ){
@@ -3445,6 +3635,76 @@ void sqlite3PagerSetMmapLimit(Pager *pPager, sqlite3_int64 szMmap){
   pagerFixMaplimit(pPager);
 }
 
+/*
+** Set the maximum number of pages read from the database file by a single
+** read-ahead operation to nPage, if nPage is non-negative. A value of zero
+** disables read-ahead. In-memory and temporary databases never read ahead.
+** Return the current setting.
+*/
+int sqlite3PagerSetReadahead(Pager *pPager, int nPage){
+  if( nPage>=0 && !MEMDB && !pPager->tempFile ){
+    if( nPage>SQLITE_MAX_READAHEAD ) nPage = SQLITE_MAX_READAHEAD;
+    if( nPage!=pPager->nReadahead ){
+      pagerReadaheadFree(pPager);
+      pPager->nReadahead = nPage;
+    }
+  }
+  return pPager->nReadahead;
+}
+
+/*
+** Set the durability policy of the pager to eDurability, if it is one of
+** the PAGER_DURABILITY_* values other than _QUERY. Return the policy in
+** effect after the call. The policy determines how much of the work
+** requested by the "PRAGMA synchronous" setting is actually done:
+**
+**    STRICT    Every sync is a full fsync() (or F_FULLFSYNC) of the file,
+**              and the directory is synced each time a journal or WAL
+**              file is created. This is the default. A transaction that
+**              has committed survives an OS crash or power failure.
+**
+**    BATCHED   In WAL mode with synchronous=FULL, the WAL is synced only
+**              on every SQLITE_DURABILITY_BATCH-th commit and whenever
+**              a checkpoint runs, instead of on every commit. Other
+**              syncs are unchanged, except that the directory is not
+**              synced when a journal or WAL file that already existed is
+**              reopened, and the kernel is asked to start write-back of
+**              dirty file ranges as they accumulate so that the syncs
+**              that remain have less to wait for. An OS crash or power
+**              failure may lose the most recent (up to BATCH-1) commits
+**              as a unit, but cannot corrupt the database. In rollback
+**              mode this policy is as safe as STRICT.
+**
+**    RELAXED   Syncs only wait until the dirty data of the file has
+**              been handed to the device (sync_file_range() on Linux).
+**              The file metadata and the device cache are not flushed
+**              and directories are not synced, so nothing is known to
+**              be durable, nor to reach storage in the order written.
+**              The database survives an application crash at any
+**              point. An OS crash or power failure may lose recent
+**              commits or corrupt the database. On systems without
+**              sync_file_range(), syncs are done as for BATCHED.
+**
+** Whatever the policy, synchronous=OFF still means that no syncs occur.
+*/
+int sqlite3PagerSetDurability(Pager *pPager, int eDurability){
+  if( eDurability>=PAGER_DURABILITY_STRICT
+   && eDurability<=PAGER_DURABILITY_RELAXED
+  ){
+    pPager->eDurability = (u8)eDurability;
+    pagerApplyDurability(pPager, pPager->fd);
+    pagerApplyDurability(pPager, pPager->jfd);
+#ifndef SQLITE_OMIT_WAL
+    if( pPager->pWal ){
+      sqlite3WalSetDurability(pPager->pWal, eDurability,
+                              &pPager->aStat[PAGER_STAT_SYNC]);
+      pagerApplyDurability(pPager, sqlite3WalFile(pPager->pWal));
+    }
+#endif
+  }
+  return pPager->eDurability;
+}
+
 /*
 ** Free as much memory as possible from the pager.
 */
@@ -3679,6 +3939,11 @@ int sqlite3PagerSetPagesize(Pager *pPager, u32 *pPageSize, int nReserve){
 
     if( rc==SQLITE_OK ){
       pager_reset(pPager);
+      pagerReadaheadFree(pPager);
+#ifdef SQLITE_HAS_CODEC
+      sqlite3_free(pPager->aWriteV);
+      pPager->aWriteV = 0;
+#endif
       rc = sqlite3PcacheSetPageSize(pPager->pPCache, pageSize);
     }
     if( rc==SQLITE_OK ){
@@ -3915,7 +4180,7 @@ void sqlite3PagerTruncateImage(Pager *pPager, Pgno nPage){
 static int pagerSyncHotJournal(Pager *pPager){
   int rc = SQLITE_OK;
   if( !pPager->noSync ){
-    rc = sqlite3OsSync(pPager->jfd, SQLITE_SYNC_NORMAL);
+    rc = pagerSync(pPager, pPager->jfd, SQLITE_SYNC_NORMAL);
   }
   if( rc==SQLITE_OK ){
     rc = sqlite3OsFileSize(pPager->jfd, &pPager->journalHdr);
@@ -4052,10 +4317,12 @@ int sqlite3PagerClose(Pager *pPager){
   sqlite3OsClose(pPager->jfd);
   sqlite3OsClose(pPager->fd);
   sqlite3PageFree(pTmp);
+  pagerReadaheadFree(pPager);
   sqlite3PcacheClose(pPager->pPCache);
 
 #ifdef SQLITE_HAS_CODEC
   if( pPager->xCodecFree ) pPager->xCodecFree(pPager->pCodec);
+  sqlite3_free(pPager->aWriteV);
 #endif
 
   assert( !pPager->aSavepoint && !pPager->pInJournal );
@@ -4188,7 +4455,7 @@ static int syncJournal(Pager *pPager, int newHdr){
         if( pPager->fullSync && 0==(iDc&SQLITE_IOCAP_SEQUENTIAL) ){
           PAGERTRACE(("SYNC journal of %d\n", PAGERID(pPager)));
           IOTRACE(("JSYNC %p\n", pPager))
-          rc = sqlite3OsSync(pPager->jfd, pPager->syncFlags);
+          rc = pagerSync(pPager, pPager->jfd, pPager->syncFlags);
           if( rc!=SQLITE_OK ) return rc;
         }
         IOTRACE(("JHDR %p %lld\n", pPager, pPager->journalHdr));
@@ -4200,7 +4467,7 @@ static int syncJournal(Pager *pPager, int newHdr){
       if( 0==(iDc&SQLITE_IOCAP_SEQUENTIAL) ){
         PAGERTRACE(("SYNC journal of %d\n", PAGERID(pPager)));
         IOTRACE(("JSYNC %p\n", pPager))
-        rc = sqlite3OsSync(pPager->jfd, pPager->syncFlags| 
+        rc = pagerSync(pPager, pPager->jfd, pPager->syncFlags| 
           (pPager->syncFlags==SQLITE_SYNC_FULL?SQLITE_SYNC_DATAONLY:0)
         );
         if( rc!=SQLITE_OK ) return rc;
@@ -4255,17 +4522,28 @@ static int syncJournal(Pager *pPager, int newHdr){
 ** in Pager.dbFileVers[] is updated to match the new value stored in
 ** the database file.
 **
+** Runs of up to SQLITE_MAX_WRITEV pages with consecutive page numbers
+** are written using a single call to sqlite3OsWriteV(). If the pager has
+** a codec, the encoded pages of a run are staged in Pager.aWriteV[], as
+** the codec returns each encoded page in the same buffer.
+**
 ** If everything is successful, SQLITE_OK is returned. If an IO error 
 ** occurs, an IO error code is returned. Or, if the EXCLUSIVE lock cannot
 ** be obtained, SQLITE_BUSY is returned.
 */
 static int pager_write_pagelist(Pager *pPager, PgHdr *pList){
   int rc = SQLITE_OK;                  /* Return code */
+  const void *apBuf[SQLITE_MAX_WRITEV>1 ? SQLITE_MAX_WRITEV : 1];
+  int anBuf[SQLITE_MAX_WRITEV>1 ? SQLITE_MAX_WRITEV : 1];
+  int mxBuf = (int)ArraySize(apBuf);   /* Most pages to write in one run */
+  int nBuf = 0;                        /* Pages in the current run */
+  i64 iBufOff = 0;                     /* File offset of the current run */
 
   /* This function is only called for rollback pagers in WRITER_DBMOD state. */
   assert( !pagerUseWal(pPager) );
   assert( pPager->eState==PAGER_WRITER_DBMOD );
   assert( pPager->eLock==EXCLUSIVE_LOCK );
+  pagerReadaheadDiscard(pPager);
 
   /* If the file is a temp-file has not yet been opened, open it now. It
   ** is not possible for rc to be other than SQLITE_OK if this branch
@@ -4289,6 +4567,15 @@ static int pager_write_pagelist(Pager *pPager, PgHdr *pList){
     pPager->dbHintSize = pPager->dbSize;
   }
 
+#ifdef SQLITE_HAS_CODEC
+  if( pPager->xCodec && mxBuf>1 && pPager->aWriteV==0 ){
+    sqlite3BeginBenignMalloc();
+    pPager->aWriteV = (u8*)sqlite3Malloc(mxBuf*(i64)pPager->pageSize);
+    sqlite3EndBenignMalloc();
+  }
+  if( pPager->xCodec && pPager->aWriteV==0 ) mxBuf = 1;
+#endif
+
   while( rc==SQLITE_OK && pList ){
     Pgno pgno = pList->pgno;
 
@@ -4307,11 +4594,32 @@ static int pager_write_pagelist(Pager *pPager, PgHdr *pList){
       assert( (pList->flags&PGHDR_NEED_SYNC)==0 );
       if( pList->pgno==1 ) pager_write_changecounter(pList);
 
+      /* Write out the current run of pages if this one does not extend it */
+      if( nBuf>0 && offset!=iBufOff+nBuf*(i64)pPager->pageSize ){
+        rc = sqlite3OsWriteV(pPager->fd, nBuf, apBuf, anBuf, iBufOff);
+        nBuf = 0;
+        if( rc ) break;
+      }
+
       /* Encode the database */
       CODEC2(pPager, pList->pData, pgno, 6, return SQLITE_NOMEM, pData);
 
-      /* Write out the page data. */
-      rc = sqlite3OsWrite(pPager->fd, pData, pPager->pageSize, offset);
+      /* Add the page data to the current run. */
+#ifdef SQLITE_HAS_CODEC
+      if( pPager->xCodec && mxBuf>1 ){
+        u8 *pSlot = &pPager->aWriteV[nBuf*(i64)pPager->pageSize];
+        memcpy(pSlot, pData, pPager->pageSize);
+        pData = (char*)pSlot;
+      }
+#endif
+      if( nBuf==0 ) iBufOff = offset;
+      apBuf[nBuf] = pData;
+      anBuf[nBuf] = pPager->pageSize;
+      nBuf++;
+      if( nBuf==mxBuf ){
+        rc = sqlite3OsWriteV(pPager->fd, nBuf, apBuf, anBuf, iBufOff);
+        nBuf = 0;
+      }
 
       /* If page 1 was just written, update Pager.dbFileVers to match
       ** the value now stored in the database file. If writing this 
@@ -4338,7 +4646,38 @@ static int pager_write_pagelist(Pager *pPager, PgHdr *pList){
     pager_set_pagehash(pList);
     pList = pList->pDirty;
   }
+  if( rc==SQLITE_OK && nBuf>0 ){
+    rc = sqlite3OsWriteV(pPager->fd, nBuf, apBuf, anBuf, iBufOff);
+  }
+
+  return rc;
+}
+
+/*
+** Tell the VFS that the writes to the database file that follow, up to
+** the next call to pagerEndWriteBatch(), may be submitted together. See
+** SQLITE_FCNTL_WRITE_BATCH.
+*/
+static void pagerBeginWriteBatch(Pager *pPager){
+  if( isOpen(pPager->fd) ){
+    int bBegin = 1;
+    sqlite3OsFileControlHint(pPager->fd, SQLITE_FCNTL_WRITE_BATCH, &bBegin);
+  }
+}
 
+/*
+** End the group of writes started by pagerBeginWriteBatch(). Parameter
+** rc is the result of the writes so far. If it is SQLITE_OK, any error
+** reported by the VFS while writing out the held pages is returned 
+** instead.
+*/
+static int pagerEndWriteBatch(Pager *pPager, int rc){
+  if( isOpen(pPager->fd) ){
+    int bBegin = 0;
+    int rc2;
+    rc2 = sqlite3OsFileControl(pPager->fd, SQLITE_FCNTL_WRITE_BATCH, &bBegin);
+    if( rc==SQLITE_OK && rc2!=SQLITE_NOTFOUND ) rc = rc2;
+  }
   return rc;
 }
 
@@ -4783,6 +5122,19 @@ act_like_temp_file:
                        !memDb?pagerStress:0, (void *)pPager, pPager->pPCache);
   }
 
+  /* If the database file was opened for direct I/O, have the page cache
+  ** allocate page buffers with the alignment the VFS asks for, so that
+  ** pages are read and written without being staged. */
+  if( rc==SQLITE_OK && isOpen(pPager->fd) ){
+    sqlite3OsFileControlHint(pPager->fd, SQLITE_FCNTL_IO_ALIGN,
+                             &pPager->szIoAlign);
+    if( pPager->szIoAlign>0 ){
+      sqlite3PcacheSetAlign(pPager->pPCache, pPager->szIoAlign);
+    }else{
+      pPager->szIoAlign = 0;
+    }
+  }
+
   /* If an error occurred above, free the  Pager structure and close the file.
   */
   if( rc!=SQLITE_OK ){
@@ -4849,6 +5201,8 @@ act_like_temp_file:
   pPager->xReiniter = xReinit;
   /* memset(pPager->aHash, 0, sizeof(pPager->aHash)); */
   /* pPager->szMmap = SQLITE_DEFAULT_MMAP_SIZE // will be set by btree.c */
+  sqlite3PagerSetReadahead(pPager, SQLITE_DEFAULT_READAHEAD);
+  sqlite3PagerSetDurability(pPager, SQLITE_DEFAULT_DURABILITY);
 
   *ppPager = pPager;
   return SQLITE_OK;
@@ -5501,6 +5855,78 @@ DbPage *sqlite3PagerLookup(Pager *pPager, Pgno pgno){
   return sqlite3PcacheFetchFinish(pPager->pPCache, pgno, pPage);
 }
 
+/*
+** Read up to *pnPage consecutive pages, beginning with page pgno, from
+** the database file into a staging buffer owned by the pager, without
+** loading them into the page cache. This is used to stream the content
+** of long overflow chains straight into the caller's buffer.
+**
+** If successful, SQLITE_OK is returned, *pnPage is set to the number of
+** pages read and *paData to the decoded image of page pgno. The images
+** of the following pages are stored after it at intervals of the page
+** size. They remain valid until the next call to this function or until
+** the page size changes.
+**
+** SQLITE_NOTFOUND is returned if the content of the file may not be
+** the current content of page pgno, either because the pager holds a
+** write transaction or because the page has a frame in the WAL file,
+** or if pages are better read from a memory mapping or cannot be read
+** from the file directly at all. In that case the caller should fall
+** back to sqlite3PagerGet(). The run is truncated (not failed) at the
+** first subsequent page that cannot be read directly.
+*/
+int sqlite3PagerReadDirect(Pager *pPager, Pgno pgno, int *pnPage, u8 **paData){
+  int pgsz = pPager->pageSize;
+  int nPage = *pnPage;
+  int i;
+  int rc;
+
+  assert( pgno>0 && nPage>0 );
+  if( pPager->eState!=PAGER_READER || MEMDB || !isOpen(pPager->fd)
+   || USEFETCH(pPager) || pPager->errCode
+  ){
+    return SQLITE_NOTFOUND;
+  }
+  if( nPage>SQLITE_MAX_DIRECT_READ/pgsz ) nPage = SQLITE_MAX_DIRECT_READ/pgsz;
+  if( nPage<1 ) nPage = 1;
+  for(i=0; i<nPage; i++){
+    if( pgno+i>pPager->dbSize || pgno+i==PAGER_MJ_PGNO(pPager) ) break;
+#ifndef SQLITE_OMIT_WAL
+    if( pagerUseWal(pPager) ){
+      u32 iFrame = 0;
+      rc = sqlite3WalFindFrame(pPager->pWal, pgno+i, &iFrame);
+      if( rc!=SQLITE_OK ) return rc;
+      if( iFrame ) break;
+    }
+#endif
+  }
+  if( i==0 ) return SQLITE_NOTFOUND;
+  nPage = i;
+
+  if( pPager->aDirect==0 ){
+    int mAlign = pPager->szIoAlign ? pPager->szIoAlign-1 : 0;
+    int nMax = MAX(1, SQLITE_MAX_DIRECT_READ/pgsz);
+    pPager->aDirect = (u8*)sqlite3Malloc((i64)nMax*pgsz + mAlign);
+    if( pPager->aDirect==0 ) return SQLITE_NOMEM;
+    pPager->aDirectPage = &pPager->aDirect[
+        (mAlign+1 - (SQLITE_PTR_TO_INT(pPager->aDirect) & mAlign)) & mAlign
+    ];
+  }
+  rc = sqlite3OsRead(pPager->fd, pPager->aDirectPage, nPage*pgsz,
+                     (pgno-1)*(i64)pgsz);
+  if( rc==SQLITE_IOERR_SHORT_READ ) rc = SQLITE_OK;
+  if( rc!=SQLITE_OK ) return rc;
+  IOTRACE(("DIRECT %p %d %d\n", pPager, pgno, nPage));
+  for(i=0; i<nPage; i++){
+    CODEC1(pPager, &pPager->aDirectPage[i*pgsz], pgno+i, 3, rc = SQLITE_NOMEM);
+    if( rc!=SQLITE_OK ) return rc;
+  }
+  pPager->aStat[PAGER_STAT_MISS] += nPage;
+  *pnPage = nPage;
+  *paData = pPager->aDirectPage;
+  return SQLITE_OK;
+}
+
 /*
 ** Release a page reference.
 **
@@ -5588,6 +6014,7 @@ static int pager_open_journal(Pager *pPager){
 #else
           rc = sqlite3OsOpen(pVfs, pPager->zJournal, pPager->jfd, flags, 0);
 #endif
+          if( rc==SQLITE_OK ) pagerApplyDurability(pPager, pPager->jfd);
         }
       }
       assert( rc!=SQLITE_OK || isOpen(pPager->jfd) );
@@ -5690,6 +6117,7 @@ int sqlite3PagerBegin(Pager *pPager, int exFlag, int subjInMemory){
       pPager->dbFileSize = pPager->dbSize;
       pPager->dbOrigSize = pPager->dbSize;
       pPager->journalOff = 0;
+      pPager->iSyncMark = pPager->aStat[PAGER_STAT_SYNC];
     }
 
     assert( rc==SQLITE_OK || pPager->eState==PAGER_READER );
@@ -6115,7 +6543,7 @@ int sqlite3PagerSync(Pager *pPager, const char *zMaster){
   }
   if( rc==SQLITE_OK && !pPager->noSync ){
     assert( !MEMDB );
-    rc = sqlite3OsSync(pPager->fd, pPager->syncFlags);
+    rc = pagerSync(pPager, pPager->fd, pPager->syncFlags);
   }
   return rc;
 }
@@ -6295,30 +6723,33 @@ int sqlite3PagerCommitPhaseOne(
       rc = syncJournal(pPager, 0);
       if( rc!=SQLITE_OK ) goto commit_phase_one_exit;
   
+      pagerBeginWriteBatch(pPager);
       rc = pager_write_pagelist(pPager,sqlite3PcacheDirtyList(pPager->pPCache));
+      if( rc==SQLITE_OK ){
+        sqlite3PcacheCleanAll(pPager->pPCache);
+
+        /* If the file on disk is smaller than the database image, use 
+        ** pager_truncate to grow the file here. This can happen if the
+        ** database image was extended as part of the current transaction
+        ** and then the last page in the db image moved to the free-list.
+        ** In this case the last page is never written out to disk, leaving
+        ** the database file undersized. Fix this now if it is the case.  */
+        if( pPager->dbSize>pPager->dbFileSize ){
+          Pgno nNew = pPager->dbSize - (pPager->dbSize==PAGER_MJ_PGNO(pPager));
+          assert( pPager->eState==PAGER_WRITER_DBMOD );
+          rc = pager_truncate(pPager, nNew);
+        }
+  
+        /* Finally, sync the database file. */
+        if( rc==SQLITE_OK && !noSync ){
+          rc = sqlite3PagerSync(pPager, zMaster);
+        }
+      }
+      rc = pagerEndWriteBatch(pPager, rc);
       if( rc!=SQLITE_OK ){
         assert( rc!=SQLITE_IOERR_BLOCKED );
         goto commit_phase_one_exit;
       }
-      sqlite3PcacheCleanAll(pPager->pPCache);
-
-      /* If the file on disk is smaller than the database image, use 
-      ** pager_truncate to grow the file here. This can happen if the database
-      ** image was extended as part of the current transaction and then the
-      ** last page in the db image moved to the free-list. In this case the
-      ** last page is never written out to disk, leaving the database file
-      ** undersized. Fix this now if it is the case.  */
-      if( pPager->dbSize>pPager->dbFileSize ){
-        Pgno nNew = pPager->dbSize - (pPager->dbSize==PAGER_MJ_PGNO(pPager));
-        assert( pPager->eState==PAGER_WRITER_DBMOD );
-        rc = pager_truncate(pPager, nNew);
-        if( rc!=SQLITE_OK ) goto commit_phase_one_exit;
-      }
-  
-      /* Finally, sync the database file. */
-      if( !noSync ){
-        rc = sqlite3PagerSync(pPager, zMaster);
-      }
       IOTRACE(("DBSYNC %p\n", pPager))
     }
   }
@@ -6383,6 +6814,10 @@ int sqlite3PagerCommitPhaseTwo(Pager *pPager){
   PAGERTRACE(("COMMIT %d\n", PAGERID(pPager)));
   pPager->iDataVersion++;
   rc = pager_end_transaction(pPager, pPager->setMaster, 1);
+  if( rc==SQLITE_OK ){
+    int nSync = pPager->aStat[PAGER_STAT_SYNC] - pPager->iSyncMark;
+    if( nSync>pPager->mxCommitSync ) pPager->mxCommitSync = nSync;
+  }
   return pager_error(pPager, rc);
 }
 
@@ -6522,19 +6957,98 @@ int *sqlite3PagerStats(Pager *pPager){
 ** returning.
 */
 void sqlite3PagerCacheStat(Pager *pPager, int eStat, int reset, int *pnVal){
+  int iStat;
 
   assert( eStat==SQLITE_DBSTATUS_CACHE_HIT
        || eStat==SQLITE_DBSTATUS_CACHE_MISS
        || eStat==SQLITE_DBSTATUS_CACHE_WRITE
+       || eStat==SQLITE_DBSTATUS_READAHEAD_HIT
+       || eStat==SQLITE_DBSTATUS_READAHEAD_MISS
   );
 
   assert( SQLITE_DBSTATUS_CACHE_HIT+1==SQLITE_DBSTATUS_CACHE_MISS );
   assert( SQLITE_DBSTATUS_CACHE_HIT+2==SQLITE_DBSTATUS_CACHE_WRITE );
+  assert( SQLITE_DBSTATUS_READAHEAD_HIT+1==SQLITE_DBSTATUS_READAHEAD_MISS );
   assert( PAGER_STAT_HIT==0 && PAGER_STAT_MISS==1 && PAGER_STAT_WRITE==2 );
+  assert( PAGER_STAT_READAHEAD_HIT==3 && PAGER_STAT_READAHEAD_MISS==4 );
 
-  *pnVal += pPager->aStat[eStat - SQLITE_DBSTATUS_CACHE_HIT];
+  if( eStat>=SQLITE_DBSTATUS_READAHEAD_HIT ){
+    iStat = eStat - SQLITE_DBSTATUS_READAHEAD_HIT + PAGER_STAT_READAHEAD_HIT;
+  }else{
+    iStat = eStat - SQLITE_DBSTATUS_CACHE_HIT;
+  }
+  *pnVal += pPager->aStat[iStat];
   if( reset ){
-    pPager->aStat[eStat - SQLITE_DBSTATUS_CACHE_HIT] = 0;
+    pPager->aStat[iStat] = 0;
+  }
+}
+
+/*
+** Parameter eStat must be one of SQLITE_DBSTATUS_MMAP_USED, _MMAP_REMAP or
+** _MMAP_MISS. Add the value of the statistic for the database file of this
+** pager to *pnCur and raise *pnMax to its highwater value, if any. If the
+** reset parameter is non-zero, the statistic is reset before returning.
+*/
+void sqlite3PagerMmapStat(
+  Pager *pPager,
+  int eStat,
+  int reset,
+  int *pnCur,
+  int *pnMax
+){
+  sqlite3_int64 aStat[5];
+  int iStat = eStat - SQLITE_DBSTATUS_MMAP_USED;
+  assert( SQLITE_DBSTATUS_MMAP_REMAP==SQLITE_DBSTATUS_MMAP_USED+1 );
+  assert( SQLITE_DBSTATUS_MMAP_MISS==SQLITE_DBSTATUS_MMAP_USED+2 );
+  assert( iStat>=0 && iStat<=2 );
+
+  if( !isOpen(pPager->fd) ) return;
+  memset(aStat, 0, sizeof(aStat));
+  aStat[4] = reset ? (1<<iStat) : 0;
+  if( sqlite3OsFileControl(pPager->fd, SQLITE_FCNTL_MMAP_STATS, aStat) ){
+    return;
+  }
+  if( iStat==0 ){
+    *pnCur += (int)aStat[0];
+    if( aStat[1]>*pnMax ) *pnMax = (int)aStat[1];
+  }else{
+    *pnCur += (int)aStat[iStat+1];
+  }
+}
+
+/*
+** Parameter eStat must be one of the SQLITE_DBSTATUS_CKPT_* or
+** SQLITE_DBSTATUS_WAL_* values. Add the value of the statistic for this pager
+** to *pnCur and raise *pnMax to its largest value (see
+** sqlite3WalCkptStat()). If the pager is not in WAL mode, neither value is
+** changed. If the reset parameter is non-zero, the statistic is zeroed
+** before returning.
+*/
+void sqlite3PagerCkptStat(
+  Pager *pPager,
+  int eStat,
+  int reset,
+  int *pnCur,
+  int *pnMax
+){
+  if( pagerUseWal(pPager) ){
+    sqlite3WalCkptStat(pPager->pWal, eStat, reset, pnCur, pnMax);
+  }
+}
+
+/*
+** Add the number of syncs issued by this pager since the statistic was
+** last reset to *pnCur, and raise *pnMax to the largest number of syncs
+** issued by a single committed write transaction. If the reset parameter
+** is non-zero, both statistics are zeroed before returning.
+*/
+void sqlite3PagerSyncStat(Pager *pPager, int reset, int *pnCur, int *pnMax){
+  *pnCur += pPager->aStat[PAGER_STAT_SYNC];
+  if( pPager->mxCommitSync>*pnMax ) *pnMax = pPager->mxCommitSync;
+  if( reset ){
+    pPager->iSyncMark -= pPager->aStat[PAGER_STAT_SYNC];
+    pPager->aStat[PAGER_STAT_SYNC] = 0;
+    pPager->mxCommitSync = 0;
   }
 }
 
@@ -7168,11 +7682,21 @@ void sqlite3PagerClearCache(Pager *pPager){
 ** or wal_blocking_checkpoint() API functions.
 **
 ** Parameter eMode is one of SQLITE_CHECKPOINT_PASSIVE, FULL or RESTART.
-*/
-int sqlite3PagerCheckpoint(Pager *pPager, int eMode, int *pnLog, int *pnCkpt){
+** Parameter db is the connection running the checkpoint. Its worker
+** thread limit (PRAGMA threads) determines whether or not the WAL module
+** may use a worker thread to read frames while writing the database.
+*/
+int sqlite3PagerCheckpoint(
+  Pager *pPager,                  /* Checkpoint on this pager */
+  sqlite3 *db,                    /* Connection running the checkpoint */
+  int eMode,                      /* Type of checkpoint */
+  int *pnLog,                     /* OUT: Final number of frames in log */
+  int *pnCkpt                     /* OUT: Final number of checkpointed frames */
+){
   int rc = SQLITE_OK;
+  pagerReadaheadDiscard(pPager);
   if( pPager->pWal ){
-    rc = sqlite3WalCheckpoint(pPager->pWal, eMode,
+    rc = sqlite3WalCheckpoint(pPager->pWal, db, eMode,
         (eMode==SQLITE_CHECKPOINT_PASSIVE ? 0 : pPager->xBusyHandler),
         pPager->pBusyHandlerArg,
         pPager->ckptSyncFlags, pPager->pageSize, (u8 *)pPager->pTmpSpace,
@@ -7243,6 +7767,11 @@ static int pagerOpenWal(Pager *pPager){
         pPager->journalSizeLimit, &pPager->pWal
     );
   }
+  if( rc==SQLITE_OK ){
+    sqlite3WalSetDurability(pPager->pWal, pPager->eDurability,
+                            &pPager->aStat[PAGER_STAT_SYNC]);
+    pagerApplyDurability(pPager, sqlite3WalFile(pPager->pWal));
+  }
   pagerFixMaplimit(pPager);
 
   return rc;
@@ -7340,6 +7869,40 @@ int sqlite3PagerCloseWal(Pager *pPager){
   return rc;
 }
 
+/*
+** Prepare pager pPager, which has not yet been used to read the database,
+** to checkpoint a WAL mode database without reading any database page.
+** This is used by the background checkpointer (see
+** sqlite3_wal_checkpoint_thread()). Its private connection has no codec,
+** so it could not decode page 1 to discover the page size or journal
+** mode in the usual way. Parameter szPage is the page size in use by the
+** connection the checkpoints are run for.
+**
+** SQLITE_OK is returned if the WAL file is open when this function
+** returns. SQLITE_EMPTY is returned if the database is not in WAL mode.
+** Otherwise, an error code.
+*/
+int sqlite3PagerOpenWalForCheckpoint(Pager *pPager, int szPage){
+  u32 pgsz = (u32)szPage;
+  int rc;
+
+  assert( pPager->eState==PAGER_OPEN );
+  assert( sqlite3PcacheRefCount(pPager->pPCache)==0 );
+  rc = sqlite3PagerSetPagesize(pPager, &pgsz, -1);
+  if( rc==SQLITE_OK && pgsz!=(u32)szPage ) rc = SQLITE_MISUSE_BKPT;
+  if( rc==SQLITE_OK ){
+    /* Take a SHARED lock and open the WAL file, if there is one. The read
+    ** transaction this opens is closed again straight away, but the SHARED
+    ** lock is retained while the WAL is open. */
+    rc = sqlite3PagerSharedLock(pPager);
+    pagerUnlockIfUnused(pPager);
+  }
+  if( rc==SQLITE_OK && !pagerUseWal(pPager) ){
+    rc = SQLITE_EMPTY;
+  }
+  return rc;
+}
+
 #ifdef SQLITE_ENABLE_SNAPSHOT
 /*
 ** If this is a WAL database, obtain a snapshot handle for the snapshot
@@ -67,6 +67,15 @@ typedef struct PgHdr DbPage;
 #define PAGER_LOCKINGMODE_NORMAL      0
 #define PAGER_LOCKINGMODE_EXCLUSIVE   1
 
+/*
+** Valid values for the second argument to sqlite3PagerSetDurability().
+** These are also the values passed through SQLITE_FCNTL_DURABILITY.
+*/
+#define PAGER_DURABILITY_QUERY       -1
+#define PAGER_DURABILITY_STRICT       0   /* Every sync is a full fsync() */
+#define PAGER_DURABILITY_BATCHED      1   /* Group WAL syncs over commits */
+#define PAGER_DURABILITY_RELAXED      2   /* Wait for write-out only */
+
 /*
 ** Numeric constants that encode the journalmode.  
 */
@@ -126,9 +135,11 @@ int sqlite3PagerMaxPageCount(Pager*, int);
 void sqlite3PagerSetCachesize(Pager*, int);
 int sqlite3PagerSetSpillsize(Pager*, int);
 void sqlite3PagerSetMmapLimit(Pager *, sqlite3_int64);
+int sqlite3PagerSetReadahead(Pager*, int);
 void sqlite3PagerShrink(Pager*);
 void sqlite3PagerSetFlags(Pager*,unsigned);
 int sqlite3PagerLockingMode(Pager *, int);
+int sqlite3PagerSetDurability(Pager*, int);
 int sqlite3PagerSetJournalMode(Pager *, int);
 int sqlite3PagerGetJournalMode(Pager*);
 int sqlite3PagerOkToChangeJournalMode(Pager*);
@@ -139,6 +150,7 @@ int sqlite3PagerFlush(Pager*);
 /* Functions used to obtain and release page references. */ 
 int sqlite3PagerGet(Pager *pPager, Pgno pgno, DbPage **ppPage, int clrFlag);
 DbPage *sqlite3PagerLookup(Pager *pPager, Pgno pgno);
+int sqlite3PagerReadDirect(Pager*, Pgno, int*, u8**);
 void sqlite3PagerRef(DbPage*);
 void sqlite3PagerUnref(DbPage*);
 void sqlite3PagerUnrefNotNull(DbPage*);
@@ -164,11 +176,12 @@ int sqlite3PagerSavepoint(Pager *pPager, int op, int iSavepoint);
 int sqlite3PagerSharedLock(Pager *pPager);
 
 #ifndef SQLITE_OMIT_WAL
-  int sqlite3PagerCheckpoint(Pager *pPager, int, int*, int*);
+  int sqlite3PagerCheckpoint(Pager *pPager, sqlite3*, int, int*, int*);
   int sqlite3PagerWalSupported(Pager *pPager);
   int sqlite3PagerWalCallback(Pager *pPager);
   int sqlite3PagerOpenWal(Pager *pPager, int *pisOpen);
   int sqlite3PagerCloseWal(Pager *pPager);
+  int sqlite3PagerOpenWalForCheckpoint(Pager *pPager, int szPage);
 # ifdef SQLITE_ENABLE_SNAPSHOT
   int sqlite3PagerSnapshotGet(Pager *pPager, sqlite3_snapshot **ppSnapshot);
   int sqlite3PagerSnapshotOpen(Pager *pPager, sqlite3_snapshot *pSnapshot);
@@ -195,6 +208,9 @@ int sqlite3PagerNosync(Pager*);
 void *sqlite3PagerTempSpace(Pager*);
 int sqlite3PagerIsMemdb(Pager*);
 void sqlite3PagerCacheStat(Pager *, int, int, int *);
+void sqlite3PagerMmapStat(Pager*, int, int, int*, int*);
+void sqlite3PagerCkptStat(Pager *, int, int, int *, int *);
+void sqlite3PagerSyncStat(Pager*, int, int*, int*);
 void sqlite3PagerClearCache(Pager *);
 int sqlite3SectorSize(sqlite3_file *);
 
@@ -206,6 +222,9 @@ void sqlite3PagerRekey(DbPage*, Pgno, u16);
 #if defined(SQLITE_HAS_CODEC) && !defined(SQLITE_OMIT_WAL)
 void *sqlite3PagerCodec(DbPage *);
 #endif
+#ifdef SQLITE_HAS_CODEC
+void *sqlite3PagerGetCodec(Pager*);
+#endif
 
 /* Functions to support testing and debugging. */
 #if !defined(NDEBUG) || defined(SQLITE_TEST)
@@ -24,6 +24,7 @@ struct PCache {
   int szSpill;                        /* Size before spilling occurs */
   int szPage;                         /* Size of every page in this cache */
   int szExtra;                        /* Size of extra space for each page */
+  int szAlign;                        /* Required page buffer alignment */
   u8 bPurgeable;                      /* True if pages are on backing store */
   u8 eCreate;                         /* eCreate value for for xFetch() */
   int (*xStress)(void*,PgHdr*);       /* Call to try make a page clean */
@@ -192,6 +193,7 @@ int sqlite3PcacheSetPageSize(PCache *pCache, int szPage){
                 pCache->bPurgeable
     );
     if( pNew==0 ) return SQLITE_NOMEM;
+    if( pCache->szAlign ) sqlite3PCacheAlignPages(pNew, pCache->szAlign);
     sqlite3GlobalConfig.pcache2.xCachesize(pNew, numberOfCachePages(pCache));
     if( pCache->pCache ){
       sqlite3GlobalConfig.pcache2.xDestroy(pCache->pCache);
@@ -202,6 +204,18 @@ int sqlite3PcacheSetPageSize(PCache *pCache, int szPage){
   return SQLITE_OK;
 }
 
+/*
+** Request that page buffers be aligned to szAlign bytes, a power of two,
+** for the remaining life of the PCache. The caller must ensure that the
+** cache is empty when this function is called.
+*/
+void sqlite3PcacheSetAlign(PCache *pCache, int szAlign){
+  assert( pCache->nRefSum==0 && pCache->pDirty==0 );
+  assert( (szAlign & (szAlign-1))==0 );
+  pCache->szAlign = szAlign;
+  if( pCache->pCache ) sqlite3PCacheAlignPages(pCache->pCache, szAlign);
+}
+
 /*
 ** Try to obtain a page from the cache.
 **
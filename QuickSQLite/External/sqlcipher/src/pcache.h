@@ -82,6 +82,10 @@ int sqlite3PcacheOpen(
 /* Modify the page-size after the cache has been created. */
 int sqlite3PcacheSetPageSize(PCache *, int);
 
+/* Request page buffers aligned to a multiple of the given number of bytes,
+** for direct I/O. Only the built-in page cache honors the request. */
+void sqlite3PcacheSetAlign(PCache *, int);
+
 /* Return the size in bytes of a PCache object.  Used to preallocate
 ** storage space.
 */
@@ -168,6 +172,7 @@ void sqlite3PcacheStats(int*,int*,int*,int*);
 #endif
 
 void sqlite3PCacheSetDefault(void);
+void sqlite3PCacheAlignPages(sqlite3_pcache*, int);
 
 /* Return the header size */
 int sqlite3HeaderSizePcache(void);
@@ -99,6 +99,8 @@ struct PgHdr1 {
   u8 isPinned;                   /* Page in use, not on the LRU list */
   u8 isBulkLocal;                /* This page from bulk local storage */
   u8 isAnchor;                   /* This is the PGroup.lru element */
+  u8 isHot;                      /* Referenced again since being loaded */
+  u8 isCold;                     /* On the PGroup.lruCold list */
   PgHdr1 *pNext;                 /* Next in hash table chain */
   PCache1 *pCache;               /* Cache that currently owns this page */
   PgHdr1 *pLruNext;              /* Next in LRU list of unpinned pages */
@@ -134,8 +136,26 @@ struct PGroup {
   unsigned int mxPinned;         /* nMaxpage + 10 - nMinPage */
   unsigned int nCurrentPage;     /* Number of purgeable pages allocated */
   PgHdr1 lru;                    /* The beginning and end of the LRU list */
+  PgHdr1 lruCold;                /* Probationary LRU list for the 2Q policy */
+  unsigned int nCold;            /* Number of pages on lruCold */
 };
 
+/* Page replacement policy.
+**
+** With the default SQLITE_PCACHE_POLICY_LRU policy every unpinned page
+** goes on the PGroup.lru list and the least recently unpinned page is
+** recycled first.
+**
+** With SQLITE_PCACHE_POLICY_2Q, a page that has not been fetched again
+** since it was loaded goes on the separate PGroup.lruCold list when it
+** is unpinned.  Pages are recycled from lruCold whenever it holds more
+** than a quarter of the group's nMaxPage budget, and from PGroup.lru
+** otherwise.  So a large table scan or VACUUM, which touches each page
+** once, cycles through the cold list without evicting the hot set.
+** This is the "simplified 2Q" of Johnson and Shasha without the ghost
+** list of recently evicted page numbers.
+*/
+
 /* Each page cache is an instance of the following object.  Every
 ** open database file (including each in-memory database and each
 ** temporary or transient database) has a single page cache which
@@ -154,6 +174,7 @@ struct PCache1 {
   int szPage;                         /* Size of database content section */
   int szExtra;                        /* sizeof(MemPage)+sizeof(PgHdr) */
   int szAlloc;                        /* Total size of one pcache line */
+  int szAlign;                        /* Page buffer alignment, or 0 */
   int bPurgeable;                     /* True if cache is purgeable */
   unsigned int nMin;                  /* Minimum number of pages reserved */
   unsigned int nMax;                  /* Configured "cache_size" value */
@@ -171,6 +192,14 @@ struct PCache1 {
   void *pBulk;                        /* Bulk memory used by pcache-local */
 };
 
+/*
+** Number of pages added to a cache at a time once the initial bulk
+** allocation of a cache with aligned page buffers has been used up.
+*/
+#ifndef SQLITE_PCACHE_ALIGN_CHUNK
+# define SQLITE_PCACHE_ALIGN_CHUNK 64
+#endif
+
 /*
 ** Free slots in the allocator used to divide up the global page cache
 ** buffer provided using the SQLITE_CONFIG_PAGECACHE mechanism.
@@ -193,6 +222,7 @@ static SQLITE_WSD struct PCacheGlobal {
   int isInit;                    /* True if initialized */
   int separateCache;             /* Use a new PGroup for each PCache */
   int nInitPage;                 /* Initial bulk allocation size */   
+  int ePolicy;                   /* SQLITE_PCACHE_POLICY_* value */
   int szSlot;                    /* Size of each free slot */
   int nSlot;                     /* The number of pcache slots */
   int nReserve;                  /* Try to keep nFreeSlot above this */
@@ -262,6 +292,67 @@ void sqlite3PCacheBufferSetup(void *pBuf, int sz, int n){
   }
 }
 
+/*
+** Add a chunk of page buffers aligned to pCache->szAlign bytes to the
+** pCache->pFree list.  The page buffers of a chunk are contiguous, so
+** aligning them costs at most szAlign bytes per chunk, and are followed by
+** the PgHdr1 and extra space of each page.  Chunks are linked together
+** through their first bytes and only freed once the cache is empty.
+** Return true if pCache->pFree ends up containing one or more free pages.
+*/
+static int pcache1InitAlignedBulk(PCache1 *pCache){
+  int szHdr = pCache->szAlloc - pCache->szPage;
+  i64 nBulk;
+  char *zRaw;
+  assert( pCache->pFree==0 );
+  if( pCache->nPage==0 && pcache1.nInitPage>0 ){
+    nBulk = pcache1.nInitPage;
+  }else if( pCache->nPage==0 && pcache1.nInitPage<0 ){
+    nBulk = (-1024 * (i64)pcache1.nInitPage) / pCache->szAlloc;
+  }else{
+    nBulk = SQLITE_PCACHE_ALIGN_CHUNK;
+  }
+  if( nBulk > (i64)pCache->nMax - pCache->nPage ){
+    nBulk = (i64)pCache->nMax - pCache->nPage;
+  }
+  if( nBulk<1 ) nBulk = 1;
+  sqlite3BeginBenignMalloc();
+  zRaw = sqlite3Malloc( nBulk*pCache->szAlloc + pCache->szAlign + 8 );
+  sqlite3EndBenignMalloc();
+  if( zRaw ){
+    int mAlign = pCache->szAlign - 1;
+    char *aPage = &zRaw[8 + ((mAlign+1 - (SQLITE_PTR_TO_INT(&zRaw[8])&mAlign))
+                                & mAlign)];
+    char *aHdr = &aPage[nBulk*pCache->szPage];
+    int i;
+    *(void**)zRaw = pCache->pBulk;
+    pCache->pBulk = zRaw;
+    for(i=0; i<nBulk; i++){
+      PgHdr1 *pX = (PgHdr1*)&aHdr[i*(i64)szHdr];
+      pX->page.pBuf = &aPage[i*(i64)pCache->szPage];
+      pX->page.pExtra = &pX[1];
+      pX->isBulkLocal = 1;
+      pX->isAnchor = 0;
+      pX->pNext = pCache->pFree;
+      pCache->pFree = pX;
+    }
+  }
+  return pCache->pFree!=0;
+}
+
+/*
+** Free the bulk memory of cache pCache, all pages of which must be on
+** the pCache->pFree list.
+*/
+static void pcache1FreeBulk(PCache1 *pCache){
+  while( pCache->pBulk ){
+    void *pNext = pCache->szAlign ? *(void**)pCache->pBulk : 0;
+    sqlite3_free(pCache->pBulk);
+    pCache->pBulk = pNext;
+  }
+  pCache->pFree = 0;
+}
+
 /*
 ** Try to initialize the pCache->pFree and pCache->pBulk fields.  Return
 ** true if pCache->pFree ends up containing one or more free pages.
@@ -269,6 +360,7 @@ void sqlite3PCacheBufferSetup(void *pBuf, int sz, int n){
 static int pcache1InitBulk(PCache1 *pCache){
   i64 szBulk;
   char *zBulk;
+  if( pCache->szAlign ) return pcache1InitAlignedBulk(pCache);
   if( pcache1.nInitPage==0 ) return 0;
   /* Do not bother with a bulk allocation if the cache size very small */
   if( pCache->nMax<3 ) return 0;
@@ -400,7 +492,9 @@ static PgHdr1 *pcache1AllocPage(PCache1 *pCache, int benignMalloc){
   void *pPg;
 
   assert( sqlite3_mutex_held(pCache->pGroup->mutex) );
-  if( pCache->pFree || (pCache->nPage==0 && pcache1InitBulk(pCache)) ){
+  if( pCache->pFree
+   || ((pCache->nPage==0 || pCache->szAlign) && pcache1InitBulk(pCache))
+  ){
     p = pCache->pFree;
     pCache->pFree = p->pNext;
     p->pNext = 0;
@@ -569,6 +663,11 @@ static PgHdr1 *pcache1PinPage(PgHdr1 *pPage){
   pPage->pLruNext = 0;
   pPage->pLruPrev = 0;
   pPage->isPinned = 1;
+  if( pPage->isCold ){
+    assert( pCache->pGroup->nCold>0 );
+    pPage->isCold = 0;
+    pCache->pGroup->nCold--;
+  }
   assert( pPage->isAnchor==0 );
   assert( pCache->pGroup->lru.isAnchor==1 );
   pCache->nRecyclable--;
@@ -597,6 +696,24 @@ static void pcache1RemoveFromHash(PgHdr1 *pPage, int freeFlag){
   if( freeFlag ) pcache1FreePage(pPage);
 }
 
+/*
+** Return the unpinned page of PGroup pGroup that should be recycled next,
+** or NULL if there are no unpinned pages in the group.
+**
+** The PGroup mutex must be held when this function is called.
+*/
+static PgHdr1 *pcache1LruVictim(PGroup *pGroup){
+  PgHdr1 *pHot = pGroup->lru.pLruPrev;
+  PgHdr1 *pCold = pGroup->lruCold.pLruPrev;
+  assert( sqlite3_mutex_held(pGroup->mutex) );
+  if( pHot && pHot->isAnchor ) pHot = 0;
+  if( pCold && pCold->isAnchor ) pCold = 0;
+  if( pCold && (pHot==0 || pGroup->nCold>pGroup->nMaxPage/4) ){
+    return pCold;
+  }
+  return pHot;
+}
+
 /*
 ** If there are currently more than nMaxPage pages allocated, try
 ** to recycle pages to reduce the number allocated to nMaxPage.
@@ -606,7 +723,7 @@ static void pcache1EnforceMaxPage(PCache1 *pCache){
   PgHdr1 *p;
   assert( sqlite3_mutex_held(pGroup->mutex) );
   while( pGroup->nCurrentPage>pGroup->nMaxPage
-      && (p=pGroup->lru.pLruPrev)->isAnchor==0
+      && (p=pcache1LruVictim(pGroup))!=0
   ){
     assert( p->pCache->pGroup==pGroup );
     assert( p->isPinned==0 );
@@ -614,8 +731,7 @@ static void pcache1EnforceMaxPage(PCache1 *pCache){
     pcache1RemoveFromHash(p, 1);
   }
   if( pCache->nPage==0 && pCache->pBulk ){
-    sqlite3_free(pCache->pBulk);
-    pCache->pBulk = pCache->pFree = 0;
+    pcache1FreeBulk(pCache);
   }
 }
 
@@ -700,6 +816,7 @@ static int pcache1Init(void *NotUsed){
   }else{
     pcache1.nInitPage = 0;
   }
+  pcache1.ePolicy = sqlite3GlobalConfig.ePcachePolicy;
   pcache1.grp.mxPinned = 10;
   pcache1.isInit = 1;
   return SQLITE_OK;
@@ -744,6 +861,8 @@ static sqlite3_pcache *pcache1Create(int szPage, int szExtra, int bPurgeable){
     if( pGroup->lru.isAnchor==0 ){
       pGroup->lru.isAnchor = 1;
       pGroup->lru.pLruPrev = pGroup->lru.pLruNext = &pGroup->lru;
+      pGroup->lruCold.isAnchor = 1;
+      pGroup->lruCold.pLruPrev = pGroup->lruCold.pLruNext = &pGroup->lruCold;
     }
     pCache->pGroup = pGroup;
     pCache->szPage = szPage;
@@ -852,16 +971,17 @@ static SQLITE_NOINLINE PgHdr1 *pcache1FetchStage2(
 
   /* Step 4. Try to recycle a page. */
   if( pCache->bPurgeable
-   && !pGroup->lru.pLruPrev->isAnchor
    && ((pCache->nPage+1>=pCache->nMax) || pcache1UnderMemoryPressure(pCache))
+   && (pPage = pcache1LruVictim(pGroup))!=0
   ){
     PCache1 *pOther;
-    pPage = pGroup->lru.pLruPrev;
     assert( pPage->isPinned==0 );
     pcache1RemoveFromHash(pPage, 0);
     pcache1PinPage(pPage);
     pOther = pPage->pCache;
-    if( pOther->szAlloc != pCache->szAlloc ){
+    if( pOther->szAlloc != pCache->szAlloc
+     || pOther->szAlign != pCache->szAlign
+    ){
       pcache1FreePage(pPage);
       pPage = 0;
     }else{
@@ -885,6 +1005,8 @@ static SQLITE_NOINLINE PgHdr1 *pcache1FetchStage2(
     pPage->pLruPrev = 0;
     pPage->pLruNext = 0;
     pPage->isPinned = 1;
+    pPage->isHot = 0;
+    pPage->isCold = 0;
     *(void **)pPage->page.pExtra = 0;
     pCache->apHash[h] = pPage;
     if( iKey>pCache->iMaxKey ){
@@ -971,6 +1093,7 @@ static PgHdr1 *pcache1FetchNoMutex(
   ** subsequent steps to try to create the page. */
   if( pPage ){
     if( !pPage->isPinned ){
+      pPage->isHot = 1;
       return pcache1PinPage(pPage);
     }else{
       return pPage;
@@ -1050,9 +1173,18 @@ static void pcache1Unpin(
   if( reuseUnlikely || pGroup->nCurrentPage>pGroup->nMaxPage ){
     pcache1RemoveFromHash(pPage, 1);
   }else{
-    /* Add the page to the PGroup LRU list. */
-    PgHdr1 **ppFirst = &pGroup->lru.pLruNext;
-    pPage->pLruPrev = &pGroup->lru;
+    /* Add the page to the PGroup LRU list.  Under the 2Q policy, pages
+    ** that have not been reused since they were loaded go on the
+    ** probationary list instead. */
+    PgHdr1 *pAnchor = &pGroup->lru;
+    PgHdr1 **ppFirst;
+    if( pcache1.ePolicy==SQLITE_PCACHE_POLICY_2Q && pPage->isHot==0 ){
+      pAnchor = &pGroup->lruCold;
+      pPage->isCold = 1;
+      pGroup->nCold++;
+    }
+    ppFirst = &pAnchor->pLruNext;
+    pPage->pLruPrev = pAnchor;
     (pPage->pLruNext = *ppFirst)->pLruPrev = pPage;
     *ppFirst = pPage;
     pCache->nRecyclable++;
@@ -1133,7 +1265,7 @@ static void pcache1Destroy(sqlite3_pcache *p){
   pGroup->mxPinned = pGroup->nMaxPage + 10 - pGroup->nMinPage;
   pcache1EnforceMaxPage(pCache);
   pcache1LeaveMutex(pGroup);
-  sqlite3_free(pCache->pBulk);
+  pcache1FreeBulk(pCache);
   sqlite3_free(pCache->apHash);
   sqlite3_free(pCache);
 }
@@ -1167,6 +1299,22 @@ void sqlite3PCacheSetDefault(void){
 */
 int sqlite3HeaderSizePcache1(void){ return ROUND8(sizeof(PgHdr1)); }
 
+/*
+** Align the page buffers of cache p to szAlign bytes, a power of two, if
+** p was created by this module and no pages have been allocated for it
+** yet.  The request is ignored if the page size is not a multiple of
+** szAlign, as transfers of such pages cannot be aligned in any case.
+*/
+void sqlite3PCacheAlignPages(sqlite3_pcache *p, int szAlign){
+  PCache1 *pCache = (PCache1*)p;
+  assert( (szAlign & (szAlign-1))==0 );
+  if( sqlite3GlobalConfig.pcache2.xCreate!=pcache1Create ) return;
+  if( pCache->nPage>0 || pCache->pBulk ) return;
+  if( (pCache->szPage & (szAlign-1))==0 && szAlign>8 ){
+    pCache->szAlign = szAlign;
+  }
+}
+
 /*
 ** Return the global mutex used by this PCACHE implementation.  The
 ** sqlite3_status() routine needs access to this mutex.
@@ -1193,8 +1341,7 @@ int sqlite3PcacheReleaseMemory(int nReq){
     PgHdr1 *p;
     pcache1EnterMutex(&pcache1.grp);
     while( (nReq<0 || nFree<nReq)
-       &&  (p=pcache1.grp.lru.pLruPrev)!=0
-       &&  p->isAnchor==0
+       &&  (p=pcache1LruVictim(&pcache1.grp))!=0
     ){
       nFree += pcache1MemSize(p->page.pBuf);
 #ifdef SQLITE_PCACHE_SEPARATE_HEADER
@@ -1227,6 +1374,10 @@ void sqlite3PcacheStats(
     assert( p->isPinned==0 );
     nRecyclable++;
   }
+  for(p=pcache1.grp.lruCold.pLruNext; p && !p->isAnchor; p=p->pLruNext){
+    assert( p->isPinned==0 );
+    nRecyclable++;
+  }
   *pnCurrent = pcache1.grp.nCurrentPage;
   *pnMax = (int)pcache1.grp.nMaxPage;
   *pnMin = (int)pcache1.grp.nMinPage;
@@ -87,6 +87,22 @@ static int getLockingMode(const char *z){
   return PAGER_LOCKINGMODE_QUERY;
 }
 
+#ifndef SQLITE_OMIT_PAGER_PRAGMAS
+/*
+** Interpret the given string as a durability policy. Return one of the
+** PAGER_DURABILITY_* values, or PAGER_DURABILITY_QUERY if the string is
+** NULL or not recognized.
+*/
+static int getDurability(const char *z){
+  if( z ){
+    if( 0==sqlite3StrICmp(z, "strict") ) return PAGER_DURABILITY_STRICT;
+    if( 0==sqlite3StrICmp(z, "batched") ) return PAGER_DURABILITY_BATCHED;
+    if( 0==sqlite3StrICmp(z, "relaxed") ) return PAGER_DURABILITY_RELAXED;
+  }
+  return PAGER_DURABILITY_QUERY;
+}
+#endif
+
 #ifndef SQLITE_OMIT_AUTOVACUUM
 /*
 ** Interpret the given string as an auto-vacuum mode value.
@@ -852,6 +868,98 @@ void sqlite3Pragma(
     break;
   }
 
+  /*
+  **  PRAGMA [schema.]readahead
+  **  PRAGMA [schema.]readahead=N
+  **
+  ** Report or change the maximum number of pages that the pager reads
+  ** from the database file with a single read once it detects that
+  ** pages are being read sequentially, as during a full table scan.
+  ** Zero disables read-ahead. The setting is not persistent. Only the
+  ** file I/O is done ahead of time: pages of an encrypted database are
+  ** still decrypted one at a time as they are used.
+  */
+  case PragTyp_READAHEAD: {
+    assert( sqlite3SchemaMutexHeld(db, iDb, 0) );
+    returnSingleInt(v, "readahead",
+       sqlite3BtreeSetReadahead(pDb->pBt, zRight ? sqlite3Atoi(zRight) : -1));
+    break;
+  }
+
+  /*
+  **  PRAGMA [schema.]durability
+  **  PRAGMA [schema.]durability = strict|batched|relaxed
+  **
+  ** Report or change the durability policy, which decides how the syncs
+  ** requested by PRAGMA synchronous are carried out. See the comments
+  ** above sqlite3PagerSetDurability() for what each policy guarantees
+  ** after an OS crash or power failure. The setting is not persistent.
+  */
+  case PragTyp_DURABILITY: {
+    static const char *const azDurability[] = {
+      "strict", "batched", "relaxed"
+    };
+    int eDurability;
+    assert( sqlite3SchemaMutexHeld(db, iDb, 0) );
+    eDurability = sqlite3BtreeSetDurability(pDb->pBt, getDurability(zRight));
+    assert( eDurability>=0 && eDurability<ArraySize(azDurability) );
+    returnSingleText(v, "durability", azDurability[eDurability]);
+    break;
+  }
+
+  /*
+  **  PRAGMA [schema.]bulk_fill
+  **  PRAGMA [schema.]bulk_fill=N
+  **
+  ** Report or change the percentage of each page that is filled when an
+  ** empty b-tree is built from keys in sorted order, as by CREATE INDEX.
+  ** Values above 100 are treated as 100. Zero disables bulk builds, so that
+  ** every key is inserted by descending from the root. The setting is not
+  ** persistent.
+  */
+  case PragTyp_BULK_FILL: {
+    assert( sqlite3SchemaMutexHeld(db, iDb, 0) );
+    returnSingleInt(v, "bulk_fill",
+       sqlite3BtreeSetBulkFill(pDb->pBt, zRight ? sqlite3Atoi(zRight) : -1));
+    break;
+  }
+
+  /*
+  **  PRAGMA [schema.]prefix_compression
+  **  PRAGMA [schema.]prefix_compression=ON|OFF
+  **
+  ** Report whether, or enable, prefix compression of index leaves. Index
+  ** leaf pages written by a bulk build (CREATE INDEX, REINDEX, VACUUM and
+  ** sorted INSERT ... SELECT into an empty index) store each key as the
+  ** part not shared with the key before it. Enabling this raises the file
+  ** format number to SQLITE_PREFIX_FILE_FORMAT, which earlier versions of
+  ** SQLite cannot read.
+  **
+  ** Turning it off takes effect at the next VACUUM of the main database,
+  ** which rewrites every index uncompressed in file format 4, readable
+  ** by stock SQLite again. Until then the setting still reports 1.
+  */
+  case PragTyp_PREFIX_COMPRESSION: {
+    int bOn = pDb->pSchema->file_format>=SQLITE_PREFIX_FILE_FORMAT;
+    assert( sqlite3SchemaMutexHeld(db, iDb, 0) );
+    if( zRight ){
+      if( !sqlite3GetBoolean(zRight, 0) ){
+        db->nextPrefix = 0;
+      }else{
+        db->nextPrefix = -1;
+        if( !bOn ){
+          sqlite3BeginWriteOperation(pParse, 0, iDb);
+          sqlite3VdbeAddOp3(v, OP_SetCookie, iDb, BTREE_FILE_FORMAT,
+                            SQLITE_PREFIX_FILE_FORMAT);
+          sqlite3ChangeCookie(pParse, iDb);
+          bOn = 1;
+        }
+      }
+    }
+    returnSingleInt(v, "prefix_compression", bOn);
+    break;
+  }
+
   /*
   **   PRAGMA temp_store
   **   PRAGMA temp_store = "default"|"memory"|"file"
@@ -1837,6 +1945,23 @@ void sqlite3Pragma(
            SQLITE_PTR_TO_INT(db->pWalArg) : 0);
   }
   break;
+
+  /*
+  **   PRAGMA wal_checkpoint_thread
+  **   PRAGMA wal_checkpoint_thread = N
+  **
+  ** Run the automatic checkpoints of this connection on a background
+  ** thread, or in the foreground with TRUNCATE once the WAL holds N or
+  ** more frames. Zero stops the background checkpointer. Or query for
+  ** the current value of N.
+  */
+  case PragTyp_WAL_CHECKPOINT_THREAD: {
+    if( zRight ){
+      sqlite3_wal_checkpoint_thread(db, sqlite3Atoi(zRight));
+    }
+    returnSingleInt(v, "wal_checkpoint_thread", sqlite3CkptThreadCap(db));
+  }
+  break;
 #endif
 
   /*
@@ -3876,6 +3876,232 @@ static Table *isSimpleCount(Select *p, AggInfo *pAggInfo){
   return pTab;
 }
 
+#ifndef SQLITE_OMIT_AGGSCAN
+/*
+** The maximum number of WHERE clause terms and of aggregate functions
+** of a query that codeAggScan() hands to OP_AggScan.
+*/
+#define AGGSCAN_MAX_TERM 16
+#define AGGSCAN_MAX_AGG  16
+
+/*
+** Return true if an index on table pTab might be used to scan column
+** iCol (or the rowid, if iCol is negative) in place of the table.
+*/
+static int aggScanIndexed(Table *pTab, int iCol){
+  Index *pIdx;
+  int i;
+  for(pIdx=pTab->pIndex; pIdx; pIdx=pIdx->pNext){
+    if( iCol<0 || pIdx->pPartIdxWhere ) return 1;
+    for(i=0; i<pIdx->nKeyCol; i++){
+      if( pIdx->aiColumn[i]==iCol ) return 1;
+    }
+  }
+  return 0;
+}
+
+/*
+** Add the AND-connected terms of pExpr to apTerm[], which already holds
+** nTerm terms.  Return the new number of terms, or -1 if there are more
+** than AGGSCAN_MAX_TERM.
+*/
+static int aggScanSplit(Expr *pExpr, Expr **apTerm, int nTerm){
+  if( pExpr->op==TK_AND ){
+    nTerm = aggScanSplit(pExpr->pLeft, apTerm, nTerm);
+    if( nTerm>=0 ) nTerm = aggScanSplit(pExpr->pRight, apTerm, nTerm);
+    return nTerm;
+  }
+  if( nTerm>=AGGSCAN_MAX_TERM ) return -1;
+  apTerm[nTerm] = pExpr;
+  return nTerm+1;
+}
+
+/*
+** Return the index of column iCol in the sorted list aiCol[0..*pnCol-1],
+** adding it to the list first if it is not already there.
+*/
+static int aggScanColumn(int *aiCol, int *pnCol, int iCol){
+  int i, j;
+  for(i=0; i<*pnCol && aiCol[i]<iCol; i++){}
+  if( i==*pnCol || aiCol[i]!=iCol ){
+    for(j=*pnCol; j>i; j--) aiCol[j] = aiCol[j-1];
+    aiCol[i] = iCol;
+    (*pnCol)++;
+  }
+  return i;
+}
+
+/*
+** The aggregate query p, which has no GROUP BY clause, is being coded.
+** If it is of the form
+**
+**   SELECT <aggregates> FROM <tbl> [WHERE <term> [AND <term> ...]]
+**
+** where each aggregate is a built-in count(*), or count(), sum(), total(),
+** avg(), min() or max() of a column, and each <term> is a column compared
+** to a constant using =, <>, <, <=, > or >=, or a column IS NULL or NOT
+** NULL, code an OP_AggScan that computes the aggregates a batch of rows
+** at a time and return the label it jumps to when it does.  The caller
+** resolves the label after the usual row-at-a-time loop, which OP_AggScan
+** falls through to if it meets data it does not handle.  Otherwise, or
+** if one of the columns is indexed (an index would either serve the WHERE
+** clause better or be scanned in place of the table, in another order),
+** code nothing and return 0.
+*/
+static int codeAggScan(Parse *pParse, Select *p, AggInfo *pAggInfo){
+  sqlite3 *db = pParse->db;
+  Vdbe *v = pParse->pVdbe;
+  struct SrcList_item *pItem = p->pSrc->a;
+  Table *pTab = pItem->pTab;
+  Expr *apTerm[AGGSCAN_MAX_TERM];      /* Terms of the WHERE clause */
+  int aTermCol[AGGSCAN_MAX_TERM];      /* Column of each term */
+  int aTermOp[AGGSCAN_MAX_TERM];       /* Comparison opcode of each term */
+  Expr *apTermVal[AGGSCAN_MAX_TERM];   /* Constant of each term, or NULL */
+  char aTermAff[AGGSCAN_MAX_TERM];     /* Affinity of each comparison */
+  int aAggFunc[AGGSCAN_MAX_AGG];       /* AGGSCAN_* code of each aggregate */
+  int aAggCol[AGGSCAN_MAX_AGG];        /* Argument column, -1 for rowid */
+  int aiCol[AGGSCAN_MAX_TERM+AGGSCAN_MAX_AGG];  /* Sorted distinct columns */
+  int nCol = 0;                        /* Number of entries in aiCol[] */
+  int nTerm = 0;                       /* Number of terms */
+  int *ai;                             /* P4 array of the OP_AggScan */
+  int iCsr;                            /* Cursor scanned by OP_AggScan */
+  int lbl;                             /* Label OP_AggScan jumps to */
+  int i, j, k;
+
+  if( p->pSrc->nSrc!=1 || pItem->pSelect || pItem->fg.isIndexedBy
+   || IsVirtual(pTab) || !HasRowid(pTab) || pAggInfo->nAccumulator
+   || pAggInfo->nFunc>AGGSCAN_MAX_AGG
+   || (db->flags & SQLITE_ReverseOrder)!=0
+  ){
+    return 0;
+  }
+
+  /* Each aggregate must be a built-in of a plain column, or count(*). */
+  for(i=0; i<pAggInfo->nFunc; i++){
+    struct AggInfo_func *pF = &pAggInfo->aFunc[i];
+    ExprList *pList = pF->pExpr->x.pList;
+    aAggFunc[i] = sqlite3AggScanFunc(pF->pFunc);
+    if( aAggFunc[i]==0 || pF->iDistinct>=0 ) return 0;
+    if( pList==0 ){
+      if( aAggFunc[i]!=AGGSCAN_COUNT ) return 0;
+      aAggCol[i] = -2;
+    }else{
+      Expr *pArg = pList->a[0].pExpr;
+      if( pList->nExpr!=1
+       || (pArg->op!=TK_AGG_COLUMN && pArg->op!=TK_COLUMN)
+       || pArg->iTable!=pItem->iCursor
+      ){
+        return 0;
+      }
+      aAggCol[i] = pArg->iColumn==pTab->iPKey ? -1 : pArg->iColumn;
+      if( aggScanIndexed(pTab, aAggCol[i]) ) return 0;
+    }
+  }
+
+  /* Each term of the WHERE clause must compare a column to a constant. */
+  if( p->pWhere ){
+    nTerm = aggScanSplit(p->pWhere, apTerm, 0);
+    if( nTerm<0 ) return 0;
+  }
+  for(i=0; i<nTerm; i++){
+    Expr *pTerm = apTerm[i];
+    Expr *pCol = pTerm->pLeft;
+    Expr *pVal = 0;
+    int op = pTerm->op;
+    switch( op ){
+      case TK_ISNULL:
+      case TK_NOTNULL:
+        break;
+      case TK_EQ: case TK_NE:
+      case TK_LT: case TK_LE: case TK_GT: case TK_GE:
+        pVal = pTerm->pRight;
+        if( pCol->op!=TK_COLUMN ){
+          /* "<constant> <op> <column>" is "<column> <commuted-op> <constant>" */
+          pVal = pCol;
+          pCol = pTerm->pRight;
+          if( op>=TK_GT ){
+            assert( TK_LT==TK_GT+2 && TK_GE==TK_LE+2 );
+            op = ((op-TK_GT)^2)+TK_GT;
+          }
+        }
+        if( !sqlite3ExprIsConstant(pVal) ) return 0;
+        aTermAff[i] = sqlite3CompareAffinity(pCol, sqlite3ExprAffinity(pVal));
+        if( aTermAff[i]==SQLITE_AFF_TEXT ) return 0;
+        break;
+      default:
+        return 0;
+    }
+    if( pCol->op!=TK_COLUMN || pCol->iTable!=pItem->iCursor
+     || pCol->iColumn<0 || pCol->iColumn==pTab->iPKey
+     || aggScanIndexed(pTab, pCol->iColumn)
+    ){
+      return 0;
+    }
+    assert( TK_EQ==OP_Eq && TK_NE==OP_Ne && TK_LT==OP_Lt && TK_LE==OP_Le
+         && TK_GT==OP_Gt && TK_GE==OP_Ge
+         && TK_ISNULL==OP_IsNull && TK_NOTNULL==OP_NotNull );
+    aTermOp[i] = op;
+    aTermCol[i] = pCol->iColumn;
+    apTermVal[i] = pVal;
+  }
+
+  /* Collect the columns decoded, then build the P4 array. */
+  for(i=0; i<nTerm; i++) aggScanColumn(aiCol, &nCol, aTermCol[i]);
+  for(i=0; i<pAggInfo->nFunc; i++){
+    if( aAggCol[i]>=-1 ) aggScanColumn(aiCol, &nCol, aAggCol[i]);
+  }
+  ai = sqlite3DbMallocRaw(db, sizeof(int)*(3 + nCol*2 + nTerm*4
+                                              + pAggInfo->nFunc*3));
+  if( ai==0 ) return 0;
+  ai[0] = nCol;
+  ai[1] = nTerm;
+  ai[2] = pAggInfo->nFunc;
+  k = 3;
+  for(i=0; i<nCol; i++){
+    int iCol = aiCol[i];
+    int f = AGGSCAN_NULL;
+    for(j=0; j<nTerm; j++){
+      if( aTermCol[j]==iCol && apTermVal[j] ) f = 0;
+    }
+    for(j=0; j<pAggInfo->nFunc; j++){
+      if( aAggCol[j]==iCol && aAggFunc[j]!=AGGSCAN_COUNT ) f = 0;
+    }
+    if( iCol>=0 ){
+      if( pTab->aCol[iCol].affinity==SQLITE_AFF_REAL ) f |= AGGSCAN_REAL;
+      if( pTab->aCol[iCol].pDflt ) f |= AGGSCAN_DFLT;
+    }
+    ai[k++] = iCol;
+    ai[k++] = f;
+  }
+  for(i=0; i<nTerm; i++){
+    ai[k++] = aggScanColumn(aiCol, &nCol, aTermCol[i]);
+    ai[k++] = aTermOp[i];
+    if( apTermVal[i] ){
+      ai[k] = ++pParse->nMem;
+      sqlite3ExprCode(pParse, apTermVal[i], ai[k++]);
+      ai[k++] = aTermAff[i];
+    }else{
+      ai[k++] = 0;
+      ai[k++] = 0;
+    }
+  }
+  for(i=0; i<pAggInfo->nFunc; i++){
+    ai[k++] = aAggFunc[i];
+    ai[k++] = aAggCol[i]<-1 ? -1 : aggScanColumn(aiCol, &nCol, aAggCol[i]);
+    ai[k++] = pAggInfo->aFunc[i].iMem;
+  }
+
+  iCsr = pParse->nTab++;
+  lbl = sqlite3VdbeMakeLabel(v);
+  sqlite3OpenTable(pParse, iCsr, sqlite3SchemaToIndex(db, pTab->pSchema),
+                   pTab, OP_OpenRead);
+  sqlite3VdbeAddOp4(v, OP_AggScan, iCsr, lbl, 0, (char*)ai, P4_INTARRAY);
+  VdbeCoverage(v);
+  sqlite3VdbeAddOp1(v, OP_Close, iCsr);
+  return lbl;
+}
+#endif /* SQLITE_OMIT_AGGSCAN */
+
 /*
 ** If the source-list item passed as an argument was augmented with an
 ** INDEXED BY clause, then try to locate the specified index. If there
@@ -5551,6 +5777,7 @@ int sqlite3Select(
         */
         ExprList *pMinMax = 0;
         u8 flag = WHERE_ORDERBY_NORMAL;
+        int lblAggScan = 0;
         
         assert( p->pGroupBy==0 );
         assert( flag==0 );
@@ -5571,8 +5798,14 @@ int sqlite3Select(
   
         /* This case runs if the aggregate has no GROUP BY clause.  The
         ** processing is much simpler since there is only a single row
-        ** of output.
+        ** of output.  If the query is simple enough, an OP_AggScan
+        ** computes the aggregates first and skips the loop below.
         */
+#ifndef SQLITE_OMIT_AGGSCAN
+        if( OptimizationEnabled(db, SQLITE_AggScan) ){
+          lblAggScan = codeAggScan(pParse, p, &sAggInfo);
+        }
+#endif
         resetAccumulator(pParse, &sAggInfo);
         pWInfo = sqlite3WhereBegin(pParse, pTabList, pWhere, pMinMax,0,flag,0);
         if( pWInfo==0 ){
@@ -5588,6 +5821,10 @@ int sqlite3Select(
         }
         sqlite3WhereEnd(pWInfo);
         finalizeAggFunctions(pParse, &sAggInfo);
+        if( lblAggScan ){
+          sqlite3VdbeResolveLabel(v, lblAggScan);
+          sqlite3ExprCacheClear(pParse);
+        }
       }
 
       sSort.pOrderBy = 0;
@@ -503,12 +503,17 @@
 ** The "file format" number is an integer that is incremented whenever
 ** the VDBE-level file format changes.  The following macros define the
 ** the default file format for new databases and the maximum file format
-** that the library can read.
+** that the library writes unless asked to.
+**
+** SQLITE_PREFIX_FILE_FORMAT is the format of a database in which index
+** leaf pages may be prefix-compressed.  It is only written by "PRAGMA
+** prefix_compression=ON", and it is the maximum format the library reads.
 */
 #define SQLITE_MAX_FILE_FORMAT 4
 #ifndef SQLITE_DEFAULT_FILE_FORMAT
 # define SQLITE_DEFAULT_FILE_FORMAT 4
 #endif
+#define SQLITE_PREFIX_FILE_FORMAT 5
 
 /*
 ** Determine whether triggers are recursive by default.  This can be
@@ -557,6 +562,15 @@
 # define SQLITE_DEFAULT_PCACHE_INITSZ 100
 #endif
 
+/*
+** The default page replacement policy of the built-in page cache.  One of
+** the SQLITE_PCACHE_POLICY_* values.  May be changed at start-time using
+** sqlite3_config(SQLITE_CONFIG_PCACHE_POLICY, ePolicy).
+*/
+#ifndef SQLITE_DEFAULT_PCACHE_POLICY
+# define SQLITE_DEFAULT_PCACHE_POLICY SQLITE_PCACHE_POLICY_LRU
+#endif
+
 /*
 ** GCC does not define the offsetof() macro so we'll have to do it
 ** ourselves.
@@ -942,6 +956,7 @@ typedef struct AggInfo AggInfo;
 typedef struct AuthContext AuthContext;
 typedef struct AutoincInfo AutoincInfo;
 typedef struct Bitvec Bitvec;
+typedef struct CkptThread CkptThread;
 typedef struct CollSeq CollSeq;
 typedef struct Column Column;
 typedef struct Db Db;
@@ -1181,6 +1196,7 @@ struct sqlite3 {
   u8 bBenignMalloc;             /* Do not require OOMs if true */
   u8 dfltLockMode;              /* Default locking-mode for attached dbs */
   signed char nextAutovac;      /* Autovac setting after VACUUM if >=0 */
+  signed char nextPrefix;       /* Prefix compression after VACUUM if >=0 */
   u8 suppressErr;               /* Do not issue error messages if true */
   u8 vtabOnConflict;            /* Value to return for s3_vtab_on_conflict() */
   u8 isTransactionSavepoint;    /* True if the outermost savepoint is a TS */
@@ -1217,6 +1233,7 @@ struct sqlite3 {
 #ifndef SQLITE_OMIT_WAL
   int (*xWalCallback)(void *, sqlite3 *, const char *, int);
   void *pWalArg;
+  CkptThread *pCkptThread;      /* Background checkpointer, or NULL */
 #endif
   void(*xCollNeeded)(void*,sqlite3*,int eTextRep,const char*);
   void(*xCollNeeded16)(void*,sqlite3*,int eTextRep,const void*);
@@ -1337,6 +1354,7 @@ struct sqlite3 {
 #define SQLITE_OmitNoopJoin   0x0400   /* Omit unused tables in joins */
 #define SQLITE_Stat34         0x0800   /* Use STAT3 or STAT4 data */
 #define SQLITE_CursorHints    0x2000   /* Add OP_CursorHint opcodes */
+#define SQLITE_AggScan        0x4000   /* Batch aggregate scans (OP_AggScan) */
 #define SQLITE_AllOpts        0xffff   /* All optimizations */
 
 /*
@@ -3037,6 +3055,7 @@ struct Sqlite3Config {
   int mxParserStack;                /* maximum depth of the parser stack */
   int sharedCacheEnabled;           /* true if shared-cache mode enabled */
   u32 szPma;                        /* Maximum Sorter PMA size */
+  int ePcachePolicy;                /* SQLITE_PCACHE_POLICY_* for pcache1 */
   /* The above might be initialized to non-zero.  The following need to always
   ** initially be zero, however. */
   int isInit;                       /* True after initialization has finished */
@@ -3575,6 +3594,9 @@ void sqlite3SelectSetName(Select*,const char*);
 void sqlite3FuncDefInsert(FuncDefHash*, FuncDef*);
 FuncDef *sqlite3FindFunction(sqlite3*,const char*,int,int,u8,u8);
 void sqlite3RegisterBuiltinFunctions(sqlite3*);
+#ifndef SQLITE_OMIT_AGGSCAN
+int sqlite3AggScanFunc(FuncDef*);
+#endif
 void sqlite3RegisterDateTimeFunctions(void);
 void sqlite3RegisterGlobalFunctions(void);
 int sqlite3SafetyCheckOk(sqlite3*);
@@ -3890,6 +3912,15 @@ const char *sqlite3JournalModename(int);
   int sqlite3Checkpoint(sqlite3*, int, int, int*, int*);
   int sqlite3WalDefaultHook(void*,sqlite3*,const char*,int);
 #endif
+#if !defined(SQLITE_OMIT_WAL) && SQLITE_MAX_WORKER_THREADS>0
+  void sqlite3CkptThreadFree(sqlite3*);
+  int sqlite3CkptThreadCap(sqlite3*);
+  void sqlite3CkptThreadStat(sqlite3*, int, int, int*, int*);
+#else
+# define sqlite3CkptThreadFree(x)
+# define sqlite3CkptThreadCap(x) 0
+# define sqlite3CkptThreadStat(v,w,x,y,z)
+#endif
 #ifndef SQLITE_OMIT_CTE
   With *sqlite3WithAdd(Parse*,With*,Token*,ExprList*,Select*);
   void sqlite3WithDelete(sqlite3*,With*);
@@ -308,7 +308,9 @@ int sqlite3_db_status(
     */
     case SQLITE_DBSTATUS_CACHE_HIT:
     case SQLITE_DBSTATUS_CACHE_MISS:
-    case SQLITE_DBSTATUS_CACHE_WRITE:{
+    case SQLITE_DBSTATUS_CACHE_WRITE:
+    case SQLITE_DBSTATUS_READAHEAD_HIT:
+    case SQLITE_DBSTATUS_READAHEAD_MISS:{
       int i;
       int nRet = 0;
       assert( SQLITE_DBSTATUS_CACHE_MISS==SQLITE_DBSTATUS_CACHE_HIT+1 );
@@ -327,6 +329,99 @@ int sqlite3_db_status(
       break;
     }
 
+    /*
+    ** Set *pCurrent to the memory-mapping statistic summed over the
+    ** database files of all pagers, and *pHighwater to the largest
+    ** single mapping for SQLITE_DBSTATUS_MMAP_USED.
+    */
+    case SQLITE_DBSTATUS_MMAP_USED:
+    case SQLITE_DBSTATUS_MMAP_REMAP:
+    case SQLITE_DBSTATUS_MMAP_MISS: {
+      int i;
+      int nCur = 0;
+      int nMax = 0;
+      for(i=0; i<db->nDb; i++){
+        if( db->aDb[i].pBt ){
+          Pager *pPager = sqlite3BtreePager(db->aDb[i].pBt);
+          sqlite3PagerMmapStat(pPager, op, resetFlag, &nCur, &nMax);
+        }
+      }
+      *pCurrent = nCur;
+      *pHighwater = nMax;
+      break;
+    }
+
+    /*
+    ** Set *pCurrent to the number of page defragmentations, the bytes
+    ** of cell content they moved, or the number of b-tree seeks that did
+    ** or did not descend from the root page, summed over all attached
+    ** databases.  The sum is taken in 64 bits and only then clamped to
+    ** fit *pCurrent.  *pHighwater is always set to zero.
+    */
+    case SQLITE_DBSTATUS_DEFRAG:
+    case SQLITE_DBSTATUS_DEFRAG_BYTES:
+    case SQLITE_DBSTATUS_SEEK_ROOT:
+    case SQLITE_DBSTATUS_SEEK_NEARBY: {
+      int i;
+      i64 nRet = 0;
+      for(i=0; i<db->nDb; i++){
+        if( db->aDb[i].pBt ){
+          sqlite3BtreeDbStatus(db->aDb[i].pBt, op, resetFlag, &nRet);
+        }
+      }
+      *pHighwater = 0;
+      *pCurrent = (int)MIN(nRet, 0x7fffffff);
+      break;
+    }
+
+    /*
+    ** Set *pCurrent to the total number of syncs issued by all pagers, and
+    ** *pHighwater to the most syncs issued by a single commit.
+    */
+    case SQLITE_DBSTATUS_SYNC: {
+      int i;
+      int nCur = 0;
+      int nMax = 0;
+      for(i=0; i<db->nDb; i++){
+        if( db->aDb[i].pBt ){
+          Pager *pPager = sqlite3BtreePager(db->aDb[i].pBt);
+          sqlite3PagerSyncStat(pPager, resetFlag, &nCur, &nMax);
+        }
+      }
+      *pCurrent = nCur;
+      *pHighwater = nMax;
+      break;
+    }
+
+    /*
+    ** Set *pCurrent to the checkpoint statistic summed over all pagers
+    ** the database handle is connected to and its background checkpointer,
+    ** and *pHighwater to its largest value for a single checkpoint. Or,
+    ** for SQLITE_DBSTATUS_WAL_SIZE, to the total size of the WAL files
+    ** and the largest size seen. The WAL read-mark contention counters
+    ** are summed over all pagers in the same way.
+    */
+    case SQLITE_DBSTATUS_CKPT_FRAMES:
+    case SQLITE_DBSTATUS_CKPT_WRITES:
+    case SQLITE_DBSTATUS_CKPT_TIME:
+    case SQLITE_DBSTATUS_WAL_SIZE:
+    case SQLITE_DBSTATUS_WAL_READ_RETRY:
+    case SQLITE_DBSTATUS_WAL_READMARK_BUSY: {
+      int i;
+      int nCur = 0;
+      int nMax = 0;
+      for(i=0; i<db->nDb; i++){
+        if( db->aDb[i].pBt ){
+          Pager *pPager = sqlite3BtreePager(db->aDb[i].pBt);
+          sqlite3PagerCkptStat(pPager, op, resetFlag, &nCur, &nMax);
+        }
+      }
+      sqlite3CkptThreadStat(db, op, resetFlag, &nCur, &nMax);
+      *pCurrent = nCur;
+      *pHighwater = nMax;
+      break;
+    }
+
     /* Set *pCurrent to non-zero if there are unresolved deferred foreign
     ** key constraints.  Set *pCurrent to zero if all foreign key constraints
     ** have been satisfied.  The *pHighwater is always set to zero.
@@ -578,7 +578,10 @@ static const sqlite3_io_methods CrashFileVtab = {
   cfShmMap,                     /* xShmMap */
   cfShmLock,                    /* xShmLock */
   cfShmBarrier,                 /* xShmBarrier */
-  cfShmUnmap                    /* xShmUnmap */
+  cfShmUnmap,                   /* xShmUnmap */
+  0,                            /* xFetch */
+  0,                            /* xUnfetch */
+  0                             /* xWriteV */
 };
 
 /*
@@ -407,7 +407,14 @@ static int demoOpen(
     demoCheckReservedLock,        /* xCheckReservedLock */
     demoFileControl,              /* xFileControl */
     demoSectorSize,               /* xSectorSize */
-    demoDeviceCharacteristics     /* xDeviceCharacteristics */
+    demoDeviceCharacteristics,    /* xDeviceCharacteristics */
+    0,                            /* xShmMap */
+    0,                            /* xShmLock */
+    0,                            /* xShmBarrier */
+    0,                            /* xShmUnmap */
+    0,                            /* xFetch */
+    0,                            /* xUnfetch */
+    0                             /* xWriteV */
   };
 
   DemoFile *p = (DemoFile*)pFile; /* Populate this structure */
@@ -118,7 +118,10 @@ static sqlite3_io_methods devsym_io_methods = {
   devsymShmMap,                     /* xShmMap */
   devsymShmLock,                    /* xShmLock */
   devsymShmBarrier,                 /* xShmBarrier */
-  devsymShmUnmap                    /* xShmUnmap */
+  devsymShmUnmap,                   /* xShmUnmap */
+  0,                                /* xFetch */
+  0,                                /* xUnfetch */
+  0                                 /* xWriteV */
 };
 
 struct DevsymGlobal {
@@ -196,7 +196,14 @@ static sqlite3_io_methods jt_io_methods = {
   jtCheckReservedLock,           /* xCheckReservedLock */
   jtFileControl,                 /* xFileControl */
   jtSectorSize,                  /* xSectorSize */
-  jtDeviceCharacteristics        /* xDeviceCharacteristics */
+  jtDeviceCharacteristics,       /* xDeviceCharacteristics */
+  0,                             /* xShmMap */
+  0,                             /* xShmLock */
+  0,                             /* xShmBarrier */
+  0,                             /* xShmUnmap */
+  0,                             /* xFetch */
+  0,                             /* xUnfetch */
+  0                              /* xWriteV */
 };
 
 struct JtGlobal {
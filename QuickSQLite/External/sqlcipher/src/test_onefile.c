@@ -222,7 +222,10 @@ static sqlite3_io_methods fs_io_methods = {
   0,                            /* xShmMap */
   0,                            /* xShmLock */
   0,                            /* xShmBarrier */
-  0                             /* xShmUnmap */
+  0,                            /* xShmUnmap */
+  0,                            /* xFetch */
+  0,                            /* xUnfetch */
+  0                             /* xWriteV */
 };
 
 
@@ -243,7 +246,10 @@ static sqlite3_io_methods tmp_io_methods = {
   0,                            /* xShmMap */
   0,                            /* xShmLock */
   0,                            /* xShmBarrier */
-  0                             /* xShmUnmap */
+  0,                            /* xShmUnmap */
+  0,                            /* xFetch */
+  0,                            /* xUnfetch */
+  0                             /* xWriteV */
 };
 
 /* Useful macros used in several places */
@@ -216,7 +216,10 @@ static sqlite3_io_methods vfslog_io_methods = {
   vfslogShmMap,                   /* xShmMap */
   vfslogShmLock,                  /* xShmLock */
   vfslogShmBarrier,               /* xShmBarrier */
-  vfslogShmUnmap                  /* xShmUnmap */
+  vfslogShmUnmap,                 /* xShmUnmap */
+  0,                              /* xFetch */
+  0,                              /* xUnfetch */
+  0                               /* xWriteV */
 };
 
 #if SQLITE_OS_UNIX && !defined(NO_GETTOD)
@@ -215,7 +215,8 @@ static sqlite3_io_methods tvfs_io_methods = {
   tvfsShmBarrier,                 /* xShmBarrier */
   tvfsShmUnmap,                   /* xShmUnmap */
   tvfsFetch,
-  tvfsUnfetch
+  tvfsUnfetch,
+  0                               /* xWriteV */
 };
 
 static int tvfsResultCode(Testvfs *p, int *pRc){
@@ -228,6 +228,29 @@ int sqlite3RunVacuum(char **pzErrMsg, sqlite3 *db){
                                            sqlite3BtreeGetAutoVacuum(pMain));
 #endif
 
+  /* A database that may hold prefix-compressed index pages keeps its file
+  ** format, so that the indexes are rebuilt compressed. The vacuum_db
+  ** schema was loaded while the file was still empty. Its format number
+  ** is raised to match as well, because the CREATE statements below see
+  ** a nonzero format in the header and so do not set it. Otherwise
+  ** CREATE INDEX would ignore DESC on the copied indexes.
+  **
+  ** After "PRAGMA prefix_compression=OFF" the format is not carried over.
+  ** The first CREATE below then gives vacuum_db the default format, and
+  ** every index is rebuilt uncompressed. */
+  {
+    u32 iFormat;
+    sqlite3BtreeGetMeta(pMain, BTREE_FILE_FORMAT, &iFormat);
+    if( iFormat>=SQLITE_PREFIX_FILE_FORMAT && db->nextPrefix!=0 ){
+      rc = sqlite3BtreeBeginTrans(pTemp, 2);
+      if( rc==SQLITE_OK ){
+        rc = sqlite3BtreeUpdateMeta(pTemp, BTREE_FILE_FORMAT, iFormat);
+      }
+      if( rc!=SQLITE_OK ) goto end_of_vacuum;
+      db->aDb[db->nDb-1].pSchema->file_format = (u8)iFormat;
+    }
+  }
+
   /* Query the schema of the main database. Create a mirror schema
   ** in the temporary database.
   */
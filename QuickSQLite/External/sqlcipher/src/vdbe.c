@@ -107,6 +107,58 @@ int sqlite3_found_count = 0;
 # define UPDATE_MAX_BLOBSIZE(P)
 #endif
 
+/*
+** Compilers that can take the address of a label (GCC and Clang) let the
+** main loop of sqlite3VdbeExec() dispatch each opcode with a computed goto
+** through the OPLABEL_INITIALIZER table of opcodes.h instead of through
+** the switch statement, which saves the range check on the opcode.  Every
+** "case OP_xxx:" line is preceded by a VDBE_LABEL(OP_xxx) line that creates
+** the L_OP_xxx label used by that table.
+**
+** Compile with SQLITE_OMIT_COMPUTED_GOTO to always use the switch.
+*/
+#if (defined(__GNUC__) || defined(__clang__)) \
+ && !defined(SQLITE_OMIT_COMPUTED_GOTO)
+# define VDBE_COMPUTED_GOTO 1
+# define VDBE_LABEL(X) L_##X:
+#else
+# define VDBE_LABEL(X)
+#endif
+
+/*
+** Count the execution of the instruction at pOp.  The main loop of
+** sqlite3VdbeExec() does this for every instruction it dispatches.  Code
+** that moves on to the next instruction without going back through the
+** main loop must do it too.
+*/
+#ifdef SQLITE_ENABLE_STMT_SCANSTATUS
+# define VDBE_COUNT_STEP \
+   nVmStep++; if( p->anExec ) p->anExec[(int)(pOp-aOp)]++
+#else
+# define VDBE_COUNT_STEP nVmStep++
+#endif
+
+/*
+** The most frequently executed opcodes end with VDBE_NEXT_OPCODE instead
+** of "break".  In a release build with computed goto, where the code at
+** the bottom and top of the main loop reduces to the rc test and the step
+** counter, it does that work itself and jumps straight to the label of
+** the next opcode, so that the CPU can predict the next opcode from the
+** one that is finishing rather than from a single shared branch.
+*/
+#if defined(VDBE_COMPUTED_GOTO) && !defined(SQLITE_DEBUG) \
+ && !defined(VDBE_PROFILE) && !defined(SQLITE_TEST)
+# define VDBE_NEXT_OPCODE                   \
+   if( rc==SQLITE_OK ){                    \
+     pOp++;                                \
+     VDBE_COUNT_STEP;                      \
+     goto *aOpLabel[pOp->opcode];          \
+   }                                       \
+   break
+#else
+# define VDBE_NEXT_OPCODE break
+#endif
+
 /*
 ** Invoke the VDBE coverage callback, if that callback is defined.  This
 ** feature is used for test suite validation only and does not appear an
@@ -540,6 +592,505 @@ static Mem *out2Prerelease(Vdbe *p, VdbeOp *pOp){
   }
 }
 
+/*
+** Compiler intrinsics used by vdbeOneByteTypes16() to test several
+** record header bytes at once.
+*/
+#if !defined(SQLITE_DISABLE_INTRINSIC)
+# if defined(__SSE2__)
+#  include <emmintrin.h>
+# elif defined(__aarch64__) && defined(__ARM_NEON)
+#  include <arm_neon.h>
+# endif
+#endif
+
+/*
+** Return true if none of the 16 bytes at z[] has its high bit set, which
+** means they are 16 complete serial types of a record header, each one
+** byte long.  The caller guarantees that all 16 bytes are readable.
+*/
+static int vdbeOneByteTypes16(const u8 *z){
+#if !defined(SQLITE_DISABLE_INTRINSIC) && defined(__SSE2__)
+  return _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)z))==0;
+#elif !defined(SQLITE_DISABLE_INTRINSIC) \
+    && defined(__aarch64__) && defined(__ARM_NEON)
+  return vmaxvq_u8(vld1q_u8(z))<0x80;
+#else
+  u64 a, b;
+  memcpy(&a, z, 8);
+  memcpy(&b, z+8, 8);
+  return ((a|b) & ((((u64)0x80808080)<<32)|0x80808080))==0;
+#endif
+}
+
+#ifndef SQLITE_OMIT_AGGSCAN
+/*
+** The number of rows that OP_AggScan decodes into its column vectors
+** before it runs the filter and aggregate kernels over them.
+*/
+#define AGGSCAN_NROW 256
+
+/*
+** A numeric value handled by OP_AggScan.  Whether it is an integer or a
+** real is recorded alongside it as MEM_Int or MEM_Real, or MEM_Null if
+** it is a NULL and the value is undefined.  A text or blob value of a
+** vector whose column is only tested for NULL is recorded as MEM_Str,
+** without a value.
+*/
+typedef union AggScanVal AggScanVal;
+union AggScanVal {
+  i64 i;                 /* Integer value */
+  double r;              /* Real value */
+};
+
+/*
+** A column vector of OP_AggScan.  It holds one record field (or the
+** rowid) of each row of the current batch.  mFlags is the OR of all
+** aFlag[] entries of the batch, which lets the kernels use a tighter
+** loop when a vector holds nothing but integers.
+*/
+typedef struct AggScanVec AggScanVec;
+struct AggScanVec {
+  int iField;            /* Record field decoded, or -1 for the rowid */
+  u8 bReal;              /* Convert integers to reals (REAL affinity) */
+  u8 bDflt;              /* The column has a DEFAULT value */
+  u8 bNull;              /* Only NULL-ness is used, so any type will do */
+  u8 mFlags;             /* OR of aFlag[0..nRow-1] */
+  u8 *aFlag;             /* MEM_Int, MEM_Real or MEM_Null for each row */
+  AggScanVal *aVal;      /* The value of each row */
+};
+
+/*
+** A filter term "<column> <op> <constant>" of OP_AggScan.  Bit c+1 of
+** mCmp is set if a row whose column compares to the constant as c
+** (-1, 0 or +1) passes the comparison.
+*/
+typedef struct AggScanTerm AggScanTerm;
+struct AggScanTerm {
+  int iVec;              /* Column vector tested */
+  int op;                /* OP_Eq, OP_Lt, ..., OP_IsNull or OP_NotNull */
+  u8 mCmp;               /* Comparison results that pass */
+  u8 f;                  /* MEM_Int, MEM_Real or MEM_Null for v */
+  AggScanVal v;          /* The constant */
+};
+
+/*
+** The running state of one aggregate of OP_AggScan.  The fields used by
+** sum(), total() and avg() are those of SumCtx in func.c and they are
+** updated in the same order, so that results are identical to those
+** of the row-at-a-time aggregate functions.
+*/
+typedef struct AggScanAcc AggScanAcc;
+struct AggScanAcc {
+  int eFunc;             /* One of the AGGSCAN_* function codes */
+  int iVec;              /* Argument vector, or -1 for count(*) */
+  int iReg;              /* Register that receives the result */
+  double rSum;           /* Floating point sum */
+  i64 iSum;              /* Integer sum */
+  i64 cnt;               /* Number of non-NULL arguments seen */
+  u8 overflow;           /* True if integer overflow seen */
+  u8 approx;             /* True if a non-integer value was summed */
+  u8 fBest;              /* Type of min()/max() so far, or 0 if none yet */
+  AggScanVal best;       /* The min() or max() so far */
+};
+
+/*
+** Compare two non-NULL numeric values the way sqlite3MemCompare() does.
+** Return -1, 0 or +1.
+*/
+static int aggScanCompare(
+  u8 f1, const AggScanVal *p1,
+  u8 f2, const AggScanVal *p2
+){
+  if( f1 & f2 & MEM_Int ){
+    return p1->i<p2->i ? -1 : p1->i>p2->i;
+  }
+  if( f1 & f2 & MEM_Real ){
+    return p1->r<p2->r ? -1 : p1->r>p2->r;
+  }
+  if( f1 & MEM_Int ){
+    return sqlite3IntFloatCompare(p1->i, p2->r);
+  }
+  return -sqlite3IntFloatCompare(p2->i, p1->r);
+}
+
+/*
+** Decode into row j of the column vectors aVec[0..nVec-1], which are
+** sorted by field with the rowid first, the fields they ask for of the
+** record of pCell.  pCrsr points at pCell if its record spills onto
+** overflow pages.
+**
+** Return non-zero if OP_AggScan cannot handle the record: it holds a
+** text or blob value in a field that is not only tested for NULL, it
+** lacks a field whose column has a DEFAULT value, or it is malformed.
+*/
+static int aggScanDecode(
+  BtCursor *pCrsr,
+  const BtreeCell *pCell,
+  AggScanVec *aVec,
+  int nVec,
+  int j
+){
+  const u8 *aData = pCell->pData;
+  u32 nHdr;                    /* Size of the record header */
+  u32 iHdr;                    /* Offset of the next serial type */
+  u32 iOff;                    /* Offset of the content of field iField */
+  u32 t;                       /* Serial type of field iField */
+  u32 len;                     /* Size of the content of field iField */
+  int iField;                  /* Current field */
+  int k = 0;                   /* Next vector to fill */
+  u8 aBuf[8];                  /* Field copied from an overflow page */
+  Mem m;                       /* Decoded field */
+
+  if( aVec[0].iField<0 ){
+    aVec[0].aFlag[j] = MEM_Int;
+    aVec[0].aVal[j].i = pCell->nKey;
+    aVec[0].mFlags |= MEM_Int;
+    if( ++k==nVec ) return 0;
+  }
+  if( pCell->nLocal==0 ) return 1;
+  iHdr = getVarint32(aData, nHdr);
+  if( nHdr>pCell->nLocal || nHdr<iHdr ) return 1;
+  iOff = nHdr;
+  for(iField=0; k<nVec; iField++){
+    AggScanVec *pVec = &aVec[k];
+    if( iHdr>=nHdr ){
+      /* The record has fewer fields than the table has columns */
+      for(; k<nVec; k++){
+        if( aVec[k].bDflt ) return 1;
+        aVec[k].aFlag[j] = MEM_Null;
+        aVec[k].mFlags |= MEM_Null;
+      }
+      break;
+    }
+    iHdr += getVarint32(&aData[iHdr], t);
+    len = sqlite3VdbeSerialTypeLen(t);
+    if( iField==pVec->iField ){
+      if( t>=12 ){
+        if( !pVec->bNull ) return 1;
+        pVec->aFlag[j] = MEM_Str;
+        pVec->mFlags |= MEM_Str;
+        k++;
+      }else if( iOff+len<=pCell->nLocal ){
+        sqlite3VdbeSerialGet(&aData[iOff], t, &m);
+      }else{
+        if( iOff+len>pCell->nData ) return 1;
+        if( sqlite3BtreeData(pCrsr, iOff, len, aBuf) ) return 1;
+        sqlite3VdbeSerialGet(aBuf, t, &m);
+      }
+      if( t<12 ){
+        if( m.flags & MEM_Int ){
+          if( pVec->bReal ){
+            pVec->aVal[j].r = (double)m.u.i;
+            m.flags = MEM_Real;
+          }else{
+            pVec->aVal[j].i = m.u.i;
+          }
+        }else if( m.flags & MEM_Real ){
+          pVec->aVal[j].r = m.u.r;
+        }
+        pVec->aFlag[j] = (u8)m.flags;
+        pVec->mFlags |= (u8)m.flags;
+        k++;
+      }
+    }
+    iOff += len;
+  }
+  return 0;
+}
+
+/*
+** Remove from aSel[0..nSel-1] the rows of vector pVec that do not pass
+** filter term pTerm and return the number of rows that remain.
+*/
+static int aggScanFilter(
+  const AggScanTerm *pTerm,
+  const AggScanVec *pVec,
+  u16 *aSel,
+  int nSel
+){
+  const u8 *aFlag = pVec->aFlag;
+  const AggScanVal *aVal = pVec->aVal;
+  const u8 mCmp = pTerm->mCmp;
+  int i, n = 0;
+
+  if( pTerm->op==OP_IsNull || pTerm->op==OP_NotNull ){
+    u8 fWant = pTerm->op==OP_IsNull ? MEM_Null : 0;
+    for(i=0; i<nSel; i++){
+      int j = aSel[i];
+      aSel[n] = (u16)j;
+      n += (aFlag[j] & MEM_Null)==fWant;
+    }
+  }else if( pTerm->f==MEM_Null ){
+    /* A comparison with NULL is never true */
+  }else if( pVec->mFlags==MEM_Int && pTerm->f==MEM_Int ){
+    const i64 iVal = pTerm->v.i;
+    for(i=0; i<nSel; i++){
+      int j = aSel[i];
+      aSel[n] = (u16)j;
+      n += (mCmp >> ((aVal[j].i>iVal) - (aVal[j].i<iVal) + 1)) & 1;
+    }
+  }else if( pVec->mFlags==MEM_Real && pTerm->f==MEM_Real ){
+    const double rVal = pTerm->v.r;
+    for(i=0; i<nSel; i++){
+      int j = aSel[i];
+      aSel[n] = (u16)j;
+      n += (mCmp >> ((aVal[j].r>rVal) - (aVal[j].r<rVal) + 1)) & 1;
+    }
+  }else{
+    for(i=0; i<nSel; i++){
+      int j = aSel[i];
+      int c;
+      if( aFlag[j] & MEM_Null ) continue;
+      aSel[n] = (u16)j;
+      c = aggScanCompare(aFlag[j], &aVal[j], pTerm->f, &pTerm->v);
+      n += (mCmp >> (c+1)) & 1;
+    }
+  }
+  return n;
+}
+
+/*
+** Feed the rows aSel[0..nSel-1] of argument vector pVec (or of no vector,
+** for count(*)) to aggregate pAcc.
+*/
+static void aggScanStep(
+  AggScanAcc *pAcc,
+  const AggScanVec *pVec,
+  const u16 *aSel,
+  int nSel
+){
+  const u8 *aFlag;
+  const AggScanVal *aVal;
+  int i;
+
+  if( pVec==0 || (pAcc->eFunc==AGGSCAN_COUNT && (pVec->mFlags&MEM_Null)==0) ){
+    pAcc->cnt += nSel;
+    return;
+  }
+  aFlag = pVec->aFlag;
+  aVal = pVec->aVal;
+  switch( pAcc->eFunc ){
+    case AGGSCAN_COUNT: {
+      for(i=0; i<nSel; i++){
+        pAcc->cnt += (aFlag[aSel[i]] & MEM_Null)==0;
+      }
+      break;
+    }
+    case AGGSCAN_MIN:
+    case AGGSCAN_MAX: {
+      const int bMax = pAcc->eFunc==AGGSCAN_MAX;
+      for(i=0; i<nSel; i++){
+        int j = aSel[i];
+        int c;
+        if( aFlag[j] & MEM_Null ) continue;
+        if( pAcc->fBest ){
+          c = aggScanCompare(pAcc->fBest, &pAcc->best, aFlag[j], &aVal[j]);
+          if( bMax ? c>=0 : c<=0 ) continue;
+        }
+        pAcc->fBest = aFlag[j];
+        pAcc->best = aVal[j];
+      }
+      break;
+    }
+    default: {
+      /* sum(), total() and avg(), exactly as sumStep() in func.c */
+      assert( pAcc->eFunc==AGGSCAN_SUM || pAcc->eFunc==AGGSCAN_TOTAL
+           || pAcc->eFunc==AGGSCAN_AVG );
+      for(i=0; i<nSel; i++){
+        int j = aSel[i];
+        if( aFlag[j] & MEM_Null ) continue;
+        pAcc->cnt++;
+        if( aFlag[j] & MEM_Int ){
+          i64 v = aVal[j].i;
+          pAcc->rSum += v;
+          if( (pAcc->approx|pAcc->overflow)==0
+           && sqlite3AddInt64(&pAcc->iSum, v)
+          ){
+            pAcc->overflow = 1;
+          }
+        }else{
+          pAcc->rSum += aVal[j].r;
+          pAcc->approx = 1;
+        }
+      }
+      break;
+    }
+  }
+}
+
+/*
+** Run the batch aggregate scan described by the P4 array ai[] of an
+** OP_AggScan over the table b-tree of cursor pCrsr.  If it runs to the
+** end, store the result of each aggregate in its register and set
+** *pbDone.  If the scan meets a row it cannot handle, or a sum() that
+** would overflow, leave *pbDone clear so that the row-at-a-time loop
+** computes the aggregates (or raises the error) instead.
+*/
+static int vdbeAggScan(Vdbe *p, BtCursor *pCrsr, const int *ai, int *pbDone){
+  sqlite3 *db = p->db;
+  const int nVec = ai[0];
+  const int nTerm = ai[1];
+  const int nAgg = ai[2];
+  const int *aiVec = &ai[3];
+  const int *aiTerm = &aiVec[nVec*2];
+  const int *aiAgg = &aiTerm[nTerm*4];
+  AggScanVec *aVec;            /* Column vectors */
+  AggScanTerm *aTerm;          /* Filter terms */
+  AggScanAcc *aAcc;            /* Aggregates */
+  BtreeCell *aCell;            /* Cells of the current batch */
+  u16 *aSel;                   /* Rows of the batch that pass the filter */
+  u8 *pSpace;                  /* Allocation holding all of the above */
+  AggScanVal *aVal;            /* Values of all vectors */
+  u8 *aFlag;                   /* Types of all vectors */
+  int bOk = 1;                 /* False once the row loop must run */
+  int res = 0;
+  int rc;
+  int i, j;
+
+  *pbDone = 0;
+  pSpace = sqlite3DbMallocZero(db,
+      nVec*(sizeof(AggScanVec) + AGGSCAN_NROW*(sizeof(AggScanVal)+1))
+    + nTerm*sizeof(AggScanTerm) + nAgg*sizeof(AggScanAcc)
+    + AGGSCAN_NROW*(sizeof(BtreeCell)+sizeof(u16)));
+  if( pSpace==0 ) return SQLITE_NOMEM;
+  aVal = (AggScanVal*)pSpace;
+  aCell = (BtreeCell*)&aVal[nVec*AGGSCAN_NROW];
+  aVec = (AggScanVec*)&aCell[AGGSCAN_NROW];
+  aTerm = (AggScanTerm*)&aVec[nVec];
+  aAcc = (AggScanAcc*)&aTerm[nTerm];
+  aSel = (u16*)&aAcc[nAgg];
+  aFlag = (u8*)&aSel[AGGSCAN_NROW];
+
+  for(i=0; i<nVec; i++){
+    aVec[i].iField = aiVec[i*2];
+    aVec[i].bReal = (aiVec[i*2+1] & AGGSCAN_REAL)!=0;
+    aVec[i].bDflt = (aiVec[i*2+1] & AGGSCAN_DFLT)!=0;
+    aVec[i].bNull = (aiVec[i*2+1] & AGGSCAN_NULL)!=0;
+    aVec[i].aFlag = &aFlag[i*AGGSCAN_NROW];
+    aVec[i].aVal = &aVal[i*AGGSCAN_NROW];
+  }
+  for(i=0; i<nTerm; i++){
+    static const u8 aCmp[] = {
+       /* OP_Ne */ 0x5, /* OP_Eq */ 0x2, /* OP_Gt */ 0x4,
+       /* OP_Le */ 0x3, /* OP_Lt */ 0x1, /* OP_Ge */ 0x6 };
+    AggScanTerm *pTerm = &aTerm[i];
+    const int *a = &aiTerm[i*4];
+    pTerm->iVec = a[0];
+    pTerm->op = a[1];
+    if( pTerm->op!=OP_IsNull && pTerm->op!=OP_NotNull ){
+      Mem *pVal = &p->aMem[a[2]];
+      Mem m;
+      assert( OP_Ne+1==OP_Eq && OP_Eq+1==OP_Gt && OP_Gt+1==OP_Le
+           && OP_Le+1==OP_Lt && OP_Lt+1==OP_Ge );
+      assert( pTerm->op>=OP_Ne && pTerm->op<=OP_Ge );
+      pTerm->mCmp = aCmp[pTerm->op-OP_Ne];
+      if( (pVal->flags & (MEM_Int|MEM_Real|MEM_Str))==MEM_Str
+       && a[3]>=SQLITE_AFF_NUMERIC
+      ){
+        /* Numeric affinity, as OP_Lt and friends apply it */
+        sqlite3VdbeMemInit(&m, db, MEM_Null);
+        sqlite3VdbeMemShallowCopy(&m, pVal, MEM_Ephem);
+        applyNumericAffinity(&m, 0);
+        pVal = &m;
+      }
+      if( pVal->flags & MEM_Null ){
+        pTerm->f = MEM_Null;
+      }else if( pVal->flags & MEM_Int ){
+        pTerm->f = MEM_Int;
+        pTerm->v.i = pVal->u.i;
+      }else if( pVal->flags & MEM_Real ){
+        pTerm->f = MEM_Real;
+        pTerm->v.r = pVal->u.r;
+      }else{
+        bOk = 0;
+      }
+    }
+  }
+  for(i=0; i<nAgg; i++){
+    aAcc[i].eFunc = aiAgg[i*3];
+    aAcc[i].iVec = aiAgg[i*3+1];
+    aAcc[i].iReg = aiAgg[i*3+2];
+  }
+
+  rc = bOk ? sqlite3BtreeFirst(pCrsr, &res) : SQLITE_OK;
+  while( bOk && rc==SQLITE_OK && res==0 ){
+    int nRow;                  /* Rows in this batch */
+    int nSel;                  /* Rows that pass the filter */
+    if( db->u1.isInterrupted ){
+      rc = SQLITE_INTERRUPT;
+      break;
+    }
+    nRow = sqlite3BtreeLeafCells(pCrsr, aCell, AGGSCAN_NROW);
+    for(i=0; i<nVec; i++) aVec[i].mFlags = 0;
+    for(j=0; j<nRow; j++){
+      if( nVec>0 && aggScanDecode(pCrsr, &aCell[j], aVec, nVec, j) ) break;
+      aSel[j] = (u16)j;
+    }
+    if( j<nRow ){
+      bOk = 0;
+      break;
+    }
+    nSel = nRow;
+    for(i=0; i<nTerm && nSel>0; i++){
+      nSel = aggScanFilter(&aTerm[i], &aVec[aTerm[i].iVec], aSel, nSel);
+    }
+    for(i=0; i<nAgg; i++){
+      AggScanAcc *pAcc = &aAcc[i];
+      aggScanStep(pAcc, pAcc->iVec<0 ? 0 : &aVec[pAcc->iVec], aSel, nSel);
+    }
+    rc = sqlite3BtreeNext(pCrsr, &res);
+  }
+
+  for(i=0; i<nAgg && bOk; i++){
+    if( aAcc[i].eFunc==AGGSCAN_SUM && aAcc[i].overflow ) bOk = 0;
+  }
+  if( rc==SQLITE_OK && bOk ){
+    for(i=0; i<nAgg; i++){
+      AggScanAcc *pAcc = &aAcc[i];
+      Mem *pOut = &p->aMem[pAcc->iReg];
+      memAboutToChange(p, pOut);
+      switch( pAcc->eFunc ){
+        case AGGSCAN_COUNT: {
+          sqlite3VdbeMemSetInt64(pOut, pAcc->cnt);
+          break;
+        }
+        case AGGSCAN_MIN:
+        case AGGSCAN_MAX: {
+          if( pAcc->fBest==MEM_Int ){
+            sqlite3VdbeMemSetInt64(pOut, pAcc->best.i);
+          }else if( pAcc->fBest==MEM_Real ){
+            sqlite3VdbeMemSetDouble(pOut, pAcc->best.r);
+          }else{
+            sqlite3VdbeMemSetNull(pOut);
+          }
+          break;
+        }
+        case AGGSCAN_TOTAL: {
+          sqlite3VdbeMemSetDouble(pOut, pAcc->rSum);
+          break;
+        }
+        default: {
+          if( pAcc->cnt==0 ){
+            sqlite3VdbeMemSetNull(pOut);
+          }else if( pAcc->eFunc==AGGSCAN_AVG ){
+            sqlite3VdbeMemSetDouble(pOut, pAcc->rSum/(double)pAcc->cnt);
+          }else if( pAcc->approx ){
+            sqlite3VdbeMemSetDouble(pOut, pAcc->rSum);
+          }else{
+            sqlite3VdbeMemSetInt64(pOut, pAcc->iSum);
+          }
+          break;
+        }
+      }
+    }
+    *pbDone = 1;
+  }
+  sqlite3DbFree(db, pSpace);
+  return rc;
+}
+#endif /* SQLITE_OMIT_AGGSCAN */
+
 
 /*
 ** Execute as much of a VDBE program as we can.
@@ -574,6 +1125,9 @@ int sqlite3VdbeExec(
   i64 lastRowid = db->lastRowid;  /* Saved value of the last insert ROWID */
 #ifdef VDBE_PROFILE
   u64 start;                 /* CPU clock count at start of opcode */
+#endif
+#ifdef VDBE_COMPUTED_GOTO
+  static const void *const aOpLabel[] = OPLABEL_INITIALIZER;
 #endif
   /*** INSERT STACK UNION HERE ***/
 
@@ -632,10 +1186,7 @@ int sqlite3VdbeExec(
 #ifdef VDBE_PROFILE
     start = sqlite3Hwtime();
 #endif
-    nVmStep++;
-#ifdef SQLITE_ENABLE_STMT_SCANSTATUS
-    if( p->anExec ) p->anExec[(int)(pOp-aOp)]++;
-#endif
+    VDBE_COUNT_STEP;
 
     /* Only allow tracing if SQLITE_DEBUG is defined.
     */
@@ -697,6 +1248,10 @@ int sqlite3VdbeExec(
     pOrigOp = pOp;
 #endif
   
+#ifdef VDBE_COMPUTED_GOTO
+    assert( pOp->opcode<ArraySize(aOpLabel) );
+    goto *aOpLabel[pOp->opcode];
+#endif
     switch( pOp->opcode ){
 
 /*****************************************************************************
@@ -746,6 +1301,7 @@ int sqlite3VdbeExec(
 ** that this Goto is the bottom of a loop and that the lines from P2 down
 ** to the current line should be indented for EXPLAIN output.
 */
+VDBE_LABEL(OP_Goto)
 case OP_Goto: {             /* jump */
 jump_to_p2_and_check_for_interrupt:
   pOp = &aOp[pOp->p2 - 1];
@@ -779,7 +1335,7 @@ check_for_interrupt:
   }
 #endif
   
-  break;
+  VDBE_NEXT_OPCODE;
 }
 
 /* Opcode:  Gosub P1 P2 * * *
@@ -787,6 +1343,7 @@ check_for_interrupt:
 ** Write the current address onto register P1
 ** and then jump to address P2.
 */
+VDBE_LABEL(OP_Gosub)
 case OP_Gosub: {            /* jump */
   assert( pOp->p1>0 && pOp->p1<=(p->nMem-p->nCursor) );
   pIn1 = &aMem[pOp->p1];
@@ -800,7 +1357,7 @@ case OP_Gosub: {            /* jump */
   ** the pOp pointer. */
 jump_to_p2:
   pOp = &aOp[pOp->p2 - 1];
-  break;
+  VDBE_NEXT_OPCODE;
 }
 
 /* Opcode:  Return P1 * * * *
@@ -808,6 +1365,7 @@ jump_to_p2:
 ** Jump to the next instruction after the address in register P1.  After
 ** the jump, register P1 becomes undefined.
 */
+VDBE_LABEL(OP_Return)
 case OP_Return: {           /* in1 */
   pIn1 = &aMem[pOp->p1];
   assert( pIn1->flags==MEM_Int );
@@ -827,6 +1385,7 @@ case OP_Return: {           /* in1 */
 **
 ** See also: EndCoroutine
 */
+VDBE_LABEL(OP_InitCoroutine)
 case OP_InitCoroutine: {     /* jump */
   assert( pOp->p1>0 &&  pOp->p1<=(p->nMem-p->nCursor) );
   assert( pOp->p2>=0 && pOp->p2<p->nOp );
@@ -847,6 +1406,7 @@ case OP_InitCoroutine: {     /* jump */
 **
 ** See also: InitCoroutine
 */
+VDBE_LABEL(OP_EndCoroutine)
 case OP_EndCoroutine: {           /* in1 */
   VdbeOp *pCaller;
   pIn1 = &aMem[pOp->p1];
@@ -873,6 +1433,7 @@ case OP_EndCoroutine: {           /* in1 */
 **
 ** See also: InitCoroutine
 */
+VDBE_LABEL(OP_Yield)
 case OP_Yield: {            /* in1, jump */
   int pcDest;
   pIn1 = &aMem[pOp->p1];
@@ -893,6 +1454,7 @@ case OP_Yield: {            /* in1, jump */
 ** value in register P3 is not NULL, then this routine is a no-op.
 ** The P5 parameter should be 1.
 */
+VDBE_LABEL(OP_HaltIfNull)
 case OP_HaltIfNull: {      /* in3 */
   pIn3 = &aMem[pOp->p3];
   if( (pIn3->flags & MEM_Null)==0 ) break;
@@ -929,6 +1491,7 @@ case OP_HaltIfNull: {      /* in3 */
 ** every program.  So a jump past the last instruction of the program
 ** is the same as executing Halt.
 */
+VDBE_LABEL(OP_Halt)
 case OP_Halt: {
   const char *zType;
   const char *zLogFmt;
@@ -1001,10 +1564,11 @@ case OP_Halt: {
 **
 ** The 32-bit integer value P1 is written into register P2.
 */
+VDBE_LABEL(OP_Integer)
 case OP_Integer: {         /* out2 */
   pOut = out2Prerelease(p, pOp);
   pOut->u.i = pOp->p1;
-  break;
+  VDBE_NEXT_OPCODE;
 }
 
 /* Opcode: Int64 * P2 * P4 *
@@ -1013,6 +1577,7 @@ case OP_Integer: {         /* out2 */
 ** P4 is a pointer to a 64-bit integer value.
 ** Write that value into register P2.
 */
+VDBE_LABEL(OP_Int64)
 case OP_Int64: {           /* out2 */
   pOut = out2Prerelease(p, pOp);
   assert( pOp->p4.pI64!=0 );
@@ -1027,6 +1592,7 @@ case OP_Int64: {           /* out2 */
 ** P4 is a pointer to a 64-bit floating point value.
 ** Write that value into register P2.
 */
+VDBE_LABEL(OP_Real)
 case OP_Real: {            /* same as TK_FLOAT, out2 */
   pOut = out2Prerelease(p, pOp);
   pOut->flags = MEM_Real;
@@ -1044,6 +1610,7 @@ case OP_Real: {            /* same as TK_FLOAT, out2 */
 ** this transformation, the length of string P4 is computed and stored
 ** as the P1 parameter.
 */
+VDBE_LABEL(OP_String8)
 case OP_String8: {         /* same as TK_STRING, out2 */
   assert( pOp->p4.z!=0 );
   pOut = out2Prerelease(p, pOp);
@@ -1083,6 +1650,7 @@ case OP_String8: {         /* same as TK_STRING, out2 */
 ** the same sequence of bytes, it is merely interpreted as a BLOB instead
 ** of a string, as if it had been CAST.
 */
+VDBE_LABEL(OP_String)
 case OP_String: {          /* out2 */
   assert( pOp->p4.z!=0 );
   pOut = out2Prerelease(p, pOp);
@@ -1115,6 +1683,7 @@ case OP_String: {          /* out2 */
 ** NULL values will not compare equal even if SQLITE_NULLEQ is set on
 ** OP_Ne or OP_Eq.
 */
+VDBE_LABEL(OP_Null)
 case OP_Null: {           /* out2 */
   int cnt;
   u16 nullFlag;
@@ -1140,6 +1709,7 @@ case OP_Null: {           /* out2 */
 ** the register, so that if the value was a string or blob that was
 ** previously copied using OP_SCopy, the copies will continue to be valid.
 */
+VDBE_LABEL(OP_SoftNull)
 case OP_SoftNull: {
   assert( pOp->p1>0 && pOp->p1<=(p->nMem-p->nCursor) );
   pOut = &aMem[pOp->p1];
@@ -1153,6 +1723,7 @@ case OP_SoftNull: {
 ** P4 points to a blob of data P1 bytes long.  Store this
 ** blob in register P2.
 */
+VDBE_LABEL(OP_Blob)
 case OP_Blob: {                /* out2 */
   assert( pOp->p1 <= SQLITE_MAX_LENGTH );
   pOut = out2Prerelease(p, pOp);
@@ -1170,6 +1741,7 @@ case OP_Blob: {                /* out2 */
 ** If the parameter is named, then its name appears in P4.
 ** The P4 value is used by sqlite3_bind_parameter_name().
 */
+VDBE_LABEL(OP_Variable)
 case OP_Variable: {            /* out2 */
   Mem *pVar;       /* Value being transferred */
 
@@ -1194,6 +1766,7 @@ case OP_Variable: {            /* out2 */
 ** P1..P1+P3-1 and P2..P2+P3-1 to overlap.  It is an error
 ** for P3 to be less than 1.
 */
+VDBE_LABEL(OP_Move)
 case OP_Move: {
   int n;           /* Number of registers left to copy */
   int p1;          /* Register to copy from */
@@ -1234,6 +1807,7 @@ case OP_Move: {
 ** This instruction makes a deep copy of the value.  A duplicate
 ** is made of any string or blob constant.  See also OP_SCopy.
 */
+VDBE_LABEL(OP_Copy)
 case OP_Copy: {
   int n;
 
@@ -1268,6 +1842,7 @@ case OP_Copy: {
 ** during the lifetime of the copy.  Use OP_Copy to make a complete
 ** copy.
 */
+VDBE_LABEL(OP_SCopy)
 case OP_SCopy: {            /* out2 */
   pIn1 = &aMem[pOp->p1];
   pOut = &aMem[pOp->p2];
@@ -1276,7 +1851,7 @@ case OP_SCopy: {            /* out2 */
 #ifdef SQLITE_DEBUG
   if( pOut->pScopyFrom==0 ) pOut->pScopyFrom = pIn1;
 #endif
-  break;
+  VDBE_NEXT_OPCODE;
 }
 
 /* Opcode: IntCopy P1 P2 * * *
@@ -1287,6 +1862,7 @@ case OP_SCopy: {            /* out2 */
 ** This is an optimized version of SCopy that works only for integer
 ** values.
 */
+VDBE_LABEL(OP_IntCopy)
 case OP_IntCopy: {            /* out2 */
   pIn1 = &aMem[pOp->p1];
   assert( (pIn1->flags & MEM_Int)!=0 );
@@ -1304,6 +1880,8 @@ case OP_IntCopy: {            /* out2 */
 ** structure to provide access to the r(P1)..r(P1+P2-1) values as
 ** the result row.
 */
+op_result_row:
+VDBE_LABEL(OP_ResultRow)
 case OP_ResultRow: {
   Mem *pMem;
   int i;
@@ -1391,6 +1969,7 @@ case OP_ResultRow: {
 ** if P3 is the same register as P2, the implementation is able
 ** to avoid a memcpy().
 */
+VDBE_LABEL(OP_Concat)
 case OP_Concat: {           /* same as TK_CONCAT, in1, in2, out3 */
   i64 nByte;
 
@@ -1464,10 +2043,15 @@ case OP_Concat: {           /* same as TK_CONCAT, in1, in2, out3 */
 ** If the value in register P1 is zero the result is NULL.
 ** If either operand is NULL, the result is NULL.
 */
+VDBE_LABEL(OP_Add)
 case OP_Add:                   /* same as TK_PLUS, in1, in2, out3 */
+VDBE_LABEL(OP_Subtract)
 case OP_Subtract:              /* same as TK_MINUS, in1, in2, out3 */
+VDBE_LABEL(OP_Multiply)
 case OP_Multiply:              /* same as TK_STAR, in1, in2, out3 */
+VDBE_LABEL(OP_Divide)
 case OP_Divide:                /* same as TK_SLASH, in1, in2, out3 */
+VDBE_LABEL(OP_Remainder)
 case OP_Remainder: {           /* same as TK_REM, in1, in2, out3 */
   char bIntint;   /* Started out as two integer operands */
   u16 flags;      /* Combined MEM_* flags from both inputs */
@@ -1546,7 +2130,7 @@ fp_math:
     }
 #endif
   }
-  break;
+  VDBE_NEXT_OPCODE;
 
 arithmetic_result_is_null:
   sqlite3VdbeMemSetNull(pOut);
@@ -1568,6 +2152,7 @@ arithmetic_result_is_null:
 ** to retrieve the collation sequence set by this opcode is not available
 ** publicly.  Only built-in functions have access to this feature.
 */
+VDBE_LABEL(OP_CollSeq)
 case OP_CollSeq: {
   assert( pOp->p4type==P4_COLLSEQ );
   if( pOp->p1 ){
@@ -1617,6 +2202,7 @@ case OP_CollSeq: {
 **
 ** See also: Function0, AggStep, AggFinal
 */
+VDBE_LABEL(OP_Function0)
 case OP_Function0: {
   int n;
   sqlite3_context *pCtx;
@@ -1638,6 +2224,7 @@ case OP_Function0: {
   pOp->opcode = OP_Function;
   /* Fall through into OP_Function */
 }
+VDBE_LABEL(OP_Function)
 case OP_Function: {
   int i;
   sqlite3_context *pCtx;
@@ -1685,7 +2272,7 @@ case OP_Function: {
 
   REGISTER_TRACE(pOp->p3, pCtx->pOut);
   UPDATE_MAX_BLOBSIZE(pCtx->pOut);
-  break;
+  VDBE_NEXT_OPCODE;
 }
 
 /* Opcode: BitAnd P1 P2 P3 * *
@@ -1718,9 +2305,13 @@ case OP_Function: {
 ** Store the result in register P3.
 ** If either input is NULL, the result is NULL.
 */
+VDBE_LABEL(OP_BitAnd)
 case OP_BitAnd:                 /* same as TK_BITAND, in1, in2, out3 */
+VDBE_LABEL(OP_BitOr)
 case OP_BitOr:                  /* same as TK_BITOR, in1, in2, out3 */
+VDBE_LABEL(OP_ShiftLeft)
 case OP_ShiftLeft:              /* same as TK_LSHIFT, in1, in2, out3 */
+VDBE_LABEL(OP_ShiftRight)
 case OP_ShiftRight: {           /* same as TK_RSHIFT, in1, in2, out3 */
   i64 iA;
   u64 uA;
@@ -1778,6 +2369,7 @@ case OP_ShiftRight: {           /* same as TK_RSHIFT, in1, in2, out3 */
 **
 ** To force any register to be an integer, just add 0.
 */
+VDBE_LABEL(OP_AddImm)
 case OP_AddImm: {            /* in1 */
   pIn1 = &aMem[pOp->p1];
   memAboutToChange(p, pIn1);
@@ -1793,6 +2385,7 @@ case OP_AddImm: {            /* in1 */
 ** without data loss, then jump immediately to P2, or if P2==0
 ** raise an SQLITE_MISMATCH exception.
 */
+VDBE_LABEL(OP_MustBeInt)
 case OP_MustBeInt: {            /* jump, in1 */
   pIn1 = &aMem[pOp->p1];
   if( (pIn1->flags & MEM_Int)==0 ){
@@ -1821,6 +2414,7 @@ case OP_MustBeInt: {            /* jump, in1 */
 ** integers, for space efficiency, but after extraction we want them
 ** to have only a real value.
 */
+VDBE_LABEL(OP_RealAffinity)
 case OP_RealAffinity: {                  /* in1 */
   pIn1 = &aMem[pOp->p1];
   if( pIn1->flags & MEM_Int ){
@@ -1846,6 +2440,7 @@ case OP_RealAffinity: {                  /* in1 */
 **
 ** A NULL value is not changed by this routine.  It remains NULL.
 */
+VDBE_LABEL(OP_Cast)
 case OP_Cast: {                  /* in1 */
   assert( pOp->p2>=SQLITE_AFF_BLOB && pOp->p2<=SQLITE_AFF_REAL );
   testcase( pOp->p2==SQLITE_AFF_TEXT );
@@ -1944,11 +2539,18 @@ case OP_Cast: {                  /* in1 */
 ** the content of register P3 is greater than or equal to the content of
 ** register P1.  See the Lt opcode for additional information.
 */
+op_compare:
+VDBE_LABEL(OP_Eq)
 case OP_Eq:               /* same as TK_EQ, jump, in1, in3 */
+VDBE_LABEL(OP_Ne)
 case OP_Ne:               /* same as TK_NE, jump, in1, in3 */
+VDBE_LABEL(OP_Lt)
 case OP_Lt:               /* same as TK_LT, jump, in1, in3 */
+VDBE_LABEL(OP_Le)
 case OP_Le:               /* same as TK_LE, jump, in1, in3 */
+VDBE_LABEL(OP_Gt)
 case OP_Gt:               /* same as TK_GT, jump, in1, in3 */
+VDBE_LABEL(OP_Ge)
 case OP_Ge: {             /* same as TK_GE, jump, in1, in3 */
   int res;            /* Result of the comparison of pIn1 against pIn3 */
   char affinity;      /* Affinity to use for comparison */
@@ -2059,7 +2661,7 @@ case OP_Ge: {             /* same as TK_GE, jump, in1, in3 */
       goto jump_to_p2;
     }
   }
-  break;
+  VDBE_NEXT_OPCODE;
 }
 
 /* Opcode: Permutation * * * P4 *
@@ -2074,6 +2676,7 @@ case OP_Ge: {             /* same as TK_GE, jump, in1, in3 */
 ** The first integer in the P4 integer array is the length of the array
 ** and does not become part of the permutation.
 */
+VDBE_LABEL(OP_Permutation)
 case OP_Permutation: {
   assert( pOp->p4type==P4_INTARRAY );
   assert( pOp->p4.ai );
@@ -2101,6 +2704,7 @@ case OP_Permutation: {
 ** NULLs are less than numbers, numbers are less than strings,
 ** and strings are less than blobs.
 */
+VDBE_LABEL(OP_Compare)
 case OP_Compare: {
   int n;
   int i;
@@ -2154,6 +2758,7 @@ case OP_Compare: {
 ** in the most recent OP_Compare instruction the P1 vector was less than
 ** equal to, or greater than the P2 vector, respectively.
 */
+VDBE_LABEL(OP_Jump)
 case OP_Jump: {             /* jump */
   if( iCompare<0 ){
     VdbeBranchTaken(0,3); pOp = &aOp[pOp->p1 - 1];
@@ -2185,7 +2790,9 @@ case OP_Jump: {             /* jump */
 ** even if the other input is NULL.  A NULL and false or two NULLs
 ** give a NULL output.
 */
+VDBE_LABEL(OP_And)
 case OP_And:              /* same as TK_AND, in1, in2, out3 */
+VDBE_LABEL(OP_Or)
 case OP_Or: {             /* same as TK_OR, in1, in2, out3 */
   int v1;    /* Left operand:  0==FALSE, 1==TRUE, 2==UNKNOWN or NULL */
   int v2;    /* Right operand: 0==FALSE, 1==TRUE, 2==UNKNOWN or NULL */
@@ -2226,6 +2833,7 @@ case OP_Or: {             /* same as TK_OR, in1, in2, out3 */
 ** boolean complement in register P2.  If the value in register P1 is 
 ** NULL, then a NULL is stored in P2.
 */
+VDBE_LABEL(OP_Not)
 case OP_Not: {                /* same as TK_NOT, in1, out2 */
   pIn1 = &aMem[pOp->p1];
   pOut = &aMem[pOp->p2];
@@ -2244,6 +2852,7 @@ case OP_Not: {                /* same as TK_NOT, in1, out2 */
 ** ones-complement of the P1 value into register P2.  If P1 holds
 ** a NULL then store a NULL in P2.
 */
+VDBE_LABEL(OP_BitNot)
 case OP_BitNot: {             /* same as TK_BITNOT, in1, out2 */
   pIn1 = &aMem[pOp->p1];
   pOut = &aMem[pOp->p2];
@@ -2266,6 +2875,7 @@ case OP_BitNot: {             /* same as TK_BITNOT, in1, out2 */
 ** All "once" flags are initially cleared whenever a prepared statement
 ** first begins to run.
 */
+VDBE_LABEL(OP_Once)
 case OP_Once: {             /* jump */
   assert( pOp->p1<p->nOnceFlag );
   VdbeBranchTaken(p->aOnceFlag[pOp->p1]!=0, 2);
@@ -2289,7 +2899,9 @@ case OP_Once: {             /* jump */
 ** is considered false if it has a numeric value of zero.  If the value
 ** in P1 is NULL then take the jump if and only if P3 is non-zero.
 */
+VDBE_LABEL(OP_If)
 case OP_If:                 /* jump, in1 */
+VDBE_LABEL(OP_IfNot)
 case OP_IfNot: {            /* jump, in1 */
   int c;
   pIn1 = &aMem[pOp->p1];
@@ -2307,7 +2919,7 @@ case OP_IfNot: {            /* jump, in1 */
   if( c ){
     goto jump_to_p2;
   }
-  break;
+  VDBE_NEXT_OPCODE;
 }
 
 /* Opcode: IsNull P1 P2 * * *
@@ -2315,6 +2927,7 @@ case OP_IfNot: {            /* jump, in1 */
 **
 ** Jump to P2 if the value in register P1 is NULL.
 */
+VDBE_LABEL(OP_IsNull)
 case OP_IsNull: {            /* same as TK_ISNULL, jump, in1 */
   pIn1 = &aMem[pOp->p1];
   VdbeBranchTaken( (pIn1->flags & MEM_Null)!=0, 2);
@@ -2329,6 +2942,7 @@ case OP_IsNull: {            /* same as TK_ISNULL, jump, in1 */
 **
 ** Jump to P2 if the value in register P1 is not NULL.  
 */
+VDBE_LABEL(OP_NotNull)
 case OP_NotNull: {            /* same as TK_NOTNULL, jump, in1 */
   pIn1 = &aMem[pOp->p1];
   VdbeBranchTaken( (pIn1->flags & MEM_Null)==0, 2);
@@ -2363,6 +2977,51 @@ case OP_NotNull: {            /* same as TK_NOTNULL, jump, in1 */
 ** or typeof() function, respectively.  The loading of large blobs can be
 ** skipped for length() and all content loading can be skipped for typeof().
 */
+/* Opcode: Columns P1 P2 P3 P4 *
+** Synopsis: r[P3..]=columns P2.. of cursor P1
+**
+** Extract P4 consecutive columns, starting with column P2, of the record
+** that cursor P1 points to and store them in registers P3 through
+** P3+P4-1.  The first column is extracted as by OP_Column.  The record
+** header entries for the others are then parsed in one pass, 16 at a time
+** where the header bytes allow it, and their values are decoded straight
+** from the row image on the b-tree page.
+**
+** The P4-1 instructions that follow are the OP_Column instructions for
+** the other columns.  They are skipped when this opcode completes.  If a
+** column is not on the b-tree page, or the cursor does not allow the
+** fast path, this opcode stops early and the remaining OP_Column
+** instructions run one at a time.
+**
+** The code generator never emits this opcode.  sqlite3VdbeMakeReady()
+** changes the first of a run of OP_Column instructions on the same
+** cursor, with consecutive columns and registers, into Columns.
+*/
+/* Opcode: ColumnCmp P1 P2 P3 P4 P5
+** Synopsis:  r[P3]=PX
+**
+** This superinstruction is an OP_Column fused with the OP_Eq, OP_Ne, OP_Lt,
+** OP_Le, OP_Gt or OP_Ge that immediately follows it.  The column is
+** extracted exactly as by OP_Column and then the comparison is run without
+** going back through the opcode dispatch.
+**
+** The code generator never emits this opcode.  sqlite3VdbeMakeReady()
+** changes OP_Column into ColumnCmp when the next instruction is one of
+** the comparisons.
+*/
+/* Opcode: ColumnRow P1 P2 P3 P4 P5
+** Synopsis:  r[P3]=PX
+**
+** This superinstruction is an OP_Column fused with the OP_ResultRow that
+** immediately follows it.  See ColumnCmp.
+*/
+VDBE_LABEL(OP_Columns)
+case OP_Columns:
+VDBE_LABEL(OP_ColumnCmp)
+case OP_ColumnCmp:
+VDBE_LABEL(OP_ColumnRow)
+case OP_ColumnRow:
+VDBE_LABEL(OP_Column)
 case OP_Column: {
   i64 payloadSize64; /* Number of bytes in the record */
   int p2;            /* column number to retrieve */
@@ -2381,6 +3040,7 @@ case OP_Column: {
   u32 avail;         /* Number of bytes of available data */
   u32 t;             /* A type code from the record header */
   Mem *pReg;         /* PseudoTable input register */
+  int nCol;          /* OP_Columns: one more than the last column */
 
   pC = p->apCsr[pOp->p1];
   p2 = pOp->p2;
@@ -2612,7 +3272,115 @@ op_column_out:
 op_column_error:
   UPDATE_MAX_BLOBSIZE(pDest);
   REGISTER_TRACE(pOp->p3, pDest);
-  break;
+  if( pOp->opcode==OP_Column || rc!=SQLITE_OK ){
+    VDBE_NEXT_OPCODE;
+  }
+  if( pOp->opcode!=OP_Columns ){
+    /* A superinstruction.  Run the second half directly. */
+    assert( pOp->opcode==OP_ColumnCmp || pOp->opcode==OP_ColumnRow );
+    pOp++;
+    VDBE_COUNT_STEP;
+#ifdef SQLITE_DEBUG
+    if( db->flags & SQLITE_VdbeTrace ){
+      sqlite3VdbePrintOp(stdout, (int)(pOp - aOp), pOp);
+    }
+#endif
+    if( pOp->opcode==OP_ResultRow ) goto op_result_row;
+    assert( pOp->opcode==OP_Eq || pOp->opcode==OP_Ne
+         || pOp->opcode==OP_Lt || pOp->opcode==OP_Le
+         || pOp->opcode==OP_Gt || pOp->opcode==OP_Ge );
+    goto op_compare;
+  }
+
+  /* OP_Columns.  The first column is done and the cursor cache is valid.
+  ** Unless the cursor was redirected to another cursor or column, or the
+  ** header is not on the b-tree page, decode the other columns here.
+  */
+  assert( pOp->p4type==P4_INT32 && pOp->p4.i>=2 );
+  if( pC!=p->apCsr[pOp->p1] || p2!=pOp->p2
+   || pC->cacheStatus!=p->cacheCtr || pC->aRow==0
+  ){
+    VDBE_NEXT_OPCODE;
+  }
+  nCol = p2 + pOp->p4.i;
+  assert( nCol<=pC->nField );
+  if( pC->nHdrParsed<nCol && pC->iHdrOffset<aOffset[0] ){
+    zData = pC->aRow;
+    i = pC->nHdrParsed;
+    offset64 = aOffset[i];
+    zHdr = zData + pC->iHdrOffset;
+    zEndHdr = zData + aOffset[0];
+    do{
+      if( i+16<=nCol && zHdr+16<=zEndHdr && vdbeOneByteTypes16(zHdr) ){
+        const u8 *zEnd16 = &zHdr[16];
+        do{
+          t = *(zHdr++);
+          offset64 += sqlite3VdbeOneByteSerialTypeLen(t);
+          pC->aType[i++] = t;
+          aOffset[i] = (u32)(offset64 & 0xffffffff);
+        }while( zHdr<zEnd16 );
+        continue;
+      }
+      if( (t = zHdr[0])<0x80 ){
+        zHdr++;
+        offset64 += sqlite3VdbeOneByteSerialTypeLen(t);
+      }else{
+        zHdr += sqlite3GetVarint32(zHdr, &t);
+        offset64 += sqlite3VdbeSerialTypeLen(t);
+      }
+      pC->aType[i++] = t;
+      aOffset[i] = (u32)(offset64 & 0xffffffff);
+    }while( i<nCol && zHdr<zEndHdr );
+    pC->nHdrParsed = i;
+    pC->iHdrOffset = (u32)(zHdr - zData);
+    if( (zHdr>=zEndHdr && (zHdr>zEndHdr || offset64!=pC->payloadSize))
+     || (offset64 > pC->payloadSize)
+    ){
+      rc = SQLITE_CORRUPT_BKPT;
+      goto abort_due_to_error;
+    }
+  }
+  for(i=p2+1; i<nCol; i++){
+    pDest++;
+    memAboutToChange(p, pDest);
+    if( i>=pC->nHdrParsed ){
+      /* The record has fewer than i+1 fields */
+      sqlite3VdbeMemSetNull(pDest);
+      continue;
+    }
+    if( pC->szRow<aOffset[i+1] ) break;  /* Content is on an overflow page */
+    t = pC->aType[i];
+    if( VdbeMemDynamic(pDest) ) sqlite3VdbeMemSetNull(pDest);
+    pDest->enc = encoding;
+    zData = pC->aRow + aOffset[i];
+    if( t<12 ){
+      sqlite3VdbeSerialGet(zData, t, pDest);
+    }else{
+      static const u16 aFlag[] = { MEM_Blob, MEM_Str|MEM_Term };
+      pDest->n = len = (t-12)/2;
+      if( pDest->szMalloc < len+2 ){
+        pDest->flags = MEM_Null;
+        if( sqlite3VdbeMemGrow(pDest, len+2, 0) ) goto no_mem;
+      }else{
+        pDest->z = pDest->zMalloc;
+      }
+      memcpy(pDest->z, zData, len);
+      pDest->z[len] = 0;
+      pDest->z[len+1] = 0;
+      pDest->flags = aFlag[t&1];
+    }
+    UPDATE_MAX_BLOBSIZE(pDest);
+    REGISTER_TRACE(pOp->p3+i-p2, pDest);
+  }
+
+  /* Step over the OP_Column instructions for the columns decoded above.
+  ** If the loop stopped at an overflow column, its OP_Column runs next. */
+  for(i-=p2+1; i>0; i--){
+    pOp++;
+    assert( pOp->p1==pOp[-1].p1 && pOp->p2==pOp[-1].p2+1 );
+    VDBE_COUNT_STEP;
+  }
+  VDBE_NEXT_OPCODE;
 }
 
 /* Opcode: Affinity P1 P2 * P4 *
@@ -2624,6 +3392,7 @@ op_column_error:
 ** string indicates the column affinity that should be used for the nth
 ** memory cell in the range.
 */
+VDBE_LABEL(OP_Affinity)
 case OP_Affinity: {
   const char *zAffinity;   /* The affinity to be applied */
   char cAff;               /* A single character of affinity */
@@ -2657,6 +3426,7 @@ case OP_Affinity: {
 **
 ** If P4 is NULL then all index fields have the affinity BLOB.
 */
+VDBE_LABEL(OP_MakeRecord)
 case OP_MakeRecord: {
   u8 *zNewRecord;        /* A buffer to hold the data for the new record */
   Mem *pRec;             /* The new record */
@@ -2795,7 +3565,7 @@ case OP_MakeRecord: {
   pOut->enc = SQLITE_UTF8;  /* In case the blob is ever converted to text */
   REGISTER_TRACE(pOp->p3, pOut);
   UPDATE_MAX_BLOBSIZE(pOut);
-  break;
+  VDBE_NEXT_OPCODE;
 }
 
 /* Opcode: Count P1 P2 * * *
@@ -2805,6 +3575,7 @@ case OP_MakeRecord: {
 ** opened by cursor P1 in register P2
 */
 #ifndef SQLITE_OMIT_BTREECOUNT
+VDBE_LABEL(OP_Count)
 case OP_Count: {         /* out2 */
   i64 nEntry;
   BtCursor *pCrsr;
@@ -2820,12 +3591,66 @@ case OP_Count: {         /* out2 */
 }
 #endif
 
+/* Opcode: AggScan P1 P2 * P4 *
+**
+** Compute the aggregates of an aggregate query without GROUP BY over
+** the table opened by cursor P1 a batch at a time, instead of running
+** the row-at-a-time loop coded after this instruction.  Rows are decoded
+** a leaf page (at most 256 rows) at a time into column vectors, and
+** filter and aggregate kernels then run over the vectors.  If all rows
+** are processed, the result of each aggregate is stored in its register,
+** as OP_AggFinal would store it, cursor P1 is closed, and the jump to P2
+** skips the loop.  Otherwise, if a row holds a value the kernels do not
+** handle (text or a blob that is not only counted or tested for NULL, or
+** a missing field of a column with a DEFAULT), or if sum() overflows, or
+** if a progress handler is registered, fall through to the loop, which
+** starts its own scan from scratch.
+**
+** P4 is an array of integers.  The first three are the number of column
+** vectors, filter terms and aggregates.  Then follow two integers for
+** each column vector: the record field (-1 for the rowid) and
+** AGGSCAN_REAL, AGGSCAN_DFLT and AGGSCAN_NULL flags.  Vectors are sorted
+** by field.  Then four for each filter term: the vector, the comparison
+** opcode (OP_Eq, OP_Ne, OP_Lt, OP_Le, OP_Gt, OP_Ge, OP_IsNull or
+** OP_NotNull), the register holding the constant compared against and
+** the affinity of the comparison.  Then three for each aggregate: the
+** AGGSCAN_* function, its argument vector (-1 for count(*)) and its
+** register.  Filter terms are ANDed.
+*/
+#ifndef SQLITE_OMIT_AGGSCAN
+VDBE_LABEL(OP_AggScan)
+case OP_AggScan: {        /* jump */
+  int bDone;
+
+  assert( p->apCsr[pOp->p1]->eCurType==CURTYPE_BTREE );
+  assert( pOp->p4type==P4_INTARRAY );
+  bDone = 0;
+#ifndef SQLITE_OMIT_PROGRESS_CALLBACK
+  if( db->xProgress==0 )
+#endif
+  {
+    rc = vdbeAggScan(p, p->apCsr[pOp->p1]->uc.pCursor, pOp->p4.ai, &bDone);
+    if( rc==SQLITE_INTERRUPT ) goto abort_due_to_interrupt;
+    if( rc ) goto abort_due_to_error;
+  }
+  VdbeBranchTaken(bDone!=0, 2);
+  if( bDone ){
+    /* The OP_Close that follows is skipped, so close the cursor here */
+    sqlite3VdbeFreeCursor(p, p->apCsr[pOp->p1]);
+    p->apCsr[pOp->p1] = 0;
+    goto jump_to_p2;
+  }
+  break;
+}
+#endif
+
 /* Opcode: Savepoint P1 * * P4 *
 **
 ** Open, release or rollback the savepoint named by parameter P4, depending
 ** on the value of P1. To open a new savepoint, P1==0. To release (commit) an
 ** existing savepoint, P1==1, or to rollback an existing savepoint P1==2.
 */
+VDBE_LABEL(OP_Savepoint)
 case OP_Savepoint: {
   int p1;                         /* Value of P1 operand */
   char *zName;                    /* Name of savepoint */
@@ -3004,6 +3829,7 @@ case OP_Savepoint: {
 **
 ** This instruction causes the VM to halt.
 */
+VDBE_LABEL(OP_AutoCommit)
 case OP_AutoCommit: {
   int desiredAutoCommit;
   int iRollback;
@@ -3092,6 +3918,7 @@ case OP_AutoCommit: {
 ** halts.  The sqlite3_step() wrapper function might then reprepare the
 ** statement and rerun it from the beginning.
 */
+VDBE_LABEL(OP_Transaction)
 case OP_Transaction: {
   Btree *pBt;
   int iMeta;
@@ -3191,6 +4018,7 @@ case OP_Transaction: {
 ** must be started or there must be an open cursor) before
 ** executing this instruction.
 */
+VDBE_LABEL(OP_ReadCookie)
 case OP_ReadCookie: {               /* out2 */
   int iMeta;
   int iDb;
@@ -3220,6 +4048,7 @@ case OP_ReadCookie: {               /* out2 */
 **
 ** A transaction must be started before executing this opcode.
 */
+VDBE_LABEL(OP_SetCookie)
 case OP_SetCookie: {
   Db *pDb;
   assert( pOp->p2<SQLITE_N_BTREE_META );
@@ -3236,8 +4065,14 @@ case OP_SetCookie: {
     pDb->pSchema->schema_cookie = pOp->p3;
     db->flags |= SQLITE_InternChanges;
   }else if( pOp->p2==BTREE_FILE_FORMAT ){
-    /* Record changes in the file format */
-    pDb->pSchema->file_format = pOp->p3;
+    /* Record changes in the file format.  Read it back, as the btree
+    ** will not lower the format of a file holding prefix-compressed
+    ** index pages. */
+    u32 iFormat = pOp->p3;
+    if( rc==SQLITE_OK ){
+      sqlite3BtreeGetMeta(pDb->pBt, BTREE_FILE_FORMAT, &iFormat);
+    }
+    pDb->pSchema->file_format = (u8)iFormat;
   }
   if( pOp->p1==1 ){
     /* Invalidate all prepared statements whenever the TEMP database
@@ -3313,6 +4148,7 @@ case OP_SetCookie: {
 **
 ** See also OpenRead.
 */
+VDBE_LABEL(OP_ReopenIdx)
 case OP_ReopenIdx: {
   int nField;
   KeyInfo *pKeyInfo;
@@ -3332,7 +4168,9 @@ case OP_ReopenIdx: {
   }
   /* If the cursor is not currently open or is open on a different
   ** index, then fall through into OP_OpenRead to force a reopen */
+VDBE_LABEL(OP_OpenRead)
 case OP_OpenRead:
+VDBE_LABEL(OP_OpenWrite)
 case OP_OpenWrite:
 
   assert( pOp->opcode==OP_OpenWrite || pOp->p5==0 || pOp->p5==OPFLAG_SEEKEQ );
@@ -3446,7 +4284,9 @@ open_cursor_set_hints:
 ** by this opcode will be used for automatically created transient
 ** indices in joins.
 */
+VDBE_LABEL(OP_OpenAutoindex)
 case OP_OpenAutoindex: 
+VDBE_LABEL(OP_OpenEphemeral)
 case OP_OpenEphemeral: {
   VdbeCursor *pCx;
   KeyInfo *pKeyInfo;
@@ -3507,6 +4347,7 @@ case OP_OpenEphemeral: {
 ** assume that a stable sort considering the first P3 fields of each
 ** key is sufficient to produce the required results.
 */
+VDBE_LABEL(OP_SorterOpen)
 case OP_SorterOpen: {
   VdbeCursor *pCx;
 
@@ -3528,6 +4369,7 @@ case OP_SorterOpen: {
 ** to P2. Regardless of whether or not the jump is taken, increment the
 ** the sequence value.
 */
+VDBE_LABEL(OP_SequenceTest)
 case OP_SequenceTest: {
   VdbeCursor *pC;
   assert( pOp->p1>=0 && pOp->p1<p->nCursor );
@@ -3555,6 +4397,7 @@ case OP_SequenceTest: {
 ** P3 is the number of fields in the records that will be stored by
 ** the pseudo-table.
 */
+VDBE_LABEL(OP_OpenPseudo)
 case OP_OpenPseudo: {
   VdbeCursor *pCx;
 
@@ -3574,6 +4417,7 @@ case OP_OpenPseudo: {
 ** Close a cursor previously opened as P1.  If P1 is not
 ** currently open, this instruction is a no-op.
 */
+VDBE_LABEL(OP_Close)
 case OP_Close: {
   assert( pOp->p1>=0 && pOp->p1<p->nCursor );
   sqlite3VdbeFreeCursor(p, p->apCsr[pOp->p1]);
@@ -3592,6 +4436,7 @@ case OP_Close: {
 ** by the cursor.  The high-order bit is set if any column after
 ** the 64th is used.
 */
+VDBE_LABEL(OP_ColumnsUsed)
 case OP_ColumnsUsed: {
   VdbeCursor *pC;
   pC = p->apCsr[pOp->p1];
@@ -3687,9 +4532,13 @@ case OP_ColumnsUsed: {
 **
 ** See also: Found, NotFound, SeekGt, SeekGe, SeekLt
 */
+VDBE_LABEL(OP_SeekLT)
 case OP_SeekLT:         /* jump, in3 */
+VDBE_LABEL(OP_SeekLE)
 case OP_SeekLE:         /* jump, in3 */
+VDBE_LABEL(OP_SeekGE)
 case OP_SeekGE:         /* jump, in3 */
+VDBE_LABEL(OP_SeekGT)
 case OP_SeekGT: {       /* jump, in3 */
   int res;           /* Comparison result */
   int oc;            /* Opcode */
@@ -3914,8 +4763,11 @@ seek_not_found:
 **
 ** See also: NotFound, Found, NotExists
 */
+VDBE_LABEL(OP_NoConflict)
 case OP_NoConflict:     /* jump, in3 */
+VDBE_LABEL(OP_NotFound)
 case OP_NotFound:       /* jump, in3 */
+VDBE_LABEL(OP_Found)
 case OP_Found: {        /* jump, in3 */
   int alreadyExists;
   int takeJump;
@@ -4016,6 +4868,7 @@ case OP_Found: {        /* jump, in3 */
 **
 ** See also: Found, NotFound, NoConflict
 */
+VDBE_LABEL(OP_NotExists)
 case OP_NotExists: {        /* jump, in3 */
   VdbeCursor *pC;
   BtCursor *pCrsr;
@@ -4063,6 +4916,7 @@ case OP_NotExists: {        /* jump, in3 */
 ** The sequence number on the cursor is incremented after this
 ** instruction.  
 */
+VDBE_LABEL(OP_Sequence)
 case OP_Sequence: {           /* out2 */
   assert( pOp->p1>=0 && pOp->p1<p->nCursor );
   assert( p->apCsr[pOp->p1]!=0 );
@@ -4088,6 +4942,7 @@ case OP_Sequence: {           /* out2 */
 ** generated record number. This P3 mechanism is used to help implement the
 ** AUTOINCREMENT feature.
 */
+VDBE_LABEL(OP_NewRowid)
 case OP_NewRowid: {           /* out2 */
   i64 v;                 /* The new rowid */
   VdbeCursor *pC;        /* Cursor of table to get the new rowid */
@@ -4253,7 +5108,9 @@ case OP_NewRowid: {           /* out2 */
 ** This works exactly like OP_Insert except that the key is the
 ** integer value P3, not the value of the integer stored in register P3.
 */
+VDBE_LABEL(OP_Insert)
 case OP_Insert: 
+VDBE_LABEL(OP_InsertInt)
 case OP_InsertInt: {
   Mem *pData;       /* MEM cell holding data for the record to be inserted */
   Mem *pKey;        /* MEM cell holding key  for the record */
@@ -4348,6 +5205,7 @@ case OP_InsertInt: {
 ** If P4 is not NULL then the P1 cursor must have been positioned
 ** using OP_NotFound prior to invoking this opcode.
 */
+VDBE_LABEL(OP_Delete)
 case OP_Delete: {
   VdbeCursor *pC;
   u8 hasUpdateCallback;
@@ -4413,6 +5271,7 @@ case OP_Delete: {
 ** Then the VMs internal change counter resets to 0.
 ** This is used by trigger programs.
 */
+VDBE_LABEL(OP_ResetCount)
 case OP_ResetCount: {
   sqlite3VdbeSetChanges(db, p->nChange);
   p->nChange = 0;
@@ -4434,6 +5293,7 @@ case OP_ResetCount: {
 ** Fall through to next instruction if the two records compare equal to
 ** each other.  Jump to P2 if they are different.
 */
+VDBE_LABEL(OP_SorterCompare)
 case OP_SorterCompare: {
   VdbeCursor *pC;
   int res;
@@ -4463,6 +5323,7 @@ case OP_SorterCompare: {
 ** parameter P3.  Clearing the P3 column cache as part of this opcode saves
 ** us from having to issue a separate NullRow instruction to clear that cache.
 */
+VDBE_LABEL(OP_SorterData)
 case OP_SorterData: {
   VdbeCursor *pC;
 
@@ -4498,7 +5359,9 @@ case OP_SorterData: {
 ** If the P1 cursor must be pointing to a valid row (not a NULL row)
 ** of a real table, not a pseudo-table.
 */
+VDBE_LABEL(OP_RowKey)
 case OP_RowKey:
+VDBE_LABEL(OP_RowData)
 case OP_RowData: {
   VdbeCursor *pC;
   BtCursor *pCrsr;
@@ -4576,6 +5439,7 @@ case OP_RowData: {
 ** be a separate OP_VRowid opcode for use with virtual tables, but this
 ** one opcode now works for both table types.
 */
+VDBE_LABEL(OP_Rowid)
 case OP_Rowid: {                 /* out2 */
   VdbeCursor *pC;
   i64 v;
@@ -4614,7 +5478,7 @@ case OP_Rowid: {                 /* out2 */
     assert( rc==SQLITE_OK );  /* Always so because of CursorRestore() above */
   }
   pOut->u.i = v;
-  break;
+  VDBE_NEXT_OPCODE;
 }
 
 /* Opcode: NullRow P1 * * * *
@@ -4623,6 +5487,7 @@ case OP_Rowid: {                 /* out2 */
 ** that occur while the cursor is on the null row will always
 ** write a NULL.
 */
+VDBE_LABEL(OP_NullRow)
 case OP_NullRow: {
   VdbeCursor *pC;
 
@@ -4650,6 +5515,7 @@ case OP_NullRow: {
 ** from the end toward the beginning.  In other words, the cursor is
 ** configured to use Prev, not Next.
 */
+VDBE_LABEL(OP_Last)
 case OP_Last: {        /* jump */
   VdbeCursor *pC;
   BtCursor *pCrsr;
@@ -4690,7 +5556,9 @@ case OP_Last: {        /* jump */
 ** regression tests can determine whether or not the optimizer is
 ** correctly optimizing out sorts.
 */
+VDBE_LABEL(OP_SorterSort)
 case OP_SorterSort:    /* jump */
+VDBE_LABEL(OP_Sort)
 case OP_Sort: {        /* jump */
 #ifdef SQLITE_TEST
   sqlite3_sort_count++;
@@ -4711,6 +5579,7 @@ case OP_Sort: {        /* jump */
 ** from the beginning toward the end.  In other words, the cursor is
 ** configured to use Next, not Prev.
 */
+VDBE_LABEL(OP_Rewind)
 case OP_Rewind: {        /* jump */
   VdbeCursor *pC;
   BtCursor *pCrsr;
@@ -4804,6 +5673,7 @@ case OP_Rewind: {        /* jump */
 ** This opcode works just like Prev except that if cursor P1 is not
 ** open it behaves a no-op.
 */
+VDBE_LABEL(OP_SorterNext)
 case OP_SorterNext: {  /* jump */
   VdbeCursor *pC;
   int res;
@@ -4813,11 +5683,15 @@ case OP_SorterNext: {  /* jump */
   res = 0;
   rc = sqlite3VdbeSorterNext(db, pC, &res);
   goto next_tail;
+VDBE_LABEL(OP_PrevIfOpen)
 case OP_PrevIfOpen:    /* jump */
+VDBE_LABEL(OP_NextIfOpen)
 case OP_NextIfOpen:    /* jump */
   if( p->apCsr[pOp->p1]==0 ) break;
   /* Fall through */
+VDBE_LABEL(OP_Prev)
 case OP_Prev:          /* jump */
+VDBE_LABEL(OP_Next)
 case OP_Next:          /* jump */
   assert( pOp->p1>=0 && pOp->p1<p->nCursor );
   assert( pOp->p5<ArraySize(p->aCounter) );
@@ -4880,7 +5754,9 @@ next_tail:
 ** This instruction only works for indices.  The equivalent instruction
 ** for tables is OP_Insert.
 */
+VDBE_LABEL(OP_SorterInsert)
 case OP_SorterInsert:       /* in2 */
+VDBE_LABEL(OP_IdxInsert)
 case OP_IdxInsert: {        /* in2 */
   VdbeCursor *pC;
   int nKey;
@@ -4919,6 +5795,7 @@ case OP_IdxInsert: {        /* in2 */
 ** an unpacked index key. This opcode removes that entry from the 
 ** index opened by cursor P1.
 */
+VDBE_LABEL(OP_IdxDelete)
 case OP_IdxDelete: {
   VdbeCursor *pC;
   BtCursor *pCrsr;
@@ -4975,7 +5852,9 @@ case OP_IdxDelete: {
 **
 ** See also: Rowid, MakeRecord.
 */
+VDBE_LABEL(OP_Seek)
 case OP_Seek:
+VDBE_LABEL(OP_IdxRowid)
 case OP_IdxRowid: {              /* out2 */
   VdbeCursor *pC;                /* The P1 index cursor */
   VdbeCursor *pTabCur;           /* The P2 table cursor (OP_Seek only) */
@@ -5074,9 +5953,13 @@ case OP_IdxRowid: {              /* out2 */
 ** If the P1 index entry is less than or equal to the key value then jump
 ** to P2. Otherwise fall through to the next instruction.
 */
+VDBE_LABEL(OP_IdxLE)
 case OP_IdxLE:          /* jump */
+VDBE_LABEL(OP_IdxGT)
 case OP_IdxGT:          /* jump */
+VDBE_LABEL(OP_IdxLT)
 case OP_IdxLT:          /* jump */
+VDBE_LABEL(OP_IdxGE)
 case OP_IdxGE:  {       /* jump */
   VdbeCursor *pC;
   int res;
@@ -5139,6 +6022,7 @@ case OP_IdxGE:  {       /* jump */
 **
 ** See also: Clear
 */
+VDBE_LABEL(OP_Destroy)
 case OP_Destroy: {     /* out2 */
   int iMoved;
   int iDb;
@@ -5187,6 +6071,7 @@ case OP_Destroy: {     /* out2 */
 **
 ** See also: Destroy
 */
+VDBE_LABEL(OP_Clear)
 case OP_Clear: {
   int nChange;
  
@@ -5215,6 +6100,7 @@ case OP_Clear: {
 ** This opcode only works for cursors used for sorting and
 ** opened with OP_OpenEphemeral or OP_SorterOpen.
 */
+VDBE_LABEL(OP_ResetSorter)
 case OP_ResetSorter: {
   VdbeCursor *pC;
  
@@ -5255,7 +6141,9 @@ case OP_ResetSorter: {
 **
 ** See documentation on OP_CreateTable for additional information.
 */
+VDBE_LABEL(OP_CreateIndex)
 case OP_CreateIndex:            /* out2 */
+VDBE_LABEL(OP_CreateTable)
 case OP_CreateTable: {          /* out2 */
   int pgno;
   int flags;
@@ -5287,6 +6175,7 @@ case OP_CreateTable: {          /* out2 */
 ** This opcode invokes the parser to create a new virtual machine,
 ** then runs the new virtual machine.  It is thus a re-entrant opcode.
 */
+VDBE_LABEL(OP_ParseSchema)
 case OP_ParseSchema: {
   int iDb;
   const char *zMaster;
@@ -5341,6 +6230,7 @@ case OP_ParseSchema: {
 ** of that table into the internal index hash table.  This will cause
 ** the analysis to be used when preparing all subsequent queries.
 */
+VDBE_LABEL(OP_LoadAnalysis)
 case OP_LoadAnalysis: {
   assert( pOp->p1>=0 && pOp->p1<db->nDb );
   rc = sqlite3AnalysisLoad(db, pOp->p1);
@@ -5356,6 +6246,7 @@ case OP_LoadAnalysis: {
 ** the internal representation of the
 ** schema consistent with what is on disk.
 */
+VDBE_LABEL(OP_DropTable)
 case OP_DropTable: {
   sqlite3UnlinkAndDeleteTable(db, pOp->p1, pOp->p4.z);
   break;
@@ -5369,6 +6260,7 @@ case OP_DropTable: {
 ** in order to keep the internal representation of the
 ** schema consistent with what is on disk.
 */
+VDBE_LABEL(OP_DropIndex)
 case OP_DropIndex: {
   sqlite3UnlinkAndDeleteIndex(db, pOp->p1, pOp->p4.z);
   break;
@@ -5382,6 +6274,7 @@ case OP_DropIndex: {
 ** the internal representation of the
 ** schema consistent with what is on disk.
 */
+VDBE_LABEL(OP_DropTrigger)
 case OP_DropTrigger: {
   sqlite3UnlinkAndDeleteTrigger(db, pOp->p1, pOp->p4.z);
   break;
@@ -5409,6 +6302,7 @@ case OP_DropTrigger: {
 **
 ** This opcode is used to implement the integrity_check pragma.
 */
+VDBE_LABEL(OP_IntegrityCk)
 case OP_IntegrityCk: {
   int nRoot;      /* Number of tables to check.  (Number of root pages.) */
   int *aRoot;     /* Array of rootpage numbers for tables to be checked */
@@ -5459,6 +6353,7 @@ case OP_IntegrityCk: {
 **
 ** An assertion fails if P2 is not an integer.
 */
+VDBE_LABEL(OP_RowSetAdd)
 case OP_RowSetAdd: {       /* in1, in2 */
   pIn1 = &aMem[pOp->p1];
   pIn2 = &aMem[pOp->p2];
@@ -5478,6 +6373,7 @@ case OP_RowSetAdd: {       /* in1, in2 */
 ** register P3.  Or, if boolean index P1 is initially empty, leave P3
 ** unchanged and jump to instruction P2.
 */
+VDBE_LABEL(OP_RowSetRead)
 case OP_RowSetRead: {       /* jump, in1, out3 */
   i64 val;
 
@@ -5521,6 +6417,7 @@ case OP_RowSetRead: {       /* jump, in1, out3 */
 ** previously inserted as part of set X (only if it was previously
 ** inserted as part of some other set).
 */
+VDBE_LABEL(OP_RowSetTest)
 case OP_RowSetTest: {                     /* jump, in1, in3 */
   int iSet;
   int exists;
@@ -5569,6 +6466,7 @@ case OP_RowSetTest: {                     /* jump, in1, in3 */
 **
 ** If P5 is non-zero, then recursive program invocation is enabled.
 */
+VDBE_LABEL(OP_Program)
 case OP_Program: {        /* jump */
   int nMem;               /* Number of memory registers for sub-program */
   int nByte;              /* Bytes of runtime space required for sub-program */
@@ -5694,6 +6592,7 @@ case OP_Program: {        /* jump */
 ** the value of the P1 argument to the value of the P1 argument to the
 ** calling OP_Program instruction.
 */
+VDBE_LABEL(OP_Param)
 case OP_Param: {           /* out2 */
   VdbeFrame *pFrame;
   Mem *pIn;
@@ -5715,6 +6614,7 @@ case OP_Param: {           /* out2 */
 ** (deferred foreign key constraints). Otherwise, if P1 is zero, the 
 ** statement counter is incremented (immediate foreign key constraints).
 */
+VDBE_LABEL(OP_FkCounter)
 case OP_FkCounter: {
   if( db->flags & SQLITE_DeferFKs ){
     db->nDeferredImmCons += pOp->p2;
@@ -5738,6 +6638,7 @@ case OP_FkCounter: {
 ** zero, the jump is taken if the statement constraint-counter is zero
 ** (immediate foreign key constraint violations).
 */
+VDBE_LABEL(OP_FkIfZero)
 case OP_FkIfZero: {         /* jump */
   if( pOp->p1 ){
     VdbeBranchTaken(db->nDeferredCons==0 && db->nDeferredImmCons==0, 2);
@@ -5762,6 +6663,7 @@ case OP_FkIfZero: {         /* jump */
 ** This instruction throws an error if the memory cell is not initially
 ** an integer.
 */
+VDBE_LABEL(OP_MemMax)
 case OP_MemMax: {        /* in2 */
   VdbeFrame *pFrame;
   if( p->pFrame ){
@@ -5791,6 +6693,7 @@ case OP_MemMax: {        /* in2 */
 ** If the initial value of register P1 is less than 1, then the
 ** value is unchanged and control passes through to the next instruction.
 */
+VDBE_LABEL(OP_IfPos)
 case OP_IfPos: {        /* jump, in1 */
   pIn1 = &aMem[pOp->p1];
   assert( pIn1->flags&MEM_Int );
@@ -5820,6 +6723,7 @@ case OP_IfPos: {        /* jump, in1 */
 **
 ** Otherwise, r[P2] is set to the sum of r[P1] and r[P3].
 */
+VDBE_LABEL(OP_OffsetLimit)
 case OP_OffsetLimit: {    /* in1, out2, in3 */
   pIn1 = &aMem[pOp->p1];
   pIn3 = &aMem[pOp->p3];
@@ -5838,6 +6742,7 @@ case OP_OffsetLimit: {    /* in1, out2, in3 */
 ** jump to P2.  If register P1 is initially zero, leave it unchanged
 ** and fall through.
 */
+VDBE_LABEL(OP_IfNotZero)
 case OP_IfNotZero: {        /* jump, in1 */
   pIn1 = &aMem[pOp->p1];
   assert( pIn1->flags&MEM_Int );
@@ -5855,6 +6760,7 @@ case OP_IfNotZero: {        /* jump, in1 */
 ** Register P1 must hold an integer.  Decrement the value in register P1
 ** then jump to P2 if the new value is exactly zero.
 */
+VDBE_LABEL(OP_DecrJumpZero)
 case OP_DecrJumpZero: {      /* jump, in1 */
   pIn1 = &aMem[pOp->p1];
   assert( pIn1->flags&MEM_Int );
@@ -5872,6 +6778,7 @@ case OP_DecrJumpZero: {      /* jump, in1 */
 ** zero, then jump to P2.  Increment register P1 regardless of whether or
 ** not the jump is taken.
 */
+VDBE_LABEL(OP_JumpZeroIncr)
 case OP_JumpZeroIncr: {        /* jump, in1 */
   pIn1 = &aMem[pOp->p1];
   assert( pIn1->flags&MEM_Int );
@@ -5908,6 +6815,7 @@ case OP_JumpZeroIncr: {        /* jump, in1 */
 ** sqlite3_context only happens once, instead of on each call to the
 ** step function.
 */
+VDBE_LABEL(OP_AggStep0)
 case OP_AggStep0: {
   int n;
   sqlite3_context *pCtx;
@@ -5929,6 +6837,7 @@ case OP_AggStep0: {
   pOp->opcode = OP_AggStep;
   /* Fall through into OP_AggStep */
 }
+VDBE_LABEL(OP_AggStep)
 case OP_AggStep: {
   int i;
   sqlite3_context *pCtx;
@@ -5975,7 +6884,7 @@ case OP_AggStep: {
     i = pOp[-1].p1;
     if( i ) sqlite3VdbeMemSetInt64(&aMem[i], 1);
   }
-  break;
+  VDBE_NEXT_OPCODE;
 }
 
 /* Opcode: AggFinal P1 P2 * P4 *
@@ -5991,6 +6900,7 @@ case OP_AggStep: {
 ** P4 argument is only needed for the degenerate case where
 ** the step function was not previously called.
 */
+VDBE_LABEL(OP_AggFinal)
 case OP_AggFinal: {
   Mem *pMem;
   assert( pOp->p1>0 && pOp->p1<=(p->nMem-p->nCursor) );
@@ -6020,6 +6930,7 @@ case OP_AggFinal: {
 ** completes into mem[P3+2].  However on an error, mem[P3+1] and
 ** mem[P3+2] are initialized to -1.
 */
+VDBE_LABEL(OP_Checkpoint)
 case OP_Checkpoint: {
   int i;                          /* Loop counter */
   int aRes[3];                    /* Results */
@@ -6057,6 +6968,7 @@ case OP_Checkpoint: {
 **
 ** Write a string containing the final journal-mode to register P2.
 */
+VDBE_LABEL(OP_JournalMode)
 case OP_JournalMode: {    /* out2 */
   Btree *pBt;                     /* Btree to change journal mode of */
   Pager *pPager;                  /* Pager associated with pBt */
@@ -6158,6 +7070,7 @@ case OP_JournalMode: {    /* out2 */
 ** machines to be created and run.  It may not be called from within
 ** a transaction.
 */
+VDBE_LABEL(OP_Vacuum)
 case OP_Vacuum: {
   assert( p->readOnly==0 );
   rc = sqlite3RunVacuum(&p->zErrMsg, db);
@@ -6172,6 +7085,7 @@ case OP_Vacuum: {
 ** the P1 database. If the vacuum has finished, jump to instruction
 ** P2. Otherwise, fall through to the next instruction.
 */
+VDBE_LABEL(OP_IncrVacuum)
 case OP_IncrVacuum: {        /* jump */
   Btree *pBt;
 
@@ -6199,6 +7113,7 @@ case OP_IncrVacuum: {        /* jump */
 ** If P1 is 0, then all SQL statements become expired. If P1 is non-zero,
 ** then only the currently executing statement is expired.
 */
+VDBE_LABEL(OP_Expire)
 case OP_Expire: {
   if( !pOp->p1 ){
     sqlite3ExpirePreparedStatements(db);
@@ -6224,6 +7139,7 @@ case OP_Expire: {
 ** P4 contains a pointer to the name of the table being locked. This is only
 ** used to generate an error message if the lock cannot be obtained.
 */
+VDBE_LABEL(OP_TableLock)
 case OP_TableLock: {
   u8 isWriteLock = (u8)pOp->p3;
   if( isWriteLock || 0==(db->flags&SQLITE_ReadUncommitted) ){
@@ -6251,6 +7167,7 @@ case OP_TableLock: {
 ** within a callback to a virtual table xSync() method. If it is, the error
 ** code will be set to SQLITE_LOCKED.
 */
+VDBE_LABEL(OP_VBegin)
 case OP_VBegin: {
   VTable *pVTab;
   pVTab = pOp->p4.pVtab;
@@ -6266,6 +7183,7 @@ case OP_VBegin: {
 ** P2 is a register that holds the name of a virtual table in database 
 ** P1. Call the xCreate method for that table.
 */
+VDBE_LABEL(OP_VCreate)
 case OP_VCreate: {
   Mem sMem;          /* For storing the record being decoded */
   const char *zTab;  /* Name of the virtual table */
@@ -6294,6 +7212,7 @@ case OP_VCreate: {
 ** P4 is the name of a virtual table in database P1.  Call the xDestroy method
 ** of that table.
 */
+VDBE_LABEL(OP_VDestroy)
 case OP_VDestroy: {
   db->nVDestroy++;
   rc = sqlite3VtabCallDestroy(db, pOp->p1, pOp->p4.z);
@@ -6309,6 +7228,7 @@ case OP_VDestroy: {
 ** P1 is a cursor number.  This opcode opens a cursor to the virtual
 ** table and stores that cursor in P1.
 */
+VDBE_LABEL(OP_VOpen)
 case OP_VOpen: {
   VdbeCursor *pCur;
   sqlite3_vtab_cursor *pVCur;
@@ -6365,6 +7285,7 @@ case OP_VOpen: {
 **
 ** A jump is made to P2 if the result set after filtering would be empty.
 */
+VDBE_LABEL(OP_VFilter)
 case OP_VFilter: {   /* jump */
   int nArg;
   int iQuery;
@@ -6419,6 +7340,7 @@ case OP_VFilter: {   /* jump */
 ** the row of the virtual-table that the 
 ** P1 cursor is pointing to into register P3.
 */
+VDBE_LABEL(OP_VColumn)
 case OP_VColumn: {
   sqlite3_vtab *pVtab;
   const sqlite3_module *pModule;
@@ -6463,6 +7385,7 @@ case OP_VColumn: {
 ** jump to instruction P2.  Or, if the virtual table has reached
 ** the end of its result set, then fall through to the next instruction.
 */
+VDBE_LABEL(OP_VNext)
 case OP_VNext: {   /* jump */
   sqlite3_vtab *pVtab;
   const sqlite3_module *pModule;
@@ -6506,6 +7429,7 @@ case OP_VNext: {   /* jump */
 ** This opcode invokes the corresponding xRename method. The value
 ** in register P1 is passed as the zName argument to the xRename method.
 */
+VDBE_LABEL(OP_VRename)
 case OP_VRename: {
   sqlite3_vtab *pVtab;
   Mem *pName;
@@ -6558,6 +7482,7 @@ case OP_VRename: {
 ** P5 is the error actions (OE_Replace, OE_Fail, OE_Ignore, etc) to
 ** apply in the case of a constraint failure on an insert or update.
 */
+VDBE_LABEL(OP_VUpdate)
 case OP_VUpdate: {
   sqlite3_vtab *pVtab;
   const sqlite3_module *pModule;
@@ -6616,6 +7541,7 @@ case OP_VUpdate: {
 **
 ** Write the current number of pages in database P1 to memory cell P2.
 */
+VDBE_LABEL(OP_Pagecount)
 case OP_Pagecount: {            /* out2 */
   pOut = out2Prerelease(p, pOp);
   pOut->u.i = sqlite3BtreeLastPage(db->aDb[pOp->p1].pBt);
@@ -6633,6 +7559,7 @@ case OP_Pagecount: {            /* out2 */
 **
 ** Store the maximum page count after the change in register P2.
 */
+VDBE_LABEL(OP_MaxPgcnt)
 case OP_MaxPgcnt: {            /* out2 */
   unsigned int newMax;
   Btree *pBt;
@@ -6662,6 +7589,7 @@ case OP_MaxPgcnt: {            /* out2 */
 **
 ** If P2 is not zero, jump to instruction P2.
 */
+VDBE_LABEL(OP_Init)
 case OP_Init: {          /* jump */
   char *zTrace;
   char *z;
@@ -6705,6 +7633,7 @@ case OP_Init: {          /* jump */
 ** to values currently held in registers.  TK_COLUMN terms in the P4
 ** expression refer to columns in the b-tree to which cursor P1 is pointing.
 */
+VDBE_LABEL(OP_CursorHint)
 case OP_CursorHint: {
   VdbeCursor *pC;
 
@@ -6731,6 +7660,7 @@ case OP_CursorHint: {
 ** This opcode records information from the optimizer.  It is the
 ** the same as a no-op.  This opcodesnever appears in a real VM program.
 */
+VDBE_LABEL(OP_Noop)
 default: {          /* This is really OP_Noop and OP_Explain */
   assert( pOp->opcode==OP_Noop || pOp->opcode==OP_Explain );
   break;
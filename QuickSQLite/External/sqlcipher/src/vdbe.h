@@ -132,6 +132,22 @@ typedef struct VdbeOpList VdbeOpList;
 #define P5_ConstraintCheck   3
 #define P5_ConstraintFK      4
 
+/*
+** Aggregate functions that OP_AggScan computes, as identified by
+** sqlite3AggScanFunc(), and the flags of its column vectors.  See the
+** description of OP_AggScan for the layout of its P4 array.
+*/
+#define AGGSCAN_COUNT    1   /* count(*) or count(X) */
+#define AGGSCAN_SUM      2   /* sum(X) */
+#define AGGSCAN_TOTAL    3   /* total(X) */
+#define AGGSCAN_AVG      4   /* avg(X) */
+#define AGGSCAN_MIN      5   /* min(X) */
+#define AGGSCAN_MAX      6   /* max(X) */
+
+#define AGGSCAN_REAL  0x01   /* Column has REAL affinity */
+#define AGGSCAN_DFLT  0x02   /* Column has a DEFAULT value */
+#define AGGSCAN_NULL  0x04   /* Only whether the column is NULL matters */
+
 /*
 ** The Vdbe.aColName array contains 5n Mem structures, where n is the 
 ** number of columns of data returned by the statement.
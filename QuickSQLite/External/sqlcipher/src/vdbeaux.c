@@ -537,6 +537,11 @@ int sqlite3VdbeAssertMayAbort(Vdbe *v, int mayAbort){
 ** (4) Initialize the p4.xAdvance pointer on opcodes that use it.
 **
 ** (5) Reclaim the memory allocated for storing labels.
+**
+** (6) Unless this is an EXPLAIN, change the first of a run of OP_Column
+**     instructions that read consecutive columns into consecutive
+**     registers into OP_Columns, and fuse any other OP_Column with the
+**     comparison or OP_ResultRow that follows it into a superinstruction.
 */
 static void resolveP2Values(Vdbe *p, int *pMaxFuncArgs){
   int i;
@@ -599,6 +604,38 @@ static void resolveP2Values(Vdbe *p, int *pMaxFuncArgs){
       }
     }
 
+    if( opcode==OP_Column && i>0 && pParse->explain==0 ){
+      int n = 0;
+      if( pOp->p4type==P4_NOTUSED && pOp->p5==0 ){
+        for(n=1; n<=i; n++){
+          if( pOp[n].opcode!=OP_Column
+           || pOp[n].p1!=pOp->p1
+           || pOp[n].p2!=pOp->p2+n
+           || pOp[n].p3!=pOp->p3+n
+           || pOp[n].p4type!=P4_NOTUSED
+           || pOp[n].p5!=0
+          ){
+            break;
+          }
+        }
+      }
+      if( n>=2 ){
+        opcode = pOp->opcode = OP_Columns;
+        pOp->p4type = P4_INT32;
+        pOp->p4.i = n;
+      }else if( pOp[1].opcode==OP_ResultRow ){
+        opcode = pOp->opcode = OP_ColumnRow;
+      }else{
+        switch( pOp[1].opcode ){
+          case OP_Eq: case OP_Ne: case OP_Lt:
+          case OP_Le: case OP_Gt: case OP_Ge: {
+            opcode = pOp->opcode = OP_ColumnCmp;
+            break;
+          }
+        }
+      }
+    }
+
     pOp->opflags = sqlite3OpcodeProperty[opcode];
     if( (pOp->opflags & OPFLG_JUMP)!=0 && pOp->p2<0 ){
       assert( ADDR(pOp->p2)<pParse->nLabel );
@@ -3689,7 +3726,7 @@ static SQLITE_NOINLINE int sqlite3BlobCompare(const Mem *pB1, const Mem *pB2){
 ** number.  Return negative, zero, or positive if the first (i64) is less than,
 ** equal to, or greater than the second (double).
 */
-static int sqlite3IntFloatCompare(i64 i, double r){
+int sqlite3IntFloatCompare(i64 i, double r){
   if( sizeof(LONGDOUBLE_TYPE)>8 ){
     LONGDOUBLE_TYPE x = (LONGDOUBLE_TYPE)i;
     if( x<r ) return -1;
@@ -268,19 +268,37 @@ int sqlite3WalTrace = 0;
 ** returns SQLITE_CANTOPEN.
 */
 #define WAL_MAX_VERSION      3007000
-#define WALINDEX_MAX_VERSION 3007000
+#if SQLITE_SHM_NLOCK==8
+# define WALINDEX_MAX_VERSION 3007000
+#else
+# define WALINDEX_MAX_VERSION (3007000+SQLITE_SHM_NLOCK)
+#endif
 
 /*
 ** Indices of various locking bytes.   WAL_NREADER is the number
 ** of available reader locks and should be at least 3.  The default
 ** is SQLITE_SHM_NLOCK==8 and  WAL_NREADER==5.
+**
+** Builds with a larger SQLITE_SHM_NLOCK have more reader slots. The
+** extra reader marks and lock bytes are appended to the WalCkptInfo
+** object, so the write, checkpoint and recover locks, the first five
+** reader locks and the VFS's deadman switch byte stay where every other
+** build expects them. Processes built with different values therefore
+** still exclude each other. The hash tables that follow WalCkptInfo do
+** move, so such builds use a different WALINDEX_MAX_VERSION. A process
+** built with a different number of slots then fails to open the
+** wal-index with SQLITE_CANTOPEN, rather than misreading it.
 */
+#if SQLITE_SHM_NLOCK<8 || SQLITE_SHM_NLOCK>31
+# error "SQLITE_SHM_NLOCK must be between 8 and 31"
+#endif
 #define WAL_WRITE_LOCK         0
 #define WAL_ALL_BUT_WRITE      1
 #define WAL_CKPT_LOCK          1
 #define WAL_RECOVER_LOCK       2
 #define WAL_READ_LOCK(I)       (3+(I))
 #define WAL_NREADER            (SQLITE_SHM_NLOCK-3)
+#define WAL_NREADER_BASE       5
 
 
 /* Object declarations */
@@ -296,7 +314,8 @@ typedef struct WalCkptInfo WalCkptInfo;
 ** object followed by one instance of the WalCkptInfo object.
 ** For all versions of SQLite through 3.10.0 and probably beyond,
 ** the locking bytes (WalCkptInfo.aLock) start at offset 120 and
-** the total header size is 136 bytes.
+** the total header size is 136 bytes. Builds with a larger
+** SQLITE_SHM_NLOCK append to the header but do not move aLock.
 **
 ** The szPage value can be any power of 2 between 512 and 32768, inclusive.
 ** Or it can be 1 to represent a 65536-byte page.  The latter case was
@@ -377,13 +396,30 @@ struct WalIndexHdr {
 */
 struct WalCkptInfo {
   u32 nBackfill;                  /* Number of WAL frames backfilled into DB */
-  u32 aReadMark[WAL_NREADER];     /* Reader marks */
-  u8 aLock[SQLITE_SHM_NLOCK];     /* Reserved space for locks */
+  u32 aReadMark[WAL_NREADER_BASE]; /* Reader marks */
+  u8 aLock[8];                    /* Reserved space for locks */
   u32 nBackfillAttempted;         /* WAL frames perhaps written, or maybe not */
   u32 notUsed0;                   /* Available for future enhancements */
+#if SQLITE_SHM_NLOCK>8
+  u32 aReadMarkX[SQLITE_SHM_NLOCK-8];  /* Reader marks 5 and up */
+  u8 aLockX[SQLITE_SHM_NLOCK-8];       /* Reserved space for locks 8 and up */
+#endif
 };
 #define READMARK_NOT_USED  0xffffffff
 
+/*
+** Reader mark I. The first WAL_NREADER_BASE marks, the eight lock bytes
+** and the fields after them are at the same offsets in every build. A
+** build with a larger SQLITE_SHM_NLOCK keeps the rest of its reader marks
+** and lock bytes in aReadMarkX[] and aLockX[], after the stock header.
+*/
+#if SQLITE_SHM_NLOCK>8
+# define walReadMark(p,I) (*((I)<WAL_NREADER_BASE ? &(p)->aReadMark[I] \
+                                : &(p)->aReadMarkX[(I)-WAL_NREADER_BASE]))
+#else
+# define walReadMark(p,I) ((p)->aReadMark[I])
+#endif
+
 
 /* A block of WALINDEX_LOCK_RESERVED bytes beginning at
 ** WALINDEX_LOCK_OFFSET is reserved for locks. Since some systems
@@ -392,6 +428,10 @@ struct WalCkptInfo {
 */
 #define WALINDEX_LOCK_OFFSET (sizeof(WalIndexHdr)*2+offsetof(WalCkptInfo,aLock))
 #define WALINDEX_HDR_SIZE    (sizeof(WalIndexHdr)*2+sizeof(WalCkptInfo))
+#if SQLITE_SHM_NLOCK>8
+# define WALINDEX_XLOCK_OFFSET \
+    (sizeof(WalIndexHdr)*2+offsetof(WalCkptInfo,aLockX))
+#endif
 
 /* Size of header before each frame in wal */
 #define WAL_FRAME_HDRSIZE 24
@@ -420,6 +460,70 @@ struct WalCkptInfo {
   WAL_HDRSIZE + ((iFrame)-1)*(i64)((szPage)+WAL_FRAME_HDRSIZE)         \
 )
 
+/*
+** When the pager has a codec attached, sqlite3WalFrames() assembles
+** up to this many complete frames (header and encrypted page) in memory
+** and writes them to the WAL file using a single call to sqlite3OsWrite().
+** Set to 0 or 1 to write encrypted frames one at a time.
+*/
+#ifndef SQLITE_WAL_CODEC_BATCH
+# define SQLITE_WAL_CODEC_BATCH 32
+#endif
+
+/*
+** Without a codec, sqlite3WalFrames() writes each frame header and the
+** page data following it straight from the page cache. Up to this many
+** frames (two buffers each) are gathered into a single sqlite3OsWriteV().
+*/
+#define WAL_WRITEV_FRAMES \
+  (SQLITE_MAX_WRITEV>=4 ? SQLITE_MAX_WRITEV/2 : 1)
+
+/*
+** walCheckpoint() copies frames from the WAL into the database file in
+** batches of up to this many frames. Within a batch, runs of adjacent WAL
+** frames are read using a single sqlite3OsRead() and runs of adjacent
+** database pages are written using a single sqlite3OsWriteV(). Set to 1
+** to copy one page at a time.
+*/
+#ifndef SQLITE_WAL_CKPT_BATCH
+# define SQLITE_WAL_CKPT_BATCH 64
+#endif
+
+/*
+** When walCheckpoint() reads each batch using a worker thread, batches are
+** enlarged to hold up to this many bytes of frames, so that the cost of
+** starting the thread is spread over more frames.
+*/
+#define WAL_CKPT_THREAD_BYTES (4*1024*1024)
+
+/*
+** The largest read, in bytes, that walCheckpoint() makes on the WAL file
+** to load a run of consecutive frames. A single frame is always read
+** using one call, whatever the page size.
+*/
+#define WAL_CKPT_MAX_READ 65536
+
+/*
+** Number of bits in the summary of the pages present in the WAL that each
+** connection keeps once its snapshot of the WAL spans more than one
+** hash table (see walPageMapUpdate()). Page P is recorded in bit
+** (P % SQLITE_WAL_PAGEMAP_BITS), so the summary is exact for databases of
+** up to this many pages. Must be a power of two, or zero to disable.
+*/
+#ifndef SQLITE_WAL_PAGEMAP_BITS
+# define SQLITE_WAL_PAGEMAP_BITS 131072
+#endif
+#if SQLITE_WAL_PAGEMAP_BITS & (SQLITE_WAL_PAGEMAP_BITS-1)
+# error "SQLITE_WAL_PAGEMAP_BITS must be a power of two"
+#endif
+
+/*
+** Indexes into the Wal.aCkptStat[] and Wal.aCkptMax[] arrays.
+*/
+#define WAL_CKPTSTAT_FRAMES  0     /* Frames copied into the database */
+#define WAL_CKPTSTAT_WRITES  1     /* Write calls made on the database file */
+#define WAL_CKPTSTAT_TIME    2     /* Milliseconds spent copying frames */
+
 /*
 ** An open write-ahead log file is represented by an instance of the
 ** following object.
@@ -454,8 +558,35 @@ struct Wal {
 #ifdef SQLITE_ENABLE_SNAPSHOT
   WalIndexHdr *pSnapshot;    /* Start transaction here if not NULL */
 #endif
+#ifdef SQLITE_HAS_CODEC
+  u8 *aFrameBuf;             /* Buffer used to batch encrypted frames */
+  int nFrameBuf;             /* Size of aFrameBuf[] in bytes */
+#endif
+  u32 aCkptStat[3];          /* Checkpoint totals. WAL_CKPTSTAT_* indexes */
+  u32 aCkptMax[3];           /* Largest values for a single checkpoint */
+  u32 mxWalFrame;            /* Largest WAL size seen, in frames */
+  u32 nReadRetry;            /* Retries made to start read transactions */
+  u32 mxReadRetry;           /* Most retries for a single read transaction */
+  u32 nReadMarkBusy;         /* Times no reader slot could be claimed */
+  u8 *aPageMap;              /* Summary of pages in frames 1..nPageMap */
+  u32 nPageMap;              /* Number of frames recorded in aPageMap[] */
+  u32 iPageMapSalt;          /* Value of hdr.aSalt[0] for aPageMap[] */
+  u8 eDurability;            /* One of the PAGER_DURABILITY_* values */
+  int nUnsynced;             /* Commits written to the WAL since last sync */
+  int *pnSync;               /* Incremented for each sync, or NULL */
 };
 
+/*
+** When the durability policy is PAGER_DURABILITY_BATCHED and
+** synchronous=FULL, the WAL file is synced by every SQLITE_DURABILITY_BATCH-th
+** commit only, instead of by every commit. Since each frame carries a
+** cumulative checksum, a power failure can only cost the tail of unsynced
+** commits; recovery stops at the first frame that did not reach the disk.
+*/
+#ifndef SQLITE_DURABILITY_BATCH
+# define SQLITE_DURABILITY_BATCH 16
+#endif
+
 /*
 ** Candidate values for Wal.exclusiveMode.
 */
@@ -713,6 +844,72 @@ static void walEncodeFrame(
   }
 }
 
+#ifdef SQLITE_HAS_CODEC
+/*
+** This function is the same as walEncodeFrame(), except that it also
+** copies the szPage bytes of page data from aData[] into aFrame[] 
+** immediately following the frame header. The copy and the checksum
+** are computed in a single pass over the (just encrypted) page data.
+**
+** Both aData[] and aFrame[] must be 8-byte aligned.
+*/
+static void walEncodeFrameCopy(
+  Wal *pWal,                      /* The write-ahead log */
+  u32 iPage,                      /* Database page number for frame */
+  u32 nTruncate,                  /* New db size (or 0 for non-commit frames) */
+  const u8 *aData,                /* Pointer to page data */
+  u8 *aFrame                      /* OUT: Write encoded frame and data here */
+){
+  u32 *aOut = (u32*)&aFrame[WAL_FRAME_HDRSIZE];
+  assert( WAL_FRAME_HDRSIZE==24 );
+  sqlite3Put4byte(&aFrame[0], iPage);
+  sqlite3Put4byte(&aFrame[4], nTruncate);
+  if( pWal->iReCksum==0 ){
+    u32 *aCksum = pWal->hdr.aFrameCksum;
+    const u32 *aIn = (const u32*)aData;
+    const u32 *aEnd = (const u32*)&aData[pWal->szPage];
+    int nativeCksum = (pWal->hdr.bigEndCksum==SQLITE_BIGENDIAN);
+    u32 s1, s2;
+
+    memcpy(&aFrame[8], pWal->hdr.aSalt, 8);
+    walChecksumBytes(nativeCksum, aFrame, 8, aCksum, aCksum);
+    s1 = aCksum[0];
+    s2 = aCksum[1];
+    if( nativeCksum ){
+      do {
+        u32 x0 = aIn[0];
+        u32 x1 = aIn[1];
+        aOut[0] = x0;
+        aOut[1] = x1;
+        s1 += x0 + s2;
+        s2 += x1 + s1;
+        aIn += 2;
+        aOut += 2;
+      }while( aIn<aEnd );
+    }else{
+      do {
+        u32 x0 = aIn[0];
+        u32 x1 = aIn[1];
+        aOut[0] = x0;
+        aOut[1] = x1;
+        s1 += BYTESWAP32(x0) + s2;
+        s2 += BYTESWAP32(x1) + s1;
+        aIn += 2;
+        aOut += 2;
+      }while( aIn<aEnd );
+    }
+    aCksum[0] = s1;
+    aCksum[1] = s2;
+
+    sqlite3Put4byte(&aFrame[16], aCksum[0]);
+    sqlite3Put4byte(&aFrame[20], aCksum[1]);
+  }else{
+    memset(&aFrame[8], 0, 16);
+    memcpy(aOut, aData, pWal->szPage);
+  }
+}
+#endif /* SQLITE_HAS_CODEC */
+
 /*
 ** Check to see if the frame with header in aFrame[] and content
 ** in aData[] is valid.  If it is a valid frame, fill *piPage and
@@ -930,6 +1127,10 @@ static u32 walFramePgno(Wal *pWal, u32 iFrame){
 ** updated.  Any later hash tables will be automatically cleared when
 ** pWal->hdr.mxFrame advances to the point where those hash tables are
 ** actually needed.
+**
+** If the summary of the pages in the WAL covers any of the discarded
+** frames, it is cleared too. Those frame numbers are reused by the next
+** frames written, which it would otherwise never see.
 */
 static void walCleanupHash(Wal *pWal){
   volatile ht_slot *aHash = 0;    /* Pointer to hash table to clear */
@@ -941,6 +1142,12 @@ static void walCleanupHash(Wal *pWal){
 
   assert( pWal->writeLock );
   testcase( pWal->hdr.mxFrame==HASHTABLE_NPAGE_ONE-1 );
+#if SQLITE_WAL_PAGEMAP_BITS>0
+  if( pWal->nPageMap>pWal->hdr.mxFrame ){
+    memset(pWal->aPageMap, 0, SQLITE_WAL_PAGEMAP_BITS/8);
+    pWal->nPageMap = 0;
+  }
+#endif
   testcase( pWal->hdr.mxFrame==HASHTABLE_NPAGE_ONE );
   testcase( pWal->hdr.mxFrame==HASHTABLE_NPAGE_ONE+1 );
 
@@ -1223,9 +1430,9 @@ finished:
     pInfo = walCkptInfo(pWal);
     pInfo->nBackfill = 0;
     pInfo->nBackfillAttempted = pWal->hdr.mxFrame;
-    pInfo->aReadMark[0] = 0;
-    for(i=1; i<WAL_NREADER; i++) pInfo->aReadMark[i] = READMARK_NOT_USED;
-    if( pWal->hdr.mxFrame ) pInfo->aReadMark[1] = pWal->hdr.mxFrame;
+    walReadMark(pInfo, 0) = 0;
+    for(i=1; i<WAL_NREADER; i++) walReadMark(pInfo, i) = READMARK_NOT_USED;
+    if( pWal->hdr.mxFrame ) walReadMark(pInfo, 1) = pWal->hdr.mxFrame;
 
     /* If more than one frame was recovered from the log file, report an
     ** event via sqlite3_log(). This is to help with identifying performance
@@ -1298,13 +1505,21 @@ int sqlite3WalOpen(
   ** value of 120, we need to know that so there is an assert() to check it.
   */
   assert( 120==WALINDEX_LOCK_OFFSET );
-  assert( 136==WALINDEX_HDR_SIZE );
+  assert( 136==WALINDEX_HDR_SIZE || SQLITE_SHM_NLOCK!=8 );
 #ifdef WIN_SHM_BASE
   assert( WIN_SHM_BASE==WALINDEX_LOCK_OFFSET );
 #endif
 #ifdef UNIX_SHM_BASE
   assert( UNIX_SHM_BASE==WALINDEX_LOCK_OFFSET );
 #endif
+#if SQLITE_SHM_NLOCK>8
+# ifdef WIN_SHM_XBASE
+  assert( WIN_SHM_XBASE==WALINDEX_XLOCK_OFFSET );
+# endif
+# ifdef UNIX_SHM_XBASE
+  assert( UNIX_SHM_XBASE==WALINDEX_XLOCK_OFFSET );
+# endif
+#endif
 
 
   /* Allocate an instance of struct Wal to return. */
@@ -1347,6 +1562,39 @@ int sqlite3WalOpen(
   return rc;
 }
 
+/*
+** Sync file pFd, which is either the WAL or the database file of pWal.
+** Syncs are counted in *pWal->pnSync. A sync of the WAL file makes all
+** commits written so far durable.
+*/
+static int walSync(Wal *pWal, sqlite3_file *pFd, int flags){
+  if( pWal->pnSync ) (*pWal->pnSync)++;
+  if( pFd==pWal->pWalFd ) pWal->nUnsynced = 0;
+  return sqlite3OsSync(pFd, flags);
+}
+
+/*
+** This is called once for each transaction committed with
+** synchronous=FULL. Return true if the WAL file should be synced at the
+** end of the transaction, or false if the sync is deferred to a later
+** commit or checkpoint by the durability policy.
+*/
+static int walCommitSync(Wal *pWal){
+  if( pWal->eDurability!=PAGER_DURABILITY_BATCHED ) return 1;
+  pWal->nUnsynced++;
+  return pWal->nUnsynced>=SQLITE_DURABILITY_BATCH;
+}
+
+/*
+** Set the durability policy used by the WAL to eDurability, one of the
+** PAGER_DURABILITY_* values, and the counter incremented each time the
+** WAL module syncs a file to pnSync.
+*/
+void sqlite3WalSetDurability(Wal *pWal, int eDurability, int *pnSync){
+  pWal->eDurability = (u8)eDurability;
+  pWal->pnSync = pnSync;
+}
+
 /*
 ** Change the size to which the WAL file is trucated on each reset.
 */
@@ -1685,9 +1933,249 @@ static void walRestartHdr(Wal *pWal, u32 salt1){
   walIndexWriteHdr(pWal);
   pInfo->nBackfill = 0;
   pInfo->nBackfillAttempted = 0;
-  pInfo->aReadMark[1] = 0;
-  for(i=2; i<WAL_NREADER; i++) pInfo->aReadMark[i] = READMARK_NOT_USED;
-  assert( pInfo->aReadMark[0]==0 );
+  walReadMark(pInfo, 1) = 0;
+  for(i=2; i<WAL_NREADER; i++) walReadMark(pInfo, i) = READMARK_NOT_USED;
+  assert( walReadMark(pInfo, 0)==0 );
+}
+
+/*
+** Tell the VFS that the writes to file pFd that follow, up to the next
+** call to walEndWriteBatch(), may be submitted together. See
+** SQLITE_FCNTL_WRITE_BATCH.
+*/
+static void walBeginWriteBatch(sqlite3_file *pFd){
+  int bBegin = 1;
+  sqlite3OsFileControlHint(pFd, SQLITE_FCNTL_WRITE_BATCH, &bBegin);
+}
+
+/*
+** End the group of writes started by walBeginWriteBatch(). Parameter rc
+** is the result of the writes so far. If it is SQLITE_OK, any error
+** reported by the VFS while writing out the held data is returned instead.
+*/
+static int walEndWriteBatch(sqlite3_file *pFd, int rc){
+  int bBegin = 0;
+  int rc2 = sqlite3OsFileControl(pFd, SQLITE_FCNTL_WRITE_BATCH, &bBegin);
+  if( rc==SQLITE_OK && rc2!=SQLITE_NOTFOUND ) rc = rc2;
+  return rc;
+}
+
+/*
+** A batch of frames being copied from the WAL into the database file by
+** walCheckpoint(). Entry i of the batch is database page aPgno[i], the
+** content of which is read from WAL frame aFrame[i].
+**
+** The content of entry i is stored at offset (i*szFrame) of aBuf[], where
+** szFrame is the size of a WAL frame. This leaves a gap the size of a frame
+** header between the page images of adjacent entries, so that a run of
+** consecutive WAL frames can be read into the buffer by a single call to
+** sqlite3OsRead() that starts at the page data of its first frame. The
+** headers of the remaining frames land in the gaps and are ignored.
+*/
+typedef struct WalCkptBatch WalCkptBatch;
+struct WalCkptBatch {
+  Wal *pWal;                 /* Wal connection */
+  int nFrame;                /* Number of entries in the batch */
+  int rc;                    /* Result of walCkptBatchRead() */
+  u32 *aPgno;                /* Database page number of each entry */
+  u32 *aFrame;               /* WAL frame number of each entry */
+  u8 *aBuf;                  /* Page content (see above) */
+};
+
+/*
+** Load the next (up to) nMax frames that are to be checkpointed from
+** iterator pIter into batch p. Frames that are not part of the range
+** (nBackfill..mxSafeFrame], or that hold pages beyond mxPage, are skipped.
+** Since the iterator visits pages in ascending order, so do the entries
+** of the batch. *pbEof is set once the iterator has been exhausted, after
+** which it is not advanced again.
+*/
+static void walCkptBatchFill(
+  WalCkptBatch *p,                /* Batch to populate */
+  int nMax,                       /* Maximum number of entries */
+  WalIterator *pIter,             /* Iterator to read frames from */
+  u32 nBackfill,                  /* Frames already copied to the database */
+  u32 mxSafeFrame,                /* Max frame that can be backfilled */
+  u32 mxPage,                     /* Max database page to write */
+  int *pbEof                      /* IN/OUT: True once pIter is exhausted */
+){
+  u32 iDbpage = 0;
+  u32 iFrame = 0;
+  p->nFrame = 0;
+  while( p->nFrame<nMax && *pbEof==0 ){
+    if( walIteratorNext(pIter, &iDbpage, &iFrame) ){
+      *pbEof = 1;
+      break;
+    }
+    assert( walFramePgno(p->pWal, iFrame)==iDbpage );
+    if( iFrame<=nBackfill || iFrame>mxSafeFrame || iDbpage>mxPage ){
+      continue;
+    }
+    p->aPgno[p->nFrame] = iDbpage;
+    p->aFrame[p->nFrame] = iFrame;
+    p->nFrame++;
+  }
+}
+
+/*
+** Read the page content for each entry of batch p from the WAL file. The
+** result is left in p->rc.
+**
+** When the connection allows it, walCheckpoint() invokes this function
+** from a worker thread to read the next batch while the current one is
+** being written to the database file. It only reads from the WAL file
+** handle, which is not otherwise used until the worker is joined.
+*/
+static void *walCkptBatchRead(void *pCtx){
+  WalCkptBatch *p = (WalCkptBatch*)pCtx;
+  int szPage = walPagesize(p->pWal);
+  int szFrame = szPage + WAL_FRAME_HDRSIZE;
+  int i, n;
+
+  p->rc = SQLITE_OK;
+  for(i=0; p->rc==SQLITE_OK && i<p->nFrame; i+=n){
+    i64 iOffset = walFrameOffset(p->aFrame[i], szPage) + WAL_FRAME_HDRSIZE;
+    for(n=1; i+n<p->nFrame && p->aFrame[i+n]==p->aFrame[i]+n
+          && (n+1)*szFrame - WAL_FRAME_HDRSIZE<=WAL_CKPT_MAX_READ; n++);
+    /* testcase( IS_BIG_INT(iOffset) ); // requires a 4GiB WAL file */
+    p->rc = sqlite3OsRead(p->pWal->pWalFd, &p->aBuf[i*szFrame],
+                          n*szFrame - WAL_FRAME_HDRSIZE, iOffset);
+  }
+  return 0;
+}
+
+/*
+** Write the pages in batch p to the database file. Each run of adjacent
+** database pages is written by a single call to sqlite3OsWriteV(). The
+** number of calls made is added to *pnWrite.
+*/
+static int walCkptBatchWrite(WalCkptBatch *p, u32 *pnWrite){
+  const void *apBuf[SQLITE_MAX_WRITEV>1 ? SQLITE_MAX_WRITEV : 1];
+  int anBuf[SQLITE_MAX_WRITEV>1 ? SQLITE_MAX_WRITEV : 1];
+  int szPage = walPagesize(p->pWal);
+  int szFrame = szPage + WAL_FRAME_HDRSIZE;
+  int rc = SQLITE_OK;
+  int i, n;
+
+  for(i=0; rc==SQLITE_OK && i<p->nFrame; i+=n){
+    i64 iOffset = (p->aPgno[i]-1)*(i64)szPage;
+    testcase( IS_BIG_INT(iOffset) );
+    for(n=0; n<ArraySize(apBuf) && i+n<p->nFrame
+          && p->aPgno[i+n]==p->aPgno[i]+n; n++){
+      apBuf[n] = &p->aBuf[(i+n)*szFrame];
+      anBuf[n] = szPage;
+    }
+    rc = sqlite3OsWriteV(p->pWal->pDbFd, n, apBuf, anBuf, iOffset);
+    (*pnWrite)++;
+  }
+  return rc;
+}
+
+/*
+** Copy the frames in the range (nBackfill..mxSafeFrame] that hold pages
+** no greater than mxPage from the WAL into the database file, in database
+** page order. Frames are copied in batches of up to SQLITE_WAL_CKPT_BATCH.
+** If db is not NULL and allows worker threads (see PRAGMA threads), each
+** batch is read from the WAL by a worker thread while the previous batch
+** is being written to the database file.
+**
+** zBuf is a buffer of one page. It is used to copy a single page at a time
+** if the batch buffers cannot be allocated. Statistics for the copy are
+** accumulated in aStat[] (see the WAL_CKPTSTAT_* indexes).
+*/
+static int walCkptCopy(
+  Wal *pWal,                      /* Wal connection */
+  sqlite3 *db,                    /* Connection running checkpoint, or NULL */
+  WalIterator *pIter,             /* Iterator over the WAL */
+  u32 nBackfill,                  /* Frames already copied to the database */
+  u32 mxSafeFrame,                /* Max frame that can be backfilled */
+  u32 mxPage,                     /* Max database page to write */
+  u8 *zBuf,                       /* Temporary buffer of one page */
+  u32 *aStat                      /* IN/OUT: Copy statistics */
+){
+  int szFrame = walPagesize(pWal) + WAL_FRAME_HDRSIZE;
+  int nMax = SQLITE_WAL_CKPT_BATCH>1 ? SQLITE_WAL_CKPT_BATCH : 1;
+  int nBatch = 1;                 /* Number of batches in aBatch[] */
+  WalCkptBatch aBatch[2];         /* Batch being written, and the next one */
+  WalCkptBatch *p;                /* Batch being written */
+  u8 *aAlloc = 0;                 /* Allocation for batches */
+  u32 aOne[2];                    /* aPgno[] and aFrame[] when nMax==1 */
+  int bEof = 0;                   /* True once pIter is exhausted */
+  int rc = SQLITE_OK;
+  int i;
+
+#if SQLITE_MAX_WORKER_THREADS>0
+  if( db && sqlite3GlobalConfig.bCoreMutex
+   && db->aLimit[SQLITE_LIMIT_WORKER_THREADS]>0
+  ){
+    nBatch = 2;
+    if( nMax>1 && nMax<WAL_CKPT_THREAD_BYTES/szFrame ){
+      nMax = WAL_CKPT_THREAD_BYTES/szFrame;
+    }
+  }
+#else
+  UNUSED_PARAMETER(db);
+#endif
+  memset(aBatch, 0, sizeof(aBatch));
+  if( nMax>1 ){
+    i64 nByte = (i64)nMax*(sizeof(u32)*2 + szFrame);
+    aAlloc = (u8*)sqlite3_malloc64(nByte*nBatch);
+  }
+  if( aAlloc==0 ){
+    nMax = 1;
+    nBatch = 1;
+    aBatch[0].aPgno = &aOne[0];
+    aBatch[0].aFrame = &aOne[1];
+    aBatch[0].aBuf = zBuf;
+  }else{
+    u8 *pSpace = aAlloc;
+    for(i=0; i<nBatch; i++){
+      aBatch[i].aPgno = (u32*)pSpace;
+      aBatch[i].aFrame = &aBatch[i].aPgno[nMax];
+      aBatch[i].aBuf = (u8*)&aBatch[i].aFrame[nMax];
+      pSpace = &aBatch[i].aBuf[nMax*szFrame];
+    }
+  }
+  aBatch[0].pWal = aBatch[1].pWal = pWal;
+
+  p = &aBatch[0];
+  walCkptBatchFill(p, nMax, pIter, nBackfill, mxSafeFrame, mxPage, &bEof);
+  walCkptBatchRead((void*)p);
+  rc = p->rc;
+  while( rc==SQLITE_OK && p->nFrame>0 ){
+    WalCkptBatch *pNext = &aBatch[(p - aBatch + 1) % nBatch];
+#if SQLITE_MAX_WORKER_THREADS>0
+    SQLiteThread *pThread = 0;
+    if( pNext!=p ){
+      walCkptBatchFill(pNext, nMax, pIter, nBackfill, mxSafeFrame, mxPage,
+                       &bEof);
+      if( pNext->nFrame>0 ){
+        rc = sqlite3ThreadCreate(&pThread, walCkptBatchRead, (void*)pNext);
+      }
+    }
+#endif
+    if( rc==SQLITE_OK ){
+      rc = walCkptBatchWrite(p, &aStat[WAL_CKPTSTAT_WRITES]);
+      aStat[WAL_CKPTSTAT_FRAMES] += p->nFrame;
+    }
+#if SQLITE_MAX_WORKER_THREADS>0
+    if( pThread ){
+      void *pOut;
+      sqlite3ThreadJoin(pThread, &pOut);
+      if( rc==SQLITE_OK ) rc = pNext->rc;
+    }else
+#endif
+    if( rc==SQLITE_OK && pNext==p ){
+      walCkptBatchFill(p, nMax, pIter, nBackfill, mxSafeFrame, mxPage,
+                       &bEof);
+      walCkptBatchRead((void*)p);
+      rc = p->rc;
+    }
+    p = pNext;
+  }
+
+  sqlite3_free(aAlloc);
+  return rc;
 }
 
 /*
@@ -1723,6 +2211,7 @@ static void walRestartHdr(Wal *pWal, u32 salt1){
 */
 static int walCheckpoint(
   Wal *pWal,                      /* Wal connection */
+  sqlite3 *db,                    /* Connection running checkpoint, or NULL */
   int eMode,                      /* One of PASSIVE, FULL or RESTART */
   int (*xBusy)(void*),            /* Function to call when busy */
   void *pBusyArg,                 /* Context argument for xBusyHandler */
@@ -1732,8 +2221,6 @@ static int walCheckpoint(
   int rc = SQLITE_OK;             /* Return code */
   int szPage;                     /* Database page-size */
   WalIterator *pIter = 0;         /* Wal iterator context */
-  u32 iDbpage = 0;                /* Next database page to write */
-  u32 iFrame = 0;                 /* Wal frame containing data for iDbpage */
   u32 mxSafeFrame;                /* Max frame that can be backfilled */
   u32 mxPage;                     /* Max database page to write */
   int i;                          /* Loop counter */
@@ -1772,12 +2259,12 @@ static int walCheckpoint(
       ** "new" version of the value is read, and not some arbitrary value
       ** that would never be written by a real client, things are still 
       ** safe.  */
-      u32 y = pInfo->aReadMark[i];
+      u32 y = walReadMark(pInfo, i);
       if( mxSafeFrame>y ){
         assert( y<=pWal->hdr.mxFrame );
         rc = walBusyLock(pWal, xBusy, pBusyArg, WAL_READ_LOCK(i), 1);
         if( rc==SQLITE_OK ){
-          pInfo->aReadMark[i] = (i==1 ? mxSafeFrame : READMARK_NOT_USED);
+          walReadMark(pInfo, i) = (i==1 ? mxSafeFrame : READMARK_NOT_USED);
           walUnlockExclusive(pWal, WAL_READ_LOCK(i), 1);
         }else if( rc==SQLITE_BUSY ){
           mxSafeFrame = y;
@@ -1793,12 +2280,16 @@ static int walCheckpoint(
     ){
       i64 nSize;                    /* Current size of database file */
       u32 nBackfill = pInfo->nBackfill;
+      u32 aStat[3] = {0, 0, 0};     /* Statistics for this checkpoint */
+      i64 iStart = 0;               /* Time checkpoint started, in ms */
+      i64 iEnd = 0;                 /* Time checkpoint ended, in ms */
 
       pInfo->nBackfillAttempted = mxSafeFrame;
+      sqlite3OsCurrentTimeInt64(pWal->pVfs, &iStart);
 
       /* Sync the WAL to disk */
       if( sync_flags ){
-        rc = sqlite3OsSync(pWal->pWalFd, sync_flags);
+        rc = walSync(pWal, pWal->pWalFd, sync_flags);
       }
 
       /* If the database may grow as a result of this checkpoint, hint
@@ -1814,20 +2305,10 @@ static int walCheckpoint(
 
 
       /* Iterate through the contents of the WAL, copying data to the db file */
-      while( rc==SQLITE_OK && 0==walIteratorNext(pIter, &iDbpage, &iFrame) ){
-        i64 iOffset;
-        assert( walFramePgno(pWal, iFrame)==iDbpage );
-        if( iFrame<=nBackfill || iFrame>mxSafeFrame || iDbpage>mxPage ){
-          continue;
-        }
-        iOffset = walFrameOffset(iFrame, szPage) + WAL_FRAME_HDRSIZE;
-        /* testcase( IS_BIG_INT(iOffset) ); // requires a 4GiB WAL file */
-        rc = sqlite3OsRead(pWal->pWalFd, zBuf, szPage, iOffset);
-        if( rc!=SQLITE_OK ) break;
-        iOffset = (iDbpage-1)*(i64)szPage;
-        testcase( IS_BIG_INT(iOffset) );
-        rc = sqlite3OsWrite(pWal->pDbFd, zBuf, szPage, iOffset);
-        if( rc!=SQLITE_OK ) break;
+      walBeginWriteBatch(pWal->pDbFd);
+      if( rc==SQLITE_OK ){
+        rc = walCkptCopy(pWal, db, pIter, nBackfill, mxSafeFrame, mxPage,
+                         zBuf, aStat);
       }
 
       /* If work was actually accomplished... */
@@ -1837,12 +2318,21 @@ static int walCheckpoint(
           testcase( IS_BIG_INT(szDb) );
           rc = sqlite3OsTruncate(pWal->pDbFd, szDb);
           if( rc==SQLITE_OK && sync_flags ){
-            rc = sqlite3OsSync(pWal->pDbFd, sync_flags);
+            rc = walSync(pWal, pWal->pDbFd, sync_flags);
           }
         }
-        if( rc==SQLITE_OK ){
-          pInfo->nBackfill = mxSafeFrame;
-        }
+      }
+      rc = walEndWriteBatch(pWal->pDbFd, rc);
+      if( rc==SQLITE_OK ){
+        pInfo->nBackfill = mxSafeFrame;
+      }
+
+      /* Accumulate statistics for sqlite3WalCkptStat() */
+      sqlite3OsCurrentTimeInt64(pWal->pVfs, &iEnd);
+      aStat[WAL_CKPTSTAT_TIME] = iEnd>iStart ? (u32)(iEnd - iStart) : 0;
+      for(i=0; i<ArraySize(aStat); i++){
+        pWal->aCkptStat[i] += aStat[i];
+        if( aStat[i]>pWal->aCkptMax[i] ) pWal->aCkptMax[i] = aStat[i];
       }
 
       /* Release the reader lock held while backfilling */
@@ -1942,8 +2432,8 @@ int sqlite3WalClose(
       if( pWal->exclusiveMode==WAL_NORMAL_MODE ){
         pWal->exclusiveMode = WAL_EXCLUSIVE_MODE;
       }
-      rc = sqlite3WalCheckpoint(
-          pWal, SQLITE_CHECKPOINT_PASSIVE, 0, 0, sync_flags, nBuf, zBuf, 0, 0
+      rc = sqlite3WalCheckpoint(pWal, 0,
+          SQLITE_CHECKPOINT_PASSIVE, 0, 0, sync_flags, nBuf, zBuf, 0, 0
       );
       if( rc==SQLITE_OK ){
         int bPersist = -1;
@@ -1975,6 +2465,10 @@ int sqlite3WalClose(
       sqlite3EndBenignMalloc();
     }
     WALTRACE(("WAL%p: closed\n", pWal));
+#ifdef SQLITE_HAS_CODEC
+    sqlite3_free(pWal->aFrameBuf);
+#endif
+    sqlite3_free(pWal->aPageMap);
     sqlite3_free((void *)pWal->apWiData);
     sqlite3_free(pWal);
   }
@@ -2113,6 +2607,9 @@ static int walIndexReadHdr(Wal *pWal, int *pChanged){
   if( badHdr==0 && pWal->hdr.iVersion!=WALINDEX_MAX_VERSION ){
     rc = SQLITE_CANTOPEN_BKPT;
   }
+  if( rc==SQLITE_OK && pWal->hdr.mxFrame>pWal->mxWalFrame ){
+    pWal->mxWalFrame = pWal->hdr.mxFrame;
+  }
 
   return rc;
 }
@@ -2293,7 +2790,7 @@ static int walTryBeginRead(Wal *pWal, int *pChanged, int useWal, int cnt){
   }
 #endif
   for(i=1; i<WAL_NREADER; i++){
-    u32 thisMark = pInfo->aReadMark[i];
+    u32 thisMark = walReadMark(pInfo, i);
     if( mxReadMark<=thisMark && thisMark<=mxFrame ){
       assert( thisMark!=READMARK_NOT_USED );
       mxReadMark = thisMark;
@@ -2306,7 +2803,7 @@ static int walTryBeginRead(Wal *pWal, int *pChanged, int useWal, int cnt){
     for(i=1; i<WAL_NREADER; i++){
       rc = walLockExclusive(pWal, WAL_READ_LOCK(i), 1);
       if( rc==SQLITE_OK ){
-        mxReadMark = pInfo->aReadMark[i] = mxFrame;
+        mxReadMark = walReadMark(pInfo, i) = mxFrame;
         mxI = i;
         walUnlockExclusive(pWal, WAL_READ_LOCK(i), 1);
         break;
@@ -2314,6 +2811,7 @@ static int walTryBeginRead(Wal *pWal, int *pChanged, int useWal, int cnt){
         return rc;
       }
     }
+    if( i==WAL_NREADER ) pWal->nReadMarkBusy++;
   }
   if( mxI==0 ){
     assert( rc==SQLITE_BUSY || (pWal->readOnly & WAL_SHM_RDONLY)!=0 );
@@ -2360,7 +2858,7 @@ static int walTryBeginRead(Wal *pWal, int *pChanged, int useWal, int cnt){
   */
   pWal->minFrame = pInfo->nBackfill+1;
   walShmBarrier(pWal);
-  if( pInfo->aReadMark[mxI]!=mxReadMark
+  if( walReadMark(pInfo, mxI)!=mxReadMark
    || memcmp((void *)walIndexHdr(pWal), &pWal->hdr, sizeof(WalIndexHdr))
   ){
     walUnlockShared(pWal, WAL_READ_LOCK(mxI));
@@ -2401,6 +2899,8 @@ int sqlite3WalBeginReadTransaction(Wal *pWal, int *pChanged){
   do{
     rc = walTryBeginRead(pWal, pChanged, 0, ++cnt);
   }while( rc==WAL_RETRY );
+  pWal->nReadRetry += cnt-1;
+  if( (u32)(cnt-1)>pWal->mxReadRetry ) pWal->mxReadRetry = cnt-1;
   testcase( (rc&0xff)==SQLITE_BUSY );
   testcase( (rc&0xff)==SQLITE_IOERR );
   testcase( rc==SQLITE_PROTOCOL );
@@ -2425,7 +2925,7 @@ int sqlite3WalBeginReadTransaction(Wal *pWal, int *pChanged){
       volatile WalCkptInfo *pInfo = walCkptInfo(pWal);
 
       assert( pWal->readLock>0 || pWal->hdr.mxFrame==0 );
-      assert( pInfo->aReadMark[pWal->readLock]<=pSnapshot->mxFrame );
+      assert( walReadMark(pInfo, pWal->readLock)<=pSnapshot->mxFrame );
 
       /* It is possible that there is a checkpointer thread running 
       ** concurrent with this code. If this is the case, it may be that the
@@ -2480,6 +2980,55 @@ void sqlite3WalEndReadTransaction(Wal *pWal){
   }
 }
 
+#if SQLITE_WAL_PAGEMAP_BITS>0
+/*
+** Bring the summary of the pages in the WAL, Wal.aPageMap[], up to date
+** with the current snapshot. The summary has a bit set for each page
+** that might have a frame in the WAL. Frames appended since the last
+** call are added to it incrementally. It is cleared and rebuilt if the
+** WAL has been restarted. Frames discarded by a rollback are dropped
+** from it by walCleanupHash().
+**
+** If the summary cannot be allocated, Wal.aPageMap is left NULL and
+** SQLITE_OK returned. The caller should then search the hash tables.
+*/
+static int walPageMapUpdate(Wal *pWal){
+  u32 iLast = pWal->hdr.mxFrame;
+
+  if( pWal->aPageMap==0 ){
+    pWal->aPageMap = (u8*)sqlite3MallocZero(SQLITE_WAL_PAGEMAP_BITS/8);
+    if( pWal->aPageMap==0 ) return SQLITE_OK;
+    pWal->nPageMap = 0;
+    pWal->iPageMapSalt = pWal->hdr.aSalt[0];
+  }
+  if( pWal->iPageMapSalt!=pWal->hdr.aSalt[0] ){
+    memset(pWal->aPageMap, 0, SQLITE_WAL_PAGEMAP_BITS/8);
+    pWal->nPageMap = 0;
+    pWal->iPageMapSalt = pWal->hdr.aSalt[0];
+  }
+  assert( pWal->nPageMap<=iLast );
+
+  while( pWal->nPageMap<iLast ){
+    volatile ht_slot *aHash;
+    volatile u32 *aPgno;
+    u32 iZero;
+    u32 iEnd;
+    u32 iFrame;
+    int iHash = walFramePage(pWal->nPageMap+1);
+    int rc = walHashGet(pWal, iHash, &aHash, &aPgno, &iZero);
+    if( rc!=SQLITE_OK ) return rc;
+    iEnd = iZero + (iHash==0 ? HASHTABLE_NPAGE_ONE : HASHTABLE_NPAGE);
+    if( iEnd>iLast ) iEnd = iLast;
+    for(iFrame=pWal->nPageMap+1; iFrame<=iEnd; iFrame++){
+      u32 iBit = aPgno[iFrame-iZero] & (SQLITE_WAL_PAGEMAP_BITS-1);
+      pWal->aPageMap[iBit/8] |= (u8)(1 << (iBit&7));
+    }
+    pWal->nPageMap = iEnd;
+  }
+  return SQLITE_OK;
+}
+#endif /* SQLITE_WAL_PAGEMAP_BITS>0 */
+
 /*
 ** Search the wal file for page pgno. If found, set *piRead to the frame that
 ** contains the page. Otherwise, if pgno is not in the wal file, set *piRead
@@ -2538,6 +3087,25 @@ int sqlite3WalFindFrame(
   **     table after the current read-transaction had started.
   */
   iMinHash = walFramePage(pWal->minFrame);
+
+#if SQLITE_WAL_PAGEMAP_BITS>0
+  /* If more than one hash table would have to be searched, first check
+  ** the summary of the pages in the WAL. Most pages read from a database
+  ** with a long WAL are not in it, and this answers that case without
+  ** visiting every hash table.  */
+  if( walFramePage(iLast)>iMinHash ){
+    int rc = walPageMapUpdate(pWal);
+    if( rc!=SQLITE_OK ) return rc;
+    if( pWal->aPageMap ){
+      u32 iBit = pgno & (SQLITE_WAL_PAGEMAP_BITS-1);
+      if( (pWal->aPageMap[iBit/8] & (1 << (iBit&7)))==0 ){
+        *piRead = 0;
+        return SQLITE_OK;
+      }
+    }
+  }
+#endif
+
   for(iHash=walFramePage(iLast); iHash>=iMinHash && iRead==0; iHash--){
     volatile ht_slot *aHash;      /* Pointer to hash table */
     volatile u32 *aPgno;          /* Pointer to array of page numbers */
@@ -2835,6 +3403,18 @@ typedef struct WalWriter {
   sqlite3_int64 iSyncPoint;    /* Fsync at this offset */
   int syncFlags;               /* Flags for the fsync */
   int szPage;                  /* Size of one page */
+#ifdef SQLITE_HAS_CODEC
+  u8 *aBatch;                  /* Buffer of frames not yet written, or NULL */
+#endif
+  int nBatch;                  /* Number of frames not yet written */
+  int mxBatch;                 /* Most frames to batch. 0 for no batching */
+  sqlite3_int64 iBatchOff;     /* WAL file offset of first unwritten frame */
+  /* Unwritten frames when there is no codec. For each frame, the header
+  ** is assembled in aVecHdr[] and the page data is written directly
+  ** from the page cache. */
+  const void *apVec[WAL_WRITEV_FRAMES*2];
+  int anVec[WAL_WRITEV_FRAMES*2];
+  u8 aVecHdr[WAL_WRITEV_FRAMES][WAL_FRAME_HDRSIZE];
 } WalWriter;
 
 /*
@@ -2860,13 +3440,78 @@ static int walWriteToLog(
     iAmt -= iFirstAmt;
     pContent = (void*)(iFirstAmt + (char*)pContent);
     assert( p->syncFlags & (SQLITE_SYNC_NORMAL|SQLITE_SYNC_FULL) );
-    rc = sqlite3OsSync(p->pFd, p->syncFlags & SQLITE_SYNC_MASK);
+    rc = walSync(p->pWal, p->pFd, p->syncFlags & SQLITE_SYNC_MASK);
     if( iAmt==0 || rc ) return rc;
   }
   rc = sqlite3OsWrite(p->pFd, pContent, iAmt, iOffset);
   return rc;
 }
 
+/*
+** Write any frames accumulated by the WalWriter to the WAL file. Encrypted
+** frames are written from the batch buffer using a single call to
+** walWriteToLog(). Otherwise, the frame headers and page data are
+** written using a single call to sqlite3OsWriteV().
+*/
+static int walWriterFlush(WalWriter *p){
+  int rc = SQLITE_OK;
+  if( p->nBatch>0 ){
+#ifdef SQLITE_HAS_CODEC
+    if( p->aBatch ){
+      int szFrame = p->szPage + WAL_FRAME_HDRSIZE;
+      rc = walWriteToLog(p, p->aBatch, p->nBatch*szFrame, p->iBatchOff);
+    }else
+#endif
+    {
+      assert( p->iSyncPoint==0 );
+      rc = sqlite3OsWriteV(p->pFd, p->nBatch*2, p->apVec, p->anVec,
+                           p->iBatchOff);
+    }
+    p->nBatch = 0;
+  }
+  return rc;
+}
+
+/*
+** Prepare WalWriter p to batch the frames for pages in pList. If the
+** pager has a codec attached, encrypted frames are assembled in a buffer
+** owned by the Wal object. If that buffer cannot be allocated, frames are
+** written one at a time.
+*/
+static void walWriterInitBatch(WalWriter *p, PgHdr *pList){
+  p->nBatch = 0;
+  p->mxBatch = WAL_WRITEV_FRAMES>1 ? WAL_WRITEV_FRAMES : 0;
+#ifdef SQLITE_HAS_CODEC
+  p->aBatch = 0;
+  if( sqlite3PagerGetCodec(pList->pPager) ){
+    Wal *pWal = p->pWal;
+    PgHdr *pPg;
+    int nFrame = 0;
+    i64 nByte;
+
+    /* The codec encodes every page into the same buffer, so the page
+    ** data cannot be written by reference. */
+    p->mxBatch = 0;
+    if( SQLITE_WAL_CODEC_BATCH<=1 ) return;
+    for(pPg=pList; pPg && nFrame<SQLITE_WAL_CODEC_BATCH; pPg=pPg->pDirty){
+      nFrame++;
+    }
+    if( nFrame<=1 ) return;
+    nByte = (i64)nFrame * (p->szPage + WAL_FRAME_HDRSIZE);
+    if( pWal->nFrameBuf<nByte ){
+      u8 *aNew = (u8*)sqlite3_realloc64(pWal->aFrameBuf, nByte);
+      if( aNew==0 ) return;
+      pWal->aFrameBuf = aNew;
+      pWal->nFrameBuf = (int)nByte;
+    }
+    p->aBatch = pWal->aFrameBuf;
+    p->mxBatch = pWal->nFrameBuf / (p->szPage + WAL_FRAME_HDRSIZE);
+  }
+#else
+  UNUSED_PARAMETER(pList);
+#endif
+}
+
 /*
 ** Write out a single frame of the WAL
 */
@@ -2881,9 +3526,40 @@ static int walWriteOneFrame(
   u8 aFrame[WAL_FRAME_HDRSIZE];   /* Buffer to assemble frame-header in */
 #if defined(SQLITE_HAS_CODEC)
   if( (pData = sqlite3PagerCodec(pPage))==0 ) return SQLITE_NOMEM;
+  if( p->aBatch ){
+    /* Encrypt the page into the codec buffer, then checksum it while
+    ** copying it into the next free slot of the batch buffer. The whole
+    ** batch is written by walWriterFlush() once it is full. */
+    int szFrame = p->szPage + WAL_FRAME_HDRSIZE;
+    if( p->nBatch==0 ){
+      p->iBatchOff = iOffset;
+    }
+    assert( iOffset==p->iBatchOff + (i64)p->nBatch*szFrame );
+    walEncodeFrameCopy(p->pWal, pPage->pgno, nTruncate, (u8*)pData,
+                       &p->aBatch[p->nBatch*szFrame]);
+    p->nBatch++;
+    return p->nBatch>=p->mxBatch ? walWriterFlush(p) : SQLITE_OK;
+  }
 #else
   pData = pPage->pData;
 #endif
+  if( p->mxBatch ){
+    /* Assemble the frame header and add it and the page data to the
+    ** list of buffers written by walWriterFlush(). */
+    u8 *aHdr = p->aVecHdr[p->nBatch];
+    if( p->nBatch==0 ){
+      p->iBatchOff = iOffset;
+    }
+    assert( iOffset==p->iBatchOff
+                     + (i64)p->nBatch*(p->szPage+WAL_FRAME_HDRSIZE) );
+    walEncodeFrame(p->pWal, pPage->pgno, nTruncate, pData, aHdr);
+    p->apVec[p->nBatch*2] = aHdr;
+    p->anVec[p->nBatch*2] = WAL_FRAME_HDRSIZE;
+    p->apVec[p->nBatch*2+1] = pData;
+    p->anVec[p->nBatch*2+1] = p->szPage;
+    p->nBatch++;
+    return p->nBatch>=p->mxBatch ? walWriterFlush(p) : SQLITE_OK;
+  }
   walEncodeFrame(p->pWal, pPage->pgno, nTruncate, pData, aFrame);
   rc = walWriteToLog(p, aFrame, sizeof(aFrame), iOffset);
   if( rc ) return rc;
@@ -3033,7 +3709,7 @@ int sqlite3WalFrames(
     **     http://localhost:591/sqlite/info/ff5be73dee
     */
     if( pWal->syncHeader && sync_flags ){
-      rc = sqlite3OsSync(pWal->pWalFd, sync_flags & SQLITE_SYNC_MASK);
+      rc = walSync(pWal, pWal->pWalFd, sync_flags & SQLITE_SYNC_MASK);
       if( rc ) return rc;
     }
   }
@@ -3047,6 +3723,8 @@ int sqlite3WalFrames(
   w.szPage = szPage;
   iOffset = walFrameOffset(iFrame+1, szPage);
   szFrame = szPage + WAL_FRAME_HDRSIZE;
+  walWriterInitBatch(&w, pList);
+  walBeginWriteBatch(w.pFd);
 
   /* Write all frames into the log file exactly once */
   for(p=pList; p; p=p->pDirty){
@@ -3067,12 +3745,15 @@ int sqlite3WalFrames(
           pWal->iReCksum = iWrite;
         }
 #if defined(SQLITE_HAS_CODEC)
-        if( (pData = sqlite3PagerCodec(p))==0 ) return SQLITE_NOMEM;
+        if( (pData = sqlite3PagerCodec(p))==0 ){
+          rc = SQLITE_NOMEM;
+          goto frames_out;
+        }
 #else
         pData = p->pData;
 #endif
         rc = sqlite3OsWrite(pWal->pWalFd, pData, szPage, iOff);
-        if( rc ) return rc;
+        if( rc ) goto frames_out;
         p->flags &= ~PGHDR_WAL_APPEND;
         continue;
       }
@@ -3082,16 +3763,18 @@ int sqlite3WalFrames(
     assert( iOffset==walFrameOffset(iFrame, szPage) );
     nDbSize = (isCommit && p->pDirty==0) ? nTruncate : 0;
     rc = walWriteOneFrame(&w, p, nDbSize, iOffset);
-    if( rc ) return rc;
+    if( rc ) goto frames_out;
     pLast = p;
     iOffset += szFrame;
     p->flags |= PGHDR_WAL_APPEND;
   }
+  rc = walWriterFlush(&w);
+  if( rc ) goto frames_out;
 
   /* Recalculate checksums within the wal file if required. */
   if( isCommit && pWal->iReCksum ){
     rc = walRewriteChecksums(pWal, iFrame);
-    if( rc ) return rc;
+    if( rc ) goto frames_out;
   }
 
   /* If this is the end of a transaction, then we might need to pad
@@ -3107,22 +3790,41 @@ int sqlite3WalFrames(
   ** boundary is crossed.  Only the part of the WAL prior to the last
   ** sector boundary is synced; the part of the last frame that extends
   ** past the sector boundary is written after the sync.
+  **
+  ** Under PAGER_DURABILITY_BATCHED, most commits skip both, as if
+  ** synchronous were NORMAL. See walCommitSync().
   */
-  if( isCommit && (sync_flags & WAL_SYNC_TRANSACTIONS)!=0 ){
+  if( isCommit && (sync_flags & WAL_SYNC_TRANSACTIONS)!=0
+   && walCommitSync(pWal)
+  ){
     if( pWal->padToSectorBoundary ){
       int sectorSize = sqlite3SectorSize(pWal->pWalFd);
+#ifdef SQLITE_HAS_CODEC
+      if( w.aBatch==0 )
+#endif
+      {
+        /* The vectored batch does not split writes at w.iSyncPoint, so
+        ** write the padding frames one at a time. */
+        w.mxBatch = 0;
+      }
       w.iSyncPoint = ((iOffset+sectorSize-1)/sectorSize)*sectorSize;
       while( iOffset<w.iSyncPoint ){
         rc = walWriteOneFrame(&w, pLast, nTruncate, iOffset);
-        if( rc ) return rc;
+        if( rc ) goto frames_out;
         iOffset += szFrame;
         nExtra++;
       }
+      rc = walWriterFlush(&w);
+      if( rc ) goto frames_out;
     }else{
-      rc = sqlite3OsSync(w.pFd, sync_flags & SQLITE_SYNC_MASK);
+      rc = walSync(pWal, w.pFd, sync_flags & SQLITE_SYNC_MASK);
     }
   }
 
+  /* The frames must be in the WAL file before they are made visible to
+  ** readers through the wal-index below. */
+  rc = walEndWriteBatch(w.pFd, rc);
+
   /* If this frame set completes the first transaction in the WAL and
   ** if PRAGMA journal_size_limit is set, then truncate the WAL to the
   ** journal size limit, if possible.
@@ -3167,11 +3869,15 @@ int sqlite3WalFrames(
     if( isCommit ){
       walIndexWriteHdr(pWal);
       pWal->iCallback = iFrame;
+      if( iFrame>pWal->mxWalFrame ) pWal->mxWalFrame = iFrame;
     }
   }
 
   WALTRACE(("WAL%p: frame write %s\n", pWal, rc ? "failed" : "ok"));
   return rc;
+
+frames_out:
+  return walEndWriteBatch(w.pFd, rc);
 }
 
 /* 
@@ -3186,6 +3892,7 @@ int sqlite3WalFrames(
 */
 int sqlite3WalCheckpoint(
   Wal *pWal,                      /* Wal connection */
+  sqlite3 *db,                    /* Connection running checkpoint, or NULL */
   int eMode,                      /* PASSIVE, FULL, RESTART, or TRUNCATE */
   int (*xBusy)(void*),            /* Function to call when busy */
   void *pBusyArg,                 /* Context argument for xBusyHandler */
@@ -3260,7 +3967,8 @@ int sqlite3WalCheckpoint(
     if( pWal->hdr.mxFrame && walPagesize(pWal)!=nBuf ){
       rc = SQLITE_CORRUPT_BKPT;
     }else{
-      rc = walCheckpoint(pWal, eMode2, xBusy2, pBusyArg, sync_flags, zBuf);
+      rc = walCheckpoint(pWal, db, eMode2, xBusy2, pBusyArg, sync_flags,
+                         zBuf);
     }
 
     /* If no error occurred, set the output variables. */
@@ -3413,6 +4121,60 @@ int sqlite3WalFramesize(Wal *pWal){
 }
 #endif
 
+/*
+** Add the value of checkpoint statistic eStat, accumulated over all
+** checkpoints run using this Wal connection, to *pnCur. If the largest
+** value for a single checkpoint is greater than *pnMax, set *pnMax to it.
+** If reset is true, zero both values.
+**
+** For SQLITE_DBSTATUS_WAL_SIZE, the number of frames in the WAL as of the
+** most recent transaction or checkpoint is added to *pnCur instead, and
+** the largest number of frames seen is used for *pnMax. The read-mark
+** contention counters SQLITE_DBSTATUS_WAL_READ_RETRY and _READMARK_BUSY
+** are handled the same way.
+*/
+void sqlite3WalCkptStat(
+  Wal *pWal,                      /* Wal connection */
+  int eStat,                      /* SQLITE_DBSTATUS_CKPT_* or WAL_* value */
+  int reset,                      /* True to reset the statistic */
+  int *pnCur,                     /* IN/OUT: Total value */
+  int *pnMax                      /* IN/OUT: Largest single value */
+){
+  int iStat = eStat - SQLITE_DBSTATUS_CKPT_FRAMES;
+
+  if( eStat==SQLITE_DBSTATUS_WAL_SIZE ){
+    *pnCur += (int)pWal->hdr.mxFrame;
+    if( (int)pWal->mxWalFrame>*pnMax ) *pnMax = (int)pWal->mxWalFrame;
+    if( reset ) pWal->mxWalFrame = pWal->hdr.mxFrame;
+    return;
+  }
+  if( eStat==SQLITE_DBSTATUS_WAL_READ_RETRY ){
+    *pnCur += (int)pWal->nReadRetry;
+    if( (int)pWal->mxReadRetry>*pnMax ) *pnMax = (int)pWal->mxReadRetry;
+    if( reset ) pWal->nReadRetry = pWal->mxReadRetry = 0;
+    return;
+  }
+  if( eStat==SQLITE_DBSTATUS_WAL_READMARK_BUSY ){
+    *pnCur += (int)pWal->nReadMarkBusy;
+    if( reset ) pWal->nReadMarkBusy = 0;
+    return;
+  }
+  assert( SQLITE_DBSTATUS_CKPT_FRAMES+WAL_CKPTSTAT_FRAMES
+                                            ==SQLITE_DBSTATUS_CKPT_FRAMES );
+  assert( SQLITE_DBSTATUS_CKPT_FRAMES+WAL_CKPTSTAT_WRITES
+                                            ==SQLITE_DBSTATUS_CKPT_WRITES );
+  assert( SQLITE_DBSTATUS_CKPT_FRAMES+WAL_CKPTSTAT_TIME
+                                            ==SQLITE_DBSTATUS_CKPT_TIME );
+  assert( iStat>=0 && iStat<ArraySize(pWal->aCkptStat) );
+
+  *pnCur += (int)pWal->aCkptStat[iStat];
+  if( (int)pWal->aCkptMax[iStat]>*pnMax ) *pnMax = (int)pWal->aCkptMax[iStat];
+  if( reset ){
+    pWal->aCkptStat[iStat] = 0;
+    pWal->aCkptMax[iStat] = 0;
+  }
+}
+
 /* Return the sqlite3_file object for the WAL file
 */
 sqlite3_file *sqlite3WalFile(Wal *pWal){
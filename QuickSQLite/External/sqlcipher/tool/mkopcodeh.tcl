@@ -31,10 +31,25 @@
 # properties apply to that opcode.  Set corresponding flags using the
 # OPFLG_INITIALIZER macro.
 #
+# The preprocessor conditionals that enclose each "case OP_aaaa:" line are
+# also remembered.  They are used to build the OPLABEL_INITIALIZER table of
+# label addresses used by the computed-goto dispatch in sqlite3VdbeExec().
+# Opcodes whose case is compiled out are sent to the label of OP_Noop.
+#
+
+# Return the negation of a preprocessor expression
+#
+proc negate {x} {
+  if {[regexp {^!(defined\(\w+\))$} $x all y]} {return $y}
+  if {[regexp {^defined\(\w+\)$} $x]} {return "!$x"}
+  if {[string index $x 0]=="("} {return "!$x"}
+  return "!($x)"
+}
 
 set in stdin
 set currentOp {}
 set nOp 0
+set ifstack {}
 while {![eof $in]} {
   set line [gets $in]
 
@@ -71,11 +86,34 @@ while {![eof $in]} {
     set synopsis($currentOp) [string trim $x]
   }
 
+  # Track the #if nesting of the vdbe.c file
+  #
+  if {[regexp {^#\s*ifdef\s+(\w+)} $line all x]} {
+    lappend ifstack "defined($x)"
+  } elseif {[regexp {^#\s*ifndef\s+(\w+)} $line all x]} {
+    lappend ifstack "!defined($x)"
+  } elseif {[regexp {^#\s*if\s+(.*)$} $line all x]} {
+    regsub {/\*.*} $x {} x
+    set x [string trim $x]
+    if {![regexp {^!?defined\(\w+\)$} $x]} {set x "($x)"}
+    lappend ifstack $x
+  } elseif {[regexp {^#\s*elif\s+(.*)$} $line all x]} {
+    regsub {/\*.*} $x {} x
+    lset ifstack end "([negate [lindex $ifstack end]] && ([string trim $x]))"
+  } elseif {[regexp {^#\s*else} $line]} {
+    lset ifstack end [negate [lindex $ifstack end]]
+  } elseif {[regexp {^#\s*endif} $line]} {
+    set ifstack [lrange $ifstack 0 end-1]
+  }
+
   # Scan for "case OP_aaaa:" lines in the vdbe.c file
   #
   if {[regexp {^case OP_} $line]} {
     set line [split $line]
     set name [string trim [lindex $line 1] :]
+    if {[llength $ifstack]>0} {
+      set cond($name) [join $ifstack " && "]
+    }
     set op($name) -1
     set jump($name) 0
     set in1($name) 0
@@ -232,3 +270,39 @@ for {set i 0} {$i<=$max} {incr i} {
   }
 }
 puts "\175"
+
+# Generate the table of label addresses used for computed-goto dispatch.
+# The labels themselves are created by the VDBE_LABEL() macro in vdbe.c.
+#
+puts ""
+puts "/* Opcodes that are omitted from the build dispatch to the OP_Noop"
+puts "** label.  See the VDBE_LABEL() macro in vdbe.c."
+puts "*/"
+for {set i 0} {$i<=$max} {incr i} {
+  set name $def($i)
+  if {[info exists cond($name)]} {
+    puts "#if [negate $cond($name)]"
+    puts "# define L_$name L_OP_Noop"
+    puts "#endif"
+  }
+}
+puts "#define OPLABEL_INITIALIZER \173\\"
+for {set i 0} {$i<=$max} {incr i} {
+  set name $def($i)
+  if {[info exists op($name)] && $name!="OP_Explain"} {
+    set lbl "&&L_$name"
+  } else {
+    set lbl "&&L_OP_Noop"
+  }
+  if {$i%3==0} {
+    puts -nonewline [format "/* %3d */" $i]
+  }
+  puts -nonewline [format " %-21s" "$lbl,"]
+  if {$i%3==2} {
+    puts "\\"
+  }
+}
+if {$max%3!=2} {
+  puts "\\"
+}
+puts "\175"
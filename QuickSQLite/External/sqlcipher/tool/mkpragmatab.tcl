@@ -174,6 +174,22 @@ set pragma_def {
   NAME: mmap_size
   IF:   !defined(SQLITE_OMIT_PAGER_PRAGMAS)
 
+  NAME: readahead
+  FLAG: NeedSchema
+  IF:   !defined(SQLITE_OMIT_PAGER_PRAGMAS)
+
+  NAME: durability
+  FLAG: NeedSchema
+  IF:   !defined(SQLITE_OMIT_PAGER_PRAGMAS)
+
+  NAME: bulk_fill
+  FLAG: NeedSchema
+  IF:   !defined(SQLITE_OMIT_PAGER_PRAGMAS)
+
+  NAME: prefix_compression
+  FLAG: NeedSchema
+  IF:   !defined(SQLITE_OMIT_PAGER_PRAGMAS)
+
   NAME: auto_vacuum
   FLAG: NeedSchema
   IF:   !defined(SQLITE_OMIT_AUTOVACUUM)
@@ -291,6 +307,9 @@ set pragma_def {
   NAME: wal_autocheckpoint
   IF:   !defined(SQLITE_OMIT_WAL)
 
+  NAME: wal_checkpoint_thread
+  IF:   !defined(SQLITE_OMIT_WAL)
+
   NAME: shrink_memory
 
   NAME: busy_timeout
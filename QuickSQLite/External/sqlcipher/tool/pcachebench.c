@@ -0,0 +1,254 @@
+/*
+** 2026 October 19
+**
+** The author disclaims copyright to this source code.  In place of
+** a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************
+**
+** Trace-driven benchmark for the page replacement policies of the
+** built-in page cache (see SQLITE_CONFIG_PCACHE_POLICY).
+**
+** A database holding a small indexed "hot" table and a large "cold" table
+** is created first.  A trace of operations is then replayed against it,
+** once for each replacement policy, and the page cache hit ratio is
+** reported separately for the point lookups and for the whole trace.
+** Each line of a trace is one of:
+**
+**     L <key>       Point lookup of <key> in the hot table
+**     S             Full scan of the cold table
+**
+** If no trace file is named on the command-line, a mixed workload of
+** random point lookups interrupted by periodic table scans is generated.
+**
+** To compile:
+**
+**     gcc -O2 -I. tool/pcachebench.c sqlite3.c -lpthread -ldl
+**
+** Usage:
+**
+**     ./a.out [--cache-size N] [--hot-rows N] [--cold-rows N] DATABASE [TRACE]
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sqlite3.h"
+
+/*
+** Command-line settings
+*/
+static int cacheSize = 500;          /* PRAGMA cache_size for the replay */
+static int nHotRow = 4000;           /* Rows in the hot table */
+static int nColdRow = 200000;        /* Rows in the cold table */
+
+/*
+** One operation of a trace
+*/
+typedef struct TraceOp TraceOp;
+struct TraceOp {
+  char eOp;                 /* 'L' or 'S' */
+  int iKey;                 /* Key for 'L' operations */
+};
+
+/*
+** Print an error message and exit.
+*/
+static void fatal(const char *zMsg, sqlite3 *db){
+  fprintf(stderr, "%s%s%s\n", zMsg, db ? ": " : "", db ? sqlite3_errmsg(db):"");
+  exit(1);
+}
+
+/*
+** Run SQL that returns no result, exiting on error.
+*/
+static void execSql(sqlite3 *db, const char *zSql){
+  char *zErr = 0;
+  if( sqlite3_exec(db, zSql, 0, 0, &zErr)!=SQLITE_OK ){
+    fprintf(stderr, "%s\n", zErr);
+    exit(1);
+  }
+}
+
+/*
+** Create the test database if it does not already contain the
+** benchmark tables.
+*/
+static void buildDatabase(const char *zDb){
+  sqlite3 *db;
+  char *zSql;
+  if( sqlite3_open(zDb, &db) ) fatal("cannot open database", db);
+  execSql(db, "DROP TABLE IF EXISTS hot; DROP TABLE IF EXISTS cold;");
+  zSql = sqlite3_mprintf(
+    "BEGIN;"
+    "CREATE TABLE hot(k INTEGER, v TEXT);"
+    "CREATE TABLE cold(a INTEGER PRIMARY KEY, b BLOB);"
+    "WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x+1 FROM c WHERE x<%d)"
+    " INSERT INTO hot SELECT (x*7919)%%%d, printf('%%.40c', 'x') FROM c;"
+    "CREATE INDEX hot_k ON hot(k);"
+    "WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x+1 FROM c WHERE x<%d)"
+    " INSERT INTO cold SELECT x, randomblob(200) FROM c;"
+    "COMMIT;", nHotRow, nHotRow, nColdRow
+  );
+  execSql(db, zSql);
+  sqlite3_free(zSql);
+  sqlite3_close(db);
+}
+
+/*
+** Load a trace from file zFile, or generate the default mixed workload
+** if zFile is NULL.  Return the number of operations in *paOp.
+*/
+static int loadTrace(const char *zFile, TraceOp **paOp){
+  TraceOp *aOp = 0;
+  int nOp = 0;
+  int nAlloc = 0;
+  if( zFile ){
+    char zLine[100];
+    FILE *in = fopen(zFile, "rb");
+    if( in==0 ) fatal("cannot open trace file", 0);
+    while( fgets(zLine, sizeof(zLine), in) ){
+      if( zLine[0]!='L' && zLine[0]!='S' ) continue;
+      if( nOp>=nAlloc ){
+        nAlloc = nAlloc*2 + 1000;
+        aOp = realloc(aOp, nAlloc*sizeof(TraceOp));
+        if( aOp==0 ) fatal("out of memory", 0);
+      }
+      aOp[nOp].eOp = zLine[0];
+      aOp[nOp].iKey = zLine[0]=='L' ? atoi(&zLine[1]) : 0;
+      nOp++;
+    }
+    fclose(in);
+  }else{
+    /* 20 rounds of 5000 lookups drawn from a skewed key distribution,
+    ** each followed by a full scan of the cold table. */
+    unsigned int x = 12345;
+    int i;
+    nOp = 20*5001;
+    aOp = malloc(nOp*sizeof(TraceOp));
+    if( aOp==0 ) fatal("out of memory", 0);
+    for(i=0; i<nOp; i++){
+      if( (i%5001)==5000 ){
+        aOp[i].eOp = 'S';
+        aOp[i].iKey = 0;
+      }else{
+        x = x*1103515245 + 12345;
+        aOp[i].eOp = 'L';
+        aOp[i].iKey = (int)((x>>8) % (unsigned)(nHotRow/10 + 1));
+        if( (x>>4)%10==0 ) aOp[i].iKey = (int)((x>>8) % (unsigned)nHotRow);
+      }
+    }
+  }
+  *paOp = aOp;
+  return nOp;
+}
+
+/*
+** Return the current value of a cumulative per-connection counter.
+*/
+static int dbStatus(sqlite3 *db, int op){
+  int iCur = 0, iHi = 0;
+  sqlite3_db_status(db, op, &iCur, &iHi, 0);
+  return iCur;
+}
+
+/*
+** Replay the trace against database zDb using replacement policy ePolicy.
+*/
+static void runTrace(
+  const char *zDb,
+  const char *zName,
+  int ePolicy,
+  TraceOp *aOp,
+  int nOp
+){
+  sqlite3 *db;
+  sqlite3_stmt *pLookup, *pScan;
+  char *zSql;
+  int i;
+  int nHit, nMiss;
+  int nLookupHit = 0, nLookupMiss = 0;
+
+  sqlite3_shutdown();
+  if( sqlite3_config(SQLITE_CONFIG_PCACHE_POLICY, ePolicy)!=SQLITE_OK ){
+    fatal("SQLITE_CONFIG_PCACHE_POLICY not supported", 0);
+  }
+  sqlite3_initialize();
+  if( sqlite3_open(zDb, &db) ) fatal("cannot open database", db);
+  zSql = sqlite3_mprintf("PRAGMA cache_size=%d", cacheSize);
+  execSql(db, zSql);
+  sqlite3_free(zSql);
+  if( sqlite3_prepare_v2(db, "SELECT v FROM hot WHERE k=?1", -1, &pLookup, 0)
+   || sqlite3_prepare_v2(db, "SELECT sum(length(b)) FROM cold", -1, &pScan, 0)
+  ){
+    fatal("cannot prepare statements", db);
+  }
+
+  for(i=0; i<nOp; i++){
+    if( aOp[i].eOp=='L' ){
+      nHit = dbStatus(db, SQLITE_DBSTATUS_CACHE_HIT);
+      nMiss = dbStatus(db, SQLITE_DBSTATUS_CACHE_MISS);
+      sqlite3_bind_int(pLookup, 1, aOp[i].iKey);
+      while( sqlite3_step(pLookup)==SQLITE_ROW ){}
+      sqlite3_reset(pLookup);
+      nLookupHit += dbStatus(db, SQLITE_DBSTATUS_CACHE_HIT) - nHit;
+      nLookupMiss += dbStatus(db, SQLITE_DBSTATUS_CACHE_MISS) - nMiss;
+    }else{
+      while( sqlite3_step(pScan)==SQLITE_ROW ){}
+      sqlite3_reset(pScan);
+    }
+  }
+
+  nHit = dbStatus(db, SQLITE_DBSTATUS_CACHE_HIT);
+  nMiss = dbStatus(db, SQLITE_DBSTATUS_CACHE_MISS);
+  printf("%-4s lookups: %9d hits %9d misses  hit ratio %5.1f%%\n",
+         zName, nLookupHit, nLookupMiss,
+         100.0*nLookupHit/(nLookupHit+nLookupMiss+(nLookupHit+nLookupMiss==0)));
+  printf("%-4s overall: %9d hits %9d misses  hit ratio %5.1f%%\n",
+         zName, nHit, nMiss, 100.0*nHit/(nHit+nMiss+(nHit+nMiss==0)));
+  sqlite3_finalize(pLookup);
+  sqlite3_finalize(pScan);
+  sqlite3_close(db);
+}
+
+int main(int argc, char **argv){
+  const char *zDb = 0;
+  const char *zTrace = 0;
+  TraceOp *aOp;
+  int nOp;
+  int i;
+
+  for(i=1; i<argc; i++){
+    const char *z = argv[i];
+    if( z[0]=='-' && z[1]=='-' ) z++;
+    if( strcmp(z, "-cache-size")==0 && i<argc-1 ){
+      cacheSize = atoi(argv[++i]);
+    }else if( strcmp(z, "-hot-rows")==0 && i<argc-1 ){
+      nHotRow = atoi(argv[++i]);
+    }else if( strcmp(z, "-cold-rows")==0 && i<argc-1 ){
+      nColdRow = atoi(argv[++i]);
+    }else if( zDb==0 ){
+      zDb = z;
+    }else if( zTrace==0 ){
+      zTrace = z;
+    }else{
+      zDb = 0;
+      break;
+    }
+  }
+  if( zDb==0 || nHotRow<10 || nColdRow<1 ){
+    fprintf(stderr, "Usage: %s [--cache-size N] [--hot-rows N] "
+                    "[--cold-rows N] DATABASE [TRACE]\n", argv[0]);
+    return 1;
+  }
+
+  buildDatabase(zDb);
+  nOp = loadTrace(zTrace, &aOp);
+  runTrace(zDb, "lru", SQLITE_PCACHE_POLICY_LRU, aOp, nOp);
+  runTrace(zDb, "2q", SQLITE_PCACHE_POLICY_2Q, aOp, nOp);
+  free(aOp);
+  return 0;
+}
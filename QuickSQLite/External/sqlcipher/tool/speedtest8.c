@@ -20,6 +20,11 @@
 ** a file containing SQL script that you want to test:
 **
 **     ./a.out test.db  test.sql
+**
+** Use the -vfs option to run the script against a particular VFS, for
+** example to compare "unix" with "unix-uring" (built with
+** -DSQLITE_ENABLE_IO_URING).  Running each under "strace -c -f" shows
+** the number of system calls made.
 */
 #include <stdio.h>
 #include <string.h>
@@ -103,6 +108,7 @@ int main(int argc, char **argv){
   int nByte = 0;
   const char *zArgv0 = argv[0];
   int bQuiet = 0;
+  const char *zVfs = 0;
 #if !defined(_MSC_VER)
   struct tms tmsStart, tmsEnd;
   clock_t clkStart, clkEnd;
@@ -167,6 +173,13 @@ int main(int argc, char **argv){
      continue;
     }
 
+    if( argc>4 && strcmp(argv[1], "-vfs")==0 ){
+     zVfs = argv[2];
+     argv += 2;
+     argc -= 2;
+     continue;
+    }
+
     break;
   }
 
@@ -178,7 +191,8 @@ int main(int argc, char **argv){
               "\t-log <log>\n"
 #endif
               "\t-priority <value> : set priority of task\n"
-              "\t-quiet : only display summary results\n",
+              "\t-quiet : only display summary results\n"
+              "\t-vfs <name> : open the database using VFS <name>\n",
               zArgv0);
    exit(1);
   }
@@ -197,7 +211,8 @@ int main(int argc, char **argv){
   clkStart = times(&tmsStart);
 #endif
   iStart = sqlite3Hwtime();
-  rc = sqlite3_open(argv[1], &db);
+  rc = sqlite3_open_v2(argv[1], &db,
+                       SQLITE_OPEN_READWRITE|SQLITE_OPEN_CREATE, zVfs);
   iElapse = sqlite3Hwtime() - iStart;
   iSetup = iElapse;
   if (!bQuiet) printf("sqlite3_open() returns %d in %llu cycles\n", rc, iElapse);